@@ -4,30 +4,294 @@
  */
 
 #include "AudioClip.h"
+#include <algorithm>
 #include <filesystem>
 
 AudioClip::AudioClip(std::string path, int sampleRate, int channels, std::vector<float> samples)
     : filePath_(std::move(path))
     , sampleRate_(sampleRate)
     , channels_(channels)
-    , samples_(std::move(samples))
 {
     displayName_ = std::filesystem::path(filePath_).filename().string();
+    setSamples(std::move(samples));
+    modified_ = false;
+}
+
+AudioClip AudioClip::fromMetadata(std::string path, int sampleRate, int channels, size_t frames,
+                                  float peakDb, float rmsDb, bool modified) {
+    AudioClip clip(std::move(path), sampleRate, channels, {});
+    clip.evict();
+    clip.endFrame_ = frames;
+    clip.updateMetrics(peakDb, rmsDb);
+    clip.modified_ = modified;
+    return clip;
+}
+
+std::span<const float> AudioClip::samples() const noexcept {
+    const float* data = floatData();
+    if (!data || channels_ <= 0) return {};
+    const auto ch = static_cast<size_t>(channels_);
+    return {data + startFrame_ * ch, (endFrame_ - startFrame_) * ch};
+}
+
+const float* AudioClip::floatData() const noexcept {
+    if (buffer_) return buffer_->data();
+    return mappedBuffer_ ? mappedBuffer_->data() : nullptr;
+}
+
+AudioClip::SampleView AudioClip::view() const {
+    return view(0, frameCount());
+}
+
+AudioClip::SampleView AudioClip::view(size_t firstFrame, size_t frames) const {
+    SampleView result;
+    const size_t available = frameCount();
+    firstFrame = std::min(firstFrame, available);
+    frames = std::min(frames, available - firstFrame);
+    const auto ch = static_cast<size_t>(std::max(channels_, 0));
+
+    if (const float* data = floatData()) {
+        result.keepAlive_ = buffer_ ? std::shared_ptr<const void>(buffer_) : std::shared_ptr<const void>(mappedBuffer_);
+        result.samples_ = {data + (startFrame_ + firstFrame) * ch, frames * ch};
+    } else if (compactBuffer_) {
+        result.expanded_.resize(frames * ch);
+        compactBuffer_->decode(startFrame_ + firstFrame, frames, result.expanded_.data());
+        result.samples_ = result.expanded_;
+    }
+    return result;
+}
+
+size_t AudioClip::readFrames(size_t firstFrame, size_t frames, float* out) const {
+    const size_t available = frameCount();
+    firstFrame = std::min(firstFrame, available);
+    frames = std::min(frames, available - firstFrame);
+    const auto ch = static_cast<size_t>(std::max(channels_, 0));
+
+    if (const float* data = floatData()) {
+        const float* first = data + (startFrame_ + firstFrame) * ch;
+        std::copy(first, first + frames * ch, out);
+    } else if (compactBuffer_) {
+        compactBuffer_->decode(startFrame_ + firstFrame, frames, out);
+    } else {
+        return 0;
+    }
+    return frames;
+}
+
+std::span<float> AudioClip::samplesMutable() {
+    if (channels_ <= 0) return {};
+    const auto ch = static_cast<size_t>(channels_);
+
+    // Processing works on float; expand the window of 16-bit storage first
+    if (compactBuffer_) {
+        auto expanded = std::make_shared<std::vector<float>>((endFrame_ - startFrame_) * ch);
+        compactBuffer_->decode(startFrame_, endFrame_ - startFrame_, expanded->data());
+        buffer_ = std::move(expanded);
+        compactBuffer_.reset();
+        endFrame_ -= startFrame_;
+        startFrame_ = 0;
+    }
+    // ... and copy spilled samples back to the heap
+    if (mappedBuffer_) {
+        const float* first = mappedBuffer_->data() + startFrame_ * ch;
+        buffer_ = std::make_shared<std::vector<float>>(first, first + (endFrame_ - startFrame_) * ch);
+        mappedBuffer_.reset();
+        endFrame_ -= startFrame_;
+        startFrame_ = 0;
+    }
+    if (!buffer_) return {};
+
+    // Copy-on-write: never modify storage another clip or the undo state can see
+    if (buffer_.use_count() > 1) {
+        const auto first = buffer_->begin() + static_cast<std::ptrdiff_t>(startFrame_ * ch);
+        const auto last = buffer_->begin() + static_cast<std::ptrdiff_t>(endFrame_ * ch);
+        buffer_ = std::make_shared<std::vector<float>>(first, last);
+        endFrame_ -= startFrame_;
+        startFrame_ = 0;
+    }
+    metricsValid_ = false;  // The caller is about to change the samples
+    return {buffer_->data() + startFrame_ * ch, (endFrame_ - startFrame_) * ch};
 }
 
 double AudioClip::durationSeconds() const noexcept {
     if (channels_ == 0 || sampleRate_ == 0) return 0.0;
-    return static_cast<double>(samples_.size()) / static_cast<double>(channels_ * sampleRate_);
+    return static_cast<double>(frameCount()) / static_cast<double>(sampleRate_);
 }
 
 size_t AudioClip::frameCount() const noexcept {
     if (channels_ == 0) return 0;
-    return samples_.size() / static_cast<size_t>(channels_);
+    return endFrame_ - startFrame_;
 }
 
 void AudioClip::setSamples(std::vector<float> samples) {
-    samples_ = std::move(samples);
+    const size_t frames = channels_ > 0 ? samples.size() / static_cast<size_t>(channels_) : 0;
+    buffer_ = std::make_shared<std::vector<float>>(std::move(samples));
+    compactBuffer_.reset();
+    mappedBuffer_.reset();
+    startFrame_ = 0;
+    endFrame_ = frames;
+    metricsValid_ = false;
+    modified_ = true;
+}
+
+bool AudioClip::trimFrames(size_t startFrame, size_t endFrame) {
+    const size_t frames = frameCount();
+    startFrame = std::min(startFrame, frames);
+    endFrame = std::min(endFrame, frames);
+    if (startFrame >= endFrame) return false;
+    if (startFrame == 0 && endFrame == frames) return false;
+
+    endFrame_ = startFrame_ + endFrame;
+    startFrame_ += startFrame;
+    trimOffsetFrames_ += startFrame;
+    metricsValid_ = false;
     modified_ = true;
+    return true;
+}
+
+void AudioClip::compact() {
+    if (compactBuffer_) {
+        if (startFrame_ == 0 && endFrame_ == compactBuffer_->frames()) return;
+        // Whole blocks are kept, so the samples are not quantized again
+        auto slice = std::make_shared<const CompactSamples>(
+            compactBuffer_->slice(startFrame_, endFrame_ - startFrame_));
+        endFrame_ = startFrame_ % CompactSamples::kBlockFrames + (endFrame_ - startFrame_);
+        startFrame_ %= CompactSamples::kBlockFrames;
+        compactBuffer_ = std::move(slice);
+        return;
+    }
+    // Spilled samples hold no memory; a trimmed window is left as is
+    if (!buffer_ || channels_ <= 0) return;
+    const auto ch = static_cast<size_t>(channels_);
+    if (startFrame_ == 0 && endFrame_ * ch == buffer_->size()) return;
+
+    const auto view = samples();
+    buffer_ = std::make_shared<std::vector<float>>(view.begin(), view.end());
+    endFrame_ -= startFrame_;
+    startFrame_ = 0;
+}
+
+bool AudioClip::storeCompact16(bool allowBlockScaled) {
+    if (channels_ <= 0) return false;
+
+    // The undo original is the unmodified source: only ever stored exactly
+    const auto ch = static_cast<size_t>(channels_);
+    if (originalBuffer_ && originalBuffer_ != buffer_) {
+        if (auto compact = CompactSamples::encode(originalBuffer_->data(), originalBuffer_->size() / ch,
+                                                  channels_, false)) {
+            originalCompactBuffer_ = std::make_shared<const CompactSamples>(std::move(*compact));
+            originalBuffer_.reset();
+        }
+    }
+
+    if (compactBuffer_) return true;
+    if (!buffer_) return false;
+    const bool sharedWithOriginal = originalBuffer_ == buffer_;
+    const bool exactOnly = !allowBlockScaled || sharedWithOriginal;
+    auto compact = CompactSamples::encode(buffer_->data(), buffer_->size() / ch, channels_, !exactOnly);
+    if (!compact) return false;
+    compactBuffer_ = std::make_shared<const CompactSamples>(std::move(*compact));
+    buffer_.reset();
+    if (sharedWithOriginal) {
+        originalCompactBuffer_ = compactBuffer_;
+        originalBuffer_.reset();
+    }
+    return true;
+}
+
+void AudioClip::storeFloat() {
+    auto expand = [](const CompactBuffer& compact) {
+        auto floats = std::make_shared<std::vector<float>>(compact->frames() * static_cast<size_t>(compact->channels()));
+        compact->decode(0, compact->frames(), floats->data());
+        return floats;
+    };
+    const bool sharedWithOriginal = originalCompactBuffer_ && originalCompactBuffer_ == compactBuffer_;
+    if (compactBuffer_) {
+        buffer_ = expand(compactBuffer_);
+        compactBuffer_.reset();
+    }
+    if (sharedWithOriginal) {
+        originalBuffer_ = buffer_;
+        originalCompactBuffer_.reset();
+    } else if (originalCompactBuffer_) {
+        originalBuffer_ = expand(originalCompactBuffer_);
+        originalCompactBuffer_.reset();
+    }
+}
+
+size_t AudioClip::residentBytes() const noexcept {
+    auto bytesOf = [](const Buffer& floats, const CompactBuffer& compact) -> size_t {
+        if (floats) return floats->capacity() * sizeof(float);
+        return compact ? compact->bytes() : 0;
+    };
+    size_t total = bytesOf(buffer_, compactBuffer_);
+    const bool shared = (buffer_ && originalBuffer_ == buffer_)
+        || (compactBuffer_ && originalCompactBuffer_ == compactBuffer_);
+    if (!shared) total += bytesOf(originalBuffer_, originalCompactBuffer_);
+    return total;
+}
+
+bool AudioClip::spill(const std::string& directory) {
+    if (channels_ <= 0) return false;
+
+    // Whole buffers are written, so the window and an undo original sharing
+    // the buffer keep their frame positions
+    auto spillStorage = [&](const Buffer& floats, const CompactBuffer& compact) -> MappedBuffer {
+        const auto ch = static_cast<size_t>(channels_);
+        if (floats) {
+            return MappedSamples::create(directory, floats->size() / ch, channels_,
+                                         [&](size_t firstFrame, size_t frames, float* out) {
+                                             std::copy_n(floats->data() + firstFrame * ch, frames * ch, out);
+                                         });
+        }
+        if (compact) {
+            return MappedSamples::create(directory, compact->frames(), channels_,
+                                         [&](size_t firstFrame, size_t frames, float* out) {
+                                             compact->decode(firstFrame, frames, out);
+                                         });
+        }
+        return nullptr;
+    };
+
+    const bool sharedWithOriginal = (buffer_ && originalBuffer_ == buffer_)
+        || (compactBuffer_ && originalCompactBuffer_ == compactBuffer_);
+    MappedBuffer current = mappedBuffer_;
+    if (!current) {
+        current = spillStorage(buffer_, compactBuffer_);
+        if (!current) return false;
+    }
+    MappedBuffer original = originalMappedBuffer_;
+    if (sharedWithOriginal) {
+        original = current;
+    } else if (originalBuffer_ || originalCompactBuffer_) {
+        original = spillStorage(originalBuffer_, originalCompactBuffer_);
+        if (!original) return false;
+    }
+
+    mappedBuffer_ = std::move(current);
+    buffer_.reset();
+    compactBuffer_.reset();
+    if (original) {
+        originalMappedBuffer_ = std::move(original);
+        originalBuffer_.reset();
+        originalCompactBuffer_.reset();
+    }
+    return true;
+}
+
+size_t AudioClip::spilledBytes() const noexcept {
+    size_t total = mappedBuffer_ ? mappedBuffer_->bytes() : 0;
+    if (originalMappedBuffer_ && originalMappedBuffer_ != mappedBuffer_) total += originalMappedBuffer_->bytes();
+    return total;
+}
+
+void AudioClip::evict() {
+    buffer_.reset();
+    compactBuffer_.reset();
+    mappedBuffer_.reset();
+    originalBuffer_.reset();
+    originalCompactBuffer_.reset();
+    originalMappedBuffer_.reset();
 }
 
 void AudioClip::setFilePath(const std::string& path) {
@@ -35,23 +299,61 @@ void AudioClip::setFilePath(const std::string& path) {
     displayName_ = std::filesystem::path(filePath_).filename().string();
 }
 
-void AudioClip::updateMetrics(float peakDb, float rmsDb) {
+void AudioClip::measureMetrics() {
+    if (!isResident()) return;
+
+    DSP::ChannelLevelMeter meter(channels_);
+    if (floatData()) {
+        meter = DSP::measureChannelLevels(samples(), channels_);
+    } else {
+        // Expand 16-bit storage a block at a time instead of in full
+        constexpr size_t kBlockFrames = 4096;
+        std::vector<float> block(kBlockFrames * static_cast<size_t>(std::max(channels_, 0)));
+        for (size_t frame = 0; frame < frameCount(); frame += kBlockFrames) {
+            meter.add(block.data(), readFrames(frame, kBlockFrames, block.data()));
+        }
+    }
+    const auto levels = meter.levels();
+    peakDb_ = levels.peakDb;
+    rmsDb_ = levels.rmsDb;
+    channelLevels_ = meter.channelLevels();
+    metricsValid_ = true;
+}
+
+void AudioClip::updateMetrics(float peakDb, float rmsDb, std::vector<DSP::Levels> channelLevels) {
     peakDb_ = peakDb;
     rmsDb_ = rmsDb;
+    channelLevels_ = std::move(channelLevels);
+    metricsValid_ = true;
 }
 
 void AudioClip::saveOriginal() {
-    originalSamples_ = samples_;
+    // Shares the buffer; the first write after this copies (see samplesMutable)
+    originalCompactBuffer_ = compactBuffer_;
+    originalMappedBuffer_ = mappedBuffer_;
+    originalBuffer_ = buffer_ || compactBuffer_ || mappedBuffer_ ? buffer_ : std::make_shared<std::vector<float>>();
+    originalStartFrame_ = startFrame_;
+    originalEndFrame_ = endFrame_;
+    originalTrimOffsetFrames_ = trimOffsetFrames_;
     originalPeakDb_ = peakDb_;
     originalRmsDb_ = rmsDb_;
+    originalChannelLevels_ = channelLevels_;
+    originalMetricsValid_ = metricsValid_;
     modified_ = false;
 }
 
 void AudioClip::restoreOriginal() {
-    if (originalSamples_.empty()) return;
+    if (!hasOriginal()) return;
 
-    samples_ = originalSamples_;
+    buffer_ = originalBuffer_;
+    compactBuffer_ = originalCompactBuffer_;
+    mappedBuffer_ = originalMappedBuffer_;
+    startFrame_ = originalStartFrame_;
+    endFrame_ = originalEndFrame_;
+    trimOffsetFrames_ = originalTrimOffsetFrames_;
     peakDb_ = originalPeakDb_;
     rmsDb_ = originalRmsDb_;
+    channelLevels_ = originalChannelLevels_;
+    metricsValid_ = originalMetricsValid_;
     modified_ = false;
 }
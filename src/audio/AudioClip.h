@@ -2,15 +2,33 @@
  * @file AudioClip.h
  * @brief Represents an audio clip with sample data and metadata.
  *
- * Supports undo of processing operations by storing a copy of the original
- * samples that can be restored.
+ * Supports undo of processing operations by keeping a reference to the
+ * original samples that can be restored.
+ *
+ * Samples live in a shared, immutable-once-shared buffer. A clip is a frame
+ * window over that buffer, so copying a clip, trimming it and undoing the
+ * trim are all O(1); the samples are only copied when a shared buffer is
+ * written to (copy-on-write) or when compact() is asked to release the
+ * trimmed-away parts.
+ *
+ * The buffer is either float or, after storeCompact16(), a CompactSamples
+ * copy at half the size. samples() only views float storage; view() and
+ * readFrames() work for both, expanding 16-bit storage on demand. Under
+ * memory pressure the float samples can also be spilled to a memory-mapped
+ * file (spill()), which every reader views in place.
  */
 
 #pragma once
 
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+#include "CompactSamples.h"
+#include "MappedSamples.h"
+#include "utils/DSP.h"
+
 /**
  * @class AudioClip
  * @brief In-memory representation of an audio file.
@@ -18,9 +36,31 @@
  * Stores interleaved float samples, sample rate, channel count, and derived
  * metrics (peak dB, RMS dB). Supports saving and restoring original samples
  * for undo functionality.
+ *
+ * samples() is a view that stays valid until the clip is next modified.
  */
 class AudioClip {
 public:
+    /**
+     * @brief Float samples of a clip's window, viewed in place or expanded.
+     *
+     * Stays valid while it exists, even if the clip is modified meanwhile,
+     * as long as the clip was float-resident or spilled (the view then
+     * points into its shared buffer, which writes never touch once shared).
+     */
+    class SampleView final {
+    public:
+        [[nodiscard]] std::span<const float> samples() const noexcept { return samples_; }
+        [[nodiscard]] const float* data() const noexcept { return samples_.data(); }
+        [[nodiscard]] size_t size() const noexcept { return samples_.size(); }
+
+    private:
+        friend class AudioClip;
+        std::shared_ptr<const void> keepAlive_;
+        std::vector<float> expanded_;
+        std::span<const float> samples_;
+    };
+
     AudioClip() = default;
 
     /**
@@ -32,14 +72,51 @@ public:
      */
     AudioClip(std::string path, int sampleRate, int channels, std::vector<float> samples);
 
+    /**
+     * @brief A clip known only by its metadata, as if it had been evicted.
+     *
+     * Lists a clip from the information cached in a project before its file
+     * is decoded; ClipPipeline::reloadClip() loads it when it is used.
+     * @param modified Whether the clip has stored processing to re-apply on reload.
+     */
+    [[nodiscard]] static AudioClip fromMetadata(std::string path, int sampleRate, int channels, size_t frames,
+                                                float peakDb, float rmsDb, bool modified);
+
     // --- Accessors ---
 
     const std::string& filePath() const noexcept { return filePath_; }
     const std::string& displayName() const noexcept { return displayName_; }
     int sampleRate() const noexcept { return sampleRate_; }
     int channels() const noexcept { return channels_; }
-    const std::vector<float>& samples() const noexcept { return samples_; }
-    std::vector<float>& samplesMutable() noexcept { return samples_; }
+
+    /**
+     * @brief Interleaved samples of the current (possibly trimmed) window.
+     *
+     * Views float storage in memory or spilled to a file. Empty while the
+     * clip is stored as 16 bits (isCompact16()); code that may see such
+     * clips reads through view() or readFrames().
+     */
+    std::span<const float> samples() const noexcept;
+
+    /** @brief Float samples of the window, expanded if the clip is stored as 16 bits. */
+    [[nodiscard]] SampleView view() const;
+
+    /** @brief Like view(), for frames [firstFrame, firstFrame + frames) of the window. */
+    [[nodiscard]] SampleView view(size_t firstFrame, size_t frames) const;
+
+    /**
+     * @brief Copy frames [firstFrame, firstFrame + frames) of the window into @p out as float.
+     * @return Frames copied; fewer if the range runs past the end.
+     */
+    size_t readFrames(size_t firstFrame, size_t frames, float* out) const;
+
+    /**
+     * @brief Writable view of the current window.
+     *
+     * Copies the window into a buffer owned by this clip first if the
+     * storage is shared with another clip or with the undo state.
+     */
+    std::span<float> samplesMutable();
 
     /** @brief Duration in seconds. */
     double durationSeconds() const noexcept;
@@ -47,14 +124,121 @@ public:
     /** @brief Total number of sample frames (samples / channels). */
     size_t frameCount() const noexcept;
 
+    /**
+     * @brief Peak level of the current window in dBFS, while hasMetrics().
+     *
+     * Reading never measures: after a trim the levels stay unknown until
+     * measureMetrics() (or a processing pass) measures them.
+     */
     float peakDb() const noexcept { return peakDb_; }
     float rmsDb() const noexcept { return rmsDb_; }
 
+    /**
+     * @brief True if peakDb()/rmsDb() are measured for the current samples.
+     *
+     * Set by updateMetrics() and measureMetrics(); cleared whenever the
+     * samples or the window change, so stale metrics are never mistaken
+     * for current ones.
+     */
+    bool hasMetrics() const noexcept { return metricsValid_; }
+
+    /**
+     * @brief Peak/RMS of each channel, while hasMetrics().
+     *
+     * Empty if only the overall metrics are known (e.g. restored from a
+     * project file without the samples being measured since).
+     */
+    const std::vector<DSP::Levels>& channelLevels() const noexcept { return channelLevels_; }
+
+    /**
+     * @brief Measure the metrics of the current window now, even if they are known.
+     *
+     * O(frames); does nothing while the clip is not resident.
+     */
+    void measureMetrics();
+
     // --- Mutators ---
 
     void setSamples(std::vector<float> samples);
+
+    /**
+     * @brief Narrow the clip to frames [startFrame, endFrame) of the current window.
+     *
+     * O(1): no samples are copied. Out-of-range values are clamped; an empty
+     * or inverted range leaves the clip unchanged.
+     * @return True if the window changed.
+     */
+    bool trimFrames(size_t startFrame, size_t endFrame);
+
+    /**
+     * @brief Frames trimmed off the start since the samples were loaded.
+     *
+     * Accumulates over repeated trims, so a re-trim can be stored relative
+     * to the file on disk.
+     */
+    size_t trimOffsetFrames() const noexcept { return trimOffsetFrames_; }
+
+    /**
+     * @brief Release storage outside the current window.
+     *
+     * Copies the window into an exactly sized buffer when the clip holds a
+     * trimmed view; a no-op otherwise.
+     */
+    void compact();
+
+    /**
+     * @brief Store the samples (and the undo original) as 16 bits.
+     *
+     * Exact for 16-bit material. Samples that are not exact 16-bit values
+     * stay float unless @p allowBlockScaled, in which case they are
+     * quantized per block (see CompactSamples); the undo original is only
+     * ever converted when it is exact.
+     * @return True if the current samples are now stored as 16 bits.
+     */
+    bool storeCompact16(bool allowBlockScaled = false);
+
+    /** @brief Expand 16-bit storage back to float, e.g. before heavy random access. */
+    void storeFloat();
+
+    /** @brief True if the current samples are stored as 16 bits. */
+    bool isCompact16() const noexcept { return compactBuffer_ != nullptr; }
+
+    /** @brief Heap bytes of the sample storage, counting storage shared with the undo original once. */
+    size_t residentBytes() const noexcept;
+
+    /**
+     * @brief Move the samples and the undo original into memory-mapped files in @p directory.
+     *
+     * For processed clips, which cannot be reloaded from their source. The
+     * samples stay readable (the OS pages them in on access) and are copied
+     * back to the heap by the next samplesMutable(). 16-bit storage is
+     * spilled as float.
+     * @return False if a file cannot be written; the clip is then unchanged.
+     */
+    bool spill(const std::string& directory);
+
+    /** @brief True if the current samples live in a spill file. */
+    bool isSpilled() const noexcept { return mappedBuffer_ != nullptr; }
+
+    /** @brief Bytes of the spill files, counting a file shared with the undo original once. */
+    size_t spilledBytes() const noexcept;
+
+    /**
+     * @brief Release the samples and the undo original to free memory.
+     *
+     * The metadata, metrics, window length and modified flag stay, so the
+     * clip can still be listed; it reads as empty until it is replaced by a
+     * reloaded copy (see ClipPipeline::reloadClip()).
+     */
+    void evict();
+
+    /** @brief False after evict() (or for a default-constructed clip). */
+    bool isResident() const noexcept {
+        return buffer_ != nullptr || compactBuffer_ != nullptr || mappedBuffer_ != nullptr;
+    }
+
     void setFilePath(const std::string& path);
-    void updateMetrics(float peakDb, float rmsDb);
+    void updateMetrics(float peakDb, float rmsDb, std::vector<DSP::Levels> channelLevels = {});
 
     // --- Undo support ---
 
@@ -77,7 +261,9 @@ public:
      * @brief Check if original samples are available for restore.
      * @return True if saveOriginal() was called and restore is possible.
      */
-    bool hasOriginal() const noexcept { return !originalSamples_.empty(); }
+    bool hasOriginal() const noexcept {
+        return originalBuffer_ != nullptr || originalCompactBuffer_ != nullptr || originalMappedBuffer_ != nullptr;
+    }
 
     /**
      * @brief Check if clip has been modified since loading.
@@ -91,17 +277,38 @@ public:
     void setModified(bool modified) noexcept { modified_ = modified; }
 
 private:
+    using Buffer = std::shared_ptr<std::vector<float>>;
+    using CompactBuffer = std::shared_ptr<const CompactSamples>;
+    using MappedBuffer = std::shared_ptr<const MappedSamples>;
+
+    /// Float samples of the whole buffer, in memory or mapped; null for 16-bit storage.
+    const float* floatData() const noexcept;
+
     std::string filePath_;
     std::string displayName_;
     int sampleRate_{44100};
     int channels_{2};
-    std::vector<float> samples_;
+    Buffer buffer_;
+    CompactBuffer compactBuffer_;   ///< Set instead of buffer_ while stored as 16 bits
+    MappedBuffer mappedBuffer_;     ///< Set instead of buffer_ while spilled
+    size_t startFrame_{0};      ///< Window start within the buffer (frames)
+    size_t endFrame_{0};        ///< Window end within the buffer (frames, exclusive)
+    size_t trimOffsetFrames_{0};
     float peakDb_{0.0f};
     float rmsDb_{0.0f};
+    std::vector<DSP::Levels> channelLevels_;
+    bool metricsValid_{false};
 
-    // Undo support: original state
-    std::vector<float> originalSamples_;
+    // Undo support: original state (shares storage until either side writes)
+    Buffer originalBuffer_;
+    CompactBuffer originalCompactBuffer_;
+    MappedBuffer originalMappedBuffer_;
+    size_t originalStartFrame_{0};
+    size_t originalEndFrame_{0};
+    size_t originalTrimOffsetFrames_{0};
     float originalPeakDb_{0.0f};
     float originalRmsDb_{0.0f};
+    std::vector<DSP::Levels> originalChannelLevels_;
+    bool originalMetricsValid_{false};
     bool modified_{false};
 };
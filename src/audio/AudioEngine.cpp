@@ -1,50 +1,222 @@
 #include "AudioEngine.h"
+#include "utils/Trace.h"
+#include <algorithm>
 #include <filesystem>
 
-std::optional<AudioClip> AudioEngine::loadClip(const std::string& path) {
+namespace {
+
+/// Export fades as an envelope the writers apply while streaming the clip out.
+DSP::FadeEnvelope exportFades(int fadeInFrames, int fadeOutFrames) {
+    return {static_cast<size_t>(std::max(0, fadeInFrames)), static_cast<size_t>(std::max(0, fadeOutFrames)),
+            DSP::FadeType::SCurve};
+}
+
+/// Frames [start, end) of a clip trimmed to [startSec, endSec); endSec <= 0 keeps the end.
+std::pair<size_t, size_t> trimWindow(int sampleRate, size_t frames, float startSec, float endSec) {
+    const double sr = sampleRate;
+    auto startFrame = static_cast<size_t>(std::max(0.0f, startSec) * sr);
+    auto endFrame = endSec <= 0 ? frames : static_cast<size_t>(endSec * sr);
+    return {startFrame, endFrame};
+}
+
+/**
+ * Copies the trimmed part of a clip out of the decoder as it arrives and
+ * runs a chain over the copy, so the chain's first pass keeps pace with the
+ * decode instead of starting after it.
+ */
+class ChainSink final : public FrameRanges::Sink {
+public:
+    ChainSink(const ProcessingChain& chain, float trimStartSec, float trimEndSec)
+        : chain_(chain), trimStartSec_(trimStartSec), trimEndSec_(trimEndSec) {}
+
+    void begin(int sampleRate, int channels, size_t frames) override {
+        // Clamped as AudioClip::trimFrames() clamps
+        auto [start, end] = trimWindow(sampleRate, frames, trimStartSec_, trimEndSec_);
+        start_ = std::min(start, frames);
+        end_ = std::min(end, frames);
+        if (start_ >= end_) {
+            start_ = 0;
+            end_ = frames;
+        }
+        next_ = 0;
+        sourceFrames_ = frames;
+        ch_ = static_cast<size_t>(std::max(channels, 0));
+        output_.assign((end_ - start_) * ch_, 0.0f);
+        stream_.emplace(chain_, output_, sampleRate, channels);
+    }
+
+    void frames(const float* samples, size_t firstFrame, size_t frames) override {
+        // Only the frames that follow those already taken
+        const size_t from = std::max({firstFrame, next_, start_});
+        const size_t to = std::min(firstFrame + frames, end_);
+        next_ = std::max(next_, firstFrame + frames);
+        if (from >= to) return;
+        std::copy(samples + (from - firstFrame) * ch_, samples + (to - firstFrame) * ch_,
+                  output_.data() + (from - start_) * ch_);
+        stream_->feed(to - from);
+    }
+
+    [[nodiscard]] bool begun() const noexcept { return stream_.has_value(); }
+
+    /** @brief Source frame count the trim window was placed over in begin(). */
+    [[nodiscard]] size_t sourceFrames() const noexcept { return sourceFrames_; }
+
+    /** @brief Finish the chain; the processed samples are left in output(). */
+    ProcessingChain::Result finish() {
+        auto result = stream_->finish();
+        output_.resize(stream_->framesFed() * ch_);
+        return result;
+    }
+
+    [[nodiscard]] std::vector<float>& output() noexcept { return output_; }
+
+private:
+    const ProcessingChain& chain_;
+    float trimStartSec_;
+    float trimEndSec_;
+    size_t start_{0};
+    size_t end_{0};
+    size_t next_{0};    ///< Source frames handed over so far
+    size_t sourceFrames_{0};
+    size_t ch_{0};
+    std::vector<float> output_;
+    std::optional<ProcessingChain::Stream> stream_;
+};
+
+} // namespace
+
+std::optional<AudioClip> AudioEngine::decode(const std::string& path, std::span<const uint8_t> bytes,
+                                             FrameRanges::Sink* sink) const {
     const auto ext = std::filesystem::path(path).extension().string();
-    std::optional<AudioClip> clip;
     if (ext == ".wav" || ext == ".WAV") {
-        clip = wavCodec_.read(path);
-    } else if (ext == ".mp3" || ext == ".MP3") {
-        clip = mp3Codec_.read(path);
+        return bytes.empty() ? wavCodec_.read(path, sink) : wavCodec_.read(path, bytes, sink);
     }
+    if (ext == ".mp3" || ext == ".MP3") {
+        return bytes.empty() ? mp3Codec_.read(path) : mp3Codec_.read(path, bytes);
+    }
+    return std::nullopt;
+}
+
+std::optional<AudioClip> AudioEngine::loadClip(const std::string& path) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::loadClip", path);
+    auto clip = decode(path, {}, nullptr);
     if (clip) {
-        refreshMetrics(*clip);
+        // Long files are measured while they decode
+        if (!clip->hasMetrics()) refreshMetrics(*clip);
+        if (compactStorage()) clip->storeCompact16();
     }
     return clip;
 }
 
-void AudioEngine::trim(AudioClip& clip, float startSec, float endSec) {
-    const auto& data = clip.samples();
-    int sr = clip.sampleRate();
-    int ch = clip.channels();
-    auto startIdx = static_cast<size_t>(std::max(0.0f, startSec) * sr * ch);
-    auto endIdx = endSec <= 0 ? data.size() : static_cast<size_t>(endSec * sr * ch);
-    startIdx = std::min(startIdx, data.size());
-    endIdx = std::min(endIdx, data.size());
-    if (startIdx >= endIdx) return;
-    std::vector<float> trimmed(data.begin() + static_cast<std::ptrdiff_t>(startIdx), data.begin() + static_cast<std::ptrdiff_t>(endIdx));
-    clip.setSamples(std::move(trimmed));
-    refreshMetrics(clip);
+std::optional<AudioClip> AudioEngine::loadClip(const std::string& path, std::span<const uint8_t> bytes) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::loadClip", path);
+    auto clip = bytes.empty() ? std::nullopt : decode(path, bytes, nullptr);
+    if (clip) {
+        if (!clip->hasMetrics()) refreshMetrics(*clip);
+        if (compactStorage()) clip->storeCompact16();
+    }
+    return clip;
 }
 
-void AudioEngine::normalizeToPeak(AudioClip& clip, float targetDbFS) {
-    DSP::normalizeToPeak(clip.samplesMutable(), targetDbFS);
-    refreshMetrics(clip);
+std::optional<AudioClip> AudioEngine::loadProcessed(const std::string& path, std::span<const uint8_t> bytes,
+                                                    float trimStartSec, float trimEndSec,
+                                                    const ProcessingChain& chain,
+                                                    ProcessingChain::Result* result) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::loadProcessed", path);
+    ChainSink sink(chain, trimStartSec, trimEndSec);
+    auto clip = decode(path, bytes, &sink);
+    if (!clip) return std::nullopt;
+
+    // Whatever the decoder did not hand over (a file read in one go, a short
+    // read). After a short read the window the header's frame count placed
+    // may not match the clip's, so it is placed again over the decoded frames.
+    const auto samples = clip->samples();
+    if (!sink.begun() || sink.sourceFrames() != clip->frameCount()) {
+        sink.begin(clip->sampleRate(), clip->channels(), clip->frameCount());
+    }
+    sink.frames(samples.data(), 0, clip->frameCount());
+    auto processed = sink.finish();
+
+    if (!clip->hasMetrics()) refreshMetrics(*clip);
+    if (compactStorage()) clip->storeCompact16();
+    clip->saveOriginal();
+    const auto [startFrame, endFrame] = trimWindow(clip->sampleRate(), clip->frameCount(), trimStartSec, trimEndSec);
+    clip->trimFrames(startFrame, endFrame);
+    clip->setSamples(std::move(sink.output()));
+    clip->updateMetrics(processed.levels.peakDb, processed.levels.rmsDb, processed.channelLevels);
+    if (compactStorage()) clip->storeCompact16(true);
+    if (result) *result = std::move(processed);
+    return clip;
 }
 
-void AudioEngine::normalizeToRms(AudioClip& clip, float targetDb) {
-    DSP::normalizeToRMS(clip.samplesMutable(), targetDb);
-    refreshMetrics(clip);
+bool AudioEngine::streamFrames(const std::string& path, FrameRanges::Sink& sink) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::streamFrames", path);
+    const auto ext = std::filesystem::path(path).extension().string();
+    if (ext == ".wav" || ext == ".WAV") return wavCodec_.stream(path, sink);
+
+    auto clip = decode(path, {}, nullptr);
+    if (!clip) return false;
+    const auto samples = clip->samples();
+    sink.begin(clip->sampleRate(), clip->channels(), clip->frameCount());
+    sink.frames(samples.data(), 0, clip->frameCount());
+    return true;
 }
 
-void AudioEngine::compress(AudioClip& clip, float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb) {
-    DSP::compressor(clip.samplesMutable(), thresholdDb, ratio, attackMs, releaseMs, makeupDb, clip.sampleRate(), clip.channels());
-    refreshMetrics(clip);
+void AudioEngine::trim(AudioClip& clip, float startSec, float endSec) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::trim");
+    const auto [startFrame, endFrame] = trimWindow(clip.sampleRate(), clip.frameCount(), startSec, endSec);
+    // O(1): the clip becomes a narrower view over the same samples; its
+    // levels are left to the next processing pass or measureMetrics()
+    clip.trimFrames(startFrame, endFrame);
+}
+
+bool AudioEngine::autoTrim(AudioClip& clip, const DSP::SilenceSettings& settings) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::autoTrim");
+    const auto view = clip.view();
+    const auto range = DSP::findSoundRange(view.samples(), clip.sampleRate(), clip.channels(), settings);
+    if (range.empty()) return false;
+    return clip.trimFrames(range.startFrame, range.endFrame);
+}
+
+void AudioEngine::normalizeToPeak(AudioClip& clip, float targetDbFS) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::normalizeToPeak");
+    process(clip, ProcessingChain().normalizeToPeak(targetDbFS));
+}
+
+void AudioEngine::normalizeToRms(AudioClip& clip, float targetDb) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::normalizeToRms");
+    process(clip, ProcessingChain().normalizeToRms(targetDb));
+}
+
+void AudioEngine::compress(AudioClip& clip, float thresholdDb, float ratio, float attackMs, float releaseMs,
+                           float makeupDb) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::compress");
+    process(clip, ProcessingChain().compress({thresholdDb, ratio, attackMs, releaseMs, makeupDb}));
+}
+
+void AudioEngine::limit(AudioClip& clip, float ceilingDb, float lookaheadMs, float releaseMs) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::limit");
+    process(clip, ProcessingChain().limit({ceilingDb, lookaheadMs, releaseMs}));
+}
+
+ProcessingChain::Result AudioEngine::process(AudioClip& clip, const ProcessingChain& chain) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::process");
+    std::optional<DSP::Levels> known;
+    if (clip.hasMetrics()) known = DSP::Levels{clip.peakDb(), clip.rmsDb()};
+    if (chain.empty()) {
+        if (!known) refreshMetrics(clip);
+        return {{clip.peakDb(), clip.rmsDb()}, known ? 0 : 1, 0, clip.channelLevels()};
+    }
+
+    auto result = chain.run(clip.samplesMutable(), clip.sampleRate(), clip.channels(), known);
+    clip.updateMetrics(result.levels.peakDb, result.levels.rmsDb, result.channelLevels);
+    if (compactStorage()) clip.storeCompact16(true);
+    return result;
 }
 
-bool AudioEngine::exportWav(const AudioClip& clip, const std::string& outFolder, int fadeInFrames, int fadeOutFrames) {
+bool AudioEngine::exportWav(const AudioClip& clip, const std::string& outFolder, int fadeInFrames, int fadeOutFrames,
+                            std::string* error) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::exportWav", clip.displayName());
     namespace fs = std::filesystem;
     fs::path folder(outFolder);
     fs::create_directories(folder);
@@ -52,22 +224,11 @@ bool AudioEngine::exportWav(const AudioClip& clip, const std::string& outFolder,
     auto outName = inPath.stem().string() + ".wav";
     fs::path outPath = folder / outName;
 
-    // If no fades, export directly
-    if (fadeInFrames <= 0 && fadeOutFrames <= 0) {
-        return wavCodec_.write(outPath.string(), clip);
-    }
-
-    // Create a copy with fades applied
-    AudioClip fadedClip = clip;
-    if (fadeInFrames > 0) {
-        DSP::applyFadeIn(fadedClip.samplesMutable(), fadeInFrames, DSP::FadeType::SCurve);
+    if (!wavCodec_.write(outPath.string(), clip, exportFades(fadeInFrames, fadeOutFrames))) {
+        if (error) *error = "Failed to write WAV file: " + outPath.string();
+        return false;
     }
-    if (fadeOutFrames > 0) {
-        DSP::applyFadeOut(fadedClip.samplesMutable(), fadeOutFrames, DSP::FadeType::SCurve);
-    }
-    refreshMetrics(fadedClip);
-
-    return wavCodec_.write(outPath.string(), fadedClip);
+    return true;
 }
 
 bool AudioEngine::exportMp3(
@@ -76,8 +237,10 @@ bool AudioEngine::exportMp3(
     Mp3Encoder::BitrateMode bitrate,
     const Mp3Metadata& metadata,
     int fadeInFrames,
-    int fadeOutFrames
-) {
+    int fadeOutFrames,
+    std::string* error
+) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::exportMp3", clip.displayName());
     namespace fs = std::filesystem;
     fs::path folder(outFolder);
     fs::create_directories(folder);
@@ -85,32 +248,41 @@ bool AudioEngine::exportMp3(
     auto outName = inPath.stem().string() + ".mp3";
     fs::path outPath = folder / outName;
 
-    // If no fades, export directly
-    if (fadeInFrames <= 0 && fadeOutFrames <= 0) {
-        return mp3Encoder_.encode(clip, outPath.string(), bitrate, metadata);
-    }
+    return mp3Encoder_.encode(clip, outPath.string(), bitrate, metadata, exportFades(fadeInFrames, fadeOutFrames),
+                              error);
+}
 
-    // Create a copy with fades applied
-    AudioClip fadedClip = clip;
-    if (fadeInFrames > 0) {
-        DSP::applyFadeIn(fadedClip.samplesMutable(), fadeInFrames, DSP::FadeType::SCurve);
-    }
-    if (fadeOutFrames > 0) {
-        DSP::applyFadeOut(fadedClip.samplesMutable(), fadeOutFrames, DSP::FadeType::SCurve);
-    }
-    refreshMetrics(fadedClip);
+std::optional<std::vector<uint8_t>> AudioEngine::encodeWav(const AudioClip& clip, int fadeInFrames, int fadeOutFrames,
+                                                       std::string* error) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::encodeWav", clip.displayName());
+    auto out = wavCodec_.encode(clip, exportFades(fadeInFrames, fadeOutFrames));
+    if (!out && error) *error = "Failed to encode WAV data for " + clip.displayName();
+    return out;
+}
 
-    return mp3Encoder_.encode(fadedClip, outPath.string(), bitrate, metadata);
+std::optional<std::vector<uint8_t>> AudioEngine::encodeMp3(
+    const AudioClip& clip,
+    Mp3Encoder::BitrateMode bitrate,
+    const Mp3Metadata& metadata,
+    int fadeInFrames,
+    int fadeOutFrames,
+    std::string* error
+) const {
+    WOOSH_TRACE_SCOPE_DETAIL("AudioEngine::encodeMp3", clip.displayName());
+    std::vector<uint8_t> out;
+    if (!mp3Encoder_.encodeToMemory(clip, out, bitrate, metadata, exportFades(fadeInFrames, fadeOutFrames), error)) {
+        return std::nullopt;
+    }
+    return out;
 }
 
-void AudioEngine::updateClipMetrics(AudioClip& clip) {
+void AudioEngine::updateClipMetrics(AudioClip& clip) const {
     refreshMetrics(clip);
 }
 
-void AudioEngine::refreshMetrics(AudioClip& clip) {
-    auto peak = DSP::computePeakDbFS(clip.samples());
-    auto rms = DSP::computeRMSDb(clip.samples());
-    clip.updateMetrics(peak, rms);
+void AudioEngine::refreshMetrics(AudioClip& clip) const {
+    WOOSH_TRACE_SCOPE("AudioEngine::refreshMetrics");
+    clip.measureMetrics();
 }
 
 
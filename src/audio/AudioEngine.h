@@ -1,24 +1,90 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 #include "AudioClip.h"
 #include "Formats/WavCodec.h"
 #include "Formats/Mp3Codec.h"
 #include "Formats/Mp3Encoder.h"
+#include "ProcessingChain.h"
 #include "utils/DSP.h"
+#include "utils/FrameRanges.h"
 
+/**
+ * @brief Loads, processes and exports clips.
+ *
+ * Thread-safe: the operations are const and keep their state per call (a
+ * codec handle or LAME context, the calling thread's BufferPool), so one
+ * engine is shared by all batch workers without locks. Concurrent calls
+ * must work on different clips. Failures are reported by each call's
+ * result, and its @p error string where it has one.
+ */
 class AudioEngine {
 public:
     AudioEngine() = default;
 
-    [[nodiscard]] std::optional<AudioClip> loadClip(const std::string& path);
-    void trim(AudioClip& clip, float startSec, float endSec);
-    void normalizeToPeak(AudioClip& clip, float targetDbFS);
-    void normalizeToRms(AudioClip& clip, float targetDb);
-    void compress(AudioClip& clip, float thresholdDb, float ratio, float attackMs, float releaseMs, float makeupDb);
-    [[nodiscard]] bool exportWav(const AudioClip& clip, const std::string& outFolder, int fadeInFrames = 0, int fadeOutFrames = 0);
+    [[nodiscard]] std::optional<AudioClip> loadClip(const std::string& path) const;
+
+    /** @brief Decode a file whose contents were already read (e.g. by a FilePrefetcher). */
+    [[nodiscard]] std::optional<AudioClip> loadClip(const std::string& path, std::span<const uint8_t> bytes) const;
+
+    /**
+     * @brief Load a clip, trim it and run @p chain over it, overlapping the chain with the decode.
+     *
+     * Gives the clip loadClip(), saving its original, trim() and process()
+     * would, but long files (see FrameRanges) hand their frame ranges to the
+     * chain's first pass as they decode. Chains that ProcessingChain::Stream
+     * cannot start early (a leading normalize) run after the decode.
+     *
+     * @param bytes The file's contents if already read, or empty to read @p path.
+     * @param result Receives what the chain measured (optional).
+     */
+    [[nodiscard]] std::optional<AudioClip> loadProcessed(const std::string& path, std::span<const uint8_t> bytes,
+                                                         float trimStartSec, float trimEndSec,
+                                                         const ProcessingChain& chain,
+                                                         ProcessingChain::Result* result = nullptr) const;
+
+    /**
+     * @brief Decode @p path into @p sink in order, without keeping a clip where the format allows.
+     *
+     * WAV files stream block by block, so only one block is held at a time;
+     * MP3 files are decoded whole and then handed over.
+     * @return False if the file cannot be decoded.
+     */
+    [[nodiscard]] bool streamFrames(const std::string& path, FrameRanges::Sink& sink) const;
+
+    /** @brief Narrow @p clip to [startSec, endSec); O(1); its levels stay unknown until measured. */
+    void trim(AudioClip& clip, float startSec, float endSec) const;
+
+    /**
+     * @brief Trim leading and trailing silence, keeping the configured pre-/post-roll.
+     *
+     * A clip that is silence throughout is left as it is.
+     * @return True if the clip was trimmed.
+     */
+    bool autoTrim(AudioClip& clip, const DSP::SilenceSettings& settings) const;
+
+    void normalizeToPeak(AudioClip& clip, float targetDbFS) const;
+    void normalizeToRms(AudioClip& clip, float targetDb) const;
+    void compress(AudioClip& clip, float thresholdDb, float ratio, float attackMs, float releaseMs,
+                  float makeupDb) const;
+    void limit(AudioClip& clip, float ceilingDb, float lookaheadMs, float releaseMs) const;
+
+    /**
+     * @brief Run a sequence of operations over a clip in fused block passes.
+     *
+     * Uses the clip's current metrics as the input level when they are valid
+     * and refreshes them from the same pass that writes the result.
+     */
+    ProcessingChain::Result process(AudioClip& clip, const ProcessingChain& chain) const;
+
+    /** @brief Export a clip as a 16-bit WAV file; @p error receives the reason on failure (optional). */
+    [[nodiscard]] bool exportWav(const AudioClip& clip, const std::string& outFolder, int fadeInFrames = 0,
+                                 int fadeOutFrames = 0, std::string* error = nullptr) const;
     
     /**
      * @brief Export an audio clip to MP3 format.
@@ -29,6 +95,7 @@ public:
      * @param metadata ID3 tag metadata.
      * @param fadeInFrames Fade in length in frames (0 = no fade).
      * @param fadeOutFrames Fade out length in frames (0 = no fade).
+     * @param error Receives the reason when the export fails (optional).
      * @return true if export succeeded, false otherwise.
      */
     [[nodiscard]] bool exportMp3(
@@ -37,17 +104,47 @@ public:
         Mp3Encoder::BitrateMode bitrate = Mp3Encoder::BitrateMode::CBR_160,
         const Mp3Metadata& metadata = {},
         int fadeInFrames = 0,
-        int fadeOutFrames = 0
-    );
+        int fadeOutFrames = 0,
+        std::string* error = nullptr
+    ) const;
+
+    /** @brief Like exportWav(), into memory: the complete file for the caller to write. */
+    [[nodiscard]] std::optional<std::vector<uint8_t>> encodeWav(const AudioClip& clip, int fadeInFrames = 0,
+                                                                int fadeOutFrames = 0,
+                                                                std::string* error = nullptr) const;
+
+    /** @brief Like exportMp3(), into memory. */
+    [[nodiscard]] std::optional<std::vector<uint8_t>> encodeMp3(
+        const AudioClip& clip,
+        Mp3Encoder::BitrateMode bitrate = Mp3Encoder::BitrateMode::CBR_160,
+        const Mp3Metadata& metadata = {},
+        int fadeInFrames = 0,
+        int fadeOutFrames = 0,
+        std::string* error = nullptr
+    ) const;
 
-    /** @brief Recalculate peak/RMS metrics for a clip (call after manual sample edits). */
-    void updateClipMetrics(AudioClip& clip);
+    /** @brief Measure a clip's peak/RMS metrics now (call after manual sample edits). */
+    void updateClipMetrics(AudioClip& clip) const;
+
+    /**
+     * @brief Keep clips stored as 16 bits to halve their memory.
+     *
+     * Loaded clips are stored as 16 bits when that is exact (16-bit
+     * sources); processed clips are block-scaled (see CompactSamples).
+     * May change while workers run; each operation reads it once.
+     */
+    void setCompactStorage(bool enabled) noexcept { compactStorage_.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] bool compactStorage() const noexcept { return compactStorage_.load(std::memory_order_relaxed); }
 
 private:
-    void refreshMetrics(AudioClip& clip);
+    /// Pick the codec by extension; empty @p bytes reads @p path.
+    std::optional<AudioClip> decode(const std::string& path, std::span<const uint8_t> bytes,
+                                    FrameRanges::Sink* sink) const;
+    void refreshMetrics(AudioClip& clip) const;
     WavCodec wavCodec_;
     Mp3Codec mp3Codec_;
     Mp3Encoder mp3Encoder_;
+    std::atomic<bool> compactStorage_{false};
 };
 
 
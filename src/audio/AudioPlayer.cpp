@@ -7,6 +7,8 @@
 
 #include "AudioPlayer.h"
 #include "AudioClip.h"
+#include "utils/DSP.h"
+#include "utils/SpeakerLayout.h"
 
 #include <QAudioSink>
 #include <QAudioDevice>
@@ -75,7 +77,7 @@ int AudioPlayer::durationFrames() const {
 // ============================================================================
 
 void AudioPlayer::play() {
-    if (!clip_ || clip_->samples().empty()) return;
+    if (!clip_ || clip_->frameCount() == 0) return;
 
     if (state_ == State::Paused && audioSink_) {
         audioSink_->resume();
@@ -97,6 +99,9 @@ void AudioPlayer::play() {
     bytePos = std::max(qint64(0), bytePos);
     audioBuffer_->seek(bytePos);
 
+    loudnessMeter_.reset(outputSampleRate_, outputChannels_);
+    meteredBytes_ = bytePos;
+
     audioSink_->start(audioBuffer_.get());
     state_ = State::Playing;
     positionTimer_->start();
@@ -155,6 +160,9 @@ void AudioPlayer::seek(int frame) {
         qint64 bytePos = static_cast<qint64>(positionFrame_ - regionStartFrame_) * bytesPerFrame_;
         bytePos = std::max(qint64(0), bytePos);
         audioBuffer_->seek(bytePos);
+
+        // Skip the meter past the jump; keep the running integrated value
+        meteredBytes_ = bytePos;
     }
 
     Q_EMIT positionChanged(positionFrame_);
@@ -227,7 +235,6 @@ void AudioPlayer::setupAudioOutput() {
 void AudioPlayer::prepareBuffer() {
     if (!clip_) return;
 
-    const auto& samples = clip_->samples();
     int srcChannels = clip_->channels();
     int srcRate = clip_->sampleRate();
     size_t frameCount = clip_->frameCount();
@@ -246,6 +253,10 @@ void AudioPlayer::prepareBuffer() {
         return;
     }
 
+    // The played region only; a clip stored as 16 bits expands just that
+    const auto view = clip_->view(startFrame, endFrame - startFrame);
+    const auto samples = view.samples();
+
     // Check if we need to resample
     bool needResample = (outputSampleRate_ != srcRate) || (outputChannels_ != srcChannels);
 
@@ -257,27 +268,11 @@ void AudioPlayer::prepareBuffer() {
         pcmData_.resize(static_cast<int>(sampleCount * sizeof(qint16)));
         qint16* pcmPtr = reinterpret_cast<qint16*>(pcmData_.data());
 
-        size_t startSample = startFrame * srcChannels;
-        for (size_t i = 0; i < sampleCount; ++i) {
-            size_t frameIdx = i / srcChannels;
-            float gain = 1.0f;
-
-            // Apply fade in (S-curve)
-            if (fadeInFrames_ > 0 && frameIdx < static_cast<size_t>(fadeInFrames_)) {
-                float t = static_cast<float>(frameIdx) / fadeInFrames_;
-                gain = t * t * (3.0f - 2.0f * t);  // Smoothstep
-            }
-            // Apply fade out (S-curve)
-            else if (fadeOutFrames_ > 0 && frameIdx >= regionFrames - static_cast<size_t>(fadeOutFrames_)) {
-                size_t fadeOutStart = regionFrames - fadeOutFrames_;
-                float t = static_cast<float>(frameIdx - fadeOutStart) / fadeOutFrames_;
-                gain = 1.0f - (t * t * (3.0f - 2.0f * t));  // Inverted smoothstep
-            }
-
-            float val = samples[startSample + i] * gain;
-            val = std::clamp(val, -1.0f, 1.0f);
-            pcmPtr[i] = static_cast<qint16>(val * 32767.0f);
-        }
+        // S-curve fades, the same envelope export applies
+        const DSP::FadeEnvelope fades{static_cast<size_t>(std::max(0, fadeInFrames_)),
+                                      static_cast<size_t>(std::max(0, fadeOutFrames_)),
+                                      DSP::FadeType::SCurve};
+        DSP::convertToInt16(samples.data(), pcmPtr, regionFrames, srcChannels, fades);
     } else {
         // Need resampling - use simple linear interpolation
         size_t srcFrames = endFrame - startFrame;
@@ -288,20 +283,29 @@ void AudioPlayer::prepareBuffer() {
         pcmData_.resize(static_cast<int>(outSamples * sizeof(qint16)));
         qint16* pcmPtr = reinterpret_cast<qint16*>(pcmData_.data());
 
+        // Mix to the device's channel count first (e.g. 5.1 folded to stereo
+        // rather than playing only its front pair)
+        std::vector<std::vector<float>> mixed;
+        if (outputChannels_ != srcChannels) {
+            const auto matrix = SpeakerLayout::mixMatrix(srcChannels, outputChannels_);
+            mixed.assign(static_cast<size_t>(outputChannels_), std::vector<float>(srcFrames));
+            std::vector<float*> planes;
+            for (auto& plane : mixed) planes.push_back(plane.data());
+            DSP::mixChannels(samples.data(), srcFrames, srcChannels, matrix.data(), outputChannels_, planes.data());
+        }
+        auto sampleAt = [&](size_t frame, int ch) {
+            if (frame >= srcFrames) return 0.0f;
+            return mixed.empty() ? samples[frame * srcChannels + ch] : mixed[static_cast<size_t>(ch)][frame];
+        };
+
         for (size_t outFrame = 0; outFrame < outFrames; ++outFrame) {
             double srcPos = outFrame / ratio;
-            size_t srcFrame = startFrame + static_cast<size_t>(srcPos);
+            size_t srcFrame = static_cast<size_t>(srcPos);     // Within the region view
             double frac = srcPos - std::floor(srcPos);
 
             for (int ch = 0; ch < outputChannels_; ++ch) {
-                int srcCh = (ch < srcChannels) ? ch : 0;  // Map channels
-
-                float val1 = 0.0f, val2 = 0.0f;
-                size_t idx1 = srcFrame * srcChannels + srcCh;
-                size_t idx2 = (srcFrame + 1) * srcChannels + srcCh;
-
-                if (idx1 < samples.size()) val1 = samples[idx1];
-                if (idx2 < samples.size()) val2 = samples[idx2];
+                const float val1 = sampleAt(srcFrame, ch);
+                const float val2 = sampleAt(srcFrame + 1, ch);
 
                 // Linear interpolation
                 float val = static_cast<float>(val1 * (1.0 - frac) + val2 * frac);
@@ -378,35 +382,64 @@ void AudioPlayer::updatePosition() {
     Q_EMIT positionChanged(positionFrame_);
 
     calculateLevels();
+    updateLoudness();
+}
+
+void AudioPlayer::updateLoudness() {
+    if (!audioBuffer_ || bytesPerFrame_ <= 0) return;
+
+    // Meter whole frames the sink has consumed since the last update
+    const qint64 readPos = audioBuffer_->pos();
+    if (readPos < meteredBytes_) {
+        meteredBytes_ = readPos;
+    }
+    const qint64 available = std::min(readPos, static_cast<qint64>(pcmData_.size())) - meteredBytes_;
+    const size_t frames = static_cast<size_t>(std::max(qint64(0), available) / bytesPerFrame_);
+    if (frames == 0) return;
+
+    const size_t sampleCount = frames * static_cast<size_t>(outputChannels_);
+    meterScratch_.resize(sampleCount);
+    const qint16* pcmPtr = reinterpret_cast<const qint16*>(pcmData_.constData() + meteredBytes_);
+    for (size_t i = 0; i < sampleCount; ++i) {
+        meterScratch_[i] = static_cast<float>(pcmPtr[i]) / 32767.0f;
+    }
+
+    loudnessMeter_.process(meterScratch_.data(), frames);
+    meteredBytes_ += static_cast<qint64>(frames) * bytesPerFrame_;
+
+    Q_EMIT loudnessChanged(loudnessMeter_.momentaryLufs(),
+                           loudnessMeter_.shortTermLufs(),
+                           loudnessMeter_.integratedLufs());
 }
 
 void AudioPlayer::calculateLevels() {
     if (!clip_) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged({});
         return;
     }
 
-    const auto& samples = clip_->samples();
-    if (samples.empty()) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+    if (clip_->frameCount() == 0) {
+        Q_EMIT levelsChanged({});
         return;
     }
 
     const int channels = clip_->channels();
     if (channels <= 0) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged({});
         return;
     }
 
     const int sampleRate = clip_->sampleRate();
     if (sampleRate <= 0) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged({});
         return;
     }
 
+    QVector<float> peaks(channels, 0.0f);
+
     const int maxFrame = static_cast<int>(clip_->frameCount());
     if (maxFrame <= 0) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged(peaks);
         return;
     }
 
@@ -419,7 +452,7 @@ void AudioPlayer::calculateLevels() {
         : maxFrame;
 
     if (positionFrame_ < regionStartFrame_ || positionFrame_ > effectiveEnd) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged(peaks);
         return;
     }
 
@@ -429,37 +462,23 @@ void AudioPlayer::calculateLevels() {
     startFrame = std::max(regionStartFrame_, startFrame);
     endFrame = std::min(effectiveEnd, endFrame);
     if (endFrame <= startFrame) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
-        return;
-    }
-
-    const size_t startSample = static_cast<size_t>(startFrame) * static_cast<size_t>(channels);
-    const size_t endSample = static_cast<size_t>(endFrame) * static_cast<size_t>(channels);
-    if (startSample >= samples.size()) {
-        Q_EMIT levelsChanged(0.0f, 0.0f);
+        Q_EMIT levelsChanged(peaks);
         return;
     }
 
-    float leftPeak = 0.0f;
-    float rightPeak = 0.0f;
-
-    for (size_t i = startSample; i + static_cast<size_t>(channels) <= samples.size() && i < endSample;
-         i += static_cast<size_t>(channels)) {
-        const float sL = std::fabs(samples[i]);
-        leftPeak = std::max(leftPeak, sL);
+    const size_t stride = static_cast<size_t>(channels);
+    const auto window = clip_->view(static_cast<size_t>(startFrame), static_cast<size_t>(endFrame - startFrame));
+    const auto samples = window.samples();
 
-        if (channels > 1) {
-            const float sR = std::fabs(samples[i + 1]);
-            rightPeak = std::max(rightPeak, sR);
+    for (size_t i = 0; i + stride <= samples.size(); i += stride) {
+        for (int ch = 0; ch < channels; ++ch) {
+            peaks[ch] = std::max(peaks[ch], std::fabs(samples[i + static_cast<size_t>(ch)]));
         }
     }
 
-    if (channels == 1) {
-        rightPeak = leftPeak;
+    for (float& peak : peaks) {
+        peak = std::clamp(peak, 0.0f, 1.0f);
     }
 
-    leftPeak = std::clamp(leftPeak, 0.0f, 1.0f);
-    rightPeak = std::clamp(rightPeak, 0.0f, 1.0f);
-
-    Q_EMIT levelsChanged(leftPeak, rightPeak);
+    Q_EMIT levelsChanged(peaks);
 }
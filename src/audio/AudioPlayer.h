@@ -11,7 +11,11 @@
 #include <QObject>
 #include <QAudioFormat>
 #include <QBuffer>
+#include <QVector>
 #include <memory>
+#include <vector>
+
+#include "utils/LoudnessMeter.h"
 
 class QAudioSink;
 class AudioClip;
@@ -21,7 +25,8 @@ class AudioClip;
  * @brief Plays AudioClip data through the default audio output.
  *
  * Uses Qt 6 QAudioSink to stream float samples converted to 16-bit PCM.
- * Emits position updates for playhead synchronization.
+ * Emits position updates for playhead synchronization, per-channel peak
+ * levels and incremental loudness of the rendered output.
  */
 class AudioPlayer : public QObject {
     Q_OBJECT
@@ -70,6 +75,11 @@ public:
      */
     int durationFrames() const;
 
+    /**
+     * @brief Bytes of the prepared playback buffer.
+     */
+    size_t bufferBytes() const { return static_cast<size_t>(pcmData_.capacity()); }
+
 public Q_SLOTS:
     /**
      * @brief Start playback from current position.
@@ -131,10 +141,17 @@ Q_SIGNALS:
 
     /**
      * @brief Emitted periodically during playback with current audio levels.
-     * @param left Left channel level (0.0 - 1.0 linear).
-     * @param right Right channel level (0.0 - 1.0 linear).
+     * @param peaks Per-channel peak level (0.0 - 1.0 linear), one entry per clip channel.
      */
-    void levelsChanged(float left, float right);
+    void levelsChanged(const QVector<float>& peaks);
+
+    /**
+     * @brief Emitted periodically during playback with loudness of the rendered output.
+     * @param momentaryLufs Momentary loudness (400 ms), -inf until available.
+     * @param shortTermLufs Short-term loudness (3 s), -inf until available.
+     * @param integratedLufs Gated integrated loudness since playback started.
+     */
+    void loudnessChanged(float momentaryLufs, float shortTermLufs, float integratedLufs);
 
 private Q_SLOTS:
     void onAudioStateChanged(int state);
@@ -145,6 +162,7 @@ private:
     void prepareBuffer();
     void cleanupAudioOutput();
     void calculateLevels();
+    void updateLoudness();
 
     AudioClip* clip_ = nullptr;
     State state_ = State::Stopped;
@@ -172,5 +190,10 @@ private:
     // Fade envelope (non-destructive)
     int fadeInFrames_ = 0;
     int fadeOutFrames_ = 0;
+
+    // Loudness of the rendered PCM, fed up to the sink's read position
+    LoudnessMeter loudnessMeter_;
+    qint64 meteredBytes_ = 0;
+    std::vector<float> meterScratch_;
 };
 
@@ -0,0 +1,113 @@
+/**
+ * @file CompactSamples.cpp
+ * @brief 16-bit block quantization and expansion.
+ */
+
+#include "CompactSamples.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "audio/Formats/PcmConvert.h"
+
+namespace {
+
+/// True if every sample is k / 32768 for some 16-bit k; scaling by a power of two is exact.
+bool isExactInt16(const float* samples, size_t count) {
+    // Branch-free so the loop vectorizes. Out-of-range values (NaN included,
+    // by the argument order) are clamped before the integer conversion and
+    // then fail the comparison
+    bool exact = true;
+    for (size_t i = 0; i < count; ++i) {
+        const float scaled = samples[i] * 32768.0f;
+        const float clamped = std::min(32767.0f, std::max(-32768.0f, scaled));
+        exact &= static_cast<float>(static_cast<int32_t>(clamped)) == scaled;
+    }
+    return exact;
+}
+
+} // namespace
+
+std::optional<CompactSamples> CompactSamples::encode(const float* samples, size_t frames, int channels,
+                                                     bool allowBlockScaled) {
+    if (channels <= 0) return std::nullopt;
+    const auto ch = static_cast<size_t>(channels);
+
+    CompactSamples result;
+    result.channels_ = channels;
+    result.frames_ = frames;
+    result.pcm_.resize(frames * ch);
+    result.gains_.reserve((frames + kBlockFrames - 1) / kBlockFrames);
+
+    std::vector<float> scaled;
+    for (size_t first = 0; first < frames; first += kBlockFrames) {
+        const size_t count = std::min(kBlockFrames, frames - first) * ch;
+        const float* in = samples + first * ch;
+        int16_t* out = result.pcm_.data() + first * ch;
+
+        if (isExactInt16(in, count)) {
+            for (size_t i = 0; i < count; ++i) out[i] = static_cast<int16_t>(in[i] * 32768.0f);
+            result.gains_.push_back(1.0f);
+            continue;
+        }
+        if (!allowBlockScaled) return std::nullopt;
+
+        // Quantize relative to the block peak; NaN and infinities clamp like a WAV write
+        float peak = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            if (std::isfinite(in[i])) peak = std::max(peak, std::fabs(in[i]));
+        }
+        if (peak == 0.0f) peak = 1.0f;
+        scaled.resize(count);
+        const float toUnit = 1.0f / peak;
+        for (size_t i = 0; i < count; ++i) scaled[i] = in[i] * toUnit;
+        PcmConvert::floatToInt16(scaled.data(), out, count);
+        result.gains_.push_back(peak * (32768.0f / 32767.0f));
+        result.exact_ = false;
+    }
+    return result;
+}
+
+size_t CompactSamples::bytes() const noexcept {
+    return pcm_.capacity() * sizeof(int16_t) + gains_.capacity() * sizeof(float);
+}
+
+void CompactSamples::decode(size_t firstFrame, size_t frames, float* out) const {
+    const auto ch = static_cast<size_t>(channels_);
+    frames = std::min(frames, frames_ - std::min(firstFrame, frames_));
+    const size_t end = firstFrame + frames;
+
+    for (size_t frame = firstFrame; frame < end;) {
+        const size_t block = frame / kBlockFrames;
+        const size_t blockEnd = std::min(end, (block + 1) * kBlockFrames);
+        const size_t count = (blockEnd - frame) * ch;
+        PcmConvert::int16ToFloat(pcm_.data() + frame * ch, out, count);
+
+        const float gain = gains_[block];
+        if (gain != 1.0f) {
+            for (size_t i = 0; i < count; ++i) out[i] *= gain;
+        }
+        out += count;
+        frame = blockEnd;
+    }
+}
+
+CompactSamples CompactSamples::slice(size_t firstFrame, size_t frames) const {
+    firstFrame = std::min(firstFrame, frames_);
+    frames = std::min(frames, frames_ - firstFrame);
+    const size_t firstBlock = firstFrame / kBlockFrames;
+    const size_t start = firstBlock * kBlockFrames;
+    const size_t end = firstFrame + frames;
+    const size_t lastBlock = (end + kBlockFrames - 1) / kBlockFrames;
+    const auto ch = static_cast<size_t>(channels_);
+
+    CompactSamples result;
+    result.channels_ = channels_;
+    result.frames_ = end - start;
+    result.pcm_.assign(pcm_.begin() + static_cast<std::ptrdiff_t>(start * ch),
+                       pcm_.begin() + static_cast<std::ptrdiff_t>(end * ch));
+    result.gains_.assign(gains_.begin() + static_cast<std::ptrdiff_t>(firstBlock),
+                         gains_.begin() + static_cast<std::ptrdiff_t>(lastBlock));
+    result.exact_ = std::all_of(result.gains_.begin(), result.gains_.end(), [](float g) { return g == 1.0f; });
+    return result;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file CompactSamples.h
+ * @brief Interleaved samples stored as 16-bit integers with a gain per block.
+ *
+ * Nearly all sources are 16-bit PCM, so their float samples are exactly
+ * k / 32768 and fit in an int16_t without loss. Blocks that are not (the
+ * output of processing, float or 24-bit sources) can optionally be
+ * block-scaled: each block of kBlockFrames frames is quantized to 16 bits
+ * relative to its own peak, which puts the error about 90 dB below the
+ * block's loudest sample.
+ *
+ * Either way the storage is half of the float samples, and decode() expands
+ * any range back to float with the SSE2 int16 kernel plus, for scaled
+ * blocks, one multiply.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @class CompactSamples
+ * @brief Immutable 16-bit copy of an interleaved float signal.
+ */
+class CompactSamples final {
+public:
+    static constexpr size_t kBlockFrames = 1024;
+
+    /**
+     * @brief Quantize @p frames frames of @p channels interleaved samples.
+     * @param allowBlockScaled Scale blocks that are not exact 16-bit values
+     *        instead of failing.
+     * @return nullopt if a block is not exact and @p allowBlockScaled is false.
+     */
+    [[nodiscard]] static std::optional<CompactSamples> encode(const float* samples, size_t frames, int channels,
+                                                              bool allowBlockScaled);
+
+    [[nodiscard]] size_t frames() const noexcept { return frames_; }
+    [[nodiscard]] int channels() const noexcept { return channels_; }
+
+    /** @brief True if every block decodes to exactly the samples it was encoded from. */
+    [[nodiscard]] bool isExact() const noexcept { return exact_; }
+
+    /** @brief Heap bytes held by the samples and block gains. */
+    [[nodiscard]] size_t bytes() const noexcept;
+
+    /** @brief Expand frames [firstFrame, firstFrame + frames) into @p out. */
+    void decode(size_t firstFrame, size_t frames, float* out) const;
+
+    /**
+     * @brief Copy of the blocks that hold frames [firstFrame, firstFrame + frames).
+     *
+     * The copy starts at the block boundary before @p firstFrame, so its
+     * samples are not quantized again; that frame is at index
+     * firstFrame % kBlockFrames of the result.
+     */
+    [[nodiscard]] CompactSamples slice(size_t firstFrame, size_t frames) const;
+
+private:
+    CompactSamples() = default;
+
+    int channels_{0};
+    size_t frames_{0};
+    bool exact_{true};
+    std::vector<int16_t> pcm_;
+    std::vector<float> gains_;      ///< Per block; 1 for exact blocks, peak * 32768 / 32767 otherwise
+};
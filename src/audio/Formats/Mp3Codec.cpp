@@ -4,20 +4,40 @@
  */
 
 #include "Mp3Codec.h"
+#include "utils/BufferPool.h"
+#include "utils/StartupProfile.h"
+#include "utils/Trace.h"
 #include <mpg123.h>
 #include <vector>
 #include <memory>
 
-Mp3Codec::Mp3Codec() {
-    initialized_ = mpg123_init() == MPG123_OK;
+namespace {
+
+/// Initialize the library on first use rather than when the engine is
+/// created, so startup (and WAV-only sessions) never pay for it. A
+/// function-local static is thread-safe: the engine is shared by workers.
+bool libraryReady() {
+    static const bool ready = [] {
+        WOOSH_STARTUP_PHASE("mpg123_init");
+        return mpg123_init() == MPG123_OK;
+    }();
+    return ready;
 }
 
-Mp3Codec::~Mp3Codec() {
-    if (initialized_) mpg123_exit();
+} // namespace
+
+std::optional<AudioClip> Mp3Codec::read(const std::string& path) const {
+    WOOSH_TRACE_SCOPE_DETAIL("Mp3Codec::read", path);
+    return decode(path, {});
+}
+
+std::optional<AudioClip> Mp3Codec::read(const std::string& path, std::span<const uint8_t> bytes) const {
+    WOOSH_TRACE_SCOPE_DETAIL("Mp3Codec::read", path);
+    return decode(path, bytes);
 }
 
-std::optional<AudioClip> Mp3Codec::read(const std::string& path) {
-    if (!initialized_) return std::nullopt;
+std::optional<AudioClip> Mp3Codec::decode(const std::string& path, std::optional<std::span<const uint8_t>> bytes) const {
+    if (!libraryReady()) return std::nullopt;
 
     int err = MPG123_OK;
     mpg123_handle* mh = mpg123_new(nullptr, &err);
@@ -28,13 +48,22 @@ std::optional<AudioClip> Mp3Codec::read(const std::string& path) {
     // Set output format to float BEFORE opening
     mpg123_param(handle.get(), MPG123_FLAGS, MPG123_FORCE_FLOAT | MPG123_GAPLESS, 0);
 
-    // Open the file
-    if (mpg123_open(handle.get(), path.c_str()) != MPG123_OK) {
-        return std::nullopt;
-    }
+    if (bytes) {
+        // Feed the whole file at once; feeds cannot seek, so there is no scan
+        // and the end of the data shows up as MPG123_NEED_MORE
+        if (mpg123_open_feed(handle.get()) != MPG123_OK
+            || mpg123_feed(handle.get(), bytes->data(), bytes->size()) != MPG123_OK) {
+            return std::nullopt;
+        }
+    } else {
+        // Open the file
+        if (mpg123_open(handle.get(), path.c_str()) != MPG123_OK) {
+            return std::nullopt;
+        }
 
-    // Scan the file to get accurate length
-    mpg123_scan(handle.get());
+        // Scan the file to get accurate length
+        mpg123_scan(handle.get());
+    }
 
     // Get the format
     long rate = 0;
@@ -56,9 +85,9 @@ std::optional<AudioClip> Mp3Codec::read(const std::string& path) {
         samples.reserve(static_cast<size_t>(totalSamples * channels));
     }
 
-    // Read all samples
+    // Read all samples (decode chunk is reused across files by the worker's pool)
     const size_t bufferSize = 16384;
-    std::vector<unsigned char> buffer(bufferSize);
+    auto buffer = BufferPool::local().acquire<unsigned char>(bufferSize);
     size_t done = 0;
 
     while ((err = mpg123_read(handle.get(), buffer.data(), bufferSize, &done)) == MPG123_OK || err == MPG123_NEW_FORMAT) {
@@ -75,7 +104,8 @@ std::optional<AudioClip> Mp3Codec::read(const std::string& path) {
     }
 
     // Handle end of file
-    if (err != MPG123_DONE && err != MPG123_OK) {
+    const bool finished = err == MPG123_DONE || err == MPG123_OK || (bytes && err == MPG123_NEED_MORE);
+    if (!finished) {
         // Read what we could, might still be usable
         if (samples.empty()) {
             return std::nullopt;
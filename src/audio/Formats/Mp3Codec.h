@@ -1,18 +1,26 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include "audio/AudioClip.h"
 
+/**
+ * @brief MP3 decoder (mpg123).
+ *
+ * Stateless and thread-safe: every call decodes with its own mpg123 handle;
+ * the library itself is initialized once per process, on first use.
+ */
 class Mp3Codec final {
 public:
-    Mp3Codec();
-    ~Mp3Codec();
+    [[nodiscard]] std::optional<AudioClip> read(const std::string& path) const;
 
-    [[nodiscard]] std::optional<AudioClip> read(const std::string& path);
+    /** @brief Decode an MP3 file already in memory (e.g. prefetched); @p path only names the clip. */
+    [[nodiscard]] std::optional<AudioClip> read(const std::string& path, std::span<const uint8_t> bytes) const;
 
 private:
-    bool initialized_{false};
+    std::optional<AudioClip> decode(const std::string& path, std::optional<std::span<const uint8_t>> bytes) const;
 };
 
 
@@ -4,38 +4,205 @@
  */
 
 #include "Mp3Encoder.h"
+#include "utils/BufferPool.h"
+#include "utils/SpeakerLayout.h"
+#include "utils/StartupProfile.h"
+#include "utils/Trace.h"
 #include <lame/lame.h>
+#include <algorithm>
 #include <fstream>
-#include <vector>
 #include <cstring>
 #include <filesystem>
+#include <utility>
+
+namespace {
+
+/// Streams encoded frames to a file.
+class FileOutput final : public Mp3Encoder::Output {
+public:
+    explicit FileOutput(std::ofstream& file) : file_(file) {}
+
+    bool append(const unsigned char* data, size_t size) override {
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return file_.good();
+    }
+
+    void patchStart(const unsigned char* data, size_t size) override {
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+    bool finish() override {
+        file_.close();
+        return !file_.fail();
+    }
+
+private:
+    std::ofstream& file_;
+};
+
+/// Collects encoded frames in memory.
+class MemoryOutput final : public Mp3Encoder::Output {
+public:
+    explicit MemoryOutput(std::vector<uint8_t>& out) : out_(out) {}
+
+    bool append(const unsigned char* data, size_t size) override {
+        out_.insert(out_.end(), data, data + size);
+        return true;
+    }
+
+    void patchStart(const unsigned char* data, size_t size) override {
+        std::copy(data, data + std::min(size, out_.size()), out_.begin());
+    }
+
+    bool finish() override { return true; }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+/// Report @p message through the caller's error string, if any; always false.
+bool fail(std::string* error, std::string message) {
+    if (error) *error = std::move(message);
+    return false;
+}
+
+/// LAME builds shared lookup tables the first time a context is initialized,
+/// which is not safe to race. Set one up once per process, on first use, so
+/// concurrent encodes only ever see the tables ready. A function-local static
+/// is thread-safe.
+bool libraryReady() {
+    static const bool ready = [] {
+        WOOSH_STARTUP_PHASE("LAME init");
+        lame_global_flags* gfp = lame_init();
+        if (!gfp) return false;
+        lame_set_in_samplerate(gfp, 44100);
+        lame_set_num_channels(gfp, 2);
+        const bool ok = lame_init_params(gfp) >= 0;
+        lame_close(gfp);
+        return ok;
+    }();
+    return ready;
+}
+
+} // namespace
 
 bool Mp3Encoder::encode(
     const AudioClip& clip,
     const std::string& outputPath,
     BitrateMode bitrate,
-    const Mp3Metadata& metadata
-) {
-    lastError_.clear();
+    const Mp3Metadata& metadata,
+    const DSP::FadeEnvelope& fades,
+    std::string* error
+) const {
+    // Title defaults to the source file name, not the output name
+    Mp3Metadata tags = metadata;
+    if (tags.title.empty()) {
+        tags.title = std::filesystem::path(clip.filePath()).stem().string();
+    }
+    const auto view = clip.view();
+    return encode(view.data(), clip.frameCount(), clip.channels(), clip.sampleRate(), outputPath, bitrate, tags, fades,
+                  error);
+}
+
+bool Mp3Encoder::encode(
+    const float* samples,
+    size_t frames,
+    int channels,
+    int sampleRate,
+    const std::string& outputPath,
+    BitrateMode bitrate,
+    const Mp3Metadata& metadata,
+    const DSP::FadeEnvelope& fades,
+    std::string* error
+) const {
+    WOOSH_TRACE_SCOPE_DETAIL("Mp3Encoder::encode", outputPath);
+
+    if (frames == 0 || channels <= 0) {
+        return fail(error, "Cannot encode empty audio clip");
+    }
 
-    if (clip.samples().empty()) {
-        lastError_ = "Cannot encode empty audio clip";
-        return false;
+    // Get title from metadata or filename
+    Mp3Metadata tags = metadata;
+    if (tags.title.empty()) {
+        tags.title = std::filesystem::path(outputPath).stem().string();
     }
 
-    // Initialize LAME
+    // Open output file
+    std::ofstream outFile(outputPath, std::ios::binary);
+    if (!outFile.is_open()) {
+        return fail(error, "Failed to open output file: " + outputPath);
+    }
+    FileOutput output(outFile);
+    return encodeTo(samples, frames, channels, sampleRate, bitrate, tags, fades, output, error);
+}
+
+bool Mp3Encoder::encodeToMemory(
+    const AudioClip& clip,
+    std::vector<uint8_t>& out,
+    BitrateMode bitrate,
+    const Mp3Metadata& metadata,
+    const DSP::FadeEnvelope& fades,
+    std::string* error
+) const {
+    // Title defaults to the source file name, as in encode()
+    Mp3Metadata tags = metadata;
+    if (tags.title.empty()) {
+        tags.title = std::filesystem::path(clip.filePath()).stem().string();
+    }
+    const auto view = clip.view();
+    return encodeToMemory(view.data(), clip.frameCount(), clip.channels(), clip.sampleRate(), out, bitrate, tags,
+                          fades, error);
+}
+
+bool Mp3Encoder::encodeToMemory(
+    const float* samples,
+    size_t frames,
+    int channels,
+    int sampleRate,
+    std::vector<uint8_t>& out,
+    BitrateMode bitrate,
+    const Mp3Metadata& metadata,
+    const DSP::FadeEnvelope& fades,
+    std::string* error
+) const {
+    WOOSH_TRACE_SCOPE("Mp3Encoder::encodeToMemory");
+    out.clear();
+
+    if (frames == 0 || channels <= 0) {
+        return fail(error, "Cannot encode empty audio clip");
+    }
+    MemoryOutput output(out);
+    return encodeTo(samples, frames, channels, sampleRate, bitrate, metadata, fades, output, error);
+}
+
+bool Mp3Encoder::encodeTo(
+    const float* samples,
+    size_t frames,
+    int channels,
+    int sampleRate,
+    BitrateMode bitrate,
+    const Mp3Metadata& metadata,
+    const DSP::FadeEnvelope& fades,
+    Output& output,
+    std::string* error
+) const {
+    // Initialize LAME; each call owns its context, so encodes may run concurrently
+    if (!libraryReady()) {
+        return fail(error, "Failed to initialize LAME encoder");
+    }
     lame_global_flags* gfp = lame_init();
     if (!gfp) {
-        lastError_ = "Failed to initialize LAME encoder";
-        return false;
+        return fail(error, "Failed to initialize LAME encoder");
     }
 
     // Configure encoder
-    lame_set_in_samplerate(gfp, clip.sampleRate());
-    lame_set_num_channels(gfp, clip.channels());
+    lame_set_in_samplerate(gfp, sampleRate);
+    // MP3 carries at most two channels; surround layouts are downmixed below
+    lame_set_num_channels(gfp, channels == 1 ? 1 : 2);
     
     // Output settings - always stereo output for compatibility
-    if (clip.channels() == 1) {
+    if (channels == 1) {
         lame_set_mode(gfp, MONO);
     } else {
         lame_set_mode(gfp, JOINT_STEREO);
@@ -64,13 +231,7 @@ bool Mp3Encoder::encode(
     id3tag_v2_only(gfp);  // Only write ID3v2, not v1
     lame_set_write_id3tag_automatic(gfp, 1);
     
-    // Get title from metadata or filename
-    std::string title = metadata.title;
-    if (title.empty()) {
-        std::filesystem::path p(clip.filePath());
-        title = p.stem().string();
-    }
-    id3tag_set_title(gfp, title.c_str());
+    id3tag_set_title(gfp, metadata.title.c_str());
     
     if (!metadata.artist.empty()) {
         id3tag_set_artist(gfp, metadata.artist.c_str());
@@ -87,40 +248,39 @@ bool Mp3Encoder::encode(
 
     // Initialize encoder with settings
     if (lame_init_params(gfp) < 0) {
-        lastError_ = "Failed to initialize LAME parameters";
-        lame_close(gfp);
-        return false;
-    }
-
-    // Open output file
-    std::ofstream outFile(outputPath, std::ios::binary);
-    if (!outFile.is_open()) {
-        lastError_ = "Failed to open output file: " + outputPath;
         lame_close(gfp);
-        return false;
+        return fail(error, "Failed to initialize LAME parameters");
     }
 
     // Prepare for encoding
-    const std::vector<float>& samples = clip.samples();
-    const int channels = clip.channels();
-    const size_t totalFrames = samples.size() / channels;
+    const size_t totalFrames = frames;
     
-    // Buffer for encoded MP3 data (worst case: 1.25 * samples + 7200)
+    // Buffer for encoded MP3 data (worst case: 1.25 * samples + 7200),
+    // leased from the worker's pool so batches reuse it across files
     const size_t mp3BufferSize = static_cast<size_t>(1.25 * 8192 + 7200);
-    std::vector<unsigned char> mp3Buffer(mp3BufferSize);
+    auto mp3Buffer = BufferPool::local().acquire<unsigned char>(mp3BufferSize);
 
     // Process in chunks
     const size_t chunkFrames = 8192;
     size_t framesProcessed = 0;
 
     if (channels == 1) {
-        // Mono encoding
+        // Mono encoding; chunks inside a fade are copied to scratch for the envelope
+        BufferPool::Lease<float> faded;
+        if (fades.isActive()) faded = BufferPool::local().acquire<float>(chunkFrames);
+
         while (framesProcessed < totalFrames) {
             size_t framesToProcess = std::min(chunkFrames, totalFrames - framesProcessed);
+            const float* chunk = samples + framesProcessed;
+            if (fades.touches(framesProcessed, framesToProcess, totalFrames)) {
+                std::copy(chunk, chunk + framesToProcess, faded.data());
+                DSP::applyFadeEnvelope(faded.data(), framesToProcess, 1, framesProcessed, totalFrames, fades);
+                chunk = faded.data();
+            }
             
             int bytesEncoded = lame_encode_buffer_ieee_float(
                 gfp,
-                samples.data() + framesProcessed,
+                chunk,
                 nullptr,  // No right channel for mono
                 static_cast<int>(framesToProcess),
                 mp3Buffer.data(),
@@ -128,30 +288,41 @@ bool Mp3Encoder::encode(
             );
 
             if (bytesEncoded < 0) {
-                lastError_ = "LAME encoding error: " + std::to_string(bytesEncoded);
                 lame_close(gfp);
-                return false;
+                return fail(error, "LAME encoding error: " + std::to_string(bytesEncoded));
             }
 
-            if (bytesEncoded > 0) {
-                outFile.write(reinterpret_cast<char*>(mp3Buffer.data()), bytesEncoded);
+            if (bytesEncoded > 0 && !output.append(mp3Buffer.data(), static_cast<size_t>(bytesEncoded))) {
+                lame_close(gfp);
+                return fail(error, "Failed to write encoded MP3 data");
             }
 
             framesProcessed += framesToProcess;
         }
     } else {
-        // Stereo encoding - need to deinterleave
-        std::vector<float> leftChannel(chunkFrames);
-        std::vector<float> rightChannel(chunkFrames);
+        // Stereo encoding - need to deinterleave, or downmix more channels to stereo
+        auto leftChannel = BufferPool::local().acquire<float>(chunkFrames);
+        auto rightChannel = BufferPool::local().acquire<float>(chunkFrames);
+        const std::vector<float> downmix = channels > 2 ? SpeakerLayout::mixMatrix(channels, 2) : std::vector<float>{};
+        float* const planes[] = {leftChannel.data(), rightChannel.data()};
+        const auto ch = static_cast<size_t>(channels);
 
         while (framesProcessed < totalFrames) {
             size_t framesToProcess = std::min(chunkFrames, totalFrames - framesProcessed);
             
-            // Deinterleave stereo samples
-            for (size_t i = 0; i < framesToProcess; ++i) {
-                size_t srcIdx = (framesProcessed + i) * 2;
-                leftChannel[i] = samples[srcIdx];
-                rightChannel[i] = samples[srcIdx + 1];
+            if (channels == 2) {
+                // Deinterleave stereo samples
+                for (size_t i = 0; i < framesToProcess; ++i) {
+                    size_t srcIdx = (framesProcessed + i) * 2;
+                    leftChannel[i] = samples[srcIdx];
+                    rightChannel[i] = samples[srcIdx + 1];
+                }
+            } else {
+                DSP::mixChannels(samples + framesProcessed * ch, framesToProcess, channels, downmix.data(), 2, planes);
+            }
+            if (fades.touches(framesProcessed, framesToProcess, totalFrames)) {
+                DSP::applyFadeEnvelope(leftChannel.data(), framesToProcess, 1, framesProcessed, totalFrames, fades);
+                DSP::applyFadeEnvelope(rightChannel.data(), framesToProcess, 1, framesProcessed, totalFrames, fades);
             }
 
             int bytesEncoded = lame_encode_buffer_ieee_float(
@@ -164,13 +335,13 @@ bool Mp3Encoder::encode(
             );
 
             if (bytesEncoded < 0) {
-                lastError_ = "LAME encoding error: " + std::to_string(bytesEncoded);
                 lame_close(gfp);
-                return false;
+                return fail(error, "LAME encoding error: " + std::to_string(bytesEncoded));
             }
 
-            if (bytesEncoded > 0) {
-                outFile.write(reinterpret_cast<char*>(mp3Buffer.data()), bytesEncoded);
+            if (bytesEncoded > 0 && !output.append(mp3Buffer.data(), static_cast<size_t>(bytesEncoded))) {
+                lame_close(gfp);
+                return fail(error, "Failed to write encoded MP3 data");
             }
 
             framesProcessed += framesToProcess;
@@ -178,21 +349,22 @@ bool Mp3Encoder::encode(
     }
 
     // Flush remaining data
+    WOOSH_TRACE_SCOPE("Mp3Encoder::finalize");
     int finalBytes = lame_encode_flush(gfp, mp3Buffer.data(), static_cast<int>(mp3BufferSize));
     if (finalBytes > 0) {
-        outFile.write(reinterpret_cast<char*>(mp3Buffer.data()), finalBytes);
+        output.append(mp3Buffer.data(), static_cast<size_t>(finalBytes));
     }
 
     // Write LAME/INFO tag (for accurate seeking)
     size_t lameTagSize = lame_get_lametag_frame(gfp, mp3Buffer.data(), mp3BufferSize);
     if (lameTagSize > 0) {
-        // Seek to beginning and write the tag
-        outFile.seekp(0);
-        outFile.write(reinterpret_cast<char*>(mp3Buffer.data()), lameTagSize);
+        // Overwrite the placeholder frame at the beginning
+        output.patchStart(mp3Buffer.data(), lameTagSize);
     }
 
-    outFile.close();
     lame_close(gfp);
-
+    if (!output.finish()) {
+        return fail(error, "Failed to write encoded MP3 data");
+    }
     return true;
 }
@@ -5,8 +5,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include "audio/AudioClip.h"
+#include "utils/DSP.h"
 
 /**
  * @brief ID3 tag metadata for MP3 files.
@@ -23,7 +27,12 @@ struct Mp3Metadata {
  * @brief MP3 encoder using LAME library.
  * 
  * Supports encoding AudioClip data to MP3 format with configurable
- * bitrate and ID3v2 metadata tags.
+ * bitrate and ID3v2 metadata tags. Clips with more than two channels are
+ * downmixed to stereo (see SpeakerLayout::mixMatrix).
+ *
+ * Stateless and thread-safe: every call encodes with its own LAME context
+ * and reports failures through the caller's error string, so one encoder
+ * can serve all batch workers at once.
  */
 class Mp3Encoder final {
 public:
@@ -47,20 +56,79 @@ public:
      * @param outputPath Full path for the output MP3 file.
      * @param bitrate The bitrate mode to use.
      * @param metadata Optional ID3 tag metadata.
+     * @param fades Fade envelope applied to each chunk as it is fed to the encoder.
+     * @param error Receives the reason when encoding fails (optional).
      * @return true if encoding succeeded, false otherwise.
      */
     [[nodiscard]] bool encode(
         const AudioClip& clip,
         const std::string& outputPath,
         BitrateMode bitrate = BitrateMode::CBR_160,
-        const Mp3Metadata& metadata = {}
-    );
+        const Mp3Metadata& metadata = {},
+        const DSP::FadeEnvelope& fades = {},
+        std::string* error = nullptr
+    ) const;
 
     /**
-     * @brief Get the last error message if encoding failed.
+     * @brief Encode interleaved samples that are not owned by a clip (e.g. pooled scratch).
+     *
+     * The ID3 title defaults to the output file's stem when metadata.title is empty.
      */
-    [[nodiscard]] const std::string& lastError() const noexcept { return lastError_; }
+    [[nodiscard]] bool encode(
+        const float* samples,
+        size_t frames,
+        int channels,
+        int sampleRate,
+        const std::string& outputPath,
+        BitrateMode bitrate = BitrateMode::CBR_160,
+        const Mp3Metadata& metadata = {},
+        const DSP::FadeEnvelope& fades = {},
+        std::string* error = nullptr
+    ) const;
+
+    /**
+     * @brief Encode a clip into @p out instead of a file (e.g. for write-behind).
+     *
+     * The ID3 title defaults to the clip's file stem, as with encode().
+     */
+    [[nodiscard]] bool encodeToMemory(
+        const AudioClip& clip,
+        std::vector<uint8_t>& out,
+        BitrateMode bitrate = BitrateMode::CBR_160,
+        const Mp3Metadata& metadata = {},
+        const DSP::FadeEnvelope& fades = {},
+        std::string* error = nullptr
+    ) const;
+
+    /** @brief Encode interleaved samples into @p out; metadata.title is used as given. */
+    [[nodiscard]] bool encodeToMemory(
+        const float* samples,
+        size_t frames,
+        int channels,
+        int sampleRate,
+        std::vector<uint8_t>& out,
+        BitrateMode bitrate = BitrateMode::CBR_160,
+        const Mp3Metadata& metadata = {},
+        const DSP::FadeEnvelope& fades = {},
+        std::string* error = nullptr
+    ) const;
+
+    /**
+     * @brief Destination of the encoded frames: a file or a memory buffer.
+     *
+     * patchStart() overwrites the first bytes with the LAME/Xing frame,
+     * which is only known once all audio is encoded.
+     */
+    class Output {
+    public:
+        virtual ~Output() = default;
+        virtual bool append(const unsigned char* data, size_t size) = 0;
+        virtual void patchStart(const unsigned char* data, size_t size) = 0;
+        virtual bool finish() = 0;
+    };
 
 private:
-    std::string lastError_;
+    bool encodeTo(const float* samples, size_t frames, int channels, int sampleRate, BitrateMode bitrate,
+                  const Mp3Metadata& metadata, const DSP::FadeEnvelope& fades, Output& output,
+                  std::string* error) const;
 };
@@ -0,0 +1,99 @@
+/**
+ * @file PcmConvert.cpp
+ * @brief Scalar and SSE2 PCM conversion kernels.
+ */
+
+#include "PcmConvert.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WOOSH_PCM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float kInt16Read = 1.0f / 32768.0f;
+constexpr float kInt24Read = 1.0f / 8388608.0f;
+constexpr float kInt32Read = 1.0f / 2147483648.0f;
+
+/// Clamp to [-1, 1] the way the SSE2 min/max sequence does: NaN ends up at -1.
+inline float clampUnit(float x) {
+    x = x > -1.0f ? x : -1.0f;
+    return x < 1.0f ? x : 1.0f;
+}
+
+} // namespace
+
+void PcmConvert::int16ToFloat(const int16_t* in, float* out, size_t count) {
+    size_t i = 0;
+#ifdef WOOSH_PCM_SSE2
+    const __m128 scale = _mm_set1_ps(kInt16Read);
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Duplicate each 16-bit lane into the top half, then shift down with sign
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#endif
+    for (; i < count; ++i) out[i] = static_cast<float>(in[i]) * kInt16Read;
+}
+
+void PcmConvert::int24ToFloat(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i, in += 3) {
+        // Assemble in the top 24 bits so the arithmetic shift sign-extends
+        const auto packed = static_cast<int32_t>(static_cast<uint32_t>(in[0]) << 8
+                                               | static_cast<uint32_t>(in[1]) << 16
+                                               | static_cast<uint32_t>(in[2]) << 24);
+        out[i] = static_cast<float>(packed >> 8) * kInt24Read;
+    }
+}
+
+void PcmConvert::int32ToFloat(const int32_t* in, float* out, size_t count) {
+    size_t i = 0;
+#ifdef WOOSH_PCM_SSE2
+    const __m128 scale = _mm_set1_ps(kInt32Read);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+#endif
+    for (; i < count; ++i) out[i] = static_cast<float>(in[i]) * kInt32Read;
+}
+
+void PcmConvert::floatToInt16(const float* in, int16_t* out, size_t count) {
+    size_t i = 0;
+#ifdef WOOSH_PCM_SSE2
+    // cvtps2dq rounds to nearest-even under the default MXCSR, as lrintf does
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    const __m128 lower = _mm_set1_ps(-1.0f);
+    const __m128 upper = _mm_set1_ps(1.0f);
+    for (; i + 8 <= count; i += 8) {
+        const __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lower), upper);
+        const __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lower), upper);
+        const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)),
+                                               _mm_cvtps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+#endif
+    for (; i < count; ++i) out[i] = static_cast<int16_t>(std::lrint(clampUnit(in[i]) * 32767.0f));
+}
+
+void PcmConvert::floatToInt24(const float* in, uint8_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i, out += 3) {
+        const auto value = static_cast<uint32_t>(std::lrint(clampUnit(in[i]) * 8388607.0f));
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+        out[2] = static_cast<uint8_t>(value >> 16);
+    }
+}
+
+void PcmConvert::floatToInt32(const float* in, int32_t* out, size_t count) {
+    // Scaled in double: 2^31 - 1 is not representable as a float and would overflow
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<int32_t>(std::lrint(static_cast<double>(clampUnit(in[i])) * 2147483647.0));
+    }
+}
@@ -0,0 +1,30 @@
+/**
+ * @file PcmConvert.h
+ * @brief Bulk conversion between float samples and integer PCM.
+ *
+ * Scales match libsndfile's normalized float I/O, so files read or written
+ * here hold the same samples as through libsndfile: reading divides by
+ * 2^(bits-1), writing multiplies by 2^(bits-1) - 1 and rounds to nearest.
+ * Writing also clamps to [-1, 1] (NaN becomes -1) instead of wrapping.
+ *
+ * The 16- and 32-bit integer kernels use SSE2 where available; the others
+ * are plain loops. Pointers need no particular alignment. All data is
+ * little-endian, as in WAV files.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PcmConvert {
+
+void int16ToFloat(const int16_t* in, float* out, size_t count);
+void int24ToFloat(const uint8_t* in, float* out, size_t count);     ///< 3 bytes per sample
+void int32ToFloat(const int32_t* in, float* out, size_t count);
+
+void floatToInt16(const float* in, int16_t* out, size_t count);
+void floatToInt24(const float* in, uint8_t* out, size_t count);     ///< 3 bytes per sample
+void floatToInt32(const float* in, int32_t* out, size_t count);
+
+} // namespace PcmConvert
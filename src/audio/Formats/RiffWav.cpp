@@ -0,0 +1,455 @@
+/**
+ * @file RiffWav.cpp
+ * @brief RIFF/RF64 WAV parsing and block-wise PCM reading and writing.
+ */
+
+#include "RiffWav.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "audio/Formats/PcmConvert.h"
+#include "utils/BufferPool.h"
+#include "utils/FrameRanges.h"
+#include "utils/Trace.h"
+
+static_assert(std::endian::native == std::endian::little, "RiffWav converts samples in place as little-endian");
+
+namespace {
+
+using RiffWav::SampleFormat;
+
+constexpr uint16_t kFormatPcm = 0x0001;
+constexpr uint16_t kFormatFloat = 0x0003;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+constexpr uint32_t kUnknownSize = 0xFFFFFFFF;   ///< RF64 placeholder, or a RIFF size a recorder never filled in
+
+/// Tail of the KSDATAFORMAT_SUBTYPE_PCM / _IEEE_FLOAT GUIDs after the 2-byte format tag.
+constexpr uint8_t kSubformatTail[14] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00,
+                                        0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+constexpr size_t kReadBlockBytes = size_t{1} << 20;
+constexpr size_t kWriteBlockFrames = 16384;
+
+struct FileCloser {
+    void operator()(std::FILE* file) const { std::fclose(file); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+bool seekTo(std::FILE* file, uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<long long>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+uint16_t u16(const uint8_t* p) { return static_cast<uint16_t>(p[0] | p[1] << 8); }
+uint32_t u32(const uint8_t* p) { return static_cast<uint32_t>(u16(p)) | static_cast<uint32_t>(u16(p + 2)) << 16; }
+uint64_t u64(const uint8_t* p) { return static_cast<uint64_t>(u32(p)) | static_cast<uint64_t>(u32(p + 4)) << 32; }
+bool isTag(const uint8_t* p, const char* tag) { return std::memcmp(p, tag, 4) == 0; }
+
+std::optional<SampleFormat> sampleFormat(uint16_t formatTag, uint16_t bits) {
+    if (formatTag == kFormatPcm) {
+        if (bits == 16) return SampleFormat::Pcm16;
+        if (bits == 24) return SampleFormat::Pcm24;
+        if (bits == 32) return SampleFormat::Pcm32;
+    } else if (formatTag == kFormatFloat && bits == 32) {
+        return SampleFormat::Float32;
+    }
+    return std::nullopt;
+}
+
+/// Parse the chunks up to "data"; @p readAt(offset, out, size) fetches header bytes from a file or memory.
+template <typename ReadAt>
+std::optional<RiffWav::Info> parseHeader(ReadAt readAt, uint64_t fileSize) {
+    uint8_t riff[12];
+    if (!readAt(0, riff, sizeof(riff)) || !isTag(riff + 8, "WAVE")) return std::nullopt;
+    RiffWav::Info info;
+    if (isTag(riff, "RF64")) {
+        info.rf64 = true;
+    } else if (!isTag(riff, "RIFF")) {
+        return std::nullopt;
+    }
+
+    uint64_t ds64DataBytes = 0;
+    std::optional<SampleFormat> format;
+    uint16_t blockAlign = 0;
+    uint64_t position = sizeof(riff);
+    while (true) {
+        uint8_t chunk[8];
+        if (!readAt(position, chunk, sizeof(chunk))) return std::nullopt;
+        const uint32_t size = u32(chunk + 4);
+
+        if (isTag(chunk, "ds64")) {
+            uint8_t ds64[24];
+            if (size < sizeof(ds64) || !readAt(position + sizeof(chunk), ds64, sizeof(ds64))) return std::nullopt;
+            ds64DataBytes = u64(ds64 + 8);
+        } else if (isTag(chunk, "fmt ")) {
+            uint8_t fmt[40] = {};
+            if (size < 16 || !readAt(position + sizeof(chunk), fmt, std::min<size_t>(size, sizeof(fmt)))) {
+                return std::nullopt;
+            }
+            uint16_t formatTag = u16(fmt);
+            const uint16_t bits = u16(fmt + 14);
+            if (formatTag == kFormatExtensible) {
+                // Only containers whose bits are all valid; e.g. 20-in-24 goes to libsndfile
+                if (size < 40 || u16(fmt + 18) != bits || std::memcmp(fmt + 26, kSubformatTail, 14) != 0) {
+                    return std::nullopt;
+                }
+                formatTag = u16(fmt + 24);
+            }
+            format = sampleFormat(formatTag, bits);
+            info.channels = u16(fmt + 2);
+            info.sampleRate = static_cast<int>(u32(fmt + 4));
+            blockAlign = u16(fmt + 12);
+        } else if (isTag(chunk, "data")) {
+            info.dataOffset = position + sizeof(chunk);
+            if (info.dataOffset > fileSize) return std::nullopt;
+            uint64_t dataBytes = size;
+            if (info.rf64 && size == kUnknownSize) dataBytes = ds64DataBytes;
+            // Streamed or interrupted recordings: take what is on disk. A size
+            // of 0 is an empty data chunk, which other chunks may follow.
+            if (dataBytes == kUnknownSize) dataBytes = fileSize - info.dataOffset;
+            dataBytes = std::min(dataBytes, fileSize - info.dataOffset);
+
+            if (!format || info.channels <= 0 || info.sampleRate <= 0
+                || blockAlign != static_cast<size_t>(info.channels) * RiffWav::bytesPerSample(*format)) {
+                return std::nullopt;
+            }
+            info.format = *format;
+            info.frames = dataBytes / blockAlign;
+            return info;
+        }
+        position += sizeof(chunk) + size + (size & 1u);     // Chunks are padded to even sizes
+    }
+}
+
+std::optional<RiffWav::Info> parseFile(std::FILE* file, uint64_t fileSize) {
+    return parseHeader([file](uint64_t offset, void* out, size_t size) {
+        return seekTo(file, offset) && std::fread(out, 1, size, file) == size;
+    }, fileSize);
+}
+
+std::optional<RiffWav::Info> parseMemory(std::span<const uint8_t> bytes) {
+    return parseHeader([bytes](uint64_t offset, void* out, size_t size) {
+        if (offset > bytes.size() || size > bytes.size() - offset) return false;
+        std::memcpy(out, bytes.data() + offset, size);
+        return true;
+    }, bytes.size());
+}
+
+// --- Header writing ---
+
+void putTag(std::vector<uint8_t>& out, const char* tag) { out.insert(out.end(), tag, tag + 4); }
+void putU16(std::vector<uint8_t>& out, uint16_t v) { out.push_back(static_cast<uint8_t>(v)); out.push_back(static_cast<uint8_t>(v >> 8)); }
+void putU32(std::vector<uint8_t>& out, uint32_t v) { putU16(out, static_cast<uint16_t>(v)); putU16(out, static_cast<uint16_t>(v >> 16)); }
+void putU64(std::vector<uint8_t>& out, uint64_t v) { putU32(out, static_cast<uint32_t>(v)); putU32(out, static_cast<uint32_t>(v >> 32)); }
+
+std::vector<uint8_t> makeHeader(uint64_t frames, int channels, int sampleRate, SampleFormat format) {
+    const bool isFloat = format == SampleFormat::Float32;
+    const size_t bytesPerSample = RiffWav::bytesPerSample(format);
+    const auto blockAlign = static_cast<uint32_t>(static_cast<size_t>(channels) * bytesPerSample);
+    const uint64_t dataBytes = frames * blockAlign;
+
+    // Float files carry a cbSize field and a fact chunk, as the format requires
+    const uint32_t fmtBytes = isFloat ? 18 : 16;
+    const uint64_t riffHeaderBytes = 4 + (8 + fmtBytes) + (isFloat ? 12 : 0) + 8;
+    const uint64_t riffBytes = riffHeaderBytes + dataBytes + (dataBytes & 1u);
+    const bool rf64 = riffBytes + 36 > kUnknownSize;
+
+    std::vector<uint8_t> header;
+    header.reserve(80);
+    putTag(header, rf64 ? "RF64" : "RIFF");
+    putU32(header, rf64 ? kUnknownSize : static_cast<uint32_t>(riffBytes));
+    putTag(header, "WAVE");
+    if (rf64) {
+        putTag(header, "ds64");
+        putU32(header, 28);
+        putU64(header, riffBytes + 36);     // Includes this ds64 chunk
+        putU64(header, dataBytes);
+        putU64(header, frames);
+        putU32(header, 0);                  // No table entries
+    }
+    putTag(header, "fmt ");
+    putU32(header, fmtBytes);
+    putU16(header, isFloat ? kFormatFloat : kFormatPcm);
+    putU16(header, static_cast<uint16_t>(channels));
+    putU32(header, static_cast<uint32_t>(sampleRate));
+    putU32(header, static_cast<uint32_t>(sampleRate) * blockAlign);
+    putU16(header, static_cast<uint16_t>(blockAlign));
+    putU16(header, static_cast<uint16_t>(bytesPerSample * 8));
+    if (isFloat) {
+        putU16(header, 0);
+        putTag(header, "fact");
+        putU32(header, 4);
+        putU32(header, static_cast<uint32_t>(std::min<uint64_t>(frames, kUnknownSize)));
+    }
+    putTag(header, "data");
+    putU32(header, rf64 ? kUnknownSize : static_cast<uint32_t>(dataBytes));
+    return header;
+}
+
+/// Convert @p count samples into @p out in @p format.
+void encodeSamples(const float* samples, size_t count, SampleFormat format, uint8_t* out) {
+    switch (format) {
+        case SampleFormat::Pcm16:   PcmConvert::floatToInt16(samples, reinterpret_cast<int16_t*>(out), count); break;
+        case SampleFormat::Pcm24:   PcmConvert::floatToInt24(samples, out, count); break;
+        case SampleFormat::Pcm32:   PcmConvert::floatToInt32(samples, reinterpret_cast<int32_t*>(out), count); break;
+        case SampleFormat::Float32: std::memcpy(out, samples, count * sizeof(float)); break;
+    }
+}
+
+void decodeSamples(const uint8_t* in, size_t count, SampleFormat format, float* out) {
+    switch (format) {
+        case SampleFormat::Pcm16:   PcmConvert::int16ToFloat(reinterpret_cast<const int16_t*>(in), out, count); break;
+        case SampleFormat::Pcm24:   PcmConvert::int24ToFloat(in, out, count); break;
+        case SampleFormat::Pcm32:   PcmConvert::int32ToFloat(reinterpret_cast<const int32_t*>(in), out, count); break;
+        case SampleFormat::Float32: std::memcpy(out, in, count * sizeof(float)); break;
+    }
+}
+
+/// Decode in place from memory; unaligned 16/32-bit data goes through an aligned block first.
+void decodeMemory(const uint8_t* in, size_t count, SampleFormat format, float* out) {
+    const size_t sampleBytes = RiffWav::bytesPerSample(format);
+    if (reinterpret_cast<uintptr_t>(in) % sampleBytes == 0 || format == SampleFormat::Pcm24) {
+        decodeSamples(in, count, format, out);
+        return;
+    }
+    const size_t blockSamples = kReadBlockBytes / sampleBytes;
+    auto aligned = BufferPool::local().acquire<uint8_t>(std::min(count, blockSamples) * sampleBytes);
+    for (size_t first = 0; first < count; first += blockSamples) {
+        const size_t n = std::min(blockSamples, count - first);
+        std::memcpy(aligned.data(), in + first * sampleBytes, n * sampleBytes);
+        decodeSamples(aligned.data(), n, format, out + first);
+    }
+}
+
+/**
+ * Read up to @p frames frames from the current position of @p file into @p out.
+ * @return Frames read; fewer at the end of the file.
+ */
+size_t readFrames(std::FILE* file, const RiffWav::Info& info, size_t frames, float* out) {
+    const auto channels = static_cast<size_t>(info.channels);
+    const size_t frameBytes = channels * RiffWav::bytesPerSample(info.format);
+    if (info.format == SampleFormat::Float32) {
+        // Already the in-memory layout: read straight into the clip
+        return std::fread(out, frameBytes, frames, file);
+    }
+
+    const size_t blockFrames = std::max<size_t>(1, kReadBlockBytes / frameBytes);
+    auto raw = BufferPool::local().acquire<uint8_t>(std::min(blockFrames, frames) * frameBytes);
+    size_t framesRead = 0;
+    while (framesRead < frames) {
+        const size_t want = std::min(blockFrames, frames - framesRead);
+        const size_t got = std::fread(raw.data(), frameBytes, want, file);
+        decodeSamples(raw.data(), got * channels, info.format, out + framesRead * channels);
+        framesRead += got;
+        if (got < want) break;
+    }
+    return framesRead;
+}
+
+/**
+ * Decode a large file as frame ranges on several threads, measuring each
+ * range as it is decoded. @p decodeRange(range, out) returns the frames it
+ * decoded; a short range ends the clip there, as a short read does.
+ */
+template <typename DecodeRange>
+AudioClip readRanges(const std::string& path, const RiffWav::Info& info, FrameRanges::Sink* sink,
+                     DecodeRange decodeRange) {
+    WOOSH_TRACE_SCOPE("RiffWav::readRanges");
+    const auto channels = static_cast<size_t>(info.channels);
+    const auto frames = static_cast<size_t>(info.frames);
+    const auto ranges = FrameRanges::split(frames, channels * RiffWav::bytesPerSample(info.format));
+
+    std::vector<float> data(frames * channels);
+    std::vector<DSP::ChannelLevelMeter> meters(ranges.size(), DSP::ChannelLevelMeter(info.channels));
+    std::vector<size_t> decoded(ranges.size(), 0);
+    if (sink) sink->begin(info.sampleRate, info.channels, frames);
+    const size_t complete = FrameRanges::run(ranges.size(), [&](size_t i) {
+        float* out = data.data() + ranges[i].first * channels;
+        decoded[i] = decodeRange(ranges[i], out);
+        meters[i].add(out, decoded[i]);
+        return decoded[i] == ranges[i].frames;
+    }, [&](size_t i) {
+        if (sink) sink->frames(data.data() + ranges[i].first * channels, ranges[i].first, ranges[i].frames);
+    });
+
+    // Ranges after a short one are dropped even if they were decoded
+    const size_t kept = std::min(complete + 1, ranges.size());
+    DSP::ChannelLevelMeter meter(info.channels);
+    for (size_t i = 0; i < kept; ++i) meter.merge(meters[i]);
+    if (complete < ranges.size()) data.resize((ranges[complete].first + decoded[complete]) * channels);
+
+    AudioClip clip(path, info.sampleRate, info.channels, std::move(data));
+    const auto levels = meter.levels();
+    clip.updateMetrics(levels.peakDb, levels.rmsDb, meter.channelLevels());
+    return clip;
+}
+
+/**
+ * Convert @p frames to @p format block by block, applying @p fades. Each
+ * block is encoded into target(bytes) and then handed to commit(bytes).
+ */
+template <typename Target, typename Commit>
+bool encodeBlocks(const float* samples, size_t frames, int channels, const DSP::FadeEnvelope& fades,
+                  SampleFormat format, Target target, Commit commit) {
+    // Only blocks that overlap a fade are copied to pick up the envelope;
+    // the rest are converted straight from the source
+    const auto ch = static_cast<size_t>(channels);
+    const size_t frameBytes = ch * RiffWav::bytesPerSample(format);
+    auto scratch = BufferPool::local().acquire<float>(fades.isActive() ? kWriteBlockFrames * ch : 0);
+    for (size_t first = 0; first < frames; first += kWriteBlockFrames) {
+        const size_t n = std::min(kWriteBlockFrames, frames - first);
+        const float* block = samples + first * ch;
+        if (fades.touches(first, n, frames)) {
+            std::copy(block, block + n * ch, scratch.data());
+            DSP::applyFadeEnvelope(scratch.data(), n, channels, first, frames, fades);
+            block = scratch.data();
+        }
+        uint8_t* out = target(n * frameBytes);
+        encodeSamples(block, n * ch, format, out);
+        if (!commit(out, n * frameBytes)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+namespace RiffWav {
+
+std::optional<Info> probe(const std::string& path) {
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    FilePtr file(std::fopen(path.c_str(), "rb"));
+    if (!file) return std::nullopt;
+    return parseFile(file.get(), static_cast<uint64_t>(fileSize));
+}
+
+std::optional<AudioClip> read(const std::string& path, FrameRanges::Sink* sink) {
+    WOOSH_TRACE_SCOPE_DETAIL("RiffWav::read", path);
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    FilePtr file(std::fopen(path.c_str(), "rb"));
+    if (!file) return std::nullopt;
+    const auto info = parseFile(file.get(), static_cast<uint64_t>(fileSize));
+    if (!info || !seekTo(file.get(), info->dataOffset)) return std::nullopt;
+
+    const auto channels = static_cast<size_t>(info->channels);
+    const size_t frameBytes = channels * bytesPerSample(info->format);
+    const auto frames = static_cast<size_t>(info->frames);
+    if (FrameRanges::worthSplitting(frames * frameBytes)) {
+        // Each range reads through its own handle
+        file.reset();
+        return readRanges(path, *info, sink, [&](const FrameRanges::Range& range, float* out) -> size_t {
+            FilePtr rangeFile(std::fopen(path.c_str(), "rb"));
+            if (!rangeFile || !seekTo(rangeFile.get(), info->dataOffset + range.first * frameBytes)) return 0;
+            return readFrames(rangeFile.get(), *info, range.frames, out);
+        });
+    }
+
+    std::vector<float> data(frames * channels);
+    const size_t framesRead = readFrames(file.get(), *info, frames, data.data());
+    data.resize(framesRead * channels);
+    return AudioClip(path, info->sampleRate, info->channels, std::move(data));
+}
+
+bool stream(const std::string& path, FrameRanges::Sink& sink) {
+    WOOSH_TRACE_SCOPE_DETAIL("RiffWav::stream", path);
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    FilePtr file(std::fopen(path.c_str(), "rb"));
+    if (!file) return false;
+    const auto info = parseFile(file.get(), static_cast<uint64_t>(fileSize));
+    if (!info || !seekTo(file.get(), info->dataOffset)) return false;
+
+    const auto channels = static_cast<size_t>(info->channels);
+    const size_t frameBytes = channels * bytesPerSample(info->format);
+    const auto frames = static_cast<size_t>(info->frames);
+    const size_t blockFrames = std::max<size_t>(1, kReadBlockBytes / frameBytes);
+    auto block = BufferPool::local().acquire<float>(std::min(blockFrames, frames) * channels);
+
+    sink.begin(info->sampleRate, info->channels, frames);
+    for (size_t first = 0; first < frames;) {
+        const size_t want = std::min(blockFrames, frames - first);
+        const size_t got = readFrames(file.get(), *info, want, block.data());
+        if (got > 0) sink.frames(block.data(), first, got);
+        first += got;
+        if (got < want) break;
+    }
+    return true;
+}
+
+std::optional<AudioClip> read(const std::string& path, std::span<const uint8_t> bytes, FrameRanges::Sink* sink) {
+    WOOSH_TRACE_SCOPE_DETAIL("RiffWav::read", path);
+    const auto info = parseMemory(bytes);
+    if (!info) return std::nullopt;
+
+    // parseMemory() clamps the frame count to the bytes present
+    const auto channels = static_cast<size_t>(info->channels);
+    const size_t frameBytes = channels * bytesPerSample(info->format);
+    const auto frames = static_cast<size_t>(info->frames);
+    const uint8_t* samples = bytes.data() + info->dataOffset;
+    if (FrameRanges::worthSplitting(frames * frameBytes)) {
+        return readRanges(path, *info, sink, [&](const FrameRanges::Range& range, float* out) {
+            decodeMemory(samples + range.first * frameBytes, range.frames * channels, info->format, out);
+            return range.frames;
+        });
+    }
+
+    std::vector<float> data(frames * channels);
+    decodeMemory(samples, frames * channels, info->format, data.data());
+    return AudioClip(path, info->sampleRate, info->channels, std::move(data));
+}
+
+bool write(const std::string& path, const float* samples, size_t frames, int channels, int sampleRate,
+           const DSP::FadeEnvelope& fades, SampleFormat format) {
+    WOOSH_TRACE_SCOPE_DETAIL("RiffWav::write", path);
+    if (channels <= 0 || channels > 0xFFFF || sampleRate <= 0) return false;
+    FilePtr file(std::fopen(path.c_str(), "wb"));
+    if (!file) return false;
+
+    const auto header = makeHeader(frames, channels, sampleRate, format);
+    if (std::fwrite(header.data(), 1, header.size(), file.get()) != header.size()) return false;
+
+    const size_t frameBytes = static_cast<size_t>(channels) * bytesPerSample(format);
+    auto encoded = BufferPool::local().acquire<uint8_t>(kWriteBlockFrames * frameBytes);
+    const bool written = encodeBlocks(samples, frames, channels, fades, format,
+        [&](size_t) { return encoded.data(); },
+        [&](const uint8_t* block, size_t size) { return std::fwrite(block, 1, size, file.get()) == size; });
+    if (!written) return false;
+
+    const uint64_t dataBytes = static_cast<uint64_t>(frames) * frameBytes;
+    if ((dataBytes & 1u) && std::fputc(0, file.get()) == EOF) return false;
+    return std::fclose(file.release()) == 0;
+}
+
+std::optional<std::vector<uint8_t>> encode(const float* samples, size_t frames, int channels, int sampleRate,
+                                           const DSP::FadeEnvelope& fades, SampleFormat format) {
+    WOOSH_TRACE_SCOPE("RiffWav::encode");
+    if (channels <= 0 || channels > 0xFFFF || sampleRate <= 0) return std::nullopt;
+
+    std::vector<uint8_t> out = makeHeader(frames, channels, sampleRate, format);
+    const size_t headerBytes = out.size();
+    const size_t dataBytes = frames * static_cast<size_t>(channels) * bytesPerSample(format);
+    out.resize(headerBytes + dataBytes + (dataBytes & 1u));     // Pad byte is zeroed by resize()
+
+    // Encoded straight into the output, no staging buffer
+    size_t offset = headerBytes;
+    encodeBlocks(samples, frames, channels, fades, format,
+        [&](size_t) { return out.data() + offset; },
+        [&](const uint8_t*, size_t size) { offset += size; return true; });
+    return out;
+}
+
+} // namespace RiffWav
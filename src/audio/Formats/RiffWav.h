@@ -0,0 +1,100 @@
+/**
+ * @file RiffWav.h
+ * @brief In-tree reader and writer for plain RIFF and RF64 WAV files.
+ *
+ * Covers what game audio and field recorders produce: 16/24/32-bit integer
+ * PCM and 32-bit float, as plain or WAVE_FORMAT_EXTENSIBLE headers, in RIFF
+ * or RF64 (EBU Tech 3306) containers. RF64 lifts the 4 GB limit of RIFF;
+ * the writer switches to it only when the data would not fit.
+ *
+ * Samples are moved in large blocks and converted with PcmConvert, so no
+ * per-sample library call is involved. Anything else (8-bit, 64-bit float,
+ * compressed formats, big-endian RIFX) is rejected, and WavCodec hands the
+ * file to libsndfile instead.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "audio/AudioClip.h"
+#include "utils/DSP.h"
+#include "utils/FrameRanges.h"
+
+namespace RiffWav {
+
+enum class SampleFormat {
+    Pcm16,
+    Pcm24,
+    Pcm32,
+    Float32
+};
+
+/**
+ * @brief Layout of a WAV file's sample data.
+ */
+struct Info {
+    int channels{0};
+    int sampleRate{0};
+    SampleFormat format{SampleFormat::Pcm16};
+    uint64_t frames{0};
+    uint64_t dataOffset{0};     ///< Byte offset of the first sample
+    bool rf64{false};
+};
+
+/** @brief Bytes per sample of @p format. */
+[[nodiscard]] constexpr size_t bytesPerSample(SampleFormat format) noexcept {
+    switch (format) {
+        case SampleFormat::Pcm16:   return 2;
+        case SampleFormat::Pcm24:   return 3;
+        case SampleFormat::Pcm32:   return 4;
+        case SampleFormat::Float32: return 4;
+    }
+    return 0;
+}
+
+/** @brief Parse the header of @p path; nullopt if it is not a WAV file this reader handles. */
+[[nodiscard]] std::optional<Info> probe(const std::string& path);
+
+/**
+ * @brief Read @p path as float samples; nullopt if unsupported or unreadable.
+ *
+ * Files with more sample data than FrameRanges::kMinSplitBytes are decoded
+ * as frame ranges on several threads. Those clips come back with their
+ * metrics measured while decoding, and @p sink (optional) receives the
+ * ranges in order as they are done.
+ */
+[[nodiscard]] std::optional<AudioClip> read(const std::string& path, FrameRanges::Sink* sink = nullptr);
+
+/** @brief Decode a WAV file already in memory, like read(path); @p path only names the clip. */
+[[nodiscard]] std::optional<AudioClip> read(const std::string& path, std::span<const uint8_t> bytes,
+                                            FrameRanges::Sink* sink = nullptr);
+
+/**
+ * @brief Decode @p path block by block into @p sink, never holding more than one block.
+ *
+ * For consumers that look at each sample once, such as fingerprinting. A
+ * short read ends the stream where the data ends.
+ * @return False, before anything reached @p sink, if unsupported or unreadable.
+ */
+[[nodiscard]] bool stream(const std::string& path, FrameRanges::Sink& sink);
+
+/**
+ * @brief Write interleaved samples, applying @p fades block by block.
+ * @return False on I/O failure; a partial file may be left behind.
+ */
+[[nodiscard]] bool write(const std::string& path, const float* samples, size_t frames, int channels,
+                         int sampleRate, const DSP::FadeEnvelope& fades = {},
+                         SampleFormat format = SampleFormat::Pcm16);
+
+/** @brief Like write(), into memory: the complete file, header included. */
+[[nodiscard]] std::optional<std::vector<uint8_t>> encode(const float* samples, size_t frames, int channels,
+                                                         int sampleRate, const DSP::FadeEnvelope& fades = {},
+                                                         SampleFormat format = SampleFormat::Pcm16);
+
+} // namespace RiffWav
@@ -1,28 +1,215 @@
 #include "WavCodec.h"
+#include "audio/Formats/RiffWav.h"
+#include "utils/BufferPool.h"
+#include "utils/FrameRanges.h"
+#include "utils/Trace.h"
 #include <sndfile.hh>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
-std::optional<AudioClip> WavCodec::read(const std::string& path) {
-    SndfileHandle handle(path);
+namespace {
+
+/// A WAV file in memory for libsndfile's virtual I/O: read from @p bytes, or written into @p out.
+struct MemoryFile {
+    std::span<const uint8_t> bytes;
+    std::vector<uint8_t>* out{nullptr};
+    sf_count_t position{0};
+
+    static MemoryFile& of(void* user) { return *static_cast<MemoryFile*>(user); }
+
+    sf_count_t size() const { return static_cast<sf_count_t>(out ? out->size() : bytes.size()); }
+    const uint8_t* data() const { return out ? out->data() : bytes.data(); }
+};
+
+SF_VIRTUAL_IO memoryIo() {
+    SF_VIRTUAL_IO io{};
+    io.get_filelen = [](void* user) { return MemoryFile::of(user).size(); };
+    io.seek = [](sf_count_t offset, int whence, void* user) {
+        MemoryFile& file = MemoryFile::of(user);
+        const sf_count_t base = whence == SEEK_CUR ? file.position : whence == SEEK_END ? file.size() : 0;
+        file.position = std::max<sf_count_t>(0, base + offset);
+        return file.position;
+    };
+    io.read = [](void* ptr, sf_count_t count, void* user) {
+        MemoryFile& file = MemoryFile::of(user);
+        const sf_count_t n = std::clamp<sf_count_t>(file.size() - file.position, 0, count);
+        std::memcpy(ptr, file.data() + file.position, static_cast<size_t>(n));
+        file.position += n;
+        return n;
+    };
+    io.write = [](const void* ptr, sf_count_t count, void* user) -> sf_count_t {
+        MemoryFile& file = MemoryFile::of(user);
+        if (!file.out) return 0;
+        const auto end = static_cast<size_t>(file.position + count);
+        if (file.out->size() < end) file.out->resize(end);
+        std::memcpy(file.out->data() + file.position, ptr, static_cast<size_t>(count));
+        file.position += count;
+        return count;
+    };
+    io.tell = [](void* user) { return MemoryFile::of(user).position; };
+    return io;
+}
+
+/**
+ * Read a large source as frame ranges on several threads, measuring each as
+ * it is decoded. @p withHandle(use) opens another handle on the source for
+ * use(handle). nullopt if a range cannot seek or comes up short; the caller
+ * then reads the source in one go.
+ */
+template <typename WithHandle>
+std::optional<AudioClip> readRanges(const std::string& path, int sampleRate, int channels, size_t frames,
+                                    FrameRanges::Sink* sink, WithHandle withHandle) {
+    WOOSH_TRACE_SCOPE("WavCodec::readRanges");
+    const auto ch = static_cast<size_t>(channels);
+    const auto ranges = FrameRanges::split(frames, ch * sizeof(float));
+    std::vector<float> data(frames * ch);
+    std::vector<DSP::ChannelLevelMeter> meters(ranges.size(), DSP::ChannelLevelMeter(channels));
+    if (sink) sink->begin(sampleRate, channels, frames);
+    const size_t complete = FrameRanges::run(ranges.size(), [&](size_t i) {
+        const auto first = static_cast<sf_count_t>(ranges[i].first);
+        const auto want = static_cast<sf_count_t>(ranges[i].frames);
+        float* out = data.data() + ranges[i].first * ch;
+        return withHandle([&](SndfileHandle& handle) {
+            if (!handle || handle.error() || handle.seek(first, SEEK_SET) != first) return false;
+            const sf_count_t got = handle.readf(out, want);
+            meters[i].add(out, static_cast<size_t>(std::max<sf_count_t>(got, 0)));
+            return got == want;
+        });
+    }, [&](size_t i) {
+        if (sink) sink->frames(data.data() + ranges[i].first * ch, ranges[i].first, ranges[i].frames);
+    });
+    if (complete < ranges.size()) return std::nullopt;
+
+    DSP::ChannelLevelMeter meter(channels);
+    for (const auto& partial : meters) meter.merge(partial);
+    AudioClip clip(path, sampleRate, channels, std::move(data));
+    const auto levels = meter.levels();
+    clip.updateMetrics(levels.peakDb, levels.rmsDb, meter.channelLevels());
+    return clip;
+}
+
+template <typename WithHandle>
+std::optional<AudioClip> readHandle(SndfileHandle& handle, const std::string& path, FrameRanges::Sink* sink,
+                                    WithHandle withHandle) {
     if (!handle || handle.error()) {
         return std::nullopt;
     }
     auto frames = static_cast<size_t>(handle.frames());
     auto channels = handle.channels();
     auto sampleRate = handle.samplerate();
+    if (FrameRanges::worthSplitting(frames * static_cast<size_t>(channels) * sizeof(float))) {
+        if (auto clip = readRanges(path, sampleRate, channels, frames, sink, withHandle)) return clip;
+    }
     std::vector<float> data(frames * static_cast<size_t>(channels));
     auto read = handle.readf(data.data(), frames);
     data.resize(static_cast<size_t>(read) * static_cast<size_t>(channels));
     return AudioClip(path, sampleRate, channels, std::move(data));
 }
 
-bool WavCodec::write(const std::string& path, const AudioClip& clip) {
-    SndfileHandle handle(path, SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_PCM_16, clip.channels(), clip.sampleRate());
+bool writeHandle(SndfileHandle& handle, const float* samples, size_t frames, int channels,
+                 const DSP::FadeEnvelope& fades) {
     if (!handle || handle.error()) return false;
-    auto frames = static_cast<sf_count_t>(clip.samples().size() / static_cast<size_t>(clip.channels()));
-    auto written = handle.writef(clip.samples().data(), frames);
-    return written == frames;
+    auto frameCount = static_cast<sf_count_t>(frames);
+    if (!fades.isActive()) {
+        auto written = handle.writef(samples, frameCount);
+        return written == frameCount;
+    }
+
+    // Write in blocks; only blocks that overlap a fade go through scratch
+    // to pick up the envelope, the rest are written straight from the source
+    constexpr size_t kBlockFrames = 8192;
+    const auto ch = static_cast<size_t>(channels);
+    auto scratch = BufferPool::local().acquire<float>(kBlockFrames * ch);
+    for (size_t first = 0; first < frames; first += kBlockFrames) {
+        const size_t n = std::min(kBlockFrames, frames - first);
+        const float* block = samples + first * ch;
+        if (fades.touches(first, n, frames)) {
+            std::copy(block, block + n * ch, scratch.data());
+            DSP::applyFadeEnvelope(scratch.data(), n, channels, first, frames, fades);
+            block = scratch.data();
+        }
+        if (handle.writef(block, static_cast<sf_count_t>(n)) != static_cast<sf_count_t>(n)) return false;
+    }
+    return true;
 }
 
+} // namespace
 
+std::optional<AudioClip> WavCodec::read(const std::string& path, FrameRanges::Sink* sink) const {
+    WOOSH_TRACE_SCOPE_DETAIL("WavCodec::read", path);
+    if (useFastPath_) {
+        if (auto clip = RiffWav::read(path, sink)) return clip;
+    }
+    SndfileHandle handle(path);
+    return readHandle(handle, path, sink, [&](auto&& use) {
+        SndfileHandle rangeHandle(path);
+        return use(rangeHandle);
+    });
+}
 
+std::optional<AudioClip> WavCodec::read(const std::string& path, std::span<const uint8_t> bytes,
+                                        FrameRanges::Sink* sink) const {
+    WOOSH_TRACE_SCOPE_DETAIL("WavCodec::read", path);
+    if (useFastPath_) {
+        if (auto clip = RiffWav::read(path, bytes, sink)) return clip;
+    }
+    MemoryFile file{bytes};
+    SF_VIRTUAL_IO io = memoryIo();
+    SndfileHandle handle(io, &file);
+    return readHandle(handle, path, sink, [&](auto&& use) {
+        MemoryFile rangeFile{bytes};
+        SndfileHandle rangeHandle(io, &rangeFile);
+        return use(rangeHandle);
+    });
+}
+
+bool WavCodec::stream(const std::string& path, FrameRanges::Sink& sink) const {
+    WOOSH_TRACE_SCOPE_DETAIL("WavCodec::stream", path);
+    if (useFastPath_ && RiffWav::stream(path, sink)) return true;
+
+    SndfileHandle handle(path);
+    if (!handle || handle.error()) return false;
+    constexpr size_t kBlockFrames = 65536;
+    auto block = BufferPool::local().acquire<float>(kBlockFrames * static_cast<size_t>(handle.channels()));
+    sink.begin(handle.samplerate(), handle.channels(), static_cast<size_t>(handle.frames()));
+    size_t first = 0;
+    for (sf_count_t got; (got = handle.readf(block.data(), kBlockFrames)) > 0; first += static_cast<size_t>(got)) {
+        sink.frames(block.data(), first, static_cast<size_t>(got));
+    }
+    return true;
+}
+
+bool WavCodec::write(const std::string& path, const AudioClip& clip, const DSP::FadeEnvelope& fades) const {
+    const auto view = clip.view();
+    return write(path, view.data(), clip.frameCount(), clip.channels(), clip.sampleRate(), fades);
+}
+
+bool WavCodec::write(const std::string& path, const float* samples, size_t frames, int channels, int sampleRate,
+                     const DSP::FadeEnvelope& fades) const {
+    WOOSH_TRACE_SCOPE_DETAIL("WavCodec::write", path);
+    if (useFastPath_) return RiffWav::write(path, samples, frames, channels, sampleRate, fades);
+
+    SndfileHandle handle(path, SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_PCM_16, channels, sampleRate);
+    return writeHandle(handle, samples, frames, channels, fades);
+}
+
+std::optional<std::vector<uint8_t>> WavCodec::encode(const AudioClip& clip, const DSP::FadeEnvelope& fades) const {
+    WOOSH_TRACE_SCOPE_DETAIL("WavCodec::encode", clip.displayName());
+    const size_t frames = clip.frameCount();
+    const auto view = clip.view();
+    if (useFastPath_) {
+        return RiffWav::encode(view.data(), frames, clip.channels(), clip.sampleRate(), fades);
+    }
+
+    std::vector<uint8_t> out;
+    {
+        // The handle finalizes the header when it closes
+        MemoryFile file{{}, &out};
+        SF_VIRTUAL_IO io = memoryIo();
+        SndfileHandle handle(io, &file, SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_PCM_16, clip.channels(),
+                             clip.sampleRate());
+        if (!writeHandle(handle, view.data(), frames, clip.channels(), fades)) return std::nullopt;
+    }
+    return out;
+}
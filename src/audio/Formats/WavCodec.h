@@ -1,14 +1,60 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
+#include <vector>
 #include "audio/AudioClip.h"
+#include "utils/DSP.h"
+#include "utils/FrameRanges.h"
 
 class WavCodec final {
 public:
-    [[nodiscard]] std::optional<AudioClip> read(const std::string& path);
-    [[nodiscard]] bool write(const std::string& path, const AudioClip& clip);
-};
+    /**
+     * @brief Read a WAV file as float samples.
+     *
+     * Plain PCM and float files go through the in-tree RiffWav reader; every
+     * other format libsndfile understands is read through libsndfile.
+     *
+     * Long files are decoded as frame ranges on several threads (libsndfile
+     * formats through one handle per range, if they can seek); such clips
+     * come back with their metrics measured, and @p sink (optional)
+     * receives the ranges in order as they are done. See FrameRanges.
+     */
+    [[nodiscard]] std::optional<AudioClip> read(const std::string& path, FrameRanges::Sink* sink = nullptr) const;
+
+    /** @brief Decode a WAV file already in memory (e.g. prefetched); @p path only names the clip. */
+    [[nodiscard]] std::optional<AudioClip> read(const std::string& path, std::span<const uint8_t> bytes,
+                                                FrameRanges::Sink* sink = nullptr) const;
+
+    /**
+     * @brief Decode a WAV file block by block into @p sink, without building a clip.
+     * @return False, before anything reached @p sink, if the file cannot be read.
+     */
+    [[nodiscard]] bool stream(const std::string& path, FrameRanges::Sink& sink) const;
 
+    /** @brief Write a clip, applying @p fades block by block as the samples are written. */
+    [[nodiscard]] bool write(const std::string& path, const AudioClip& clip,
+                             const DSP::FadeEnvelope& fades = {}) const;
 
+    /** @brief Write interleaved samples that are not owned by a clip (e.g. pooled scratch). */
+    [[nodiscard]] bool write(const std::string& path, const float* samples, size_t frames,
+                             int channels, int sampleRate, const DSP::FadeEnvelope& fades = {}) const;
 
+    /** @brief The 16-bit WAV file write() would produce, in memory. */
+    [[nodiscard]] std::optional<std::vector<uint8_t>> encode(const AudioClip& clip,
+                                                             const DSP::FadeEnvelope& fades = {}) const;
+
+    /**
+     * @brief Route all I/O through libsndfile when false (for A/B benchmarks and parity tests).
+     *
+     * The codec is otherwise stateless; set this before sharing it between threads.
+     */
+    void setFastPathEnabled(bool enabled) noexcept { useFastPath_ = enabled; }
+    [[nodiscard]] bool isFastPathEnabled() const noexcept { return useFastPath_; }
+
+private:
+    bool useFastPath_{true};
+};
@@ -0,0 +1,116 @@
+/**
+ * @file MappedSamples.cpp
+ * @brief File-backed sample storage (mmap on POSIX, file mapping on Windows).
+ */
+
+#include "MappedSamples.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kChunkFrames = 16384;
+
+#ifdef _WIN32
+bool writeAll(HANDLE file, const float* data, size_t count) {
+    const auto* bytes = reinterpret_cast<const char*>(data);
+    size_t left = count * sizeof(float);
+    while (left > 0) {
+        DWORD written = 0;
+        const auto chunk = static_cast<DWORD>(std::min<size_t>(left, 1u << 30));
+        if (!WriteFile(file, bytes, chunk, &written, nullptr) || written == 0) return false;
+        bytes += written;
+        left -= written;
+    }
+    return true;
+}
+#else
+bool writeAll(int fd, const float* data, size_t count) {
+    const auto* bytes = reinterpret_cast<const char*>(data);
+    size_t left = count * sizeof(float);
+    while (left > 0) {
+        const ssize_t written = ::write(fd, bytes, left);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        bytes += written;
+        left -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+std::shared_ptr<const MappedSamples> MappedSamples::create(const std::string& directory, size_t frames,
+                                                           int channels, const Fill& fill) {
+    std::shared_ptr<MappedSamples> result(new MappedSamples());
+    const auto ch = static_cast<size_t>(std::max(channels, 0));
+    const size_t count = frames * ch;
+    if (count == 0) return result;
+
+    std::vector<float> chunk(std::min(frames, kChunkFrames) * ch);
+    auto writeSamples = [&](auto&& write) {
+        for (size_t first = 0; first < frames; first += kChunkFrames) {
+            const size_t n = std::min(kChunkFrames, frames - first);
+            fill(first, n, chunk.data());
+            if (!write(chunk.data(), n * ch)) return false;
+        }
+        return true;
+    };
+
+#ifdef _WIN32
+    static std::atomic<unsigned> counter{0};
+    const auto name = std::filesystem::path(directory) /
+        ("woosh-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(counter++) + ".spill");
+    HANDLE file = CreateFileW(name.wstring().c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_NEW,
+                              FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    result->file_ = file;   // Closed (and deleted) by the destructor from here on
+
+    if (!writeSamples([&](const float* data, size_t n) { return writeAll(file, data, n); })) return nullptr;
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return nullptr;
+    result->mapping_ = mapping;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) return nullptr;
+#else
+    std::string pattern = (std::filesystem::path(directory) / "woosh-XXXXXX").string();
+    const int fd = mkstemp(pattern.data());
+    if (fd < 0) return nullptr;
+    ::unlink(pattern.c_str());     // The file lives on while it is open or mapped
+
+    const bool written = writeSamples([&](const float* data, size_t n) { return writeAll(fd, data, n); });
+    void* view = written ? mmap(nullptr, count * sizeof(float), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    ::close(fd);
+    if (view == MAP_FAILED) return nullptr;
+#endif
+
+    result->data_ = static_cast<const float*>(view);
+    result->count_ = count;
+    return result;
+}
+
+MappedSamples::~MappedSamples() {
+#ifdef _WIN32
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+#else
+    if (data_) munmap(const_cast<float*>(data_), count_ * sizeof(float));
+#endif
+}
@@ -0,0 +1,60 @@
+/**
+ * @file MappedSamples.h
+ * @brief Float samples moved out of the heap into a memory-mapped temp file.
+ *
+ * Used to spill processed clips under memory pressure. The samples are
+ * written once and mapped read-only, so their pages are clean page cache:
+ * the OS pages them in when playback, the waveform or an export reads
+ * them and drops them again when memory is short, instead of swapping.
+ *
+ * The file has no name once created (unlinked on POSIX, delete-on-close on
+ * Windows), so nothing is left behind even if the process dies.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+/**
+ * @class MappedSamples
+ * @brief Immutable, file-backed array of floats.
+ */
+class MappedSamples final {
+public:
+    /// Writes the interleaved samples of frames [firstFrame, firstFrame + frames) into @p out.
+    using Fill = std::function<void(size_t firstFrame, size_t frames, float* out)>;
+
+    /**
+     * @brief Write @p frames frames of @p channels samples into a new file in @p directory and map it.
+     *
+     * The samples are produced by @p fill in chunks, so expanding 16-bit
+     * storage never needs a full-size float copy on the heap.
+     * @return nullptr if the file cannot be created, written (e.g. the disk
+     *         is full) or mapped.
+     */
+    [[nodiscard]] static std::shared_ptr<const MappedSamples> create(const std::string& directory, size_t frames,
+                                                                     int channels, const Fill& fill);
+
+    ~MappedSamples();
+
+    MappedSamples(const MappedSamples&) = delete;
+    MappedSamples& operator=(const MappedSamples&) = delete;
+
+    /** @brief The interleaved samples; null if there are none. */
+    [[nodiscard]] const float* data() const noexcept { return data_; }
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] size_t bytes() const noexcept { return count_ * sizeof(float); }
+
+private:
+    MappedSamples() = default;
+
+    const float* data_{nullptr};
+    size_t count_{0};
+#ifdef _WIN32
+    void* file_{nullptr};
+    void* mapping_{nullptr};
+#endif
+};
@@ -0,0 +1,271 @@
+/**
+ * @file ProcessingChain.cpp
+ * @brief Implementation of the fused processing chain.
+ */
+
+#include "ProcessingChain.h"
+#include "utils/Trace.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Frames per block: small enough that a block of any common channel count
+// stays in L1/L2 while every stage runs over it
+constexpr size_t kBlockFrames = 2048;
+
+inline float dbToLinear(float db) { return std::pow(10.0f, db / 20.0f); }
+
+/// One operation inside a fused pass: a plain gain, a compressor, or a
+/// limiter (only ever the last stage).
+struct Stage {
+    float gain{1.0f};
+    std::optional<DSP::Compressor> compressor;
+    std::optional<DSP::Limiter> limiter;
+};
+
+/**
+ * One fused pass over @p samples, fed in order: feed() hands over frames
+ * that are ready, finish() processes the rest and returns the output levels.
+ * Frames are processed in the same blocks however they are fed.
+ */
+class FusedPass {
+public:
+    FusedPass(std::span<float> samples, int channels, std::vector<Stage> stages)
+        : samples_(samples)
+        , channels_(channels)
+        , ch_(static_cast<size_t>(channels))
+        , stages_(std::move(stages))
+        , meter_(channels)
+    {
+    }
+
+    /** @brief The next @p frames frames are ready; process every whole block among them. */
+    void feed(size_t frames) {
+        ready_ = std::min(ready_ + frames, samples_.size() / ch_);
+        while (ready_ - processed_ >= kBlockFrames) {
+            processBlock(kBlockFrames);
+        }
+    }
+
+    /** @brief Process what was fed but not yet processed, and flush the limiter. */
+    DSP::ChannelLevelMeter finish() {
+        if (ready_ > processed_) processBlock(ready_ - processed_);
+        if (DSP::Limiter* limiter = trailingLimiter()) {
+            limiter->finish();
+            drainLimiter();
+        }
+        return std::move(meter_);
+    }
+
+private:
+    /// The limiter trails the other stages: it limits (and the meter reads)
+    /// whatever frames its look-ahead has fully seen
+    DSP::Limiter* trailingLimiter() noexcept {
+        return stages_.back().limiter ? &*stages_.back().limiter : nullptr;
+    }
+
+    void processBlock(size_t n) {
+        float* block = samples_.data() + processed_ * ch_;
+        for (auto& stage : stages_) {
+            if (stage.limiter) {
+                stage.limiter->analyze(block, n, channels_);
+            } else if (stage.compressor) {
+                stage.compressor->process(block, n, channels_);
+            } else {
+                for (size_t i = 0; i < n * ch_; ++i) block[i] *= stage.gain;
+            }
+        }
+        processed_ += n;
+        if (trailingLimiter()) {
+            drainLimiter();
+        } else {
+            meter_.add(block, n);
+        }
+    }
+
+    void drainLimiter() {
+        DSP::Limiter& limiter = *trailingLimiter();
+        const size_t ready = limiter.readyFrames();
+        float* out = samples_.data() + limited_ * ch_;
+        limiter.apply(out, ready, channels_);
+        meter_.add(out, ready);
+        limited_ += ready;
+    }
+
+    std::span<float> samples_;
+    int channels_;
+    size_t ch_;
+    std::vector<Stage> stages_;
+    DSP::ChannelLevelMeter meter_;
+    size_t ready_{0};       ///< Frames fed
+    size_t processed_{0};   ///< Frames the stages have run over
+    size_t limited_{0};     ///< Frames the limiter has written
+};
+
+DSP::ChannelLevelMeter runFused(std::span<float> samples, int channels, std::vector<Stage> stages) {
+    WOOSH_TRACE_SCOPE("ProcessingChain::fusedPass");
+    FusedPass pass(samples, channels, std::move(stages));
+    pass.feed(samples.size() / static_cast<size_t>(channels));
+    return pass.finish();
+}
+
+/**
+ * Plan the stages of the pass that starts at @p steps[next] and advance
+ * @p next past them. @p levels are those of the pass's input, if
+ * @p levelsKnown; a normalize that needs them otherwise gets them from
+ * @p measureInput(), and they follow the planned gains from there.
+ */
+template <typename MeasureInput>
+std::vector<Stage> planPass(const std::vector<ProcessingChain::Step>& steps, size_t& next, int sampleRate,
+                            DSP::Levels& levels, bool& levelsKnown, MeasureInput measureInput) {
+    using Chain = ProcessingChain;
+    std::vector<Stage> stages;
+    for (; next < steps.size(); ++next) {
+        const Chain::Step& step = steps[next];
+        if (const auto* comp = std::get_if<Chain::Compress>(&step)) {
+            stages.push_back({1.0f, DSP::Compressor(comp->settings, sampleRate), std::nullopt});
+            levelsKnown = false;
+            continue;
+        }
+        if (const auto* lim = std::get_if<Chain::Limit>(&step)) {
+            // Ends the pass; the limiter has to run last in it
+            stages.push_back({1.0f, std::nullopt, DSP::Limiter(lim->settings, sampleRate)});
+            levelsKnown = false;
+            ++next;
+            break;
+        }
+
+        if (!levelsKnown) {
+            // A normalize after a compressor needs that compressor's output
+            if (!stages.empty()) break;
+            levels = measureInput();
+            levelsKnown = true;
+        }
+        const float gainDb = std::holds_alternative<Chain::NormalizePeak>(step)
+            ? std::get<Chain::NormalizePeak>(step).targetDbFS - levels.peakDb
+            : std::get<Chain::NormalizeRms>(step).targetDb - levels.rmsDb;
+        levels.peakDb += gainDb;
+        levels.rmsDb += gainDb;
+
+        // Consecutive gains fold into one multiply
+        if (!stages.empty() && !stages.back().compressor) {
+            stages.back().gain *= dbToLinear(gainDb);
+        } else {
+            stages.push_back({dbToLinear(gainDb), std::nullopt, std::nullopt});
+        }
+    }
+    return stages;
+}
+
+} // namespace
+
+ProcessingChain& ProcessingChain::normalizeToPeak(float targetDbFS) {
+    steps_.emplace_back(NormalizePeak{targetDbFS});
+    return *this;
+}
+
+ProcessingChain& ProcessingChain::normalizeToRms(float targetDb) {
+    steps_.emplace_back(NormalizeRms{targetDb});
+    return *this;
+}
+
+ProcessingChain& ProcessingChain::compress(const DSP::CompressorSettings& settings) {
+    steps_.emplace_back(Compress{settings});
+    return *this;
+}
+
+ProcessingChain& ProcessingChain::limit(const DSP::LimiterSettings& settings) {
+    steps_.emplace_back(Limit{settings});
+    return *this;
+}
+
+ProcessingChain::Result ProcessingChain::run(std::span<float> samples, int sampleRate, int channels,
+                                             std::optional<DSP::Levels> inputLevels) const {
+    Result result;
+    if (samples.empty() || channels <= 0 || sampleRate <= 0) {
+        result.levels = inputLevels ? *inputLevels : DSP::measureLevels(samples);
+        return result;
+    }
+    return runPasses(0, samples, sampleRate, channels, inputLevels.value_or(DSP::Levels{}),
+                     inputLevels.has_value(), std::move(result));
+}
+
+ProcessingChain::Result ProcessingChain::runPasses(size_t next, std::span<float> samples, int sampleRate,
+                                                   int channels, DSP::Levels levels, bool levelsKnown,
+                                                   Result result) const {
+    // levels are those of the signal as it stands after the stages planned
+    // so far; unknown once a compressor or limiter has been planned
+    while (next < steps_.size()) {
+        auto stages = planPass(steps_, next, sampleRate, levels, levelsKnown, [&] {
+            ++result.analysisPasses;
+            return DSP::measureLevels(samples);
+        });
+        const DSP::ChannelLevelMeter meter = runFused(samples, channels, std::move(stages));
+        levels = meter.levels();
+        result.channelLevels = meter.channelLevels();
+        levelsKnown = true;
+        ++result.fusedPasses;
+    }
+
+    if (!levelsKnown) {
+        const DSP::ChannelLevelMeter meter = DSP::measureChannelLevels(samples, channels);
+        levels = meter.levels();
+        result.channelLevels = meter.channelLevels();
+        ++result.analysisPasses;
+    }
+    result.levels = levels;
+    return result;
+}
+
+// --- Stream ---
+
+struct ProcessingChain::Stream::Pass {
+    FusedPass fused;
+    size_t nextStep;
+};
+
+bool ProcessingChain::Stream::canStream(const ProcessingChain& chain, std::optional<DSP::Levels> inputLevels) {
+    if (chain.empty()) return false;
+    // Only a leading normalize needs the level of the whole input
+    const Step& first = chain.steps().front();
+    return inputLevels || std::holds_alternative<Compress>(first) || std::holds_alternative<Limit>(first);
+}
+
+ProcessingChain::Stream::Stream(const ProcessingChain& chain, std::span<float> samples, int sampleRate,
+                                int channels, std::optional<DSP::Levels> inputLevels)
+    : chain_(chain)
+    , samples_(samples)
+    , sampleRate_(sampleRate)
+    , channels_(channels)
+    , inputLevels_(inputLevels)
+{
+    if (!canStream(chain, inputLevels) || samples.empty() || channels <= 0 || sampleRate <= 0) return;
+    DSP::Levels levels = inputLevels.value_or(DSP::Levels{});
+    bool levelsKnown = inputLevels.has_value();
+    size_t next = 0;
+    // canStream() rules out a normalize that would have to measure the input
+    auto stages = planPass(chain.steps(), next, sampleRate, levels, levelsKnown, [] { return DSP::Levels{}; });
+    pass_ = std::make_unique<Pass>(Pass{FusedPass(samples, channels, std::move(stages)), next});
+}
+
+ProcessingChain::Stream::~Stream() = default;
+
+void ProcessingChain::Stream::feed(size_t frames) {
+    fed_ += frames;
+    if (pass_) pass_->fused.feed(frames);
+}
+
+ProcessingChain::Result ProcessingChain::Stream::finish() {
+    WOOSH_TRACE_SCOPE("ProcessingChain::Stream::finish");
+    const auto ch = static_cast<size_t>(std::max(channels_, 1));
+    const auto samples = samples_.first(std::min(fed_ * ch, samples_.size()));
+    if (!pass_) return chain_.run(samples, sampleRate_, channels_, inputLevels_);
+
+    Result result;
+    const DSP::ChannelLevelMeter meter = pass_->fused.finish();
+    result.channelLevels = meter.channelLevels();
+    result.fusedPasses = 1;
+    return chain_.runPasses(pass_->nextStep, samples, sampleRate_, channels_, meter.levels(), true,
+                            std::move(result));
+}
@@ -0,0 +1,141 @@
+/**
+ * @file ProcessingChain.h
+ * @brief A sequence of processing operations run as fused block passes.
+ *
+ * Running normalize and compress one after the other streams the whole clip
+ * through the cache once per operation, plus twice more per operation to
+ * refresh the peak/RMS metrics. A ProcessingChain instead applies every
+ * operation to one cache-sized block before moving on to the next, and
+ * measures the output levels as it writes them, so a chain costs one read
+ * and one write of the audio.
+ *
+ * Normalization needs a level of its whole input. At the start of a chain
+ * that level is either supplied by the caller (the clip's current metrics)
+ * or measured in a read-only pass; after a gain it follows arithmetically.
+ * Only a normalize that comes after a compressor has to wait for the
+ * compressor's output, which splits the chain into two passes.
+ *
+ * A limiter looks ahead of the block it is limiting, so it runs last in its
+ * pass, trailing the other stages by its look-ahead; steps after it start a
+ * new pass.
+ *
+ * A Stream runs the first pass over frames as they become available, e.g.
+ * while later parts of a long file are still decoding (see FrameRanges).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+#include "utils/DSP.h"
+
+class ProcessingChain final {
+public:
+    struct NormalizePeak {
+        float targetDbFS;
+    };
+    struct NormalizeRms {
+        float targetDb;
+    };
+    struct Compress {
+        DSP::CompressorSettings settings;
+    };
+    struct Limit {
+        DSP::LimiterSettings settings;
+    };
+    using Step = std::variant<NormalizePeak, NormalizeRms, Compress, Limit>;
+
+    /** @brief What running a chain measured and how many passes it took over the audio. */
+    struct Result {
+        DSP::Levels levels{};       ///< Peak/RMS of the processed samples
+        int analysisPasses{0};      ///< Read-only passes to measure a level for normalization
+        int fusedPasses{0};         ///< Read-modify-write passes
+        std::vector<DSP::Levels> channelLevels;   ///< Peak/RMS of each channel; empty if not measured
+    };
+
+    ProcessingChain& normalizeToPeak(float targetDbFS);
+    ProcessingChain& normalizeToRms(float targetDb);
+    ProcessingChain& compress(const DSP::CompressorSettings& settings);
+    ProcessingChain& limit(const DSP::LimiterSettings& settings);
+
+    [[nodiscard]] bool empty() const noexcept { return steps_.empty(); }
+    [[nodiscard]] const std::vector<Step>& steps() const noexcept { return steps_; }
+
+    /**
+     * @brief Run the chain over interleaved samples in place.
+     *
+     * The result matches running the DSP functions one after the other,
+     * up to float rounding.
+     *
+     * @param samples Interleaved samples to process.
+     * @param sampleRate Sample rate in Hz (for compressor and limiter time constants).
+     * @param channels Number of interleaved channels.
+     * @param inputLevels Levels of @p samples if already known; saves the analysis pass
+     *                    a leading normalize would otherwise need.
+     */
+    Result run(std::span<float> samples, int sampleRate, int channels,
+               std::optional<DSP::Levels> inputLevels = std::nullopt) const;
+
+    class Stream;
+
+private:
+    /// Run the passes from steps_[next] on; @p levels are those of @p samples if @p levelsKnown.
+    Result runPasses(size_t next, std::span<float> samples, int sampleRate, int channels, DSP::Levels levels,
+                     bool levelsKnown, Result result) const;
+
+    std::vector<Step> steps_;
+};
+
+/**
+ * @brief Runs a chain over samples that are filled in order, starting before they are complete.
+ *
+ * The first pass processes frames as feed() announces them, so a serial
+ * stage such as the compressor keeps up with the decoder instead of waiting
+ * for the whole file; finish() completes it and runs any further passes
+ * over the whole output. The result matches run() over the same samples.
+ *
+ * A chain that starts with a normalize needs the level of its whole input
+ * first, unless it is known; such a chain only runs in finish().
+ */
+class ProcessingChain::Stream final {
+public:
+    /** @brief Whether the first pass of @p chain can run before its input is complete. */
+    [[nodiscard]] static bool canStream(const ProcessingChain& chain,
+                                        std::optional<DSP::Levels> inputLevels = std::nullopt);
+
+    /**
+     * @param chain Chain to run; must outlive the stream.
+     * @param samples Interleaved samples the caller fills in order and processes in place.
+     */
+    Stream(const ProcessingChain& chain, std::span<float> samples, int sampleRate, int channels,
+           std::optional<DSP::Levels> inputLevels = std::nullopt);
+    ~Stream();
+
+    Stream(const Stream&) = delete;
+    Stream& operator=(const Stream&) = delete;
+
+    /** @brief The next @p frames frames of the samples are filled in. */
+    void feed(size_t frames);
+
+    /** @brief Frames fed so far. */
+    [[nodiscard]] size_t framesFed() const noexcept { return fed_; }
+
+    /** @brief Finish the chain; frames that were never fed are left out of it. */
+    Result finish();
+
+private:
+    struct Pass;
+
+    const ProcessingChain& chain_;
+    std::span<float> samples_;
+    int sampleRate_;
+    int channels_;
+    std::optional<DSP::Levels> inputLevels_;
+    std::unique_ptr<Pass> pass_;    ///< Null if the first pass has to wait for finish()
+    size_t fed_{0};
+};
@@ -0,0 +1,793 @@
+/**
+ * @file WooshBench.cpp
+ * @brief Micro and macro benchmarks for Woosh's audio pipeline.
+ *
+ * Runs DSP kernels, codecs, batch file reads, fingerprinting, waveform
+ * column computation, 16-bit clip storage and project serialization over synthetic data and emits JSON with throughput figures,
+ * so regressions can be tracked release-over-release on the same hardware.
+ * Decode cases report MB/s of the encoded file; project cases count clip
+ * states as "samples". Every case also reports heap allocations per
+ * iteration, counted by replacing the global operator new.
+ *
+ * Usage:
+ *   WooshBench [--frames N] [--channels N] [--rate HZ] [--iterations N]
+ *              [--clips N] [--width N] [--filter TEXT] [--out FILE]
+ */
+
+#include "audio/AudioClip.h"
+#include "audio/AudioEngine.h"
+#include "audio/CompactSamples.h"
+#include "audio/Formats/Mp3Codec.h"
+#include "audio/Formats/Mp3Encoder.h"
+#include "audio/Formats/RiffWav.h"
+#include "audio/Formats/WavCodec.h"
+#include "audio/ProcessingChain.h"
+#include "core/FingerprintIndex.h"
+#include "core/Project.h"
+#include "ui/WaveformViewHelpers.h"
+#include "utils/AsyncFileIO.h"
+#include "utils/BufferPool.h"
+#include "utils/DSP.h"
+#include "utils/Fingerprint.h"
+#include "utils/FrameRanges.h"
+#include "utils/JsonEscape.h"
+#include "utils/SpeakerLayout.h"
+#include "Version.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace {
+std::atomic<size_t> gAllocations{0};
+
+void* countedAlloc(size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* countedAlignedAlloc(size_t size, std::align_val_t align) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    const auto alignment = std::max(static_cast<size_t>(align), sizeof(void*));
+    const size_t rounded = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+#ifdef _WIN32
+    if (void* p = _aligned_malloc(rounded, alignment)) return p;
+#else
+    if (void* p = std::aligned_alloc(alignment, rounded)) return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void alignedFree(void* p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+} // namespace
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void* operator new(size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align) { return countedAlignedAlloc(size, align); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+
+namespace {
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+struct BenchConfig {
+    size_t frames{44100 * 10};      ///< Frames per synthetic clip
+    int channels{2};
+    int sampleRate{44100};
+    int iterations{5};              ///< Timed runs per case (plus one warm-up)
+    int clips{1000};                ///< Clip states in the project benchmark, sounds in fingerprint.cluster
+    int waveformWidth{1920};        ///< Pixel columns for waveform computation
+    std::string filter;             ///< Only run cases whose name contains this
+    std::string outPath;            ///< JSON destination (stdout if empty)
+};
+
+struct BenchResult {
+    std::string name;
+    int iterations{0};
+    double samples{0.0};            ///< Samples processed per iteration
+    double bytes{0.0};              ///< Bytes consumed per iteration
+    double minSec{0.0};
+    double medianSec{0.0};
+    double allocations{0.0};        ///< Heap allocations per timed iteration
+};
+
+void printUsage() {
+    std::cerr <<
+        "Usage: WooshBench [options]\n"
+        "  --frames N       Frames per synthetic clip (default 441000)\n"
+        "  --channels N     Channel count (default 2)\n"
+        "  --rate HZ        Sample rate (default 44100)\n"
+        "  --iterations N   Timed iterations per case (default 5)\n"
+        "  --clips N        Clip states for project load/save, sounds for fingerprint.cluster (default 1000)\n"
+        "  --width N        Waveform columns (default 1920)\n"
+        "  --filter TEXT    Only run cases whose name contains TEXT\n"
+        "  --out FILE       Write JSON to FILE instead of stdout\n";
+}
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const std::string value = argv[++i];
+        try {
+            if (arg == "--frames") config.frames = std::stoull(value);
+            else if (arg == "--channels") config.channels = std::stoi(value);
+            else if (arg == "--rate") config.sampleRate = std::stoi(value);
+            else if (arg == "--iterations") config.iterations = std::stoi(value);
+            else if (arg == "--clips") config.clips = std::stoi(value);
+            else if (arg == "--width") config.waveformWidth = std::stoi(value);
+            else if (arg == "--filter") config.filter = value;
+            else if (arg == "--out") config.outPath = value;
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return false;
+        }
+    }
+
+    if (config.frames == 0 || config.channels <= 0 || config.sampleRate <= 0 ||
+        config.iterations <= 0 || config.clips < 0 || config.waveformWidth <= 0) {
+        std::cerr << "All sizes must be positive\n";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Synthetic data
+// ============================================================================
+
+/// Decaying tone bursts over low-level noise: exercises the compressor's
+/// attack/release paths and gives the MP3 encoder realistic content.
+std::vector<float> makeSignal(size_t frames, int channels, int sampleRate) {
+    std::vector<float> data(frames * static_cast<size_t>(channels));
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.02f, 0.02f);
+
+    constexpr double kTwoPi = 2.0 * 3.14159265358979323846;
+    const size_t burstFrames = static_cast<size_t>(sampleRate) / 4;
+    for (size_t i = 0; i < frames; ++i) {
+        const double t = static_cast<double>(i) / sampleRate;
+        const double envelope = std::exp(-8.0 * static_cast<double>(i % burstFrames) / sampleRate);
+        for (int c = 0; c < channels; ++c) {
+            const double freq = 220.0 * (c + 1);
+            data[i * static_cast<size_t>(channels) + static_cast<size_t>(c)] =
+                static_cast<float>(0.8 * envelope * std::sin(kTwoPi * freq * t)) + noise(rng);
+        }
+    }
+    return data;
+}
+
+// ============================================================================
+// Timing
+// ============================================================================
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchConfig& config) : config_(config) {}
+
+    /**
+     * @brief Time a case.
+     * @param prepare Untimed setup before every run (e.g. restoring a buffer).
+     * @param body The timed operation; returns false on failure.
+     */
+    void run(const std::string& name, double samples, double bytes,
+             const std::function<void()>& prepare,
+             const std::function<bool()>& body) {
+        if (!config_.filter.empty() && name.find(config_.filter) == std::string::npos) {
+            return;
+        }
+
+        std::cerr << "  " << name << "..." << std::flush;
+
+        // Warm-up run primes caches and lazily initialized libraries
+        prepare();
+        if (!body()) {
+            std::cerr << " failed\n";
+            failures_++;
+            return;
+        }
+
+        std::vector<double> times;
+        times.reserve(static_cast<size_t>(config_.iterations));
+        size_t allocations = 0;
+        for (int i = 0; i < config_.iterations; ++i) {
+            prepare();
+            const size_t allocsBefore = gAllocations.load(std::memory_order_relaxed);
+            const auto start = std::chrono::steady_clock::now();
+            const bool ok = body();
+            const auto end = std::chrono::steady_clock::now();
+            allocations += gAllocations.load(std::memory_order_relaxed) - allocsBefore;
+            if (!ok) {
+                std::cerr << " failed\n";
+                failures_++;
+                return;
+            }
+            times.push_back(std::chrono::duration<double>(end - start).count());
+        }
+
+        std::sort(times.begin(), times.end());
+        BenchResult result;
+        result.name = name;
+        result.iterations = config_.iterations;
+        result.samples = samples;
+        result.bytes = bytes;
+        result.minSec = times.front();
+        result.medianSec = times[times.size() / 2];
+        result.allocations = static_cast<double>(allocations) / config_.iterations;
+        results_.push_back(result);
+
+        std::cerr << " " << result.medianSec * 1000.0 << " ms\n";
+    }
+
+    [[nodiscard]] const std::vector<BenchResult>& results() const noexcept { return results_; }
+    [[nodiscard]] int failures() const noexcept { return failures_; }
+
+private:
+    const BenchConfig& config_;
+    std::vector<BenchResult> results_;
+    int failures_{0};
+};
+
+// ============================================================================
+// JSON output
+// ============================================================================
+
+std::string toJson(const BenchConfig& config, const std::vector<BenchResult>& results) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\n";
+    ss << "  \"version\": \"" << WOOSH_VERSION_STRING << "\",\n";
+    ss << "  \"config\": {\n";
+    ss << "    \"frames\": " << config.frames << ",\n";
+    ss << "    \"channels\": " << config.channels << ",\n";
+    ss << "    \"sampleRate\": " << config.sampleRate << ",\n";
+    ss << "    \"iterations\": " << config.iterations << ",\n";
+    ss << "    \"clips\": " << config.clips << ",\n";
+    ss << "    \"waveformWidth\": " << config.waveformWidth << "\n";
+    ss << "  },\n";
+    ss << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        const double samplesPerSec = r.medianSec > 0.0 ? r.samples / r.medianSec : 0.0;
+        const double mbPerSec = r.medianSec > 0.0 ? r.bytes / 1.0e6 / r.medianSec : 0.0;
+        ss << "    {\n";
+        ss << "      \"name\": \"" << escapeJson(r.name) << "\",\n";
+        ss << "      \"iterations\": " << r.iterations << ",\n";
+        ss << "      \"samples\": " << static_cast<long long>(r.samples) << ",\n";
+        ss << "      \"bytes\": " << static_cast<long long>(r.bytes) << ",\n";
+        ss << "      \"minMs\": " << r.minSec * 1000.0 << ",\n";
+        ss << "      \"medianMs\": " << r.medianSec * 1000.0 << ",\n";
+        ss << "      \"samplesPerSec\": " << samplesPerSec << ",\n";
+        ss << "      \"mbPerSec\": " << mbPerSec << ",\n";
+        ss << "      \"allocsPerIter\": " << r.allocations << "\n";
+        ss << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    ss << "  ]\n";
+    ss << "}\n";
+    return ss.str();
+}
+
+// ============================================================================
+// Cases
+// ============================================================================
+
+void benchDsp(BenchRunner& runner, const BenchConfig& config, const std::vector<float>& signal) {
+    const double samples = static_cast<double>(signal.size());
+    const double bytes = samples * sizeof(float);
+    std::vector<float> work;
+    auto reset = [&] { work = signal; };
+    auto noop = [] {};
+
+    runner.run("dsp.peak", samples, bytes, noop, [&] {
+        volatile float peak = DSP::computePeakDbFS(signal);
+        (void)peak;
+        return true;
+    });
+    runner.run("dsp.rms", samples, bytes, noop, [&] {
+        volatile float rms = DSP::computeRMSDb(signal);
+        (void)rms;
+        return true;
+    });
+    runner.run("dsp.normalizePeak", samples, bytes, reset, [&] {
+        DSP::normalizeToPeak(work, -1.0f);
+        return true;
+    });
+    runner.run("dsp.normalizeRms", samples, bytes, reset, [&] {
+        DSP::normalizeToRMS(work, -18.0f);
+        return true;
+    });
+    runner.run("dsp.compressor", samples, bytes, reset, [&] {
+        DSP::compressor(work, -12.0f, 4.0f, 10.0f, 100.0f, 0.0f, config.sampleRate, config.channels);
+        return true;
+    });
+    runner.run("dsp.limiter", samples, bytes, reset, [&] {
+        DSP::limiter(work, {-1.0f, 5.0f, 50.0f}, config.sampleRate, config.channels);
+        return true;
+    });
+    runner.run("dsp.limiter.long", samples, bytes, reset, [&] {
+        // 200 ms look-ahead: per-frame cost must not grow with the window
+        DSP::limiter(work, {-1.0f, 200.0f, 200.0f}, config.sampleRate, config.channels);
+        return true;
+    });
+    runner.run("dsp.fades", samples, bytes, reset, [&] {
+        // 50 ms S-curve fades at both ends, as applied on export
+        const auto fadeFrames = static_cast<size_t>(config.sampleRate / 20);
+        DSP::applyFadeIn(work, fadeFrames, DSP::FadeType::SCurve, config.channels);
+        DSP::applyFadeOut(work, fadeFrames, DSP::FadeType::SCurve, config.channels);
+        return true;
+    });
+
+    // Playback buffer conversion with the same fades
+    std::vector<int16_t> pcm(signal.size());
+    runner.run("dsp.toInt16", samples, bytes, noop, [&] {
+        const auto fadeFrames = static_cast<size_t>(config.sampleRate / 20);
+        DSP::convertToInt16(signal.data(), pcm.data(), config.frames, config.channels,
+                            {fadeFrames, fadeFrames, DSP::FadeType::SCurve});
+        return true;
+    });
+
+    // Per-channel levels, and the stereo downmix the MP3 encoder and playback
+    // use for more than two channels (a plain deinterleave for stereo)
+    runner.run("dsp.channelLevels", samples, bytes, noop, [&] {
+        volatile float peak = DSP::measureChannelLevels(signal, config.channels).levels().peakDb;
+        (void)peak;
+        return true;
+    });
+    const auto downmix = SpeakerLayout::mixMatrix(config.channels, 2);
+    std::vector<float> left(config.frames);
+    std::vector<float> right(config.frames);
+    float* const planes[] = {left.data(), right.data()};
+    runner.run("dsp.downmix", samples, bytes, noop, [&] {
+        DSP::mixChannels(signal.data(), config.frames, config.channels, downmix.data(), 2, planes);
+        return true;
+    });
+
+    // Normalize + compress with metrics after each step, one full pass per
+    // operation, against the same work as a fused chain
+    const DSP::CompressorSettings comp{-12.0f, 4.0f, 10.0f, 100.0f, 0.0f};
+    runner.run("chain.sequential", samples, bytes, reset, [&] {
+        DSP::normalizeToPeak(work, -1.0f);
+        volatile float peak = DSP::computePeakDbFS(work);
+        volatile float rms = DSP::computeRMSDb(work);
+        DSP::compressor(work, comp.thresholdDb, comp.ratio, comp.attackMs, comp.releaseMs, comp.makeupDb,
+                        config.sampleRate, config.channels);
+        peak = DSP::computePeakDbFS(work);
+        rms = DSP::computeRMSDb(work);
+        (void)peak;
+        (void)rms;
+        return true;
+    });
+    const auto inputLevels = DSP::measureLevels(signal);
+    const auto chain = ProcessingChain().normalizeToPeak(-1.0f).compress(comp);
+    runner.run("chain.fused", samples, bytes, reset, [&] {
+        return chain.run(work, config.sampleRate, config.channels, inputLevels).fusedPasses == 1;
+    });
+}
+
+void benchCodecs(BenchRunner& runner, const BenchConfig& config,
+                 const std::vector<float>& signal, const fs::path& workDir) {
+    const double samples = static_cast<double>(signal.size());
+    const double pcmBytes = samples * sizeof(float);
+    const AudioClip clip("bench.wav", config.sampleRate, config.channels, signal);
+    auto noop = [] {};
+
+    const std::string wavPath = (workDir / "bench.wav").string();
+    const std::string mp3Path = (workDir / "bench.mp3").string();
+
+    // The in-tree RIFF path against libsndfile, for writing 16-bit PCM and
+    // for reading each sample format the fast path handles
+    WavCodec wavCodec;
+    WavCodec sndfileCodec;
+    sndfileCodec.setFastPathEnabled(false);
+    for (WavCodec* codec : {&wavCodec, &sndfileCodec}) {
+        const std::string suffix = codec->isFastPathEnabled() ? "" : ".sndfile";
+        runner.run("wav.encode" + suffix, samples, pcmBytes, noop, [&] {
+            return codec->write(wavPath, clip);
+        });
+    }
+
+    std::error_code ec;
+    struct DecodeCase { const char* name; RiffWav::SampleFormat format; };
+    for (const DecodeCase c : {DecodeCase{"wav.decode", RiffWav::SampleFormat::Pcm16},
+                               DecodeCase{"wav.decode.pcm24", RiffWav::SampleFormat::Pcm24},
+                               DecodeCase{"wav.decode.float", RiffWav::SampleFormat::Float32}}) {
+        const std::string path = (workDir / (std::string(c.name) + ".wav")).string();
+        if (!RiffWav::write(path, signal.data(), signal.size() / static_cast<size_t>(config.channels),
+                            config.channels, config.sampleRate, {}, c.format)) {
+            std::cerr << "  could not write " << path << ", skipping " << c.name << "\n";
+            continue;
+        }
+        const double wavBytes = static_cast<double>(fs::file_size(path, ec));
+        for (WavCodec* codec : {&wavCodec, &sndfileCodec}) {
+            const std::string suffix = codec->isFastPathEnabled() ? "" : ".sndfile";
+            runner.run(c.name + suffix, samples, wavBytes, noop, [&] {
+                return codec->read(path).has_value();
+            });
+        }
+    }
+
+    // MP3 encode is stereo/mono only
+    if (config.channels > 2) {
+        std::cerr << "  mp3 cases skipped for " << config.channels << " channels\n";
+        return;
+    }
+
+    Mp3Encoder encoder;
+    runner.run("mp3.encode", samples, pcmBytes, noop, [&] {
+        return encoder.encode(clip, mp3Path, Mp3Encoder::BitrateMode::CBR_192);
+    });
+
+    std::string error;
+    if (!fs::exists(mp3Path, ec)
+        && !encoder.encode(clip, mp3Path, Mp3Encoder::BitrateMode::CBR_192, {}, {}, &error)) {
+        std::cerr << "  could not write " << mp3Path << ": " << error << "\n";
+        return;
+    }
+
+    Mp3Codec mp3Codec;
+    const double mp3Bytes = static_cast<double>(fs::file_size(mp3Path, ec));
+    runner.run("mp3.decode", samples, mp3Bytes, noop, [&] {
+        return mp3Codec.read(mp3Path).has_value();
+    });
+}
+
+/// Read a batch of WAV files one after another, then with all reads in
+/// flight on the AsyncFileIO backend and on its thread-pool fallback. From
+/// the page cache this shows the submission overhead; point TMPDIR at slow
+/// or network storage to see the latency the batch pipeline overlaps.
+void benchFileIO(BenchRunner& runner, const BenchConfig& config,
+                 const std::vector<float>& signal, const fs::path& workDir) {
+    constexpr int kFiles = 32;
+    const fs::path dir = workDir / "io";
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+
+    std::vector<std::string> paths;
+    double totalBytes = 0.0;
+    for (int i = 0; i < kFiles; ++i) {
+        paths.push_back((dir / ("clip_" + std::to_string(i) + ".wav")).string());
+        if (!RiffWav::write(paths.back(), signal.data(), signal.size() / static_cast<size_t>(config.channels),
+                            config.channels, config.sampleRate)) {
+            std::cerr << "  could not write " << paths.back() << ", skipping io cases\n";
+            return;
+        }
+        totalBytes += static_cast<double>(fs::file_size(paths.back(), ec));
+    }
+    const double samples = static_cast<double>(signal.size()) * kFiles;
+    auto noop = [] {};
+
+    runner.run("io.read.sync", samples, totalBytes, noop, [&] {
+        for (const auto& path : paths) {
+            std::ifstream in(path, std::ios::binary);
+            const std::vector<char> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            if (data.empty()) return false;
+        }
+        return true;
+    });
+
+    for (const bool threadPool : {false, true}) {
+        AsyncFileIO::Options options;
+        options.forceThreadPool = threadPool;
+        AsyncFileIO io(options);
+        if (!threadPool && io.backend() != AsyncFileIO::Backend::IoUring) {
+            std::cerr << "  io_uring unavailable, io.read.async runs on the thread pool\n";
+        }
+        runner.run(threadPool ? "io.read.pool" : "io.read.async", samples, totalBytes, noop, [&] {
+            for (size_t i = 0; i < paths.size(); ++i) io.read(i, paths[i]);
+            bool ok = true;
+            while (io.pending() > 0) {
+                for (const auto& completion : io.wait()) ok = ok && completion.ok;
+            }
+            return ok;
+        });
+    }
+}
+
+/// Export through AudioEngine without fades as a baseline, then with fades
+/// once with pooled scratch buffers and once with the pool disabled, to
+/// show that streamed fades cost about the same as a plain export.
+void benchExport(BenchRunner& runner, const BenchConfig& config,
+                 const std::vector<float>& signal, const fs::path& workDir) {
+    const double samples = static_cast<double>(signal.size());
+    const double pcmBytes = samples * sizeof(float);
+    const AudioClip clip((workDir / "export.wav").string(), config.sampleRate, config.channels, signal);
+    const std::string outFolder = (workDir / "out").string();
+    const int fadeFrames = config.sampleRate / 20;
+    auto noop = [] {};
+
+    AudioEngine engine;
+    runner.run("export.wav", samples, pcmBytes, noop, [&] {
+        return engine.exportWav(clip, outFolder);
+    });
+    if (config.channels <= 2) {
+        runner.run("export.mp3", samples, pcmBytes, noop, [&] {
+            return engine.exportMp3(clip, outFolder, Mp3Encoder::BitrateMode::CBR_192);
+        });
+    }
+
+    for (bool pooled : {true, false}) {
+        const std::string suffix = pooled ? ".pooled" : ".unpooled";
+        BufferPool::setEnabled(pooled);
+        BufferPool::local().clear();
+
+        runner.run("export.wav.fades" + suffix, samples, pcmBytes, noop, [&] {
+            return engine.exportWav(clip, outFolder, fadeFrames, fadeFrames);
+        });
+        if (config.channels <= 2) {
+            runner.run("export.mp3.fades" + suffix, samples, pcmBytes, noop, [&] {
+                return engine.exportMp3(clip, outFolder, Mp3Encoder::BitrateMode::CBR_192, {},
+                                        fadeFrames, fadeFrames);
+            });
+        }
+    }
+    BufferPool::setEnabled(true);
+
+    // Trim works in place, so its only allocations come from the prepare copy
+    AudioClip work;
+    runner.run("engine.trim", samples, pcmBytes, [&] { work = clip; }, [&] {
+        engine.trim(work, 0.1f, 0.0f);
+        return true;
+    });
+
+    // Silence scan over a clip whose first and last quarter are silent
+    std::vector<float> padded(signal.begin(), signal.end());
+    const size_t quarter = (padded.size() / static_cast<size_t>(config.channels) / 4) * static_cast<size_t>(config.channels);
+    std::fill(padded.begin(), padded.begin() + static_cast<std::ptrdiff_t>(quarter), 0.0f);
+    std::fill(padded.end() - static_cast<std::ptrdiff_t>(quarter), padded.end(), 0.0f);
+    const AudioClip paddedClip(clip.filePath(), clip.sampleRate(), clip.channels(), std::move(padded));
+    runner.run("engine.autoTrim", samples, pcmBytes, [&] { work = paddedClip; }, [&] {
+        return engine.autoTrim(work, {-50.0f, 10.0f, 100.0f});
+    });
+
+    // A 16-bit file twice the size at which decoding splits into frame ranges,
+    // compressed and limited after the load against while it decodes; written
+    // by the first prepare() so filtered-out runs skip it
+    const std::string longPath = (workDir / "long.wav").string();
+    const size_t longFrames = 2 * FrameRanges::kMinSplitBytes / (2 * static_cast<size_t>(config.channels));
+    const double longSamples = static_cast<double>(longFrames) * config.channels;
+    const auto chain = ProcessingChain().compress({-18.0f, 3.0f, 5.0f, 80.0f, 0.0f}).limit({-1.0f, 5.0f, 50.0f});
+    bool longWritten = false;
+    auto writeLong = [&] {
+        if (longWritten) return;
+        std::vector<float> tiled(longFrames * static_cast<size_t>(config.channels));
+        for (size_t i = 0; i < tiled.size(); i += signal.size()) {
+            std::copy_n(signal.begin(), std::min(signal.size(), tiled.size() - i), tiled.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        longWritten = RiffWav::write(longPath, tiled.data(), longFrames, config.channels, config.sampleRate);
+    };
+    runner.run("engine.long.loadThenProcess", longSamples, longSamples * 2, writeLong, [&] {
+        auto loaded = engine.loadClip(longPath);
+        if (!loaded) return false;
+        loaded->saveOriginal();
+        engine.process(*loaded, chain);
+        return true;
+    });
+    runner.run("engine.long.loadProcessed", longSamples, longSamples * 2, writeLong, [&] {
+        return engine.loadProcessed(longPath, {}, 0.0f, 0.0f, chain).has_value();
+    });
+}
+
+void benchFingerprint(BenchRunner& runner, const BenchConfig& config, const std::vector<float>& signal) {
+    const double samples = static_cast<double>(signal.size());
+    runner.run("fingerprint.compute", samples, samples * sizeof(float), [] {}, [&] {
+        return !fingerprintSamples(signal, config.sampleRate, config.channels).landmarks.empty();
+    });
+
+    // A library of --clips short sounds, every tenth one a quieter copy of the one
+    // before; built by the first prepare() so filtered-out runs skip it
+    FingerprintIndex index;
+    auto buildLibrary = [&] {
+        if (index.size() > 0) return;
+        constexpr double kTwoPi = 2.0 * 3.14159265358979323846;
+        const size_t clipFrames = static_cast<size_t>(config.sampleRate);
+        const size_t channels = static_cast<size_t>(config.channels);
+        const size_t noteFrames = clipFrames / 8;
+        std::mt19937 rng(99);
+        std::vector<float> clip(clipFrames * channels);
+        for (int i = 0; i < config.clips; ++i) {
+            if (i % 10 == 9) {
+                for (float& s : clip) s *= 0.5f;
+            } else {
+                double freq = 0.0;
+                for (size_t f = 0; f < clipFrames; ++f) {
+                    if (f % noteFrames == 0) freq = 200.0 + static_cast<double>(rng() % 4000);
+                    const double t = static_cast<double>(f % noteFrames) / config.sampleRate;
+                    const auto x = static_cast<float>(0.5 * std::exp(-12.0 * t) * std::sin(kTwoPi * freq * t));
+                    std::fill_n(clip.begin() + static_cast<std::ptrdiff_t>(f * channels), channels, x);
+                }
+            }
+            index.add("sfx/clip_" + std::to_string(i) + ".wav", 0, 0,
+                      fingerprintSamples(clip, config.sampleRate, config.channels));
+        }
+    };
+
+    runner.run("fingerprint.cluster", static_cast<double>(config.clips), 0.0, buildLibrary, [&] {
+        return !index.findDuplicates().empty();
+    });
+}
+
+void benchWaveform(BenchRunner& runner, const BenchConfig& config, const std::vector<float>& signal) {
+    const double samples = static_cast<double>(signal.size());
+    const double bytes = samples * sizeof(float);
+    const double samplesPerPixel = static_cast<double>(config.frames) / config.waveformWidth;
+
+    runner.run("waveform.columns", samples, bytes, [] {}, [&] {
+        auto columns = computeWaveformColumns(signal.data(), signal.size(), config.channels,
+                                              0, samplesPerPixel, config.waveformWidth);
+        return !columns.empty();
+    });
+}
+
+void benchStorage(BenchRunner& runner, const BenchConfig& config, const std::vector<float>& signal) {
+    const double samples = static_cast<double>(signal.size());
+    const double bytes = samples * sizeof(float);
+
+    // What a 16-bit source decodes to: stored exactly
+    std::vector<float> pcm16(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i) {
+        pcm16[i] = std::nearbyint(std::clamp(signal[i], -1.0f, 32767.0f / 32768.0f) * 32768.0f) / 32768.0f;
+    }
+
+    runner.run("clip.compact16.exact", samples, bytes, [] {}, [&] {
+        return CompactSamples::encode(pcm16.data(), config.frames, config.channels, false).has_value();
+    });
+    runner.run("clip.compact16.scaled", samples, bytes, [] {}, [&] {
+        return CompactSamples::encode(signal.data(), config.frames, config.channels, true).has_value();
+    });
+
+    const auto compact = CompactSamples::encode(signal.data(), config.frames, config.channels, true);
+    std::vector<float> out(signal.size());
+    runner.run("clip.expand16", samples, bytes, [] {}, [&] {
+        compact->decode(0, config.frames, out.data());
+        return true;
+    });
+}
+
+void benchProject(BenchRunner& runner, const BenchConfig& config, const fs::path& workDir) {
+    Project project;
+    project.setName("Bench");
+    project.setRawFolder((workDir / "raw").string());
+    project.setGameFolder((workDir / "game").string());
+    for (int i = 0; i < config.clips; ++i) {
+        ClipState state;
+        state.relativePath = "sfx/category_" + std::to_string(i % 16) + "/clip_" + std::to_string(i) + ".wav";
+        state.isNormalized = true;
+        state.normalizeTargetDb = -1.0;
+        state.isCompressed = (i % 2) == 0;
+        state.compressorSettings = {-12.0f, 4.0f, 10.0f, 100.0f, 2.0f};
+        state.isTrimmed = (i % 3) == 0;
+        state.trimStartSec = 0.125;
+        state.trimEndSec = 1.5;
+        state.fadeInFrames = 441;
+        state.fadeOutFrames = 2205;
+        state.exportedFilename = "clip_" + std::to_string(i) + ".mp3";
+        project.addClipState(state);
+    }
+
+    const std::string projectPath = (workDir / "bench.wooshp").string();
+    auto noop = [] {};
+
+    if (!project.save(projectPath)) {
+        std::cerr << "  could not write " << projectPath << ", skipping project cases\n";
+        return;
+    }
+
+    std::error_code ec;
+    const double fileBytes = static_cast<double>(fs::file_size(projectPath, ec));
+    const double items = static_cast<double>(config.clips);
+
+    runner.run("project.save", items, fileBytes, noop, [&] {
+        return project.save(projectPath);
+    });
+    runner.run("project.load", items, fileBytes, noop, [&] {
+        return Project::load(projectPath).has_value();
+    });
+}
+
+} // namespace
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        printUsage();
+        return 2;
+    }
+
+    std::error_code ec;
+    const fs::path workDir = fs::temp_directory_path(ec) /
+        ("woosh-bench-" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(workDir, ec);
+    if (ec) {
+        std::cerr << "Could not create " << workDir.string() << ": " << ec.message() << "\n";
+        return 1;
+    }
+
+    std::cerr << "WooshBench " << WOOSH_VERSION_STRING << ": "
+              << config.frames << " frames x " << config.channels << " ch @ "
+              << config.sampleRate << " Hz, " << config.iterations << " iterations\n";
+
+    const std::vector<float> signal = makeSignal(config.frames, config.channels, config.sampleRate);
+
+    BenchRunner runner(config);
+    benchDsp(runner, config, signal);
+    benchCodecs(runner, config, signal, workDir);
+    benchFileIO(runner, config, signal, workDir);
+    benchExport(runner, config, signal, workDir);
+    benchFingerprint(runner, config, signal);
+    benchWaveform(runner, config, signal);
+    benchStorage(runner, config, signal);
+    benchProject(runner, config, workDir);
+
+    fs::remove_all(workDir, ec);
+
+    const std::string json = toJson(config, runner.results());
+    if (config.outPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(config.outPath);
+        if (!out) {
+            std::cerr << "Could not write " << config.outPath << "\n";
+            return 1;
+        }
+        out << json;
+    }
+
+    return runner.failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file BatchIO.cpp
+ * @brief I/O threads of the batch read-ahead and write-behind.
+ */
+
+#include "BatchIO.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+#include "utils/Trace.h"
+
+// --- FilePrefetcher ---
+
+FilePrefetcher::FilePrefetcher(std::vector<std::string> paths, AsyncFileIO::Options io, size_t budgetBytes)
+    : paths_(std::move(paths))
+    , budgetBytes_(budgetBytes)
+    , queueDepth_(std::max(1u, io.queueDepth))
+    , io_(io)
+    , states_(paths_.size(), State::Pending)
+    , contents_(paths_.size())
+    , reserved_(paths_.size(), 0)
+{
+    thread_ = std::thread([this] { run(); });
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    space_.notify_all();
+    thread_.join();
+}
+
+std::optional<std::vector<uint8_t>> FilePrefetcher::take(size_t index) {
+    std::unique_lock lock(mutex_);
+    ready_.wait(lock, [&] { return states_[index] != State::Pending; });
+    if (states_[index] != State::Ready) {
+        states_[index] = State::Taken;
+        return std::nullopt;
+    }
+    std::vector<uint8_t> data = std::move(contents_[index]);
+    contents_[index] = {};
+    states_[index] = State::Taken;
+    heldBytes_ -= data.size();
+    lock.unlock();
+    space_.notify_one();
+    return data;
+}
+
+size_t FilePrefetcher::peakBytes() {
+    std::lock_guard lock(mutex_);
+    return peakBytes_;
+}
+
+void FilePrefetcher::run() {
+    Trace::setThreadName("Batch prefetch");
+    size_t next = 0;
+    size_t sized = 0;   // Files whose size is known
+    while (true) {
+        // Sizes of the files that could be submitted next, read outside the lock
+        for (; sized < paths_.size() && sized < next + queueDepth_; ++sized) {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(paths_[sized], ec);
+            reserved_[sized] = ec ? 0 : static_cast<size_t>(size);
+        }
+
+        size_t submit = 0;
+        {
+            std::unique_lock lock(mutex_);
+            // Whole reads count from submission on; a file larger than the
+            // budget goes only when nothing else is held or in flight
+            auto fits = [&](size_t index) {
+                const size_t used = heldBytes_ + inFlightBytes_;
+                return used == 0 || used + reserved_[index] <= budgetBytes_;
+            };
+            if (io_.pending() == 0) {
+                space_.wait(lock, [&] { return stopping_ || next >= paths_.size() || fits(next); });
+            }
+            if (stopping_ || (next >= paths_.size() && io_.pending() == 0)) break;
+            while (next + submit < paths_.size() && io_.pending() + submit < queueDepth_ && fits(next + submit)) {
+                inFlightBytes_ += reserved_[next + submit];
+                ++submit;
+            }
+            peakBytes_ = std::max(peakBytes_, heldBytes_ + inFlightBytes_);
+        }
+
+        for (; submit > 0; --submit, ++next) {
+            io_.read(next, paths_[next]);
+        }
+        if (io_.pending() == 0) continue;
+
+        auto done = io_.wait();
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& completion : done) {
+                const auto index = static_cast<size_t>(completion.tag);
+                states_[index] = completion.ok ? State::Ready : State::Failed;
+                inFlightBytes_ -= reserved_[index];
+                heldBytes_ += completion.data.size();
+                contents_[index] = std::move(completion.data);
+            }
+            peakBytes_ = std::max(peakBytes_, heldBytes_ + inFlightBytes_);
+        }
+        ready_.notify_all();
+    }
+}
+
+// --- FileWriteBehind ---
+
+FileWriteBehind::FileWriteBehind(size_t count, AsyncFileIO::Options io, size_t budgetBytes)
+    : budgetBytes_(budgetBytes)
+    , queueDepth_(std::max(1u, io.queueDepth))
+    , io_(io)
+    , sizes_(count, 0)
+    , written_(count, 0)
+{
+    thread_ = std::thread([this] { run(); });
+}
+
+FileWriteBehind::~FileWriteBehind() {
+    if (thread_.joinable()) (void)finish();
+}
+
+void FileWriteBehind::write(size_t index, std::string path, std::vector<uint8_t> data) {
+    {
+        std::unique_lock lock(mutex_);
+        space_.wait(lock, [&] { return heldBytes_ == 0 || heldBytes_ < budgetBytes_; });
+        sizes_[index] = data.size();
+        heldBytes_ += data.size();
+        queue_.push_back({index, std::move(path), std::move(data)});
+    }
+    work_.notify_one();
+}
+
+std::vector<char> FileWriteBehind::finish() {
+    {
+        std::lock_guard lock(mutex_);
+        finishing_ = true;
+    }
+    work_.notify_one();
+    thread_.join();
+    return written_;
+}
+
+void FileWriteBehind::run() {
+    Trace::setThreadName("Batch write-behind");
+    while (true) {
+        std::vector<Job> jobs;
+        {
+            std::unique_lock lock(mutex_);
+            if (io_.pending() == 0) {
+                work_.wait(lock, [&] { return finishing_ || !queue_.empty(); });
+            }
+            if (queue_.empty() && io_.pending() == 0 && finishing_) break;
+            while (!queue_.empty() && io_.pending() + jobs.size() < queueDepth_) {
+                jobs.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        for (auto& job : jobs) {
+            io_.write(job.index, job.path, std::move(job.data));
+        }
+        if (io_.pending() == 0) continue;
+
+        const auto done = io_.wait();
+        {
+            std::lock_guard lock(mutex_);
+            for (const auto& completion : done) {
+                const auto index = static_cast<size_t>(completion.tag);
+                written_[index] = completion.ok;
+                heldBytes_ -= sizes_[index];
+            }
+        }
+        space_.notify_all();
+    }
+}
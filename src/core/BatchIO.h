@@ -0,0 +1,136 @@
+/**
+ * @file BatchIO.h
+ * @brief Read-ahead and write-behind of batch files on an AsyncFileIO.
+ *
+ * The batch workers decode and encode in memory while one I/O thread keeps
+ * the reads of upcoming sources and the writes of finished exports in
+ * flight. On high-latency storage the workers then no longer sit in I/O
+ * wait, and throughput approaches what the storage can deliver without
+ * adding worker threads. Both classes cap the bytes they hold so a batch
+ * of large files cannot exhaust memory.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utils/AsyncFileIO.h"
+
+/**
+ * @class FilePrefetcher
+ * @brief Reads a list of files in order, ahead of the workers that take them.
+ */
+class FilePrefetcher final {
+public:
+    static constexpr size_t kDefaultBudgetBytes = size_t{256} << 20;
+
+    /**
+     * @param budgetBytes Most bytes read ahead and not yet taken, counting
+     *        reads still in flight by the files' sizes. A larger file is
+     *        read on its own once nothing else is held.
+     */
+    explicit FilePrefetcher(std::vector<std::string> paths, AsyncFileIO::Options io = {},
+                            size_t budgetBytes = kDefaultBudgetBytes);
+    ~FilePrefetcher();
+
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    /**
+     * @brief Contents of file @p index, waiting for its read if needed.
+     *
+     * Each index can be taken once; files are read in index order, so
+     * workers should take them roughly in that order.
+     * @return nullopt if the file could not be read.
+     */
+    [[nodiscard]] std::optional<std::vector<uint8_t>> take(size_t index);
+
+    [[nodiscard]] AsyncFileIO::Backend backend() const noexcept { return io_.backend(); }
+
+    /** @brief Most bytes held and in flight at any one time so far. */
+    [[nodiscard]] size_t peakBytes();
+
+private:
+    enum class State { Pending, Ready, Failed, Taken };
+
+    void run();
+
+    std::vector<std::string> paths_;
+    size_t budgetBytes_;
+    unsigned queueDepth_;
+    AsyncFileIO io_;        // Used only by the I/O thread once it runs
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+    std::vector<State> states_;
+    std::vector<std::vector<uint8_t>> contents_;
+    std::vector<size_t> reserved_;  // Size each read counts against the budget; I/O thread only
+    size_t heldBytes_{0};           // Read and not yet taken
+    size_t inFlightBytes_{0};       // Submitted and not yet completed
+    size_t peakBytes_{0};
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+/**
+ * @class FileWriteBehind
+ * @brief Writes files handed over by workers while they go on encoding.
+ *
+ * write() is thread-safe and only blocks while the queued bytes exceed the
+ * budget. finish() waits for everything queued and reports per-file success.
+ */
+class FileWriteBehind final {
+public:
+    static constexpr size_t kDefaultBudgetBytes = size_t{256} << 20;
+
+    /** @param count Number of files; write() takes indices in [0, count). */
+    explicit FileWriteBehind(size_t count, AsyncFileIO::Options io = {},
+                             size_t budgetBytes = kDefaultBudgetBytes);
+    ~FileWriteBehind();
+
+    FileWriteBehind(const FileWriteBehind&) = delete;
+    FileWriteBehind& operator=(const FileWriteBehind&) = delete;
+
+    /** @brief Queue writing @p data to @p path as file @p index. */
+    void write(size_t index, std::string path, std::vector<uint8_t> data);
+
+    /**
+     * @brief Wait for all queued writes.
+     * @return Per index, true if the file was written; indices never passed to write() are false.
+     */
+    [[nodiscard]] std::vector<char> finish();
+
+    [[nodiscard]] AsyncFileIO::Backend backend() const noexcept { return io_.backend(); }
+
+private:
+    struct Job {
+        size_t index{0};
+        std::string path;
+        std::vector<uint8_t> data;
+    };
+
+    void run();
+
+    size_t budgetBytes_;
+    unsigned queueDepth_;
+    AsyncFileIO io_;        // Used only by the I/O thread once it runs
+
+    std::mutex mutex_;
+    std::condition_variable work_;
+    std::condition_variable space_;
+    std::deque<Job> queue_;
+    std::vector<size_t> sizes_;
+    std::vector<char> written_;
+    size_t heldBytes_{0};
+    bool finishing_{false};
+    std::thread thread_;
+};
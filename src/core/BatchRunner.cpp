@@ -0,0 +1,264 @@
+/**
+ * @file BatchRunner.cpp
+ * @brief Implementation of the headless batch pipeline.
+ */
+
+#include "BatchRunner.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include "audio/AudioEngine.h"
+#include "core/BatchIO.h"
+#include "core/ClipPipeline.h"
+#include "core/ExportCache.h"
+#include "core/ParallelFor.h"
+#include "utils/FileScanner.h"
+#include "utils/Trace.h"
+
+namespace {
+
+uint64_t fileSize(const std::string& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<uint64_t>(size);
+}
+
+uint64_t sampleBytes(const AudioClip& clip) {
+    return static_cast<uint64_t>(clip.frameCount() * static_cast<size_t>(clip.channels()) * sizeof(float));
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(int threads, unsigned ioQueueDepth)
+    : threads_(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+    , ioQueueDepth_(ioQueueDepth)
+{
+}
+
+BatchRunResult BatchRunner::run(const Project& project, bool exportClips, bool useExportCache) const {
+    BatchRunResult result;
+
+    if (project.rawFolder().empty()) {
+        result.error = "Project has no RAW folder";
+        return result;
+    }
+    if (exportClips && project.gameFolder().empty()) {
+        result.error = "Project has no game folder to export to";
+        return result;
+    }
+
+    FileScanner scanner;
+    return runFiles(project, scanner.scan(project.rawFolder()), exportClips, useExportCache);
+}
+
+BatchRunResult BatchRunner::runFiles(const Project& project, std::vector<std::string> paths, bool exportClips,
+                                     bool useExportCache, const std::string& manifestFile) const {
+    BatchRunResult result;
+
+    if (exportClips && project.gameFolder().empty()) {
+        result.error = "Project has no game folder to export to";
+        return result;
+    }
+
+    const auto& settings = project.exportSettings();
+    const auto bitrate = ClipPipeline::mp3Bitrate(settings.mp3Bitrate);
+    const auto metadata = ClipPipeline::mp3Metadata(settings);
+
+    // --- Export cache: drop sources whose output is already up to date ---
+    ExportManifest manifest;
+    std::vector<std::optional<SourceStamp>> stamps(paths.size());
+    std::vector<uint64_t> keys(paths.size(), 0);
+    if (exportClips && useExportCache) {
+        WOOSH_TRACE_SCOPE("BatchRunner::checkExportCache");
+        manifest = ExportManifest::load(project.gameFolder());
+        std::vector<char> upToDate(paths.size(), 0);
+        parallelFor(paths.size(), threads_, [&](size_t i, const AudioEngine&) {
+            stamps[i] = manifest.sourceStamp(paths[i]);
+            if (!stamps[i]) return;
+            const ClipState* state = project.findClipState(std::filesystem::path(paths[i]).filename().string());
+            keys[i] = ExportCache::exportKey(stamps[i]->contentHash, state, settings.format, bitrate, metadata);
+            upToDate[i] = manifest.isUpToDate(project.gameFolder(),
+                                              ExportCache::outputFileName(paths[i], settings.format), keys[i]);
+        });
+
+        size_t kept = 0;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (upToDate[i]) continue;
+            if (kept != i) {
+                paths[kept] = std::move(paths[i]);
+                stamps[kept] = stamps[i];
+                keys[kept] = keys[i];
+            }
+            ++kept;
+        }
+        result.upToDateFiles = paths.size() - kept;
+        paths.resize(kept);
+        stamps.resize(kept);
+        keys.resize(kept);
+    }
+
+    // --- Load ---
+    std::vector<std::optional<AudioClip>> loaded(paths.size());
+    std::vector<char> processedOnLoad(paths.size(), 0);
+    {
+        WOOSH_TRACE_SCOPE("BatchRunner::loadBatch");
+        BatchRecorder recorder("load", threads_);
+
+        // Sources are read ahead on one I/O thread; the workers only decode.
+        // "ioWait" is the time a worker still had to wait for its file.
+        std::optional<FilePrefetcher> prefetcher;
+        if (ioQueueDepth_ > 0) prefetcher.emplace(paths, AsyncFileIO::Options{ioQueueDepth_});
+
+        // Long WAV files whose processing can start before they are fully
+        // decoded are processed here, as their frame ranges come in
+        parallelFor(paths.size(), threads_, [&](size_t i, const AudioEngine& engine) {
+            StageTimer fileTimer(nullptr, "file");
+            std::optional<std::vector<uint8_t>> bytes;
+            if (prefetcher) {
+                StageTimer timer(&recorder, "ioWait");
+                bytes = prefetcher->take(i);
+            }
+            const uint64_t size = fileSize(paths[i]);
+            const ClipState* state = project.findClipState(std::filesystem::path(paths[i]).filename().string());
+            const bool overlap = state && ClipPipeline::processesWhileDecoding(paths[i], size, *state);
+            {
+                StageTimer timer(&recorder, "decode");
+                if (overlap) {
+                    const std::span<const uint8_t> contents = bytes ? std::span<const uint8_t>(*bytes)
+                                                                    : std::span<const uint8_t>();
+                    loaded[i] = ClipPipeline::loadProcessed(engine, paths[i], contents, *state);
+                    processedOnLoad[i] = loaded[i].has_value();
+                } else {
+                    loaded[i] = bytes ? engine.loadClip(paths[i], *bytes) : engine.loadClip(paths[i]);
+                }
+            }
+            recorder.addFile(paths[i], size, fileTimer.elapsedMs(), loaded[i].has_value());
+        });
+        result.reports.push_back(recorder.finish());
+    }
+
+    std::vector<AudioClip> clips;
+    std::vector<size_t> clipSource;     // Index into paths of each clip
+    clips.reserve(paths.size());
+    clipSource.reserve(paths.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        if (!loaded[i]) continue;
+        clips.push_back(std::move(*loaded[i]));
+        clipSource.push_back(i);
+    }
+    loaded.clear();
+
+    // --- Process ---
+    {
+        WOOSH_TRACE_SCOPE("BatchRunner::processBatch");
+        BatchRecorder recorder("process", threads_);
+        parallelFor(clips.size(), threads_, [&](size_t i, const AudioEngine& engine) {
+            AudioClip& clip = clips[i];
+            const ClipState* state = project.findClipState(clip.displayName());
+            if (!state || processedOnLoad[clipSource[i]]) return;
+
+            WOOSH_TRACE_SCOPE_DETAIL("BatchRunner::processClip", clip.displayName());
+            StageTimer fileTimer(nullptr, "file");
+            ClipPipeline::applyClipState(engine, clip, *state, &recorder);
+            recorder.addFile(clip.filePath(), sampleBytes(clip), fileTimer.elapsedMs(), true);
+        });
+        result.reports.push_back(recorder.finish());
+    }
+
+    if (!exportClips) {
+        return result;
+    }
+
+    // --- Export ---
+    {
+        WOOSH_TRACE_SCOPE("BatchRunner::exportBatch");
+        const std::filesystem::path gameFolder(project.gameFolder());
+
+        BatchRecorder recorder("export", threads_);
+        std::vector<char> succeeded(clips.size(), 0);
+        std::vector<double> fileMs(clips.size(), 0.0);
+        std::vector<std::string> errors(clips.size());   // Each worker writes only its clips' entries
+
+        // Encoded files are handed to one I/O thread, so the workers go on
+        // encoding while earlier outputs are still being written
+        std::optional<FileWriteBehind> writer;
+        if (ioQueueDepth_ > 0) {
+            std::error_code ec;
+            std::filesystem::create_directories(gameFolder, ec);
+            writer.emplace(clips.size(), AsyncFileIO::Options{ioQueueDepth_});
+        }
+
+        parallelFor(clips.size(), threads_, [&](size_t i, const AudioEngine& engine) {
+            const AudioClip& clip = clips[i];
+            int fadeInFrames = 0;
+            int fadeOutFrames = 0;
+            if (const ClipState* state = project.findClipState(clip.displayName())) {
+                fadeInFrames = state->fadeInFrames;
+                fadeOutFrames = state->fadeOutFrames;
+            }
+
+            StageTimer fileTimer(nullptr, "file");
+            if (writer) {
+                std::optional<std::vector<uint8_t>> encoded;
+                {
+                    StageTimer timer(&recorder, "encode");
+                    encoded = ClipPipeline::encodeClip(engine, clip, settings.format, bitrate, metadata,
+                                                       fadeInFrames, fadeOutFrames, &errors[i]);
+                }
+                if (encoded) {
+                    StageTimer timer(&recorder, "ioWait");
+                    const auto outPath = gameFolder / ExportCache::outputFileName(clip.filePath(), settings.format);
+                    writer->write(i, outPath.string(), std::move(*encoded));
+                }
+            } else {
+                StageTimer timer(&recorder, "encode");
+                succeeded[i] = ClipPipeline::exportClip(engine, clip, project.gameFolder(), settings.format,
+                                                        bitrate, metadata, fadeInFrames, fadeOutFrames,
+                                                        &errors[i]);
+            }
+            fileMs[i] = fileTimer.elapsedMs();
+        });
+        if (writer) succeeded = writer->finish();
+
+        size_t exported = 0;
+        for (size_t i = 0; i < clips.size(); ++i) {
+            const auto outPath = gameFolder / ExportCache::outputFileName(clips[i].filePath(), settings.format);
+            const bool ok = succeeded[i];
+            recorder.addFile(outPath.string(), ok ? fileSize(outPath.string()) : 0, fileMs[i], ok);
+            if (ok) {
+                ++exported;
+            } else {
+                result.exportErrors.push_back(clips[i].displayName() + ": "
+                                              + (errors[i].empty() ? "could not write " + outPath.string()
+                                                                   : errors[i]));
+            }
+        }
+        result.exportedFiles = exported;
+        result.reports.push_back(recorder.finish());
+
+        if (useExportCache) {
+            for (size_t i = 0; i < clips.size(); ++i) {
+                const size_t source = clipSource[i];
+                const std::string outputName = ExportCache::outputFileName(paths[source], settings.format);
+                if (succeeded[i] && stamps[source]) {
+                    manifest.record(project.gameFolder(), outputName, keys[source], paths[source], *stamps[source]);
+                } else {
+                    manifest.remove(outputName);
+                }
+            }
+            const bool saved = manifestFile.empty() ? manifest.save(project.gameFolder())
+                                                    : manifest.saveFile(manifestFile);
+            if (!saved) {
+                result.error = "Could not write the export manifest "
+                    + (manifestFile.empty() ? "to " + project.gameFolder() : manifestFile);
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file BatchRunner.h
+ * @brief Headless load/process/export of a project for unattended runs.
+ *
+ * Scans the project's RAW folder, loads every clip, re-applies the stored
+ * ClipState processing and exports to the game folder using the project's
+ * export settings. Each of the three batches produces a BatchReport, which
+ * lets nightly asset builds track throughput over time. Clips whose export
+ * is unchanged since the last run are skipped before they are loaded.
+ * Source reads and export writes run on an AsyncFileIO thread, overlapped
+ * with the workers' decoding and encoding.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/Project.h"
+#include "utils/AsyncFileIO.h"
+#include "utils/BatchReport.h"
+
+/**
+ * @brief Outcome of a headless run.
+ */
+struct BatchRunResult {
+    std::vector<BatchReport> reports;   ///< One report per batch, in run order
+    size_t exportedFiles{0};
+    size_t upToDateFiles{0};            ///< Sources skipped because their export was unchanged
+    std::vector<std::string> exportErrors;  ///< Why each failed export failed, one line per clip
+    std::string error;                  ///< Empty on success
+
+    [[nodiscard]] bool ok() const noexcept { return error.empty(); }
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs the load, process and export batches of a project on a worker pool.
+ *
+ * The workers share one stateless AudioEngine, so they need no locks;
+ * each clip's export reports its own error.
+ */
+class BatchRunner final {
+public:
+    /**
+     * @param threads Worker count; 0 uses the hardware concurrency.
+     * @param ioQueueDepth Reads/writes kept in flight by the batch I/O
+     *        thread; 0 lets every worker read and write its own files.
+     */
+    explicit BatchRunner(int threads = 0, unsigned ioQueueDepth = AsyncFileIO::kDefaultQueueDepth);
+
+    /**
+     * @brief Load, process and (optionally) export all clips of @p project.
+     * @param exportClips When false, stop after the process batch.
+     * @param useExportCache Skip clips whose output in the game folder is
+     *        up to date according to its ExportManifest, and record the new
+     *        exports in it. Only applies when exporting.
+     */
+    [[nodiscard]] BatchRunResult run(const Project& project, bool exportClips = true,
+                                     bool useExportCache = true) const;
+
+    /**
+     * @brief Like run(), for @p paths instead of a scan of the RAW folder.
+     * @param manifestFile Where the updated export manifest is written;
+     *        empty writes it into the game folder. Shard workers write their
+     *        own copy so that concurrent processes do not overwrite each other.
+     */
+    [[nodiscard]] BatchRunResult runFiles(const Project& project, std::vector<std::string> paths,
+                                          bool exportClips = true, bool useExportCache = true,
+                                          const std::string& manifestFile = {}) const;
+
+    [[nodiscard]] int threads() const noexcept { return threads_; }
+    [[nodiscard]] unsigned ioQueueDepth() const noexcept { return ioQueueDepth_; }
+
+private:
+    int threads_;
+    unsigned ioQueueDepth_;
+};
@@ -0,0 +1,159 @@
+/**
+ * @file ClipPipeline.cpp
+ * @brief Implementation of the shared per-clip processing and export steps.
+ */
+
+#include "ClipPipeline.h"
+#include "utils/BatchReport.h"
+#include "utils/FrameRanges.h"
+
+#include <filesystem>
+#include <system_error>
+
+namespace ClipPipeline {
+
+ProcessingChain processingChain(const ClipState& state) {
+    ProcessingChain chain;
+    if (state.isNormalized) {
+        chain.normalizeToPeak(static_cast<float>(state.normalizeTargetDb));
+    }
+    if (state.isCompressed) {
+        const auto& cs = state.compressorSettings;
+        chain.compress({cs.threshold, cs.ratio, cs.attackMs, cs.releaseMs, cs.makeupDb});
+    }
+    if (state.isLimited) {
+        const auto& ls = state.limiterSettings;
+        chain.limit({ls.ceilingDb, ls.lookaheadMs, ls.releaseMs});
+    }
+    return chain;
+}
+
+void applyClipState(const AudioEngine& engine, AudioClip& clip, const ClipState& state,
+                    BatchRecorder* recorder) {
+    // Save original first (if not already saved)
+    if (!clip.hasOriginal()) {
+        clip.saveOriginal();
+    }
+
+    // Apply trim if stored
+    if (state.isTrimmed) {
+        StageTimer timer(recorder, "trim");
+        engine.trim(clip, static_cast<float>(state.trimStartSec), static_cast<float>(state.trimEndSec));
+    }
+
+    // Normalize, compress and limit run as one fused pass over the samples
+    const ProcessingChain chain = processingChain(state);
+    if (!chain.empty()) {
+        StageTimer timer(recorder, "process");
+        engine.process(clip, chain);
+    } else if (!clip.hasMetrics()) {
+        // A trim alone leaves the kept range unmeasured
+        engine.updateClipMetrics(clip);
+    }
+}
+
+bool processesWhileDecoding(const std::string& path, uint64_t fileBytes, const ClipState& state) {
+    // Only WAV sources are decoded in frame ranges
+    const auto ext = std::filesystem::path(path).extension().string();
+    if (ext != ".wav" && ext != ".WAV") return false;
+    if (!FrameRanges::worthSplitting(static_cast<size_t>(fileBytes))) return false;
+    const ProcessingChain chain = processingChain(state);
+    return !chain.empty() && ProcessingChain::Stream::canStream(chain);
+}
+
+std::optional<AudioClip> loadProcessed(const AudioEngine& engine, const std::string& path,
+                                       std::span<const uint8_t> bytes, const ClipState& state) {
+    const float trimStart = state.isTrimmed ? static_cast<float>(state.trimStartSec) : 0.0f;
+    const float trimEnd = state.isTrimmed ? static_cast<float>(state.trimEndSec) : 0.0f;
+    return engine.loadProcessed(path, bytes, trimStart, trimEnd, processingChain(state));
+}
+
+std::optional<AudioClip> reloadClip(const AudioEngine& engine, const AudioClip& evicted, const ClipState* state,
+                                    BatchRecorder* recorder) {
+    const bool reprocess = evicted.isModified() && state;
+    std::optional<AudioClip> clip;
+    {
+        StageTimer timer(recorder, "reload");
+        std::error_code ec;
+        const auto fileBytes = std::filesystem::file_size(evicted.filePath(), ec);
+        if (reprocess && !ec && processesWhileDecoding(evicted.filePath(), fileBytes, *state)) {
+            return loadProcessed(engine, evicted.filePath(), {}, *state);
+        }
+        clip = engine.loadClip(evicted.filePath());
+    }
+    if (!clip) return std::nullopt;
+    clip->saveOriginal();
+    if (reprocess) {
+        applyClipState(engine, *clip, *state, recorder);
+    }
+    return clip;
+}
+
+Mp3Encoder::BitrateMode mp3Bitrate(int kbps) noexcept {
+    switch (kbps) {
+        case 128: return Mp3Encoder::BitrateMode::CBR_128;
+        case 160: return Mp3Encoder::BitrateMode::CBR_160;
+        case 192: return Mp3Encoder::BitrateMode::CBR_192;
+        default:  return Mp3Encoder::BitrateMode::CBR_160;
+    }
+}
+
+Mp3Metadata mp3Metadata(const ExportSettings& settings) {
+    Mp3Metadata metadata;
+    metadata.artist = settings.authorName;
+    metadata.album = settings.gameName;
+    metadata.comment = "Made by Woosh";
+    return metadata;
+}
+
+std::string fileExtension(ExportFormat format) {
+    switch (format) {
+        case ExportFormat::MP3: return ".mp3";
+        case ExportFormat::OGG: return ".ogg";
+        case ExportFormat::WAV:
+        default: return ".wav";
+    }
+}
+
+bool exportClip(const AudioEngine& engine,
+                const AudioClip& clip,
+                const std::string& destFolder,
+                ExportFormat format,
+                Mp3Encoder::BitrateMode bitrate,
+                const Mp3Metadata& metadata,
+                int fadeInFrames,
+                int fadeOutFrames,
+                std::string* error) {
+    switch (format) {
+        case ExportFormat::MP3:
+            return engine.exportMp3(clip, destFolder, bitrate, metadata, fadeInFrames, fadeOutFrames, error);
+        case ExportFormat::OGG:
+            // OGG export not yet implemented, fall back to WAV
+            return engine.exportWav(clip, destFolder, fadeInFrames, fadeOutFrames, error);
+        case ExportFormat::WAV:
+        default:
+            return engine.exportWav(clip, destFolder, fadeInFrames, fadeOutFrames, error);
+    }
+}
+
+std::optional<std::vector<uint8_t>> encodeClip(const AudioEngine& engine,
+                                               const AudioClip& clip,
+                                               ExportFormat format,
+                                               Mp3Encoder::BitrateMode bitrate,
+                                               const Mp3Metadata& metadata,
+                                               int fadeInFrames,
+                                               int fadeOutFrames,
+                                               std::string* error) {
+    switch (format) {
+        case ExportFormat::MP3:
+            return engine.encodeMp3(clip, bitrate, metadata, fadeInFrames, fadeOutFrames, error);
+        case ExportFormat::OGG:
+            // OGG export not yet implemented, fall back to WAV
+            return engine.encodeWav(clip, fadeInFrames, fadeOutFrames, error);
+        case ExportFormat::WAV:
+        default:
+            return engine.encodeWav(clip, fadeInFrames, fadeOutFrames, error);
+    }
+}
+
+} // namespace ClipPipeline
@@ -0,0 +1,108 @@
+/**
+ * @file ClipPipeline.h
+ * @brief Shared per-clip processing and export steps.
+ *
+ * Used by both the interactive MainWindow batches and the headless
+ * BatchRunner, so a clip is processed and exported the same way whether it
+ * was driven from the UI or from the command line.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "audio/AudioClip.h"
+#include "audio/AudioEngine.h"
+#include "core/Project.h"
+
+class BatchRecorder;
+
+namespace ClipPipeline {
+
+/** @brief The fused chain for a clip's stored normalize, compress and limit steps. */
+[[nodiscard]] ProcessingChain processingChain(const ClipState& state);
+
+/**
+ * @brief Re-apply stored trim/normalize/compress state to a freshly loaded clip.
+ *
+ * Saves the original samples first so the processing can be undone. Fades are
+ * non-destructive and are only applied at playback/export time. Normalize and
+ * compress are recorded as a single "process" stage since they run fused.
+ *
+ * @param recorder Optional batch recorder receiving per-stage timings.
+ */
+void applyClipState(const AudioEngine& engine, AudioClip& clip, const ClipState& state,
+                    BatchRecorder* recorder = nullptr);
+
+/**
+ * @brief Load an evicted clip's source again and bring it back to its state.
+ *
+ * Modified clips get @p state re-applied, so they come back as reopening
+ * the project would produce them; without a state only unmodified clips
+ * can be reproduced. The undo original is the file on disk, as after a load.
+ * @return nullopt if the source cannot be decoded any more.
+ */
+[[nodiscard]] std::optional<AudioClip> reloadClip(const AudioEngine& engine, const AudioClip& evicted,
+                                                  const ClipState* state, BatchRecorder* recorder = nullptr);
+
+/**
+ * @brief Whether loadProcessed() overlaps @p state's processing with decoding the source.
+ *
+ * True for WAV files of @p fileBytes long enough to be decoded in frame
+ * ranges (see FrameRanges) whose chain does not start with a normalize.
+ */
+[[nodiscard]] bool processesWhileDecoding(const std::string& path, uint64_t fileBytes, const ClipState& state);
+
+/**
+ * @brief Load a clip with @p state applied, as loadClip() and applyClipState() would.
+ *
+ * See AudioEngine::loadProcessed(); the undo original is the file on disk.
+ * @param bytes The file's contents if already read, or empty to read @p path.
+ */
+[[nodiscard]] std::optional<AudioClip> loadProcessed(const AudioEngine& engine, const std::string& path,
+                                                     std::span<const uint8_t> bytes, const ClipState& state);
+
+/** @brief Map a project bitrate in kbps to the encoder mode (160 kbps if unsupported). */
+[[nodiscard]] Mp3Encoder::BitrateMode mp3Bitrate(int kbps) noexcept;
+
+/** @brief ID3 metadata written for a project's MP3 exports. */
+[[nodiscard]] Mp3Metadata mp3Metadata(const ExportSettings& settings);
+
+/** @brief Output file extension (including the dot) for an export format. */
+[[nodiscard]] std::string fileExtension(ExportFormat format);
+
+/**
+ * @brief Export one clip into @p destFolder in the requested format.
+ *
+ * OGG is not implemented yet and falls back to WAV.
+ * @param error Receives the reason when the export fails (optional).
+ */
+[[nodiscard]] bool exportClip(const AudioEngine& engine,
+                              const AudioClip& clip,
+                              const std::string& destFolder,
+                              ExportFormat format,
+                              Mp3Encoder::BitrateMode bitrate,
+                              const Mp3Metadata& metadata,
+                              int fadeInFrames,
+                              int fadeOutFrames,
+                              std::string* error = nullptr);
+
+/**
+ * @brief Like exportClip(), into memory: the bytes of the file exportClip() would write.
+ *
+ * The file belongs at ExportCache::outputFileName(clip.filePath(), format).
+ */
+[[nodiscard]] std::optional<std::vector<uint8_t>> encodeClip(const AudioEngine& engine,
+                                                             const AudioClip& clip,
+                                                             ExportFormat format,
+                                                             Mp3Encoder::BitrateMode bitrate,
+                                                             const Mp3Metadata& metadata,
+                                                             int fadeInFrames,
+                                                             int fadeOutFrames,
+                                                             std::string* error = nullptr);
+
+} // namespace ClipPipeline
@@ -0,0 +1,248 @@
+/**
+ * @file ExportCache.cpp
+ * @brief Implementation of export keys and the export manifest.
+ */
+
+#include "ExportCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include "Version.h"
+#include "utils/FileStamp.h"
+#include "utils/Hash.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kManifestHeader = "woosh-export-manifest 1";
+constexpr size_t kReadChunkBytes = 1 << 20;
+
+bool parseLine(const std::string& line, std::string& outputName, ExportManifest::Entry& entry) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t tab = line.find('\t'); fields.size() < 6 && tab != std::string::npos; tab = line.find('\t', start)) {
+        fields.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+    }
+    if (fields.size() != 6) return false;
+    entry.sourcePath = line.substr(start);
+
+    try {
+        entry.key = std::stoull(fields[0], nullptr, 16);
+        entry.outputSize = std::stoull(fields[1]);
+        entry.source.contentHash = std::stoull(fields[2], nullptr, 16);
+        entry.source.fileSize = std::stoull(fields[3]);
+        entry.source.modifiedTime = std::stoll(fields[4]);
+    } catch (const std::exception&) {
+        return false;
+    }
+    outputName = fields[5];
+    return !outputName.empty() && !entry.sourcePath.empty();
+}
+
+} // namespace
+
+namespace ExportCache {
+
+std::optional<uint64_t> hashFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+
+    Fnv1a hash;
+    std::vector<char> buffer(kReadChunkBytes);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hash.addBytes(buffer.data(), static_cast<size_t>(in.gcount()));
+    }
+    if (in.bad()) return std::nullopt;
+    return hash.value();
+}
+
+uint64_t exportKey(uint64_t sourceHash,
+                   const ClipState* state,
+                   ExportFormat format,
+                   Mp3Encoder::BitrateMode bitrate,
+                   const Mp3Metadata& metadata) {
+    Fnv1a hash;
+    hash.add(WOOSH_VERSION_STRING);
+    hash.add(sourceHash);
+
+    hash.add(state != nullptr);
+    if (state) {
+        hash.add(state->isTrimmed);
+        if (state->isTrimmed) {
+            hash.add(state->trimStartSec);
+            hash.add(state->trimEndSec);
+        }
+        hash.add(state->isNormalized);
+        if (state->isNormalized) {
+            hash.add(state->normalizeTargetDb);
+        }
+        hash.add(state->isCompressed);
+        if (state->isCompressed) {
+            const auto& cs = state->compressorSettings;
+            hash.add(cs.threshold);
+            hash.add(cs.ratio);
+            hash.add(cs.attackMs);
+            hash.add(cs.releaseMs);
+            hash.add(cs.makeupDb);
+        }
+        hash.add(state->isLimited);
+        if (state->isLimited) {
+            const auto& ls = state->limiterSettings;
+            hash.add(ls.ceilingDb);
+            hash.add(ls.lookaheadMs);
+            hash.add(ls.releaseMs);
+        }
+        hash.add(state->fadeInFrames);
+        hash.add(state->fadeOutFrames);
+    }
+
+    // Bitrate and tags only reach MP3 files; WAV outputs ignore them
+    hash.add(format);
+    if (format == ExportFormat::MP3) {
+        hash.add(bitrate);
+        hash.add(metadata.title);
+        hash.add(metadata.artist);
+        hash.add(metadata.album);
+        hash.add(metadata.comment);
+        hash.add(metadata.year);
+    }
+    return hash.value();
+}
+
+std::string outputFileName(const std::string& sourcePath, ExportFormat format) {
+    // OGG currently falls back to WAV
+    const char* extension = format == ExportFormat::MP3 ? ".mp3" : ".wav";
+    return fs::path(sourcePath).stem().string() + extension;
+}
+
+bool forgetOutput(const std::string& folder, const std::string& sourcePath, ExportFormat format) {
+    ExportManifest manifest = ExportManifest::load(folder);
+    const std::string outputName = outputFileName(sourcePath, format);
+    if (!manifest.contains(outputName)) return true;
+    manifest.remove(outputName);
+    return manifest.save(folder);
+}
+
+} // namespace ExportCache
+
+ExportManifest ExportManifest::load(const std::string& folder) {
+    return loadFile((fs::path(folder) / kFileName).string());
+}
+
+ExportManifest ExportManifest::loadFile(const std::string& path) {
+    ExportManifest manifest;
+    std::ifstream in(path);
+    std::string line;
+    if (!in || !std::getline(in, line) || line != kManifestHeader) return manifest;
+
+    // Unparsable lines are dropped; their outputs are simply exported again
+    while (std::getline(in, line)) {
+        std::string outputName;
+        Entry entry;
+        if (!parseLine(line, outputName, entry)) continue;
+        manifest.sources_[entry.sourcePath] = entry.source;
+        manifest.entries_[outputName] = std::move(entry);
+    }
+    return manifest;
+}
+
+// One line per output, tab-separated:
+//   key(hex) outputSize sourceHash(hex) sourceSize sourceModified outputName sourcePath
+// The source path comes last so it may contain anything but a newline.
+bool ExportManifest::save(const std::string& folder) const {
+    return saveFile((fs::path(folder) / kFileName).string());
+}
+
+bool ExportManifest::saveFile(const std::string& file) const {
+    const fs::path path(file);
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out) return false;
+        out << kManifestHeader << '\n';
+        for (const auto& [outputName, entry] : entries_) {
+            out << std::hex << entry.key << std::dec << '\t'
+                << entry.outputSize << '\t'
+                << std::hex << entry.source.contentHash << std::dec << '\t'
+                << entry.source.fileSize << '\t'
+                << entry.source.modifiedTime << '\t'
+                << outputName << '\t'
+                << entry.sourcePath << '\n';
+        }
+        if (!out) return false;
+    }
+
+    // Replace the old manifest in one step so an interrupted save never leaves half a file
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<SourceStamp> ExportManifest::sourceStamp(const std::string& sourcePath) const {
+    const auto stamp = fileStamp(sourcePath);
+    if (!stamp) return std::nullopt;
+
+    auto known = sources_.find(sourcePath);
+    if (known != sources_.end() && known->second.fileSize == stamp->size
+        && known->second.modifiedTime == stamp->modifiedTime) {
+        return known->second;
+    }
+
+    const auto contentHash = ExportCache::hashFile(sourcePath);
+    if (!contentHash) return std::nullopt;
+    return SourceStamp{*contentHash, stamp->size, stamp->modifiedTime};
+}
+
+bool ExportManifest::isUpToDate(const std::string& folder, const std::string& outputName, uint64_t key) const {
+    const Entry* entry = find(outputName);
+    if (!entry || entry->key != key) return false;
+
+    std::error_code ec;
+    const auto size = fs::file_size(fs::path(folder) / outputName, ec);
+    return !ec && static_cast<uint64_t>(size) == entry->outputSize;
+}
+
+const ExportManifest::Entry* ExportManifest::find(const std::string& outputName) const {
+    auto it = entries_.find(outputName);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+void ExportManifest::record(const std::string& folder, const std::string& outputName, uint64_t key,
+                            const std::string& sourcePath, const SourceStamp& source) {
+    std::error_code ec;
+    const auto size = fs::file_size(fs::path(folder) / outputName, ec);
+    if (ec) {
+        entries_.erase(outputName);
+        return;
+    }
+    entries_[outputName] = Entry{key, static_cast<uint64_t>(size), sourcePath, source};
+    sources_[sourcePath] = source;
+}
+
+void ExportManifest::remove(const std::string& outputName) {
+    entries_.erase(outputName);
+}
+
+void ExportManifest::merge(const ExportManifest& other, const std::vector<std::string>& outputNames) {
+    for (const auto& outputName : outputNames) {
+        const Entry* entry = other.find(outputName);
+        if (!entry) {
+            entries_.erase(outputName);
+            continue;
+        }
+        entries_[outputName] = *entry;
+        sources_[entry->sourcePath] = entry->source;
+    }
+}
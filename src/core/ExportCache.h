@@ -0,0 +1,130 @@
+/**
+ * @file ExportCache.h
+ * @brief Content-addressed export manifest, so unchanged outputs are not re-encoded.
+ *
+ * Every export is keyed by a hash of everything its bytes depend on: the
+ * source file's content, the clip's stored processing (ClipState), the
+ * export format, bitrate and metadata, and the Woosh version. The key of
+ * each output is recorded in a manifest in the output folder; an output
+ * whose recorded key matches and whose file is still there with the
+ * recorded size is up to date, and its clip does not need to be loaded,
+ * processed or encoded again.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "audio/Formats/Mp3Encoder.h"
+#include "core/Project.h"
+
+/**
+ * @brief Content hash of a source file and the file state it was computed from.
+ */
+struct SourceStamp {
+    uint64_t contentHash{0};
+    uint64_t fileSize{0};
+    int64_t modifiedTime{0};    ///< Filesystem clock ticks; only compared for equality
+};
+
+namespace ExportCache {
+
+/** @brief FNV-1a hash of the bytes of @p path; nullopt if it cannot be read. */
+[[nodiscard]] std::optional<uint64_t> hashFile(const std::string& path);
+
+/**
+ * @brief Key of one export: identical keys produce identical output files.
+ *
+ * Covers every ClipState field that changes the exported samples (trim,
+ * normalize, compress, limit, fades); fields added to ClipState that affect
+ * the output must be added here too.
+ * @param state Stored processing of the clip; nullptr if it has none.
+ */
+[[nodiscard]] uint64_t exportKey(uint64_t sourceHash,
+                                 const ClipState* state,
+                                 ExportFormat format,
+                                 Mp3Encoder::BitrateMode bitrate,
+                                 const Mp3Metadata& metadata);
+
+/** @brief File name of an exported clip: the source's stem plus the extension actually written. */
+[[nodiscard]] std::string outputFileName(const std::string& sourcePath, ExportFormat format);
+
+/**
+ * @brief Drop the manifest entry of @p sourcePath's output in @p folder.
+ *
+ * Used when a clip's processing is discarded, so its next export is written
+ * even if the manifest would otherwise consider the old output current.
+ * @return False if the manifest listed the output and could not be saved.
+ */
+bool forgetOutput(const std::string& folder, const std::string& sourcePath, ExportFormat format);
+
+} // namespace ExportCache
+
+/**
+ * @class ExportManifest
+ * @brief Keys of the outputs in one export folder, stored next to them.
+ *
+ * Lookups are const and safe from several threads; record() and save()
+ * must not run concurrently with anything else.
+ */
+class ExportManifest final {
+public:
+    /** @brief Manifest file name inside the output folder. */
+    static constexpr const char* kFileName = ".woosh-export-manifest";
+
+    struct Entry {
+        uint64_t key{0};
+        uint64_t outputSize{0};
+        std::string sourcePath;
+        SourceStamp source;
+    };
+
+    /** @brief Read the manifest of @p folder; empty if there is none or it cannot be read. */
+    [[nodiscard]] static ExportManifest load(const std::string& folder);
+
+    /** @brief Write the manifest into @p folder. @return False on I/O failure. */
+    [[nodiscard]] bool save(const std::string& folder) const;
+
+    /** @brief load() and save() for a manifest stored under any name, e.g. a shard's copy. */
+    [[nodiscard]] static ExportManifest loadFile(const std::string& path);
+    [[nodiscard]] bool saveFile(const std::string& path) const;
+
+    /**
+     * @brief Content hash of @p sourcePath.
+     *
+     * Reuses the hash recorded for that source if its size and modification
+     * time are unchanged, so an unchanged library is not read in full.
+     * @return nullopt if the file cannot be read.
+     */
+    [[nodiscard]] std::optional<SourceStamp> sourceStamp(const std::string& sourcePath) const;
+
+    /** @brief True if @p outputName in @p folder was written with @p key and is still intact. */
+    [[nodiscard]] bool isUpToDate(const std::string& folder, const std::string& outputName, uint64_t key) const;
+
+    [[nodiscard]] bool contains(const std::string& outputName) const { return entries_.count(outputName) > 0; }
+    [[nodiscard]] const Entry* find(const std::string& outputName) const;
+    [[nodiscard]] size_t size() const noexcept { return entries_.size(); }
+
+    /** @brief Record a finished export; the output's size is read from @p folder. */
+    void record(const std::string& folder, const std::string& outputName, uint64_t key,
+                const std::string& sourcePath, const SourceStamp& source);
+
+    /** @brief Forget @p outputName, e.g. after a failed export left a partial file. */
+    void remove(const std::string& outputName);
+
+    /**
+     * @brief Take the entries of @p outputNames from @p other, which owns them.
+     *
+     * Outputs that @p other does not list are forgotten here too. Used to
+     * combine the manifests of shard workers that exported disjoint files.
+     */
+    void merge(const ExportManifest& other, const std::vector<std::string>& outputNames);
+
+private:
+    std::map<std::string, Entry> entries_;              ///< By output file name
+    std::map<std::string, SourceStamp> sources_;        ///< Latest stamp of each source path
+};
@@ -0,0 +1,373 @@
+/**
+ * @file FingerprintIndex.cpp
+ * @brief Implementation of the fingerprint index and duplicate clustering.
+ */
+
+#include "FingerprintIndex.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "core/ParallelFor.h"
+#include "utils/FileStamp.h"
+#include "utils/Trace.h"
+
+namespace {
+
+constexpr char kMagic[4] = {'W', 'F', 'P', 'I'};
+constexpr uint32_t kFormatVersion = 2;     // 2: landmarks carry their frame
+constexpr size_t kHashSpace = size_t{1} << kFingerprintHashBits;
+
+/// Files with fewer landmarks are too short or too plain to call near-duplicates.
+constexpr size_t kMinNearLandmarks = 8;
+
+/// Shared hashes a pair needs in the inverted index before its similarity is computed.
+constexpr uint32_t kMinCandidateHashes = 4;
+
+/// Hashes in more files than this (or 0.5% of the library) are skipped when finding candidates.
+constexpr size_t kMinPostingCap = 256;
+
+template <typename T>
+void writeValue(std::ostream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+/// Bytes a file record takes besides its path: length, size, time, content hash, duration, landmark count.
+constexpr uint64_t kFileRecordBytes = sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(uint64_t)
+                                      + sizeof(double) + sizeof(uint32_t);
+
+/// Bytes a landmark takes in the postings: file index and frame.
+constexpr uint64_t kPostingBytes = 2 * sizeof(uint32_t);
+
+/// Bytes left in @p in from the read position; 0 if it cannot tell.
+uint64_t remainingBytes(std::istream& in) {
+    const auto here = in.tellg();
+    if (here < 0 || !in.seekg(0, std::ios::end)) return 0;
+    const auto end = in.tellg();
+    in.seekg(here);
+    return end > here ? static_cast<uint64_t>(end - here) : 0;
+}
+
+/// Call @p use once for each distinct hash of @p fingerprint, in ascending order.
+template <typename Use>
+void forEachHash(const Fingerprint& fingerprint, Use use) {
+    const auto& landmarks = fingerprint.landmarks;
+    for (size_t i = 0; i < landmarks.size(); ++i) {
+        if (i == 0 || landmarks[i].hash != landmarks[i - 1].hash) use(landmarks[i].hash);
+    }
+}
+
+/// Disjoint sets over file indices, tracking the weakest link of each set.
+class Clusters {
+public:
+    explicit Clusters(size_t count) : parent_(count), similarity_(count, 1.0) {
+        std::iota(parent_.begin(), parent_.end(), size_t{0});
+    }
+
+    size_t root(size_t i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void join(size_t a, size_t b, double similarity) {
+        a = root(a);
+        b = root(b);
+        if (a == b) return;
+        parent_[b] = a;
+        similarity_[a] = std::min({similarity_[a], similarity_[b], similarity});
+    }
+
+    double similarity(size_t i) { return similarity_[root(i)]; }
+
+private:
+    std::vector<size_t> parent_;
+    std::vector<double> similarity_;
+};
+
+} // namespace
+
+void FingerprintIndex::add(const std::string& path, uint64_t fileSize, int64_t modifiedTime, Fingerprint fingerprint) {
+    entries_[path] = Entry{fileSize, modifiedTime, std::move(fingerprint)};
+}
+
+bool FingerprintIndex::remove(const std::string& path) {
+    return entries_.erase(path) > 0;
+}
+
+bool FingerprintIndex::isCurrent(const std::string& path, uint64_t fileSize, int64_t modifiedTime) const {
+    const Entry* entry = find(path);
+    return entry && entry->fileSize == fileSize && entry->modifiedTime == modifiedTime;
+}
+
+const FingerprintIndex::Entry* FingerprintIndex::find(const std::string& path) const {
+    auto it = entries_.find(path);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+FingerprintUpdateStats FingerprintIndex::update(const std::vector<std::string>& paths, int threads) {
+    WOOSH_TRACE_SCOPE("FingerprintIndex::update");
+    FingerprintUpdateStats stats;
+
+    const std::unordered_set<std::string> present(paths.begin(), paths.end());
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (present.count(it->first) == 0) {
+            it = entries_.erase(it);
+            ++stats.removed;
+        } else {
+            ++it;
+        }
+    }
+
+    struct Pending {
+        const std::string* path;
+        FileStamp stamp;
+        std::optional<Fingerprint> fingerprint;
+    };
+    std::vector<Pending> pending;
+    for (const auto& path : present) {
+        auto stamp = fileStamp(path);
+        if (!stamp) {
+            entries_.erase(path);
+            ++stats.failed;
+        } else if (isCurrent(path, stamp->size, stamp->modifiedTime)) {
+            ++stats.unchanged;
+        } else {
+            pending.push_back({&path, *stamp, std::nullopt});
+        }
+    }
+
+    // Files stream into the fingerprinter, so a worker holds one decoded
+    // block at a time rather than a whole clip
+    const int workers = threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    parallelFor(pending.size(), workers, [&](size_t i, const AudioEngine& engine) {
+        WOOSH_TRACE_SCOPE_DETAIL("FingerprintIndex::fingerprint", *pending[i].path);
+        FingerprintSink sink;
+        if (engine.streamFrames(*pending[i].path, sink)) pending[i].fingerprint = sink.finish();
+    });
+
+    for (auto& item : pending) {
+        if (item.fingerprint) {
+            add(*item.path, item.stamp.size, item.stamp.modifiedTime, std::move(*item.fingerprint));
+            ++stats.fingerprinted;
+        } else {
+            entries_.erase(*item.path);
+            ++stats.failed;
+        }
+    }
+    return stats;
+}
+
+std::vector<DuplicateCluster> FingerprintIndex::findDuplicates(double minSimilarity) const {
+    WOOSH_TRACE_SCOPE("FingerprintIndex::findDuplicates");
+
+    std::vector<const std::string*> paths;
+    std::vector<const Fingerprint*> fingerprints;
+    paths.reserve(entries_.size());
+    fingerprints.reserve(entries_.size());
+    for (const auto& [path, entry] : entries_) {
+        paths.push_back(&path);
+        fingerprints.push_back(&entry.fingerprint);
+    }
+    const size_t count = paths.size();
+    Clusters clusters(count);
+
+    // --- Exact copies ---
+    std::unordered_map<uint64_t, size_t> firstWithContent;
+    for (size_t i = 0; i < count; ++i) {
+        if (fingerprints[i]->durationSeconds <= 0.0) continue;
+        auto [it, inserted] = firstWithContent.emplace(fingerprints[i]->contentHash, i);
+        if (!inserted) clusters.join(it->second, i, 1.0);
+    }
+
+    // --- Inverted index: files of each hash, in ascending file order ---
+    std::vector<uint32_t> offsets(kHashSpace + 1, 0);
+    for (const Fingerprint* fp : fingerprints) {
+        forEachHash(*fp, [&](uint32_t hash) { ++offsets[hash + 1]; });
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<uint32_t> postings(offsets.back());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            forEachHash(*fingerprints[i], [&](uint32_t hash) { postings[fill[hash]++] = static_cast<uint32_t>(i); });
+        }
+    }
+
+    // --- Near duplicates: count hashes shared with later files, verify candidates by alignment ---
+    const size_t postingCap = std::max(kMinPostingCap, count / 200);
+    std::vector<uint32_t> shared(count, 0);
+    std::vector<uint32_t> touched;
+    for (size_t i = 0; i < count; ++i) {
+        if (fingerprints[i]->landmarks.size() < kMinNearLandmarks) continue;
+
+        forEachHash(*fingerprints[i], [&](uint32_t hash) {
+            const uint32_t* begin = postings.data() + offsets[hash];
+            const uint32_t* end = postings.data() + offsets[hash + 1];
+            if (static_cast<size_t>(end - begin) > postingCap) return;
+            for (const uint32_t* j = std::upper_bound(begin, end, static_cast<uint32_t>(i)); j != end; ++j) {
+                if (shared[*j]++ == 0) touched.push_back(*j);
+            }
+        });
+
+        for (uint32_t j : touched) {
+            if (shared[j] >= kMinCandidateHashes && fingerprints[j]->landmarks.size() >= kMinNearLandmarks) {
+                const double similarity = fingerprintSimilarity(*fingerprints[i], *fingerprints[j]);
+                if (similarity >= minSimilarity) clusters.join(i, j, similarity);
+            }
+            shared[j] = 0;
+        }
+        touched.clear();
+    }
+
+    // --- Collect clusters of two or more files ---
+    std::unordered_map<size_t, size_t> clusterOfRoot;
+    std::vector<std::vector<size_t>> members;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t root = clusters.root(i);
+        auto [it, inserted] = clusterOfRoot.emplace(root, members.size());
+        if (inserted) members.emplace_back();
+        members[it->second].push_back(i);
+    }
+
+    std::vector<DuplicateCluster> result;
+    for (const auto& group : members) {
+        if (group.size() < 2) continue;
+        DuplicateCluster cluster;
+        cluster.exact = std::all_of(group.begin(), group.end(), [&](size_t i) {
+            return fingerprints[i]->contentHash == fingerprints[group.front()]->contentHash;
+        });
+        cluster.similarity = cluster.exact ? 1.0 : clusters.similarity(group.front());
+        for (size_t i : group) cluster.paths.push_back(*paths[i]);
+        result.push_back(std::move(cluster));
+    }
+    std::sort(result.begin(), result.end(), [](const DuplicateCluster& a, const DuplicateCluster& b) {
+        if (a.paths.size() != b.paths.size()) return a.paths.size() > b.paths.size();
+        return a.paths.front() < b.paths.front();
+    });
+    return result;
+}
+
+// File layout (native byte order):
+//   "WFPI" u32 version u32 fileCount
+//   per file:    u32 pathLength, path, u64 size, i64 modifiedTime,
+//                u64 contentHash, f64 durationSeconds, u32 landmarkCount
+//   u32 hashCount
+//   per hash:    u32 hash, u32 postingCount, (u32 fileIndex, u32 frame)[postingCount]
+// Landmarks are stored inverted (hash -> files) so the index on disk is the
+// lookup structure; load() turns it back into per-file landmark lists.
+bool FingerprintIndex::save(const std::string& path) const {
+    WOOSH_TRACE_SCOPE_DETAIL("FingerprintIndex::save", path);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    out.write(kMagic, sizeof(kMagic));
+    writeValue(out, kFormatVersion);
+    writeValue(out, static_cast<uint32_t>(entries_.size()));
+
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> postings;   // (hash, file index, frame)
+    uint32_t fileIndex = 0;
+    for (const auto& [filePath, entry] : entries_) {
+        writeValue(out, static_cast<uint32_t>(filePath.size()));
+        out.write(filePath.data(), static_cast<std::streamsize>(filePath.size()));
+        writeValue(out, entry.fileSize);
+        writeValue(out, entry.modifiedTime);
+        writeValue(out, entry.fingerprint.contentHash);
+        writeValue(out, entry.fingerprint.durationSeconds);
+        writeValue(out, static_cast<uint32_t>(entry.fingerprint.landmarks.size()));
+        for (const Landmark& landmark : entry.fingerprint.landmarks) {
+            postings.emplace_back(landmark.hash, fileIndex, landmark.frame);
+        }
+        ++fileIndex;
+    }
+    std::sort(postings.begin(), postings.end());
+
+    uint32_t hashCount = 0;
+    for (size_t i = 0; i < postings.size(); ++i) {
+        if (i == 0 || std::get<0>(postings[i]) != std::get<0>(postings[i - 1])) ++hashCount;
+    }
+    writeValue(out, hashCount);
+    for (size_t i = 0; i < postings.size();) {
+        const uint32_t hash = std::get<0>(postings[i]);
+        size_t end = i;
+        while (end < postings.size() && std::get<0>(postings[end]) == hash) ++end;
+        writeValue(out, hash);
+        writeValue(out, static_cast<uint32_t>(end - i));
+        for (size_t k = i; k < end; ++k) {
+            writeValue(out, std::get<1>(postings[k]));
+            writeValue(out, std::get<2>(postings[k]));
+        }
+        i = end;
+    }
+    return static_cast<bool>(out);
+}
+
+std::optional<FingerprintIndex> FingerprintIndex::load(const std::string& path) {
+    WOOSH_TRACE_SCOPE_DETAIL("FingerprintIndex::load", path);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return std::nullopt;
+
+    char magic[sizeof(kMagic)];
+    uint32_t version = 0;
+    uint32_t fileCount = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), kMagic)) return std::nullopt;
+    if (!readValue(in, version) || version != kFormatVersion) return std::nullopt;
+    if (!readValue(in, fileCount)) return std::nullopt;
+
+    // Counts and lengths come from the file, so they are checked against
+    // what is left of it before anything is allocated for them
+    const uint64_t recordBytes = remainingBytes(in);
+    if (fileCount > recordBytes / kFileRecordBytes) return std::nullopt;
+
+    std::vector<std::pair<std::string, Entry>> files(fileCount);
+    std::vector<uint32_t> expectedLandmarks(fileCount);
+    for (uint32_t i = 0; i < fileCount; ++i) {
+        auto& [filePath, entry] = files[i];
+        uint32_t pathLength = 0;
+        if (!readValue(in, pathLength) || pathLength > remainingBytes(in)) return std::nullopt;
+        filePath.resize(pathLength);
+        if (!in.read(filePath.data(), pathLength)) return std::nullopt;
+        if (!readValue(in, entry.fileSize) || !readValue(in, entry.modifiedTime)
+            || !readValue(in, entry.fingerprint.contentHash) || !readValue(in, entry.fingerprint.durationSeconds)
+            || !readValue(in, expectedLandmarks[i])) {
+            return std::nullopt;
+        }
+        if (expectedLandmarks[i] > remainingBytes(in) / kPostingBytes) return std::nullopt;
+        entry.fingerprint.landmarks.reserve(expectedLandmarks[i]);
+    }
+
+    // Hashes come in ascending order and frames ascend within a file's
+    // postings, so every file's list is built sorted
+    uint32_t hashCount = 0;
+    if (!readValue(in, hashCount)) return std::nullopt;
+    for (uint32_t h = 0; h < hashCount; ++h) {
+        uint32_t hash = 0;
+        uint32_t postingCount = 0;
+        if (!readValue(in, hash) || !readValue(in, postingCount) || hash >= kHashSpace) return std::nullopt;
+        for (uint32_t k = 0; k < postingCount; ++k) {
+            uint32_t fileIndex = 0;
+            uint32_t frame = 0;
+            if (!readValue(in, fileIndex) || !readValue(in, frame) || fileIndex >= fileCount) return std::nullopt;
+            files[fileIndex].second.fingerprint.landmarks.push_back({hash, frame});
+        }
+    }
+
+    FingerprintIndex index;
+    for (uint32_t i = 0; i < fileCount; ++i) {
+        if (files[i].second.fingerprint.landmarks.size() != expectedLandmarks[i]) return std::nullopt;
+        index.entries_.emplace_hint(index.entries_.end(), std::move(files[i].first), std::move(files[i].second));
+    }
+    return index;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file FingerprintIndex.h
+ * @brief On-disk index of audio fingerprints for finding duplicate sounds.
+ *
+ * Holds the Fingerprint of every file in a library together with the size
+ * and modification time it was computed from, so an update only decodes
+ * files that are new or changed. Duplicates are found through an inverted
+ * index (hash -> files), which compares each file only with the files it
+ * shares hashes with instead of with the whole library.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "utils/Fingerprint.h"
+
+/**
+ * @brief Files that are copies or close variants of the same sound.
+ */
+struct DuplicateCluster {
+    std::vector<std::string> paths;     ///< Sorted
+    bool exact{false};                  ///< All members have identical samples
+    double similarity{1.0};             ///< Lowest similarity of the pairs that joined the cluster
+};
+
+/**
+ * @brief What FingerprintIndex::update() did.
+ */
+struct FingerprintUpdateStats {
+    size_t fingerprinted{0};    ///< New or changed files decoded and fingerprinted
+    size_t unchanged{0};        ///< Files whose stored fingerprint was still current
+    size_t removed{0};          ///< Entries dropped because their file is gone
+    size_t failed{0};           ///< Files that could not be decoded
+};
+
+/**
+ * @class FingerprintIndex
+ * @brief Fingerprints of a sound library, kept up to date incrementally.
+ */
+class FingerprintIndex final {
+public:
+    /** @brief A fingerprinted file and the state of the file it was computed from. */
+    struct Entry {
+        uint64_t fileSize{0};
+        int64_t modifiedTime{0};    ///< Filesystem clock ticks; only compared for equality
+        Fingerprint fingerprint;
+    };
+
+    /** @brief Add or replace the entry of @p path. */
+    void add(const std::string& path, uint64_t fileSize, int64_t modifiedTime, Fingerprint fingerprint);
+
+    /** @brief Remove the entry of @p path. @return True if there was one. */
+    bool remove(const std::string& path);
+
+    /** @brief True if @p path has an entry computed from a file of this size and time. */
+    [[nodiscard]] bool isCurrent(const std::string& path, uint64_t fileSize, int64_t modifiedTime) const;
+
+    [[nodiscard]] const Entry* find(const std::string& path) const;
+    [[nodiscard]] size_t size() const noexcept { return entries_.size(); }
+
+    /**
+     * @brief Bring the index in line with @p paths (typically FileScanner results).
+     *
+     * Files that are new or whose size or modification time changed are
+     * decoded and fingerprinted on @p threads workers; entries of files not
+     * in @p paths are removed.
+     * @param threads Worker count; 0 uses the hardware concurrency.
+     */
+    FingerprintUpdateStats update(const std::vector<std::string>& paths, int threads = 0);
+
+    /**
+     * @brief Group the indexed files into exact and near-duplicate clusters.
+     *
+     * Files with identical samples always share a cluster. Other files join
+     * when fingerprintSimilarity() of a pair reaches @p minSimilarity, i.e.
+     * enough of their landmarks line up at one time offset. Hashes
+     * found in a large share of the library say little about any one file
+     * and are skipped when looking for candidate pairs.
+     * @return Clusters of two or more files, largest first.
+     */
+    [[nodiscard]] std::vector<DuplicateCluster> findDuplicates(double minSimilarity = 0.5) const;
+
+    /** @brief Write the index to @p path. @return False on I/O failure. */
+    [[nodiscard]] bool save(const std::string& path) const;
+
+    /** @brief Read an index written by save(). @return nullopt if missing or not an index file. */
+    [[nodiscard]] static std::optional<FingerprintIndex> load(const std::string& path);
+
+private:
+    std::map<std::string, Entry> entries_;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file MemoryGovernor.cpp
+ * @brief Implementation of the clip memory budget.
+ */
+
+#include "MemoryGovernor.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+MemoryGovernor::MemoryGovernor(uint64_t budgetBytes)
+    : budget_(budgetBytes)
+{
+}
+
+void MemoryGovernor::track(ClipId id, uint64_t bytes) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        recency_.push_front(id);
+        entries_.emplace(id, Entry{bytes, recency_.begin()});
+        clipBytes_ += bytes;
+        return;
+    }
+    clipBytes_ = clipBytes_ - it->second.bytes + bytes;
+    it->second.bytes = bytes;
+    recency_.splice(recency_.begin(), recency_, it->second.position);
+}
+
+void MemoryGovernor::touch(ClipId id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return;
+    recency_.splice(recency_.begin(), recency_, it->second.position);
+}
+
+void MemoryGovernor::forget(ClipId id) {
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return;
+    clipBytes_ -= it->second.bytes;
+    recency_.erase(it->second.position);
+    entries_.erase(it);
+}
+
+void MemoryGovernor::clear() {
+    entries_.clear();
+    recency_.clear();
+    clipBytes_ = 0;
+}
+
+std::vector<MemoryGovernor::ClipId> MemoryGovernor::selectVictims(
+    const std::function<bool(ClipId)>& canEvict) const {
+    std::vector<ClipId> victims;
+    if (!overBudget()) return victims;
+
+    uint64_t used = usedBytes();
+    for (auto it = recency_.rbegin(); it != recency_.rend() && used > budget_; ++it) {
+        if (!canEvict(*it)) continue;
+        victims.push_back(*it);
+        used -= entries_.at(*it).bytes;
+    }
+    return victims;
+}
+
+uint64_t MemoryGovernor::defaultBudgetBytes() {
+#ifdef _WIN32
+    MEMORYSTATUSEX status{};
+    status.dwLength = sizeof(status);
+    if (!GlobalMemoryStatusEx(&status)) return 0;
+    return static_cast<uint64_t>(status.ullTotalPhys) / 2;
+#else
+    const long pages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) return 0;
+    return static_cast<uint64_t>(pages) * static_cast<uint64_t>(pageSize) / 2;
+#endif
+}
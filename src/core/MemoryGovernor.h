@@ -0,0 +1,86 @@
+/**
+ * @file MemoryGovernor.h
+ * @brief Memory budget for the clips held by the editor.
+ *
+ * The editor keeps every loaded clip in memory, so a large folder can push
+ * the machine into swap. The governor tracks the resident bytes of each
+ * clip in least-recently-used order, plus the caches that are not tied to
+ * a clip (waveform columns, playback buffer), and picks the clips to evict
+ * when the total goes over the budget.
+ *
+ * It only keeps the books: the owner decides which clips can be evicted
+ * (e.g. only those it can reload) and releases their samples itself.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class MemoryGovernor
+ * @brief LRU accounting of clip memory against a byte budget.
+ *
+ * Clips are identified by an id chosen by the owner (the editor uses the
+ * clip's index). Not thread-safe; used from the UI thread.
+ */
+class MemoryGovernor final {
+public:
+    using ClipId = size_t;
+
+    /** @param budgetBytes Budget for clips and caches; 0 is unlimited. */
+    explicit MemoryGovernor(uint64_t budgetBytes = 0);
+
+    void setBudget(uint64_t budgetBytes) noexcept { budget_ = budgetBytes; }
+    [[nodiscard]] uint64_t budget() const noexcept { return budget_; }
+
+    /** @brief Record @p bytes resident for @p id and mark it most recently used. */
+    void track(ClipId id, uint64_t bytes);
+
+    /** @brief Mark @p id most recently used; ignored if it is not tracked. */
+    void touch(ClipId id);
+
+    /** @brief Stop tracking @p id, e.g. after it was evicted. */
+    void forget(ClipId id);
+
+    /** @brief Forget every clip (the cache bytes stay). */
+    void clear();
+
+    /** @brief Bytes held outside the clips; counted against the budget, never evicted. */
+    void setCacheBytes(uint64_t bytes) noexcept { cacheBytes_ = bytes; }
+    [[nodiscard]] uint64_t cacheBytes() const noexcept { return cacheBytes_; }
+
+    [[nodiscard]] uint64_t clipBytes() const noexcept { return clipBytes_; }
+    [[nodiscard]] uint64_t usedBytes() const noexcept { return clipBytes_ + cacheBytes_; }
+    [[nodiscard]] size_t residentClips() const noexcept { return entries_.size(); }
+    [[nodiscard]] bool isTracked(ClipId id) const { return entries_.count(id) != 0; }
+    [[nodiscard]] bool overBudget() const noexcept { return budget_ != 0 && usedBytes() > budget_; }
+
+    /**
+     * @brief Clips to evict, least recently used first, to get within the budget.
+     *
+     * Skips clips for which @p canEvict returns false. Returns fewer clips
+     * (possibly none) if evicting every candidate is still not enough. The
+     * clips stay tracked until forget() is called for them.
+     */
+    [[nodiscard]] std::vector<ClipId> selectVictims(const std::function<bool(ClipId)>& canEvict) const;
+
+    /** @brief Half of the physical memory; 0 (unlimited) if it cannot be determined. */
+    [[nodiscard]] static uint64_t defaultBudgetBytes();
+
+private:
+    struct Entry {
+        uint64_t bytes{0};
+        std::list<ClipId>::iterator position;
+    };
+
+    uint64_t budget_;
+    uint64_t clipBytes_{0};
+    uint64_t cacheBytes_{0};
+    std::list<ClipId> recency_;     ///< Most recently used first
+    std::unordered_map<ClipId, Entry> entries_;
+};
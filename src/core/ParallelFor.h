@@ -0,0 +1,50 @@
+/**
+ * @file ParallelFor.h
+ * @brief Worker pool shared by the headless batch passes.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/AudioEngine.h"
+#include "utils/FrameRanges.h"
+#include "utils/Trace.h"
+
+/**
+ * @brief Run @p body(index, engine) for every index in [0, count) on @p threads workers.
+ *
+ * Indices are handed out one at a time, so long files do not hold up a
+ * fixed slice of the work. The workers share one AudioEngine, which keeps
+ * no state between calls; the calling thread is worker 1. Each worker holds
+ * a FrameRanges::WorkerScope, so long files split into ranges only borrow
+ * cores the other workers leave idle.
+ */
+template <typename Body>
+void parallelFor(size_t count, int threads, Body body) {
+    const size_t workerCount = std::min(static_cast<size_t>(std::max(1, threads)), std::max<size_t>(count, 1));
+    std::atomic<size_t> next{0};
+    const AudioEngine engine;
+
+    auto worker = [&](size_t workerIndex) {
+        Trace::setThreadName("Batch worker " + std::to_string(workerIndex + 1));
+        const FrameRanges::WorkerScope busy;
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            body(i, engine);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workerCount - 1);
+    for (size_t w = 1; w < workerCount; ++w) {
+        pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto& t : pool) {
+        t.join();
+    }
+}
@@ -7,28 +7,13 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include "utils/JsonEscape.h"
 
 // Simple JSON writing helpers (avoiding external dependencies)
 namespace {
 
-std::string escapeJson(const std::string& s) {
-    std::string result;
-    result.reserve(s.size() + 10);
-    for (char c : s) {
-        switch (c) {
-            case '"':  result += "\\\""; break;
-            case '\\': result += "\\\\"; break;
-            case '\b': result += "\\b"; break;
-            case '\f': result += "\\f"; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default:   result += c; break;
-        }
-    }
-    return result;
-}
-
 std::string indent(int level) {
     return std::string(level * 2, ' ');
 }
@@ -125,7 +110,30 @@ private:
         }
         return false;
     }
-    
+
+    // \uXXXX with pos_ on the 'u'; leaves pos_ on the last hex digit.
+    // Written as UTF-8; surrogate pairs are not combined.
+    void appendCodePoint(std::string& out) {
+        if (pos_ + 4 >= json_.size()) return;
+        unsigned code = 0;
+        for (size_t i = 1; i <= 4; ++i) {
+            const char h = json_[pos_ + i];
+            if (!std::isxdigit(static_cast<unsigned char>(h))) return;
+            code = code * 16 + static_cast<unsigned>(std::isdigit(h) ? h - '0' : std::tolower(h) - 'a' + 10);
+        }
+        pos_ += 4;
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+
     [[nodiscard]] std::optional<JsonValue> parseValue() {
         skipWhitespace();
         char c = peek();
@@ -155,6 +163,7 @@ private:
                     case 'n':  result += '\n'; break;
                     case 'r':  result += '\r'; break;
                     case 't':  result += '\t'; break;
+                    case 'u':  appendCodePoint(result); break;
                     default:   result += json_[pos_]; break;
                 }
             } else {
@@ -317,36 +326,27 @@ void Project::setProcessingSettings(const ProcessingSettings& settings) {
 
 void Project::addClipState(const ClipState& state) {
     clipStates_.push_back(state);
+    // The first state of a path wins, as with a front-to-back search
+    clipIndex_.emplace(state.relativePath, clipStates_.size() - 1);
     dirty_ = true;
 }
 
 void Project::updateClipState(const std::string& relativePath,
                               const std::function<void(ClipState&)>& updater) {
-    for (auto& state : clipStates_) {
-        if (state.relativePath == relativePath) {
-            updater(state);
-            dirty_ = true;
-            return;
-        }
+    if (ClipState* state = findClipState(relativePath)) {
+        updater(*state);
+        dirty_ = true;
     }
 }
 
 ClipState* Project::findClipState(const std::string& relativePath) {
-    for (auto& state : clipStates_) {
-        if (state.relativePath == relativePath) {
-            return &state;
-        }
-    }
-    return nullptr;
+    auto it = clipIndex_.find(relativePath);
+    return it != clipIndex_.end() ? &clipStates_[it->second] : nullptr;
 }
 
 const ClipState* Project::findClipState(const std::string& relativePath) const {
-    for (const auto& state : clipStates_) {
-        if (state.relativePath == relativePath) {
-            return &state;
-        }
-    }
-    return nullptr;
+    auto it = clipIndex_.find(relativePath);
+    return it != clipIndex_.end() ? &clipStates_[it->second] : nullptr;
 }
 
 bool Project::removeClipState(const std::string& relativePath) {
@@ -355,6 +355,7 @@ bool Project::removeClipState(const std::string& relativePath) {
     
     if (it != clipStates_.end()) {
         clipStates_.erase(it);
+        rebuildClipIndex();
         dirty_ = true;
         return true;
     }
@@ -364,10 +365,19 @@ bool Project::removeClipState(const std::string& relativePath) {
 void Project::clearClipStates() {
     if (!clipStates_.empty()) {
         clipStates_.clear();
+        clipIndex_.clear();
         dirty_ = true;
     }
 }
 
+void Project::rebuildClipIndex() {
+    clipIndex_.clear();
+    clipIndex_.reserve(clipStates_.size());
+    for (size_t i = 0; i < clipStates_.size(); ++i) {
+        clipIndex_.emplace(clipStates_[i].relativePath, i);
+    }
+}
+
 bool Project::save(const std::string& path) {
     std::ofstream file(path);
     if (!file.is_open()) return false;
@@ -396,7 +406,13 @@ bool Project::save(const std::string& path) {
     file << indent(2) << "\"compRatio\": " << processingSettings_.compRatio << ",\n";
     file << indent(2) << "\"compAttackMs\": " << processingSettings_.compAttackMs << ",\n";
     file << indent(2) << "\"compReleaseMs\": " << processingSettings_.compReleaseMs << ",\n";
-    file << indent(2) << "\"compMakeupDb\": " << processingSettings_.compMakeupDb << "\n";
+    file << indent(2) << "\"compMakeupDb\": " << processingSettings_.compMakeupDb << ",\n";
+    file << indent(2) << "\"limiterCeilingDb\": " << processingSettings_.limiterCeilingDb << ",\n";
+    file << indent(2) << "\"limiterLookaheadMs\": " << processingSettings_.limiterLookaheadMs << ",\n";
+    file << indent(2) << "\"limiterReleaseMs\": " << processingSettings_.limiterReleaseMs << ",\n";
+    file << indent(2) << "\"autoTrimThresholdDb\": " << processingSettings_.autoTrimThresholdDb << ",\n";
+    file << indent(2) << "\"autoTrimPreRollMs\": " << processingSettings_.autoTrimPreRollMs << ",\n";
+    file << indent(2) << "\"autoTrimPostRollMs\": " << processingSettings_.autoTrimPostRollMs << "\n";
     file << indent(1) << "},\n";
     
     // Clip states
@@ -407,6 +423,7 @@ bool Project::save(const std::string& path) {
         file << indent(3) << "\"relativePath\": \"" << escapeJson(clip.relativePath) << "\",\n";
         file << indent(3) << "\"isNormalized\": " << (clip.isNormalized ? "true" : "false") << ",\n";
         file << indent(3) << "\"isCompressed\": " << (clip.isCompressed ? "true" : "false") << ",\n";
+        file << indent(3) << "\"isLimited\": " << (clip.isLimited ? "true" : "false") << ",\n";
         file << indent(3) << "\"isTrimmed\": " << (clip.isTrimmed ? "true" : "false") << ",\n";
         file << indent(3) << "\"isExported\": " << (clip.isExported ? "true" : "false") << ",\n";
         file << indent(3) << "\"normalizeTargetDb\": " << clip.normalizeTargetDb << ",\n";
@@ -417,9 +434,30 @@ bool Project::save(const std::string& path) {
         file << indent(4) << "\"releaseMs\": " << clip.compressorSettings.releaseMs << ",\n";
         file << indent(4) << "\"makeupDb\": " << clip.compressorSettings.makeupDb << "\n";
         file << indent(3) << "},\n";
+        file << indent(3) << "\"limiter\": {\n";
+        file << indent(4) << "\"ceilingDb\": " << clip.limiterSettings.ceilingDb << ",\n";
+        file << indent(4) << "\"lookaheadMs\": " << clip.limiterSettings.lookaheadMs << ",\n";
+        file << indent(4) << "\"releaseMs\": " << clip.limiterSettings.releaseMs << "\n";
+        file << indent(3) << "},\n";
         file << indent(3) << "\"trimStartSec\": " << clip.trimStartSec << ",\n";
         file << indent(3) << "\"trimEndSec\": " << clip.trimEndSec << ",\n";
-        file << indent(3) << "\"exportedFilename\": \"" << escapeJson(clip.exportedFilename) << "\"\n";
+        file << indent(3) << "\"exportedFilename\": \"" << escapeJson(clip.exportedFilename) << "\"";
+        if (clip.info) {
+            // The modification time is a string: as a JSON number it would
+            // lose digits on the way through a double
+            const ClipInfo& info = *clip.info;
+            file << ",\n";
+            file << indent(3) << "\"info\": {\n";
+            file << indent(4) << "\"sourceSize\": " << info.sourceSize << ",\n";
+            file << indent(4) << "\"sourceModified\": \"" << info.sourceModified << "\",\n";
+            file << indent(4) << "\"frames\": " << info.frames << ",\n";
+            file << indent(4) << "\"sampleRate\": " << info.sampleRate << ",\n";
+            file << indent(4) << "\"channels\": " << info.channels << ",\n";
+            file << indent(4) << "\"peakDb\": " << info.peakDb << ",\n";
+            file << indent(4) << "\"rmsDb\": " << info.rmsDb << "\n";
+            file << indent(3) << "}";
+        }
+        file << "\n";
         file << indent(2) << "}" << (i < clipStates_.size() - 1 ? "," : "") << "\n";
     }
     file << indent(1) << "]\n";
@@ -478,6 +516,12 @@ std::optional<Project> Project::load(const std::string& path) {
         project.processingSettings_.compAttackMs = static_cast<float>(proc->getNumber("compAttackMs", 10.0));
         project.processingSettings_.compReleaseMs = static_cast<float>(proc->getNumber("compReleaseMs", 100.0));
         project.processingSettings_.compMakeupDb = static_cast<float>(proc->getNumber("compMakeupDb", 0.0));
+        project.processingSettings_.limiterCeilingDb = static_cast<float>(proc->getNumber("limiterCeilingDb", -1.0));
+        project.processingSettings_.limiterLookaheadMs = static_cast<float>(proc->getNumber("limiterLookaheadMs", 5.0));
+        project.processingSettings_.limiterReleaseMs = static_cast<float>(proc->getNumber("limiterReleaseMs", 50.0));
+        project.processingSettings_.autoTrimThresholdDb = static_cast<float>(proc->getNumber("autoTrimThresholdDb", -50.0));
+        project.processingSettings_.autoTrimPreRollMs = static_cast<float>(proc->getNumber("autoTrimPreRollMs", 10.0));
+        project.processingSettings_.autoTrimPostRollMs = static_cast<float>(proc->getNumber("autoTrimPostRollMs", 100.0));
     }
     
     // Clip states
@@ -489,6 +533,7 @@ std::optional<Project> Project::load(const std::string& path) {
             state.relativePath = clipJson.getString("relativePath");
             state.isNormalized = clipJson.getBool("isNormalized");
             state.isCompressed = clipJson.getBool("isCompressed");
+            state.isLimited = clipJson.getBool("isLimited");
             state.isTrimmed = clipJson.getBool("isTrimmed");
             state.isExported = clipJson.getBool("isExported");
             state.normalizeTargetDb = clipJson.getNumber("normalizeTargetDb");
@@ -504,9 +549,32 @@ std::optional<Project> Project::load(const std::string& path) {
                 state.compressorSettings.makeupDb = static_cast<float>(comp->getNumber("makeupDb"));
             }
             
+            if (auto* lim = clipJson.getObject("limiter")) {
+                state.limiterSettings.ceilingDb = static_cast<float>(lim->getNumber("ceilingDb", -1.0));
+                state.limiterSettings.lookaheadMs = static_cast<float>(lim->getNumber("lookaheadMs", 5.0));
+                state.limiterSettings.releaseMs = static_cast<float>(lim->getNumber("releaseMs", 50.0));
+            }
+
+            if (auto* info = clipJson.getObject("info")) {
+                ClipInfo cached;
+                cached.sourceSize = static_cast<uint64_t>(info->getNumber("sourceSize"));
+                try {
+                    cached.sourceModified = std::stoll(info->getString("sourceModified"));
+                } catch (const std::exception&) {
+                    cached.sourceModified = 0;  // Never matches a real file; the clip is decoded
+                }
+                cached.frames = static_cast<uint64_t>(info->getNumber("frames"));
+                cached.sampleRate = info->getInt("sampleRate");
+                cached.channels = info->getInt("channels");
+                cached.peakDb = static_cast<float>(info->getNumber("peakDb"));
+                cached.rmsDb = static_cast<float>(info->getNumber("rmsDb"));
+                if (cached.sampleRate > 0 && cached.channels > 0) state.info = cached;
+            }
+            
             project.clipStates_.push_back(std::move(state));
         }
     }
+    project.rebuildClipIndex();
     
     project.dirty_ = false;
     return project;
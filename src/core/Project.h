@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <optional>
 #include <functional>
@@ -37,6 +40,36 @@ struct CompressorSettings {
     float makeupDb{0.0f};     ///< Makeup gain in dB
 };
 
+/**
+ * @brief Look-ahead limiter settings applied to a clip.
+ */
+struct LimiterSettings {
+    float ceilingDb{-1.0f};   ///< Output ceiling in dBFS
+    float lookaheadMs{5.0f};  ///< Look-ahead (and attack) time in milliseconds
+    float releaseMs{50.0f};   ///< Release time in milliseconds
+};
+
+/**
+ * @brief Last known properties of a clip after its stored processing.
+ *
+ * Cached in the project so the clip list can be shown before any file is
+ * decoded. Valid while the source file keeps the recorded size and
+ * modification time.
+ */
+struct ClipInfo {
+    uint64_t sourceSize{0};
+    int64_t sourceModified{0};          ///< Filesystem clock ticks; only compared for equality
+    uint64_t frames{0};
+    int sampleRate{0};
+    int channels{0};
+    float peakDb{0.0f};
+    float rmsDb{0.0f};
+
+    [[nodiscard]] bool matchesSource(uint64_t size, int64_t modified) const noexcept {
+        return sourceSize == size && sourceModified == modified;
+    }
+};
+
 /**
  * @brief Per-clip processing state tracking.
  *
@@ -49,6 +82,7 @@ struct ClipState {
     // Processing flags
     bool isNormalized{false};
     bool isCompressed{false};
+    bool isLimited{false};
     bool isTrimmed{false};
     bool isExported{false};
     
@@ -58,6 +92,9 @@ struct ClipState {
     // Compressor parameters (if applied)
     CompressorSettings compressorSettings;
     
+    // Limiter parameters (if applied)
+    LimiterSettings limiterSettings;
+    
     // Trim parameters (if applied)
     double trimStartSec{0.0};
     double trimEndSec{0.0};
@@ -68,6 +105,32 @@ struct ClipState {
     
     // Export info
     std::string exportedFilename;       ///< Name of exported file in game folder
+
+    std::optional<ClipInfo> info;       ///< Cached clip properties, if known
+
+    /** @brief True if any processing is stored (i.e. a reload must re-apply it). */
+    [[nodiscard]] bool hasProcessing() const noexcept {
+        return isTrimmed || isNormalized || isCompressed || isLimited;
+    }
+
+    /**
+     * @brief Forget all stored processing, e.g. after the clip was restored to its source.
+     *
+     * The cached info described the processed clip, so it goes too; fades and
+     * export info are kept.
+     */
+    void clearProcessing() {
+        isNormalized = false;
+        isCompressed = false;
+        isLimited = false;
+        isTrimmed = false;
+        normalizeTargetDb = 0.0;
+        compressorSettings = {};
+        limiterSettings = {};
+        trimStartSec = 0.0;
+        trimEndSec = 0.0;
+        info.reset();
+    }
 };
 
 /**
@@ -91,6 +154,12 @@ struct ProcessingSettings {
     float compAttackMs{10.0f};          ///< Default attack time
     float compReleaseMs{100.0f};        ///< Default release time
     float compMakeupDb{0.0f};           ///< Default makeup gain
+    float limiterCeilingDb{-1.0f};      ///< Default limiter ceiling
+    float limiterLookaheadMs{5.0f};     ///< Default limiter look-ahead
+    float limiterReleaseMs{50.0f};      ///< Default limiter release time
+    float autoTrimThresholdDb{-50.0f};  ///< Auto-trim: RMS below this counts as silence
+    float autoTrimPreRollMs{10.0f};     ///< Auto-trim: silence kept before the sound
+    float autoTrimPostRollMs{100.0f};   ///< Auto-trim: silence kept after the sound
 };
 
 /**
@@ -158,12 +227,15 @@ public:
     [[nodiscard]] static std::optional<Project> load(const std::string& path);
     
 private:
+    void rebuildClipIndex();
+
     std::string name_;
     std::string rawFolder_;
     std::string gameFolder_;
     std::string filePath_;              ///< Path where project was saved/loaded
     
     std::vector<ClipState> clipStates_;
+    std::unordered_map<std::string, size_t> clipIndex_;    ///< relativePath -> clipStates_ index
     ExportSettings exportSettings_;
     ProcessingSettings processingSettings_;
     
@@ -0,0 +1,214 @@
+/**
+ * @file ShardQueue.cpp
+ * @brief Implementation of the file-based shard queue.
+ */
+
+#include "ShardQueue.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr const char* kQueueHeader = "woosh-shard-queue 1";
+constexpr const char* kQueueFile = "queue";
+
+bool isQueueFile(const std::string& name) {
+    return name == kQueueFile || name.rfind("shard-", 0) == 0;
+}
+
+/// Create @p path only if it does not exist yet; the basis of every claim.
+bool createExclusive(const fs::path& path, const std::string& content) {
+    std::FILE* file = std::fopen(path.string().c_str(), "wx");
+    if (!file) return false;
+    const bool written = std::fwrite(content.data(), 1, content.size(), file) == content.size();
+    return std::fclose(file) == 0 && written;
+}
+
+/// Write @p content under a temporary name and rename it into place, so readers never see half a file.
+bool writeAtomically(const fs::path& path, const std::string& content) {
+    fs::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << content;
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) fs::remove(temp, ec);
+    return !ec;
+}
+
+} // namespace
+
+ShardQueue::ShardQueue(std::string directory)
+    : directory_(std::move(directory))
+{
+}
+
+bool ShardQueue::create(const std::vector<std::string>& files, size_t shardSize) {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    if (!fs::is_directory(directory_, ec)) return false;
+
+    // Drop the header first so no worker starts on a half-rewritten queue
+    fs::remove(fs::path(directory_) / kQueueFile, ec);
+    std::vector<fs::path> stale;
+    for (const auto& entry : fs::directory_iterator(directory_, ec)) {
+        if (isQueueFile(entry.path().filename().string())) stale.push_back(entry.path());
+    }
+    for (const auto& path : stale) fs::remove(path, ec);
+
+    shardSize = std::max<size_t>(1, shardSize);
+    const size_t count = (files.size() + shardSize - 1) / shardSize;
+    for (size_t shard = 0; shard < count; ++shard) {
+        std::string list;
+        const size_t end = std::min(files.size(), (shard + 1) * shardSize);
+        for (size_t i = shard * shardSize; i < end; ++i) list += files[i] + '\n';
+        if (!writeAtomically(shardFile(shard, ".list"), list)) return false;
+    }
+    return writeAtomically(fs::path(directory_) / kQueueFile,
+                           std::string(kQueueHeader) + '\n' + std::to_string(count) + '\n');
+}
+
+std::optional<size_t> ShardQueue::shardCount() const {
+    std::ifstream in(fs::path(directory_) / kQueueFile);
+    std::string header;
+    size_t count = 0;
+    if (!std::getline(in, header) || header != kQueueHeader || !(in >> count)) return std::nullopt;
+    return count;
+}
+
+std::optional<ShardQueue::Claim> ShardQueue::claim(const std::string& worker, std::chrono::seconds staleAfter) {
+    const auto count = shardCount();
+    if (!count) return std::nullopt;
+
+    std::error_code ec;
+    for (size_t shard = 0; shard < *count; ++shard) {
+        if (fs::exists(shardFile(shard, ".done"), ec)) continue;
+        if (createExclusive(shardFile(shard, ".claim"), worker + '\n')) return Claim{shard, files(shard)};
+    }
+
+    // Take over claims of workers that stopped making progress. Renaming the
+    // old claim away succeeds for only one of several competing workers; a
+    // worker that checked staleness just before a takeover may still take
+    // the shard again, which costs a duplicate export but loses nothing.
+    for (size_t shard = 0; shard < *count; ++shard) {
+        if (fs::exists(shardFile(shard, ".done"), ec) || !isStale(shard, staleAfter)) continue;
+
+        const fs::path claimFile = shardFile(shard, ".claim");
+        fs::path abandoned = claimFile;
+        abandoned += ".stale";
+        fs::rename(claimFile, abandoned, ec);
+        if (ec) continue;
+        fs::remove(abandoned, ec);
+        if (createExclusive(claimFile, worker + '\n')) return Claim{shard, files(shard)};
+    }
+    return std::nullopt;
+}
+
+void ShardQueue::heartbeat(size_t shard) const {
+    std::error_code ec;
+    fs::last_write_time(shardFile(shard, ".claim"), fs::file_time_type::clock::now(), ec);
+}
+
+ShardQueue::Heartbeat::Heartbeat(const ShardQueue& queue, size_t shard, std::chrono::milliseconds interval) {
+    interval = std::max(interval, std::chrono::milliseconds(10));
+    thread_ = std::thread([this, &queue, shard, interval] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval, [this] { return stopping_; })) {
+            queue.heartbeat(shard);
+        }
+    });
+}
+
+ShardQueue::Heartbeat::~Heartbeat() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+bool ShardQueue::isClaimedBy(size_t shard, const std::string& worker) const {
+    std::ifstream in(shardFile(shard, ".claim"));
+    std::string owner;
+    return std::getline(in, owner) && owner == worker;
+}
+
+size_t ShardQueue::releaseClaims(const std::string& worker) const {
+    size_t released = 0;
+    const size_t count = shardCount().value_or(0);
+    std::error_code ec;
+    for (size_t shard = 0; shard < count; ++shard) {
+        if (fs::exists(shardFile(shard, ".done"), ec) || !isClaimedBy(shard, worker)) continue;
+        if (fs::remove(shardFile(shard, ".claim"), ec)) ++released;
+    }
+    return released;
+}
+
+bool ShardQueue::complete(size_t shard, const ShardResult& result) const {
+    // A worker whose claim went stale and was taken over leaves the shard to
+    // the new owner. The check and the write are not one atomic step, but
+    // the heartbeat keeps a running worker's claim far from stale.
+    if (!isClaimedBy(shard, result.worker)) return false;
+
+    char totals[128];
+    std::snprintf(totals, sizeof(totals), "%zu %zu %zu %zu\n",
+                  result.files, result.exported, result.upToDate, result.failed);
+    return writeAtomically(shardFile(shard, ".done"), totals + result.worker + '\n');
+}
+
+std::optional<ShardResult> ShardQueue::result(size_t shard) const {
+    std::ifstream in(shardFile(shard, ".done"));
+    ShardResult result;
+    if (!(in >> result.files >> result.exported >> result.upToDate >> result.failed)) return std::nullopt;
+    in >> std::ws;
+    std::getline(in, result.worker);
+    return result;
+}
+
+std::vector<std::string> ShardQueue::files(size_t shard) const {
+    std::vector<std::string> files;
+    std::ifstream in(shardFile(shard, ".list"));
+    for (std::string line; std::getline(in, line);) {
+        if (!line.empty()) files.push_back(line);
+    }
+    return files;
+}
+
+ShardQueue::Status ShardQueue::status(std::chrono::seconds staleAfter) const {
+    Status status;
+    status.total = shardCount().value_or(0);
+    std::error_code ec;
+    for (size_t shard = 0; shard < status.total; ++shard) {
+        if (fs::exists(shardFile(shard, ".done"), ec)) {
+            ++status.done;
+        } else if (fs::exists(shardFile(shard, ".claim"), ec) && !isStale(shard, staleAfter)) {
+            ++status.claimed;
+        } else {
+            ++status.unclaimed;
+        }
+    }
+    return status;
+}
+
+std::string ShardQueue::shardFile(size_t shard, const char* extension) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "shard-%05zu", shard);
+    return (fs::path(directory_) / (name + std::string(extension))).string();
+}
+
+bool ShardQueue::isStale(size_t shard, std::chrono::seconds staleAfter) const {
+    std::error_code ec;
+    const auto claimed = fs::last_write_time(shardFile(shard, ".claim"), ec);
+    return !ec && fs::file_time_type::clock::now() - claimed >= staleAfter;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file ShardQueue.h
+ * @brief File-based work queue that lets several processes share one batch.
+ *
+ * A coordinator splits the RAW files of a project into shards and writes
+ * them into a queue folder. Workers, local child processes or other
+ * machines that see the same folder, claim shards by creating a lock file
+ * exclusively, export them, and mark them done with their totals. Workers
+ * refresh their claims while they run; a claim whose worker died stops
+ * being refreshed and is taken over once it is older than the stale timeout.
+ *
+ * Queue folder layout:
+ *   queue                 Header and shard count, written last
+ *   shard-NNNNN.list      Files of the shard, relative to the RAW folder
+ *   shard-NNNNN.claim     Lock file; holds the worker's name
+ *   shard-NNNNN.done      Totals of the finished shard
+ *   shard-NNNNN.manifest  The worker's export manifest (see ExportManifest)
+ *   shard-NNNNN.json      The worker's batch reports
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Totals of one finished shard.
+ */
+struct ShardResult {
+    size_t files{0};
+    size_t exported{0};
+    size_t upToDate{0};
+    size_t failed{0};
+    std::string worker;
+};
+
+/**
+ * @class ShardQueue
+ * @brief Creates, claims and completes the shards of a queue folder.
+ *
+ * Claims rely on exclusive file creation, which is atomic on local file
+ * systems and on SMB and NFSv3+ shares. Any number of ShardQueue objects
+ * in any number of processes may work on the same folder.
+ */
+class ShardQueue final {
+public:
+    static constexpr size_t kDefaultShardSize = 16;
+    static constexpr std::chrono::seconds kDefaultStaleAfter{600};
+
+    struct Claim {
+        size_t shard{0};
+        std::vector<std::string> files;     ///< Relative to the RAW folder
+    };
+
+    struct Status {
+        size_t total{0};
+        size_t done{0};
+        size_t claimed{0};      ///< In progress; stale claims count as unclaimed
+        size_t unclaimed{0};
+    };
+
+    explicit ShardQueue(std::string directory);
+
+    [[nodiscard]] const std::string& directory() const noexcept { return directory_; }
+
+    /**
+     * @brief Write a fresh queue of @p files, @p shardSize per shard.
+     *
+     * Removes the queue files of an earlier run from the folder; other
+     * files are left alone.
+     * @return False if the folder cannot be written.
+     */
+    [[nodiscard]] bool create(const std::vector<std::string>& files, size_t shardSize = kDefaultShardSize);
+
+    /** @brief Number of shards; nullopt if the folder holds no complete queue. */
+    [[nodiscard]] std::optional<size_t> shardCount() const;
+
+    /**
+     * @brief Claim the next shard nobody is working on.
+     *
+     * Unclaimed shards are taken first; then shards whose claim is older
+     * than @p staleAfter and still not done.
+     * @return nullopt once every shard is done or actively claimed.
+     */
+    [[nodiscard]] std::optional<Claim> claim(const std::string& worker,
+                                             std::chrono::seconds staleAfter = kDefaultStaleAfter);
+
+    /** @brief Refresh the claim of @p shard so it is not considered stale. */
+    void heartbeat(size_t shard) const;
+
+    /**
+     * @class Heartbeat
+     * @brief Refreshes the claim of a shard from a background thread while it lives.
+     *
+     * Held by a worker around the export of a shard, so a shard that takes
+     * longer than the stale timeout is not taken over while it still runs.
+     */
+    class Heartbeat final {
+    public:
+        /** @param interval Time between refreshes; well below the stale timeout. */
+        Heartbeat(const ShardQueue& queue, size_t shard, std::chrono::milliseconds interval);
+        ~Heartbeat();
+
+        Heartbeat(const Heartbeat&) = delete;
+        Heartbeat& operator=(const Heartbeat&) = delete;
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stopping_{false};      // Guarded by mutex_
+        std::thread thread_;
+    };
+
+    /** @brief Whether the claim on @p shard is held by @p worker. */
+    [[nodiscard]] bool isClaimedBy(size_t shard, const std::string& worker) const;
+
+    /**
+     * @brief Drop the claims @p worker holds on shards that are not done.
+     *
+     * For a coordinator whose worker process crashed: the shards become
+     * claimable again right away instead of after the stale timeout.
+     * @return Number of claims released.
+     */
+    size_t releaseClaims(const std::string& worker) const;
+
+    /**
+     * @brief Mark @p shard done with @p result, if result.worker still holds its claim.
+     * @return False if the claim was taken over, or on I/O failure.
+     */
+    [[nodiscard]] bool complete(size_t shard, const ShardResult& result) const;
+
+    /** @brief Totals of @p shard; nullopt while it is not done. */
+    [[nodiscard]] std::optional<ShardResult> result(size_t shard) const;
+
+    [[nodiscard]] std::vector<std::string> files(size_t shard) const;
+    [[nodiscard]] Status status(std::chrono::seconds staleAfter = kDefaultStaleAfter) const;
+
+    /** @brief Path of a file of @p shard, e.g. shardFile(3, ".manifest"). */
+    [[nodiscard]] std::string shardFile(size_t shard, const char* extension) const;
+
+private:
+    bool isStale(size_t shard, std::chrono::seconds staleAfter) const;
+
+    std::string directory_;
+};
@@ -0,0 +1,107 @@
+/**
+ * @file ShardedBatch.cpp
+ * @brief Implementation of the sharded batch worker and coordinator steps.
+ */
+
+#include "ShardedBatch.h"
+
+#include <filesystem>
+#include <system_error>
+
+#include "core/ExportCache.h"
+#include "utils/FileScanner.h"
+
+namespace fs = std::filesystem;
+
+namespace ShardedBatch {
+
+std::string defaultQueueFolder(const Project& project) {
+    return (fs::path(project.gameFolder()) / ".woosh-shards").string();
+}
+
+bool createQueue(ShardQueue& queue, const Project& project, size_t shardSize) {
+    // Shards list paths relative to the RAW folder, so machines that mount
+    // the shared folder at different places can still resolve them
+    std::vector<std::string> files;
+    for (const auto& path : FileScanner().scan(project.rawFolder())) {
+        files.push_back(fs::path(path).lexically_relative(project.rawFolder()).generic_string());
+    }
+    return queue.create(files, shardSize);
+}
+
+ShardResult runWorker(ShardQueue& queue, const Project& project, const BatchRunner& runner,
+                      const std::string& worker, bool useExportCache, std::chrono::seconds staleAfter) {
+    ShardResult total;
+    total.worker = worker;
+
+    while (auto claim = queue.claim(worker, staleAfter)) {
+        std::vector<std::string> paths;
+        paths.reserve(claim->files.size());
+        for (const auto& file : claim->files) {
+            paths.push_back((fs::path(project.rawFolder()) / fs::path(file)).lexically_normal().string());
+        }
+
+        const std::string manifestFile = useExportCache ? queue.shardFile(claim->shard, ".manifest") : std::string();
+        BatchRunResult run;
+        {
+            // Long shards must not look abandoned while they run
+            const ShardQueue::Heartbeat heartbeat(
+                queue, claim->shard, std::chrono::duration_cast<std::chrono::milliseconds>(staleAfter) / 4);
+            run = runner.runFiles(project, std::move(paths), true, useExportCache, manifestFile);
+        }
+
+        ShardResult shard;
+        shard.worker = worker;
+        shard.files = claim->files.size();
+        shard.exported = run.exportedFiles;
+        shard.upToDate = run.upToDateFiles;
+        for (const auto& report : run.reports) shard.failed += report.failedFiles;
+        // A run error here means only the shard's manifest is missing; the
+        // merge then forgets its outputs and they are exported again next time
+
+        // Another worker took the shard over after all; its files are the ones kept
+        if (!queue.isClaimedBy(claim->shard, worker)) continue;
+        (void)writeBatchReportsJson(queue.shardFile(claim->shard, ".json"), run.reports);
+        // An unrecorded shard is reclaimed once its claim goes stale
+        if (!queue.complete(claim->shard, shard)) continue;
+
+        total.files += shard.files;
+        total.exported += shard.exported;
+        total.upToDate += shard.upToDate;
+        total.failed += shard.failed;
+    }
+    return total;
+}
+
+ShardResult totals(const ShardQueue& queue) {
+    ShardResult total;
+    const size_t count = queue.shardCount().value_or(0);
+    for (size_t shard = 0; shard < count; ++shard) {
+        const auto result = queue.result(shard);
+        if (!result) continue;
+        total.files += result->files;
+        total.exported += result->exported;
+        total.upToDate += result->upToDate;
+        total.failed += result->failed;
+    }
+    return total;
+}
+
+bool mergeManifests(const ShardQueue& queue, const Project& project) {
+    ExportManifest manifest = ExportManifest::load(project.gameFolder());
+    const auto format = project.exportSettings().format;
+
+    const size_t count = queue.shardCount().value_or(0);
+    std::error_code ec;
+    for (size_t shard = 0; shard < count; ++shard) {
+        const std::string shardManifest = queue.shardFile(shard, ".manifest");
+        if (!queue.result(shard) || !fs::exists(shardManifest, ec)) continue;
+
+        std::vector<std::string> outputs;
+        for (const auto& file : queue.files(shard)) outputs.push_back(ExportCache::outputFileName(file, format));
+        manifest.merge(ExportManifest::loadFile(shardManifest), outputs);
+    }
+    return manifest.save(project.gameFolder());
+}
+
+} // namespace ShardedBatch
@@ -0,0 +1,51 @@
+/**
+ * @file ShardedBatch.h
+ * @brief Runs a project's batch as shards of a ShardQueue, across processes.
+ *
+ * The coordinator queues the RAW files, starts the workers (local child
+ * processes, other machines, or both), waits for the queue to drain and
+ * merges the workers' export manifests. Each worker runs the normal
+ * BatchRunner on the shards it claims, in its own process, so codec and
+ * allocator state is never shared and a crash only loses its claimed shard.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "core/BatchRunner.h"
+#include "core/Project.h"
+#include "core/ShardQueue.h"
+
+namespace ShardedBatch {
+
+/** @brief Default queue folder of a project: hidden inside its game folder, which all workers share. */
+[[nodiscard]] std::string defaultQueueFolder(const Project& project);
+
+/** @brief Queue every RAW file of @p project. @return False if the queue cannot be written. */
+[[nodiscard]] bool createQueue(ShardQueue& queue, const Project& project,
+                               size_t shardSize = ShardQueue::kDefaultShardSize);
+
+/**
+ * @brief Claim and export shards until none is left.
+ *
+ * Each shard's export manifest and batch reports are written next to it in
+ * the queue folder.
+ * @param worker Name recorded in claims and results, e.g. host:pid.
+ * @return Totals of the shards this worker finished.
+ */
+ShardResult runWorker(ShardQueue& queue, const Project& project, const BatchRunner& runner,
+                      const std::string& worker, bool useExportCache = true,
+                      std::chrono::seconds staleAfter = ShardQueue::kDefaultStaleAfter);
+
+/** @brief Sum of the results of all finished shards. */
+[[nodiscard]] ShardResult totals(const ShardQueue& queue);
+
+/**
+ * @brief Fold the finished shards' manifests into the game folder's manifest.
+ * @return False if the merged manifest cannot be written.
+ */
+[[nodiscard]] bool mergeManifests(const ShardQueue& queue, const Project& project);
+
+} // namespace ShardedBatch
@@ -3,13 +3,79 @@
  * @brief Woosh Audio Batch Editor entry point.
  *
  * Sets up the Qt application with dark theme styling and launches MainWindow.
+ *
+ * Command line:
+ *   --trace <file>   Record load/process/export spans and write them as
+ *                    Chrome trace-event JSON on exit. The WOOSH_TRACE
+ *                    environment variable does the same.
+ *   --startup-trace  Print how long each startup phase took (from process
+ *                    start until the window is interactive) to stderr.
+ *
+ * Headless mode (no window, for nightly asset builds):
+ *   --headless --project <file.wooshp> [--report <file.json>]
+ *              [--threads <n>] [--no-export] [--force-export] [--trace <file>]
+ *              [--io-depth <n>]
+ *                    Load, process and export the project, print a
+ *                    per-batch performance summary and optionally write it
+ *                    as JSON. Clips whose export is unchanged (per the
+ *                    manifest in the game folder) are skipped unless
+ *                    --force-export is given. Exits non-zero if any file
+ *                    failed. --io-depth sets the reads/writes kept in
+ *                    flight (io_uring on Linux; default 32); 0 reads and
+ *                    writes on the workers instead.
+ *   --headless --duplicates --project <file.wooshp> [--index <file>]
+ *              [--similarity <0..1>] [--threads <n>]
+ *                    Fingerprint the RAW folder and print clusters of
+ *                    exact and near-duplicate sounds. The fingerprint index
+ *                    (default: <project>.fpindex next to the project) is
+ *                    updated incrementally, so only new or changed files
+ *                    are decoded on later runs.
+ *   --headless --workers <n> --project <file.wooshp> [--shard-queue <dir>]
+ *              [--shard-size <n>] [--threads <n>] [--force-export]
+ *                    Split the RAW files into shards in a queue folder
+ *                    (default: .woosh-shards in the game folder), export
+ *                    them with <n> worker processes, then merge the export
+ *                    manifests. Workers on other machines can join with
+ *                    --shard-worker; with --workers 0 only they do the work.
+ *   --headless --shard-worker --project <file.wooshp> [--shard-queue <dir>]
+ *              [--threads <n>] [--force-export]
+ *                    Export shards of an existing queue until none is left.
+ *   --headless --watch --project <file.wooshp> [--threads <n>]
+ *                    Export the project, then keep watching the RAW folder
+ *                    and re-export new or rewritten files a moment after
+ *                    they are saved, until interrupted.
  */
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
 #include <QIcon>
 #include <QFont>
+#include <QProcess>
+#include <QSysInfo>
+#include <QThread>
+#include <QTimer>
 #include <QStyleFactory>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include "core/BatchRunner.h"
+#include "core/FingerprintIndex.h"
+#include "core/ShardedBatch.h"
 #include "ui/MainWindow.h"
+#include "utils/AsyncFileIO.h"
+#include "utils/BatchReport.h"
+#include "utils/FileScanner.h"
+#include "utils/FolderWatcher.h"
+#include "utils/StartupProfile.h"
+#include "utils/Trace.h"
 
 /**
  * @brief Apply a modern dark theme stylesheet to the application.
@@ -315,25 +381,452 @@ static void applyDarkTheme(QApplication& app) {
     )");
 }
 
+/**
+ * @brief Update the fingerprint index of a project's RAW folder and print its duplicate clusters.
+ * @return Process exit code.
+ */
+static int reportDuplicates(const Project& project, const std::string& indexPath, int threads, double minSimilarity) {
+    if (project.rawFolder().empty()) {
+        std::fprintf(stderr, "Project has no RAW folder\n");
+        return 1;
+    }
+
+    FileScanner scanner;
+    const std::vector<std::string> paths = scanner.scan(project.rawFolder());
+
+    FingerprintIndex index = FingerprintIndex::load(indexPath).value_or(FingerprintIndex{});
+    const FingerprintUpdateStats stats = index.update(paths, threads);
+    std::printf("Fingerprints: %zu new or changed, %zu unchanged, %zu removed, %zu failed\n",
+                stats.fingerprinted, stats.unchanged, stats.removed, stats.failed);
+    if (!index.save(indexPath)) {
+        std::fprintf(stderr, "Could not write fingerprint index %s\n", indexPath.c_str());
+        return 1;
+    }
+
+    const std::vector<DuplicateCluster> clusters = index.findDuplicates(minSimilarity);
+    for (const auto& cluster : clusters) {
+        if (cluster.exact) {
+            std::printf("\nExact copies (%zu files):\n", cluster.paths.size());
+        } else {
+            std::printf("\nNear duplicates (%zu files, similarity >= %.2f):\n", cluster.paths.size(), cluster.similarity);
+        }
+        for (const auto& path : cluster.paths) {
+            std::printf("  %s\n", path.c_str());
+        }
+    }
+    std::printf("\n%zu duplicate clusters in %zu files\n", clusters.size(), index.size());
+
+    return stats.failed == 0 ? 0 : 1;
+}
+
+static FolderWatcher* activeWatcher = nullptr;
+
+static void stopWatching(int) {
+    if (activeWatcher) activeWatcher->stop();
+}
+
+/**
+ * @brief Export the project, then re-export RAW files whenever they change.
+ *
+ * Every round runs the full batch; the export manifest limits the work to
+ * the changed files. The project file is re-read each round so processing
+ * saved from the GUI in the meantime is applied.
+ * @return Process exit code once interrupted.
+ */
+static int watchProject(const std::string& projectPath, int threads) {
+    auto project = Project::load(projectPath);
+    if (!project) {
+        std::fprintf(stderr, "Could not load project %s\n", projectPath.c_str());
+        return 2;
+    }
+
+    const BatchRunner runner(threads);
+    auto runRound = [&](size_t changedFiles) {
+        const auto start = std::chrono::steady_clock::now();
+        const BatchRunResult result = runner.run(*project);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        size_t failedFiles = 0;
+        for (const auto& report : result.reports) failedFiles += report.failedFiles;
+
+        char stamp[16];
+        const std::time_t now = std::time(nullptr);
+        std::strftime(stamp, sizeof(stamp), "%H:%M:%S", std::localtime(&now));
+        std::printf("[%s] %zu changed: exported %zu, %zu up to date, %zu failed (%.0f ms)\n",
+                    stamp, changedFiles, result.exportedFiles, result.upToDateFiles, failedFiles, ms);
+        for (const auto& error : result.exportErrors) std::fprintf(stderr, "Export failed: %s\n", error.c_str());
+        if (!result.ok()) std::fprintf(stderr, "%s\n", result.error.c_str());
+        std::fflush(stdout);
+    };
+
+    // Exports must not retrigger the watch when the game folder is inside the RAW folder
+    FolderWatcher::Options options;
+    options.excludedFolder = project->gameFolder();
+    FolderWatcher watcher(project->rawFolder(), options);
+    activeWatcher = &watcher;
+    std::signal(SIGINT, stopWatching);
+    std::signal(SIGTERM, stopWatching);
+
+    // Catch up on everything that changed while nobody was watching; the
+    // watcher already exists, so files saved during this round are not missed
+    runRound(0);
+    std::printf("Watching %s (%s), Ctrl+C to stop\n", project->rawFolder().c_str(),
+                watcher.usesNotifications() ? "notifications" : "polling");
+    std::fflush(stdout);
+
+    while (true) {
+        const auto changed = watcher.waitForChanges();
+        if (watcher.stopped()) break;
+
+        if (auto reloaded = Project::load(projectPath)) {
+            project = std::move(reloaded);
+        } else {
+            std::fprintf(stderr, "Could not reload project %s, using the previous settings\n", projectPath.c_str());
+        }
+        runRound(changed.size());
+    }
+
+    activeWatcher = nullptr;
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    return 0;
+}
+
+/**
+ * @brief Name a worker process records in its shard claims: host:pid.
+ */
+static std::string shardWorkerName(qint64 pid) {
+    return QSysInfo::machineHostName().toStdString() + ":" + std::to_string(pid);
+}
+
+static void printShardTotals(const ShardResult& totals, const char* what) {
+    std::printf("%s: %zu files, exported %zu, %zu up to date, %zu failed\n",
+                what, totals.files, totals.exported, totals.upToDate, totals.failed);
+}
+
+/**
+ * @brief Export shards of an existing queue until none is left.
+ * @return Process exit code.
+ */
+static int runShardWorker(const Project& project, const std::string& queueFolder, int threads, bool useExportCache) {
+    ShardQueue queue(queueFolder);
+    if (!queue.shardCount()) {
+        std::fprintf(stderr, "No shard queue in %s\n", queueFolder.c_str());
+        return 2;
+    }
+
+    const std::string worker = shardWorkerName(QCoreApplication::applicationPid());
+    const ShardResult totals = ShardedBatch::runWorker(queue, project, BatchRunner(threads), worker, useExportCache);
+    printShardTotals(totals, worker.c_str());
+    return totals.failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Queue the project's RAW files, run @p workers local worker
+ *        processes on them, and merge the results once the queue is drained.
+ *
+ * Remote workers started with --shard-worker on the same queue folder help
+ * drain it. The coordinator returns once every shard is done, or once its
+ * own workers have exited and no other worker holds a live claim.
+ * @return Process exit code.
+ */
+static int runShardCoordinator(const Project& project, const QString& projectPath, const std::string& queueFolder,
+                               int workers, int threads, size_t shardSize, bool useExportCache) {
+    ShardQueue queue(queueFolder);
+    if (!ShardedBatch::createQueue(queue, project, shardSize)) {
+        std::fprintf(stderr, "Could not write the shard queue to %s\n", queueFolder.c_str());
+        return 1;
+    }
+    const auto shardCount = queue.shardCount().value_or(0);
+    std::printf("Queued %zu shards in %s\n", shardCount, queueFolder.c_str());
+    std::fflush(stdout);
+
+    // Split the cores between the workers unless told otherwise
+    if (threads <= 0 && workers > 0) {
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / workers);
+    }
+    QStringList arguments = {"--headless", "--shard-worker", "--project", projectPath,
+                             "--shard-queue", QString::fromStdString(queueFolder),
+                             "--threads", QString::number(threads)};
+    if (!useExportCache) arguments << "--force-export";
+
+    // The pid is kept apart because QProcess forgets it once the process has exited
+    struct WorkerProcess {
+        std::unique_ptr<QProcess> process;
+        std::string name;
+    };
+    auto startWorker = [&]() {
+        WorkerProcess worker{std::make_unique<QProcess>(), {}};
+        worker.process->setProcessChannelMode(QProcess::ForwardedChannels);
+        worker.process->start(QCoreApplication::applicationFilePath(), arguments);
+        if (!worker.process->waitForStarted()) {
+            std::fprintf(stderr, "Could not start a worker process\n");
+            worker.process.reset();
+            return worker;
+        }
+        worker.name = shardWorkerName(worker.process->processId());
+        return worker;
+    };
+
+    std::vector<WorkerProcess> processes;
+    for (int i = 0; i < workers; ++i) {
+        processes.push_back(startWorker());
+    }
+
+    // A crashed worker's shards are released and picked up by the others, or
+    // by a replacement if none is left; replacements are capped so a file
+    // that crashes every worker cannot keep the run going forever
+    int replacements = workers;
+    while (true) {
+        bool running = false;
+        for (auto& worker : processes) {
+            if (!worker.process || worker.process->state() == QProcess::NotRunning) continue;
+            if (!worker.process->waitForFinished(100)) {
+                running = true;
+                continue;
+            }
+            if (worker.process->exitStatus() == QProcess::CrashExit) {
+                const size_t released = queue.releaseClaims(worker.name);
+                std::fprintf(stderr, "Worker %s crashed; %zu shard(s) released\n", worker.name.c_str(), released);
+                if (replacements > 0) {
+                    --replacements;
+                    worker = startWorker();
+                    running = running || worker.process != nullptr;
+                }
+            }
+        }
+
+        const auto status = queue.status();
+        if (status.done == status.total) break;
+        if (workers > 0 && !running && status.claimed == 0) break;
+        if (!running) QThread::msleep(250);
+    }
+
+    const auto status = queue.status();
+    const ShardResult totals = ShardedBatch::totals(queue);
+    printShardTotals(totals, "Total");
+    std::printf("Per-shard batch reports (shard-*.json) are in %s\n", queueFolder.c_str());
+
+    if (useExportCache && !ShardedBatch::mergeManifests(queue, project)) {
+        std::fprintf(stderr, "Could not write the export manifest to %s\n", project.gameFolder().c_str());
+        return 1;
+    }
+    if (status.done != status.total) {
+        std::fprintf(stderr, "%zu of %zu shards were not finished\n", status.total - status.done, status.total);
+        return 1;
+    }
+    return totals.failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Run load/process/export of a project without a GUI.
+ * @return Process exit code.
+ */
+static int runHeadless(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("Woosh");
+    QCoreApplication::setApplicationName("Woosh Audio Editor");
+    QCoreApplication::setApplicationVersion("0.1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Woosh Audio Batch Editor (headless)");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption headlessOption("headless", "Run without a window.");
+    QCommandLineOption projectOption("project", "Project file to process.", "file");
+    QCommandLineOption reportOption("report", "Write the batch performance report as JSON to <file>.", "file");
+    QCommandLineOption threadsOption("threads", "Worker threads (default: all cores).", "n", "0");
+    QCommandLineOption noExportOption("no-export", "Load and process only; skip the export batch.");
+    QCommandLineOption forceExportOption("force-export", "Export every clip, even if its output is up to date.");
+    QCommandLineOption traceOption("trace", "Write a Chrome trace of the run to <file>.", "file");
+    QCommandLineOption duplicatesOption("duplicates", "Report duplicate sounds in the RAW folder instead of running the batches.");
+    QCommandLineOption indexOption("index", "Fingerprint index for --duplicates (default: next to the project).", "file");
+    QCommandLineOption similarityOption("similarity", "Shared fingerprint share for near duplicates (default: 0.5).", "0..1", "0.5");
+    QCommandLineOption watchOption("watch", "Keep exporting RAW files as they are added or saved, until interrupted.");
+    QCommandLineOption workersOption("workers", "Export in <n> worker processes that share a shard queue.", "n");
+    QCommandLineOption shardWorkerOption("shard-worker", "Work on the shards of an existing queue until none is left.");
+    QCommandLineOption shardQueueOption("shard-queue", "Shard queue folder (default: .woosh-shards in the game folder).", "dir");
+    QCommandLineOption shardSizeOption("shard-size", "Files per shard (default: 16).", "n", "16");
+    QCommandLineOption ioDepthOption("io-depth", "File reads/writes kept in flight; 0 disables async I/O (default: 32).",
+                                     "n", QString::number(AsyncFileIO::kDefaultQueueDepth));
+    parser.addOptions({headlessOption, projectOption, reportOption, threadsOption, noExportOption, forceExportOption,
+                       traceOption, duplicatesOption, indexOption, similarityOption, watchOption,
+                       workersOption, shardWorkerOption, shardQueueOption, shardSizeOption, ioDepthOption});
+    parser.process(app);
+
+    const QString projectPath = parser.value(projectOption);
+    if (projectPath.isEmpty()) {
+        std::fprintf(stderr, "--headless requires --project <file>\n");
+        return 2;
+    }
+
+    if (parser.isSet(watchOption)) {
+        return watchProject(projectPath.toStdString(), parser.value(threadsOption).toInt());
+    }
+
+    auto project = Project::load(projectPath.toStdString());
+    if (!project) {
+        std::fprintf(stderr, "Could not load project %s\n", qPrintable(projectPath));
+        return 2;
+    }
+
+    const QString tracePath = parser.value(traceOption);
+    if (!tracePath.isEmpty()) {
+        Trace::setThreadName("Main");
+        Trace::setEnabled(true);
+    }
+
+    if (parser.isSet(duplicatesOption)) {
+        QString indexPath = parser.value(indexOption);
+        if (indexPath.isEmpty()) {
+            const QFileInfo projectInfo(projectPath);
+            indexPath = projectInfo.dir().filePath(projectInfo.completeBaseName() + ".fpindex");
+        }
+        const int exitCode = reportDuplicates(*project, indexPath.toStdString(),
+                                              parser.value(threadsOption).toInt(),
+                                              parser.value(similarityOption).toDouble());
+        if (!tracePath.isEmpty() && !Trace::writeChromeJson(tracePath.toStdString())) {
+            std::fprintf(stderr, "Could not write trace to %s\n", qPrintable(tracePath));
+        }
+        return exitCode;
+    }
+
+    if (parser.isSet(workersOption) || parser.isSet(shardWorkerOption)) {
+        if (project->rawFolder().empty() || project->gameFolder().empty()) {
+            std::fprintf(stderr, "Sharded runs need a RAW and a game folder\n");
+            return 2;
+        }
+        std::string queueFolder = parser.value(shardQueueOption).toStdString();
+        if (queueFolder.empty()) queueFolder = ShardedBatch::defaultQueueFolder(*project);
+        const int threads = parser.value(threadsOption).toInt();
+        const bool useExportCache = !parser.isSet(forceExportOption);
+        if (parser.isSet(shardWorkerOption)) {
+            return runShardWorker(*project, queueFolder, threads, useExportCache);
+        }
+        return runShardCoordinator(*project, projectPath, queueFolder,
+                                   std::max(0, parser.value(workersOption).toInt()), threads,
+                                   static_cast<size_t>(std::max(1, parser.value(shardSizeOption).toInt())),
+                                   useExportCache);
+    }
+
+    BatchRunner runner(parser.value(threadsOption).toInt(),
+                       static_cast<unsigned>(std::max(0, parser.value(ioDepthOption).toInt())));
+    BatchRunResult result = runner.run(*project, !parser.isSet(noExportOption), !parser.isSet(forceExportOption));
+
+    if (!tracePath.isEmpty() && !Trace::writeChromeJson(tracePath.toStdString())) {
+        std::fprintf(stderr, "Could not write trace to %s\n", qPrintable(tracePath));
+    }
+
+    if (!result.ok()) {
+        std::fprintf(stderr, "%s\n", result.error.c_str());
+        return 1;
+    }
+
+    if (result.upToDateFiles > 0) {
+        std::printf("%zu clips up to date, not exported again\n\n", result.upToDateFiles);
+    }
+    size_t failedFiles = 0;
+    for (const auto& report : result.reports) {
+        std::printf("%s\n", report.toText().c_str());
+        failedFiles += report.failedFiles;
+    }
+    for (const auto& error : result.exportErrors) {
+        std::fprintf(stderr, "Export failed: %s\n", error.c_str());
+    }
+
+    const QString reportPath = parser.value(reportOption);
+    if (!reportPath.isEmpty() && !writeBatchReportsJson(reportPath.toStdString(), result.reports)) {
+        std::fprintf(stderr, "Could not write report to %s\n", qPrintable(reportPath));
+        return 1;
+    }
+
+    return failedFiles == 0 ? 0 : 1;
+}
+
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    // Headless runs must not create a QApplication (no display on build agents)
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            return runHeadless(argc, argv);
+        }
+    }
+
+    // Checked before the parser exists so that creating the application is timed too
+    const bool startupTrace = std::any_of(argv + 1, argv + argc, [](const char* arg) {
+        return std::strcmp(arg, "--startup-trace") == 0;
+    });
+    if (startupTrace) StartupProfile::begin();
+
+    std::unique_ptr<QApplication> application;
+    {
+        WOOSH_STARTUP_PHASE("QApplication");
+        application = std::make_unique<QApplication>(argc, argv);
+    }
+    QApplication& app = *application;
 
     // Set application metadata
     QCoreApplication::setOrganizationName("Woosh");
     QCoreApplication::setApplicationName("Woosh Audio Editor");
     QCoreApplication::setApplicationVersion("0.1.0");
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Woosh Audio Batch Editor");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption traceOption("trace",
+        "Write a Chrome trace of load/process/export to <file> on exit.", "file");
+    parser.addOption(traceOption);
+    QCommandLineOption startupTraceOption("startup-trace",
+        "Print the time taken by each startup phase to stderr.");
+    parser.addOption(startupTraceOption);
+    parser.process(app);
+
+    QString tracePath = parser.value(traceOption);
+    if (tracePath.isEmpty()) {
+        tracePath = qEnvironmentVariable("WOOSH_TRACE");
+    }
+    if (!tracePath.isEmpty()) {
+        Trace::setThreadName("UI");
+        Trace::setEnabled(true);
+    }
+
     // Apply dark theme
-    applyDarkTheme(app);
+    {
+        WOOSH_STARTUP_PHASE("theme");
+        applyDarkTheme(app);
+    }
 
     // Set application icon
     QIcon appIcon(":/images/icon.png");
     app.setWindowIcon(appIcon);
 
     // Create and show main window
-    MainWindow window;
+    std::unique_ptr<MainWindow> mainWindow;
+    {
+        WOOSH_STARTUP_PHASE("MainWindow");
+        mainWindow = std::make_unique<MainWindow>();
+    }
+    MainWindow& window = *mainWindow;
     window.setWindowIcon(appIcon);
-    window.show();
+    {
+        WOOSH_STARTUP_PHASE("show");
+        window.show();
+    }
+
+    // A zero timer fires once the event loop has handled the pending show
+    // and paint events, i.e. when the window starts taking input
+    if (startupTrace) {
+        QTimer::singleShot(0, &window, [] {
+            StartupProfile::mark("interactive");
+            std::fputs(StartupProfile::report().c_str(), stderr);
+        });
+    }
+
+    const int result = app.exec();
+
+    if (!tracePath.isEmpty() && !Trace::writeChromeJson(tracePath.toStdString())) {
+        qWarning("Could not write trace to %s", qPrintable(tracePath));
+    }
 
-    return app.exec();
+    return result;
 }
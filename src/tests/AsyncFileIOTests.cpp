@@ -0,0 +1,307 @@
+/**
+ * @file AsyncFileIOTests.cpp
+ * @brief Unit tests for AsyncFileIO (io_uring and thread pool) and the batch read-ahead/write-behind.
+ */
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/BatchIO.h"
+#include "tests/TestFiles.h"
+#include "utils/AsyncFileIO.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static std::vector<uint8_t> pattern(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data(size);
+    uint32_t state = seed * 2654435761u + 1;
+    for (auto& byte : data) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return data;
+}
+
+static std::vector<uint8_t> readFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+static AsyncFileIO::Options options(bool threadPool, unsigned queueDepth = AsyncFileIO::kDefaultQueueDepth) {
+    AsyncFileIO::Options result;
+    result.queueDepth = queueDepth;
+    result.forceThreadPool = threadPool;
+    return result;
+}
+
+static std::vector<AsyncFileIO::Completion> waitAll(AsyncFileIO& io) {
+    std::vector<AsyncFileIO::Completion> all;
+    while (io.pending() > 0) {
+        for (auto& completion : io.wait()) all.push_back(std::move(completion));
+    }
+    return all;
+}
+
+// ============================================================================
+// AsyncFileIO (each runs on io_uring, where available, and on the thread pool)
+// ============================================================================
+
+static void testAsyncIO_writeThenRead(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_roundtrip");
+    AsyncFileIO io(options(threadPool));
+    if (threadPool) assert(io.backend() == AsyncFileIO::Backend::ThreadPool);
+
+    const auto data = pattern(100000, 1);
+    io.write(7, (dir / "a.bin").string(), data);
+    assert(io.pending() == 1);
+    auto done = waitAll(io);
+    assert(done.size() == 1 && done[0].tag == 7 && done[0].ok && done[0].data.empty());
+    assert(readFile(dir / "a.bin") == data);
+
+    io.read(8, (dir / "a.bin").string());
+    done = waitAll(io);
+    assert(done.size() == 1 && done[0].tag == 8 && done[0].ok);
+    assert(done[0].data == data);
+    assert(io.wait().empty());
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_manyFilesBeyondQueueDepth(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_many");
+    constexpr int kFiles = 40;
+    for (int i = 0; i < kFiles; ++i) {
+        writeFile(dir / (std::to_string(i) + ".bin"), pattern(1000 + static_cast<size_t>(i) * 97, i));
+    }
+
+    AsyncFileIO io(options(threadPool, 4));
+    for (int i = 0; i < kFiles; ++i) {
+        io.read(static_cast<uint64_t>(i), (dir / (std::to_string(i) + ".bin")).string());
+    }
+    const auto done = waitAll(io);
+    assert(done.size() == kFiles);
+    std::vector<bool> seen(kFiles, false);
+    for (const auto& completion : done) {
+        assert(completion.ok && !seen[completion.tag]);
+        seen[completion.tag] = true;
+        assert(completion.data == pattern(1000 + completion.tag * 97, static_cast<uint32_t>(completion.tag)));
+    }
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_largeFileInChunks(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_large");
+    const auto data = pattern(AsyncFileIO::kChunkBytes * 3 + AsyncFileIO::kChunkBytes / 2 + 3, 9);
+
+    AsyncFileIO io(options(threadPool, 2));
+    io.write(1, (dir / "large.bin").string(), data);
+    auto done = waitAll(io);
+    assert(done.size() == 1 && done[0].ok);
+    assert(fs::file_size(dir / "large.bin") == data.size());
+
+    io.read(2, (dir / "large.bin").string());
+    done = waitAll(io);
+    assert(done.size() == 1 && done[0].ok && done[0].data == data);
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_emptyFile(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_empty");
+    AsyncFileIO io(options(threadPool));
+    io.write(1, (dir / "empty.bin").string(), {});
+    auto done = waitAll(io);
+    assert(done.size() == 1 && done[0].ok);
+    assert(fs::exists(dir / "empty.bin") && fs::file_size(dir / "empty.bin") == 0);
+
+    io.read(2, (dir / "empty.bin").string());
+    done = waitAll(io);
+    assert(done.size() == 1 && done[0].ok && done[0].data.empty());
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_replacesLongerFile(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_replace");
+    writeFile(dir / "a.bin", pattern(5000, 1));
+    AsyncFileIO io(options(threadPool));
+    io.write(1, (dir / "a.bin").string(), pattern(100, 2));
+    (void)waitAll(io);
+    assert(readFile(dir / "a.bin") == pattern(100, 2));
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_reportsFailures(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_fail");
+    writeFile(dir / "ok.bin", pattern(10, 3));
+    AsyncFileIO io(options(threadPool));
+    io.read(1, (dir / "missing.bin").string());
+    io.write(2, (dir / "no" / "such" / "dir.bin").string(), pattern(10, 1));
+    io.read(3, (dir / "ok.bin").string());
+    const auto done = waitAll(io);
+    assert(done.size() == 3);
+    for (const auto& completion : done) {
+        assert(completion.ok == (completion.tag == 3));
+    }
+    fs::remove_all(dir);
+}
+
+static void testAsyncIO_destructorWaitsForWrites(bool threadPool) {
+    const fs::path dir = makeTempDir("woosh_aio_dtor");
+    {
+        AsyncFileIO io(options(threadPool));
+        for (int i = 0; i < 8; ++i) {
+            io.write(static_cast<uint64_t>(i), (dir / (std::to_string(i) + ".bin")).string(), pattern(50000, i));
+        }
+    }
+    for (int i = 0; i < 8; ++i) {
+        assert(readFile(dir / (std::to_string(i) + ".bin")) == pattern(50000, i));
+    }
+    fs::remove_all(dir);
+}
+
+// ============================================================================
+// FilePrefetcher / FileWriteBehind
+// ============================================================================
+
+static void testPrefetcher_readsEveryFileOnce() {
+    const fs::path dir = makeTempDir("woosh_prefetch");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 20; ++i) {
+        paths.push_back((dir / (std::to_string(i) + ".bin")).string());
+        if (i != 5) writeFile(paths.back(), pattern(3000, i));
+    }
+
+    // A budget below one file still reads one at a time
+    FilePrefetcher prefetcher(paths, options(false, 4), 1000);
+    for (int i = 0; i < 20; ++i) {
+        const auto data = prefetcher.take(static_cast<size_t>(i));
+        if (i == 5) {
+            assert(!data);
+        } else {
+            assert(data && *data == pattern(3000, i));
+        }
+    }
+    fs::remove_all(dir);
+}
+
+static void testPrefetcher_countsReadsInFlight() {
+    const fs::path dir = makeTempDir("woosh_prefetch_budget");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 24; ++i) {
+        paths.push_back((dir / (std::to_string(i) + ".bin")).string());
+        // Each file is above budget / queue depth; file 10 is above the whole budget
+        writeFile(paths.back(), pattern(i == 10 ? 40000 : 3000, i));
+    }
+
+    FilePrefetcher prefetcher(paths, options(false, 32), 10000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));   // Let it read ahead as far as it may
+    for (int i = 0; i < 24; ++i) {
+        const auto data = prefetcher.take(static_cast<size_t>(i));
+        assert(data && *data == pattern(i == 10 ? 40000 : 3000, i));
+        // File 10 can only start once file 9 is taken
+        if (i < 9) assert(prefetcher.peakBytes() <= 10000);
+    }
+    // The oversized file was read while nothing else was held
+    assert(prefetcher.peakBytes() == 40000);
+    fs::remove_all(dir);
+}
+
+static void testPrefetcher_concurrentTakers() {
+    const fs::path dir = makeTempDir("woosh_prefetch_mt");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 64; ++i) {
+        paths.push_back((dir / (std::to_string(i) + ".bin")).string());
+        writeFile(paths.back(), pattern(2000 + static_cast<size_t>(i), i));
+    }
+
+    FilePrefetcher prefetcher(paths, options(false, 8), 16000);
+    std::vector<char> matched(paths.size(), 0);
+    std::vector<std::thread> takers;
+    for (int t = 0; t < 4; ++t) {
+        takers.emplace_back([&, t] {
+            for (size_t i = static_cast<size_t>(t); i < paths.size(); i += 4) {
+                const auto data = prefetcher.take(i);
+                matched[i] = data && *data == pattern(2000 + i, static_cast<uint32_t>(i));
+            }
+        });
+    }
+    for (auto& taker : takers) taker.join();
+    for (const char ok : matched) assert(ok);
+    fs::remove_all(dir);
+}
+
+static void testPrefetcher_destroyedBeforeTaken() {
+    const fs::path dir = makeTempDir("woosh_prefetch_early");
+    std::vector<std::string> paths;
+    for (int i = 0; i < 10; ++i) {
+        paths.push_back((dir / (std::to_string(i) + ".bin")).string());
+        writeFile(paths.back(), pattern(1000, i));
+    }
+    {
+        FilePrefetcher prefetcher(paths);
+        assert(prefetcher.take(0));
+    }
+    fs::remove_all(dir);
+}
+
+static void testWriteBehind_reportsPerFileResult() {
+    const fs::path dir = makeTempDir("woosh_writebehind");
+    FileWriteBehind writer(6, options(false, 2), 10000);
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < 4; ++i) {
+        workers.emplace_back([&, i] {
+            writer.write(i, (dir / (std::to_string(i) + ".bin")).string(), pattern(8000, static_cast<uint32_t>(i)));
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    writer.write(4, (dir / "missing" / "4.bin").string(), pattern(10, 4));
+
+    const auto written = writer.finish();
+    assert(written.size() == 6);
+    for (size_t i = 0; i < 4; ++i) {
+        assert(written[i]);
+        assert(readFile(dir / (std::to_string(i) + ".bin")) == pattern(8000, static_cast<uint32_t>(i)));
+    }
+    assert(!written[4]);
+    assert(!written[5]);
+    fs::remove_all(dir);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    {
+        AsyncFileIO io;
+        std::printf("AsyncFileIO backend: %s\n", AsyncFileIO::backendName(io.backend()));
+    }
+
+    for (const bool threadPool : {false, true}) {
+        testAsyncIO_writeThenRead(threadPool);
+        testAsyncIO_manyFilesBeyondQueueDepth(threadPool);
+        testAsyncIO_largeFileInChunks(threadPool);
+        testAsyncIO_emptyFile(threadPool);
+        testAsyncIO_replacesLongerFile(threadPool);
+        testAsyncIO_reportsFailures(threadPool);
+        testAsyncIO_destructorWaitsForWrites(threadPool);
+    }
+
+    // Batch read-ahead / write-behind
+    testPrefetcher_readsEveryFileOnce();
+    testPrefetcher_countsReadsInFlight();
+    testPrefetcher_concurrentTakers();
+    testPrefetcher_destroyedBeforeTaken();
+    testWriteBehind_reportsPerFileResult();
+    return 0;
+}
@@ -3,8 +3,10 @@
  * @brief Unit tests for AudioClip class.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <filesystem>
 #include <vector>
 #include <string>
 #include "audio/AudioClip.h"
@@ -268,6 +270,340 @@ static void testRestoreOriginal_clearsModifiedFlag() {
     assert(!clip.isModified());
 }
 
+// ============================================================================
+// Trim window tests
+// ============================================================================
+
+static std::vector<float> makeRampStereo(size_t frames) {
+    std::vector<float> data(frames * 2);
+    for (size_t i = 0; i < frames; ++i) {
+        data[i * 2] = static_cast<float>(i);
+        data[i * 2 + 1] = -static_cast<float>(i);
+    }
+    return data;
+}
+
+static void testTrimFrames_viewsSameStorage() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    const float* before = clip.samples().data();
+
+    assert(clip.trimFrames(10, 30));
+
+    assert(clip.frameCount() == 20);
+    assert(clip.samples().size() == 40);
+    assert(clip.samples()[0] == 10.0f);
+    assert(clip.samples()[1] == -10.0f);
+    assert(clip.samples().data() == before + 20); // No copy, just a narrower view
+    assert(clip.trimOffsetFrames() == 10);
+    assert(clip.isModified());
+}
+
+static void testTrimFrames_retrimAccumulatesOffset() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    assert(clip.trimFrames(10, 90));
+    assert(clip.trimFrames(5, 20));  // Relative to the current window
+
+    assert(clip.frameCount() == 15);
+    assert(clip.samples()[0] == 15.0f);
+    assert(clip.trimOffsetFrames() == 15);
+}
+
+static void testTrimFrames_clampsAndRejectsEmptyRange() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+
+    assert(!clip.trimFrames(50, 50));
+    assert(!clip.trimFrames(60, 40));
+    assert(!clip.trimFrames(0, 100));   // Whole clip: nothing to do
+    assert(!clip.isModified());
+
+    assert(clip.trimFrames(90, 1000));
+    assert(clip.frameCount() == 10);
+}
+
+static void testTrimFrames_leavesLevelsToMeasureMetrics() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.updateMetrics(0.0f, 0.0f);
+    assert(clip.trimFrames(10, 30));
+    assert(!clip.hasMetrics());  // The trim itself does not read the samples
+
+    // Reading the levels does not measure them either
+    assert(clip.peakDb() == 0.0f && !clip.hasMetrics());
+
+    // Frames 10..29: the loudest sample is 29 on both channels
+    clip.measureMetrics();
+    assert(clip.hasMetrics());
+    assert(approxEqual(clip.peakDb(), 20.0 * std::log10(29.0)));
+    assert(clip.channelLevels().size() == 2);
+    assert(approxEqual(clip.channelLevels()[1].peakDb, 20.0 * std::log10(29.0)));
+}
+
+static void testRestoreOriginal_undoesTrim() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.saveOriginal();
+    clip.trimFrames(10, 30);
+
+    clip.restoreOriginal();
+
+    assert(clip.frameCount() == 100);
+    assert(clip.samples()[0] == 0.0f);
+    assert(clip.trimOffsetFrames() == 0);
+}
+
+static void testSamplesMutable_copiesSharedStorage() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.saveOriginal();
+    AudioClip copy = clip;
+
+    auto data = clip.samplesMutable();
+    data[0] = 42.0f;
+
+    assert(clip.samples()[0] == 42.0f);
+    assert(copy.samples()[0] == 0.0f);   // Copies keep their own view
+    clip.restoreOriginal();
+    assert(clip.samples()[0] == 0.0f);   // Undo state is untouched
+}
+
+static void testSamplesMutable_afterTrimCopiesOnlyWindow() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.saveOriginal();
+    clip.trimFrames(10, 30);
+
+    auto data = clip.samplesMutable();
+
+    assert(data.size() == 40);
+    assert(data[0] == 10.0f);
+    assert(clip.trimOffsetFrames() == 10);
+}
+
+static void testCompact_keepsWindowContents() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.trimFrames(40, 60);
+
+    clip.compact();
+
+    assert(clip.frameCount() == 20);
+    assert(clip.samples()[0] == 40.0f);
+    assert(clip.samples()[39] == -59.0f);
+    assert(clip.trimOffsetFrames() == 40);
+}
+
+// ============================================================================
+// 16-bit storage tests
+// ============================================================================
+
+/// Stereo 16-bit material: every sample is k / 32768.
+static std::vector<float> makePcm16Stereo(size_t frames) {
+    std::vector<float> data(frames * 2);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<float>(static_cast<int>((i * 7919) % 65536) - 32768) / 32768.0f;
+    }
+    return data;
+}
+
+static std::vector<float> readAll(const AudioClip& clip) {
+    std::vector<float> out(clip.frameCount() * static_cast<size_t>(clip.channels()));
+    clip.readFrames(0, clip.frameCount(), out.data());
+    return out;
+}
+
+static void testStoreCompact16_exactForPcm16() {
+    const auto source = makePcm16Stereo(5000);
+    AudioClip clip("test.wav", 44100, 2, source);
+    clip.saveOriginal();
+    const size_t floatBytes = clip.residentBytes();
+
+    assert(clip.storeCompact16());
+    assert(clip.isCompact16());
+    assert(clip.samples().empty());
+    assert(clip.frameCount() == 5000);
+    assert(clip.residentBytes() * 2 <= floatBytes + 64);
+    assert(readAll(clip) == source);
+
+    const auto view = clip.view(4000, 2000);
+    assert(view.size() == 2000);
+    assert(std::equal(view.data(), view.data() + view.size(), source.begin() + 8000));
+
+    clip.storeFloat();
+    assert(!clip.isCompact16());
+    assert(std::equal(clip.samples().begin(), clip.samples().end(), source.begin(), source.end()));
+}
+
+static void testStoreCompact16_keepsFloatWithoutBlockScaling() {
+    AudioClip clip("test.wav", 44100, 2, makeStereoSamples(100, 0.3f));
+    assert(!clip.storeCompact16());
+    assert(!clip.isCompact16());
+    assert(clip.samples()[0] == 0.3f);
+}
+
+static void testStoreCompact16_blockScaledProcessedData() {
+    AudioClip clip("test.wav", 44100, 1, makePcm16Stereo(3000));
+    clip.saveOriginal();
+    auto data = clip.samplesMutable();
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (i < 2048 ? 0.01f : 0.9f) * std::sin(static_cast<float>(i) * 0.01f);
+    }
+    const std::vector<float> processed(data.begin(), data.end());
+
+    assert(clip.storeCompact16(true));
+    const auto restored = readAll(clip);
+    for (size_t i = 0; i < processed.size(); ++i) {
+        // Quiet blocks keep their own resolution
+        const float blockPeak = i < 2048 ? 0.01f : 0.9f;
+        assert(std::fabs(restored[i] - processed[i]) <= blockPeak / 32767.0f);
+    }
+
+    // The unmodified original is stored exactly
+    clip.restoreOriginal();
+    assert(readAll(clip) == makePcm16Stereo(3000));
+}
+
+static void testStoreCompact16_trimAndUndo() {
+    const auto source = makePcm16Stereo(5000);
+    AudioClip clip("test.wav", 44100, 2, source);
+    clip.saveOriginal();
+    assert(clip.storeCompact16());
+    assert(clip.trimFrames(1500, 4000));
+
+    auto window = readAll(clip);
+    assert(window.size() == 5000);
+    assert(std::equal(window.begin(), window.end(), source.begin() + 3000));
+
+    // compact() keeps whole blocks and the same window contents
+    clip.compact();
+    assert(clip.isCompact16() && clip.frameCount() == 2500 && clip.trimOffsetFrames() == 1500);
+    window = readAll(clip);
+    assert(std::equal(window.begin(), window.end(), source.begin() + 3000));
+
+    // Writing expands just the window to float
+    auto data = clip.samplesMutable();
+    assert(!clip.isCompact16() && data.size() == 5000 && data[0] == source[3000]);
+
+    clip.restoreOriginal();
+    assert(clip.isCompact16() && clip.frameCount() == 5000);
+    assert(readAll(clip) == source);
+}
+
+static void testReadFrames_clampsToWindow() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.trimFrames(10, 20);
+    std::vector<float> out(40, -1.0f);
+    assert(clip.readFrames(5, 20, out.data()) == 5);
+    assert(out[0] == 15.0f && out[9] == -19.0f && out[10] == -1.0f);
+    assert(clip.view(8, 100).size() == 4);
+}
+
+static void testEvict_keepsMetadataAndReleasesSamples() {
+    AudioClip clip("sfx/test.wav", 100, 2, makeRampStereo(100));
+    clip.saveOriginal();
+    clip.trimFrames(10, 60);
+    clip.updateMetrics(-3.0f, -12.0f);
+    assert(clip.isResident() && clip.residentBytes() > 0);
+
+    clip.evict();
+    assert(!clip.isResident());
+    assert(clip.residentBytes() == 0);
+    assert(!clip.hasOriginal());
+    assert(clip.view().size() == 0);
+
+    // What the clip list shows is unchanged
+    assert(clip.displayName() == "test.wav");
+    assert(clip.frameCount() == 50 && clip.trimOffsetFrames() == 10);
+    assert(clip.hasMetrics() && approxEqual(clip.peakDb(), -3.0f));
+    assert(clip.isModified());
+}
+
+static void testFromMetadata_listsLikeAnEvictedClip() {
+    const AudioClip clip = AudioClip::fromMetadata("sfx/cached.wav", 48000, 2, 96000, -1.5f, -20.0f, true);
+    assert(!clip.isResident() && !clip.hasOriginal());
+    assert(clip.view().size() == 0);
+
+    assert(clip.displayName() == "cached.wav");
+    assert(clip.sampleRate() == 48000 && clip.channels() == 2);
+    assert(clip.frameCount() == 96000);
+    assert(approxEqual(clip.durationSeconds(), 2.0));
+    assert(clip.hasMetrics() && approxEqual(clip.peakDb(), -1.5f) && approxEqual(clip.rmsDb(), -20.0f));
+    assert(clip.isModified());
+}
+
+static std::string spillDirectory() {
+    return std::filesystem::temp_directory_path().string();
+}
+
+static void testSpill_keepsSamplesAndReleasesHeap() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.trimFrames(10, 60);
+    clip.setModified(true);
+
+    assert(clip.spill(spillDirectory()));
+    assert(clip.isSpilled() && clip.isResident());
+    assert(clip.residentBytes() == 0);
+    assert(clip.spilledBytes() == 200 * sizeof(float));
+
+    // Read in place from the mapping, window unchanged
+    const auto samples = clip.samples();
+    assert(samples.size() == 100);
+    assert(samples[0] == 10.0f && samples[1] == -10.0f);
+    assert(clip.view().data() == samples.data());
+
+    float frame[2] = {};
+    assert(clip.readFrames(49, 1, frame) == 1);
+    assert(frame[0] == 59.0f && frame[1] == -59.0f);
+}
+
+static void testSpill_samplesMutableCopiesBackToHeap() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.trimFrames(20, 30);
+    assert(clip.spill(spillDirectory()));
+
+    auto view = clip.view();
+    auto writable = clip.samplesMutable();
+    assert(!clip.isSpilled());
+    assert(writable.size() == 20 && writable[0] == 20.0f);
+    writable[0] = 1.0f;
+
+    // An outstanding view keeps reading the spilled samples
+    assert(view.data()[0] == 20.0f);
+    assert(clip.residentBytes() == 20 * sizeof(float));
+}
+
+static void testSpill_undoRestoresOriginal() {
+    AudioClip clip("test.wav", 100, 2, makeRampStereo(100));
+    clip.saveOriginal();
+    clip.setSamples(std::vector<float>(40, 0.25f));
+    clip.setModified(true);
+
+    assert(clip.spill(spillDirectory()));
+    assert(clip.hasOriginal());
+    assert(clip.residentBytes() == 0);
+    assert(clip.spilledBytes() == (40 + 200) * sizeof(float));
+
+    clip.restoreOriginal();
+    assert(clip.frameCount() == 100);
+    assert(clip.samples()[198] == 99.0f);
+    assert(!clip.isModified());
+}
+
+static void testSpill_compactAndSharedOriginal() {
+    std::vector<float> pcm(200);
+    for (size_t i = 0; i < pcm.size(); ++i) pcm[i] = static_cast<float>(static_cast<int>(i) - 100) / 32768.0f;
+    AudioClip clip("test.wav", 100, 2, pcm);
+    clip.saveOriginal();
+    assert(clip.storeCompact16(true));
+
+    // Trimmed only: current and original share one file
+    clip.trimFrames(50, 100);
+    assert(clip.spill(spillDirectory()));
+    assert(clip.spilledBytes() == 200 * sizeof(float));
+    assert(clip.samples()[0] == pcm[100]);
+
+    clip.restoreOriginal();
+    assert(clip.isSpilled() && clip.frameCount() == 100);
+
+    clip.evict();
+    assert(!clip.isResident() && !clip.isSpilled());
+    assert(clip.spilledBytes() == 0);
+}
+
 // ============================================================================
 // Edge cases
 // ============================================================================
@@ -341,6 +677,29 @@ int main() {
     testSetModified_setsFlag();
     testRestoreOriginal_clearsModifiedFlag();
     
+    // Trim window tests
+    testTrimFrames_viewsSameStorage();
+    testTrimFrames_retrimAccumulatesOffset();
+    testTrimFrames_clampsAndRejectsEmptyRange();
+    testTrimFrames_leavesLevelsToMeasureMetrics();
+    testRestoreOriginal_undoesTrim();
+    testSamplesMutable_copiesSharedStorage();
+    testSamplesMutable_afterTrimCopiesOnlyWindow();
+    testCompact_keepsWindowContents();
+
+    // 16-bit storage tests
+    testStoreCompact16_exactForPcm16();
+    testStoreCompact16_keepsFloatWithoutBlockScaling();
+    testStoreCompact16_blockScaledProcessedData();
+    testStoreCompact16_trimAndUndo();
+    testReadFrames_clampsToWindow();
+    testEvict_keepsMetadataAndReleasesSamples();
+    testFromMetadata_listsLikeAnEvictedClip();
+    testSpill_keepsSamplesAndReleasesHeap();
+    testSpill_samplesMutableCopiesBackToHeap();
+    testSpill_undoRestoresOriginal();
+    testSpill_compactAndSharedOriginal();
+    
     // Edge cases
     testClip_veryLargeSamples();
     testClip_highSampleRate();
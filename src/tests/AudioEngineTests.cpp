@@ -1,9 +1,16 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 #include "utils/DSP.h"
 #include "audio/AudioClip.h"
 #include "audio/AudioEngine.h"
+#include "utils/FrameRanges.h"
 
 static std::vector<float> makeSine(float freq, int sr, int frames, int channels) {
     std::vector<float> data(frames * channels);
@@ -30,9 +37,233 @@ static void testTrim() {
     assert(clip.durationSeconds() > 0.49 && clip.durationSeconds() < 0.51);
 }
 
+static void testTrim_keepsMiddleRangeInPlace() {
+    std::vector<float> ramp(48000 * 2);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = static_cast<float>(i) / static_cast<float>(ramp.size());
+    AudioClip clip("test.wav", 48000, 2, ramp);
+    AudioEngine engine;
+    engine.trim(clip, 0.25f, 0.75f);
+    assert(clip.frameCount() == 24000);
+    // First kept sample is the one at 0.25 s (frame 12000, interleaved index 24000)
+    assert(clip.samples().front() == ramp[24000]);
+    assert(clip.samples().back() == ramp[72000 - 1]);
+    assert(clip.isModified());
+}
+
+static void testAutoTrim_removesSilenceAroundSound() {
+    // 0.25 s silence, 0.5 s tone, 0.25 s silence
+    auto samples = makeSine(440.0f, 48000, 48000, 2);
+    std::fill(samples.begin(), samples.begin() + 12000 * 2, 0.0f);
+    std::fill(samples.end() - 12000 * 2, samples.end(), 0.0f);
+    AudioClip clip("test.wav", 48000, 2, samples);
+    AudioEngine engine;
+
+    assert(engine.autoTrim(clip, {-40.0f, 10.0f, 20.0f}));
+    // Pre-roll 480 frames, post-roll 960 frames around the tone; the tone's
+    // edges sit on zero crossings, so the detected edges may be a frame or two inside
+    assert(clip.trimOffsetFrames() >= 12000 - 480 && clip.trimOffsetFrames() < 12000 - 480 + 5);
+    assert(clip.frameCount() > 24000 + 480 + 960 - 10 && clip.frameCount() <= 24000 + 480 + 960);
+    // The kept range is measured on request, not by the trim
+    assert(!clip.hasMetrics());
+    engine.updateClipMetrics(clip);
+    assert(clip.hasMetrics());
+    assert(std::abs(clip.peakDb() - DSP::computePeakDbFS(clip.samples())) < 1e-3f);
+
+    // Nothing left to trim the second time
+    assert(!engine.autoTrim(clip, {-40.0f, 10.0f, 20.0f}));
+}
+
+static void testAutoTrim_leavesSilentClipAlone() {
+    AudioClip clip("test.wav", 48000, 1, std::vector<float>(4800, 0.0f));
+    AudioEngine engine;
+    assert(!engine.autoTrim(clip, {-60.0f, 0.0f, 0.0f}));
+    assert(clip.frameCount() == 4800);
+    assert(!clip.isModified());
+}
+
+static void testProcess_usesClipMetricsAndRefreshesThem() {
+    AudioClip clip("test.wav", 48000, 2, makeSine(440.0f, 48000, 48000, 2));
+    AudioEngine engine;
+    engine.updateClipMetrics(clip);
+
+    auto result = engine.process(clip, ProcessingChain().normalizeToPeak(-1.0f).compress({-12.0f, 4.0f, 10.0f, 100.0f, 0.0f}));
+
+    // Known input level: no analysis pass, one fused pass
+    assert(result.analysisPasses == 0);
+    assert(result.fusedPasses == 1);
+    assert(clip.hasMetrics());
+    assert(std::abs(clip.peakDb() - DSP::computePeakDbFS(clip.samples())) < 1e-3f);
+    assert(std::abs(clip.rmsDb() - DSP::computeRMSDb(clip.samples())) < 1e-3f);
+}
+
+static void testProcess_measuresClipWithoutMetrics() {
+    AudioClip clip("test.wav", 48000, 2, makeSine(440.0f, 48000, 48000, 2));
+    AudioEngine engine;
+
+    auto result = engine.process(clip, ProcessingChain().normalizeToPeak(-3.0f));
+
+    assert(result.analysisPasses == 1);
+    assert(std::abs(clip.peakDb() + 3.0f) < 1e-3f);
+}
+
+static void testProcess_measuresEachChannel() {
+    // 5.1 with a quieter centre and a silent LFE
+    auto samples = makeSine(440.0f, 48000, 48000, 6);
+    for (size_t f = 0; f < 48000; ++f) {
+        samples[f * 6 + 2] *= 0.5f;
+        samples[f * 6 + 3] = 0.0f;
+    }
+    AudioClip clip("test.wav", 48000, 6, samples);
+    AudioEngine engine;
+
+    engine.updateClipMetrics(clip);
+    assert(clip.channelLevels().size() == 6);
+    assert(std::abs(clip.channelLevels()[2].peakDb - (clip.peakDb() - 6.02f)) < 0.01f);
+    assert(clip.channelLevels()[3].peakDb < -150.0f);
+
+    engine.process(clip, ProcessingChain().normalizeToPeak(-3.0f));
+    assert(clip.channelLevels().size() == 6);
+    assert(std::abs(clip.channelLevels()[0].peakDb + 3.0f) < 1e-3f);
+    assert(std::abs(clip.channelLevels()[2].peakDb + 9.02f) < 0.01f);
+
+    // The 16-bit block-wise measurement gives the same channel levels
+    engine.setCompactStorage(true);
+    engine.process(clip, ProcessingChain().normalizeToPeak(-3.0f));
+    const auto processed = clip.channelLevels();
+    engine.updateClipMetrics(clip);
+    for (size_t c = 0; c < 3; ++c) assert(std::abs(clip.channelLevels()[c].rmsDb - processed[c].rmsDb) < 1e-3f);
+}
+
+static void testCompactStorage_processesAndTrimsCompactClips() {
+    auto samples = makeSine(440.0f, 48000, 48000, 2);
+    std::fill(samples.begin(), samples.begin() + 12000 * 2, 0.0f);
+    AudioClip clip("test.wav", 48000, 2, samples);
+    AudioEngine engine;
+    engine.setCompactStorage(true);
+    engine.updateClipMetrics(clip);
+
+    engine.process(clip, ProcessingChain().normalizeToPeak(-1.0f));
+    assert(clip.isCompact16());
+    assert(clip.residentBytes() < clip.frameCount() * 2 * sizeof(float) * 6 / 10);
+    assert(std::abs(clip.peakDb() + 1.0f) < 1e-3f);
+
+    // Levels measured block-wise from the 16-bit storage agree with the processed float
+    const float peakDb = clip.peakDb();
+    engine.updateClipMetrics(clip);
+    assert(std::abs(clip.peakDb() - peakDb) < 1e-3f);
+
+    assert(engine.autoTrim(clip, {-40.0f, 10.0f, 20.0f}));
+    assert(clip.isCompact16());
+    assert(clip.trimOffsetFrames() >= 12000 - 480 && clip.trimOffsetFrames() < 12000 - 480 + 5);
+}
+
+/// Process and encode a copy of @p source the way a batch worker does.
+static std::optional<std::vector<uint8_t>> processAndEncode(const AudioEngine& engine, const AudioClip& source) {
+    AudioClip clip = source;
+    engine.trim(clip, 0.05f, 0.0f);
+    engine.process(clip, ProcessingChain().normalizeToPeak(-1.0f).compress({-18.0f, 3.0f, 5.0f, 80.0f, 2.0f}));
+    return engine.encodeWav(clip, 480, 960);
+}
+
+static void testSharedEngine_concurrentCallsMatchSerial() {
+    // One engine shared by all threads, as the batch workers share it; run
+    // under ThreadSanitizer (WOOSH_SANITIZER=thread) to check for races
+    const AudioEngine engine;
+    std::vector<AudioClip> sources;
+    std::vector<std::vector<uint8_t>> expected;
+    for (int i = 0; i < 6; ++i) {
+        sources.emplace_back("clip" + std::to_string(i) + ".wav", 48000, 2,
+                             makeSine(220.0f * static_cast<float>(i + 1), 48000, 24000, 2));
+        auto encoded = processAndEncode(engine, sources.back());
+        assert(encoded);
+        expected.push_back(std::move(*encoded));
+    }
+
+    constexpr int kThreads = 8;
+    constexpr int kRounds = 4;
+    std::vector<int> mismatches(kThreads, 0);
+    std::vector<std::string> errors(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < kRounds; ++round) {
+                for (size_t i = 0; i < sources.size(); ++i) {
+                    const size_t index = (i + static_cast<size_t>(t)) % sources.size();
+                    const auto encoded = processAndEncode(engine, sources[index]);
+                    if (!encoded || *encoded != expected[index]) {
+                        ++mismatches[t];
+                        continue;
+                    }
+
+                    // Decode the result again, and fail an encode on every thread
+                    const auto decoded = engine.loadClip(sources[index].filePath(), *encoded);
+                    if (!decoded || decoded->frameCount() != sources[index].frameCount() - 2400) ++mismatches[t];
+                    const AudioClip empty("empty.wav", 48000, 2, {});
+                    if (engine.encodeMp3(empty, Mp3Encoder::BitrateMode::CBR_128, {}, 0, 0, &errors[t])) {
+                        ++mismatches[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int t = 0; t < kThreads; ++t) {
+        assert(mismatches[t] == 0);
+        // Each call reports its own failure
+        assert(!errors[t].empty());
+    }
+}
+
+/// Load, trim and process @p bytes one step after the other, as a batch used to.
+static std::optional<AudioClip> loadThenProcess(const AudioEngine& engine, std::span<const uint8_t> bytes,
+                                                const ProcessingChain& chain) {
+    auto clip = engine.loadClip("long.wav", bytes);
+    if (!clip) return std::nullopt;
+    clip->saveOriginal();
+    engine.trim(*clip, 1.0f, 150.0f);
+    engine.process(*clip, chain);
+    return clip;
+}
+
+static void testLoadProcessed_matchesLoadThenProcess() {
+    const AudioEngine engine;
+    const auto chain = ProcessingChain().compress({-18.0f, 3.0f, 5.0f, 80.0f, 2.0f}).limit({-1.0f, 5.0f, 50.0f});
+    // 16-bit stereo past FrameRanges::kMinSplitBytes, so it decodes in ranges; and a short one read in one go
+    for (const int frames : {static_cast<int>(FrameRanges::kMinSplitBytes / 4) + 1000, 48000 * 4}) {
+        const AudioClip source("long.wav", 48000, 2, makeSine(330.0f, 48000, frames, 2));
+        const auto bytes = engine.encodeWav(source);
+        assert(bytes);
+
+        const auto expected = loadThenProcess(engine, *bytes, chain);
+        ProcessingChain::Result result;
+        auto clip = engine.loadProcessed("long.wav", *bytes, 1.0f, 150.0f, chain, &result);
+        assert(expected && clip);
+        assert(clip->frameCount() == expected->frameCount() && clip->trimOffsetFrames() == 48000);
+        const auto a = clip->samples();
+        const auto b = expected->samples();
+        assert(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+        assert(clip->isModified() && clip->hasMetrics());
+        assert(std::abs(clip->peakDb() - expected->peakDb()) < 1e-4f && result.fusedPasses == 1);
+
+        // Undo goes back to the whole file
+        clip->restoreOriginal();
+        assert(clip->frameCount() == static_cast<size_t>(frames) && clip->hasMetrics());
+    }
+}
+
 int main() {
     testNormalizePeak();
     testTrim();
+    testTrim_keepsMiddleRangeInPlace();
+    testAutoTrim_removesSilenceAroundSound();
+    testAutoTrim_leavesSilentClipAlone();
+    testProcess_usesClipMetricsAndRefreshesThem();
+    testProcess_measuresClipWithoutMetrics();
+    testProcess_measuresEachChannel();
+    testCompactStorage_processesAndTrimsCompactClips();
+    testSharedEngine_concurrentCallsMatchSerial();
+    testLoadProcessed_matchesLoadThenProcess();
     return 0;
 }
 
@@ -0,0 +1,169 @@
+/**
+ * @file BatchReportTests.cpp
+ * @brief Unit tests for batch timing collection and report output.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/BatchReport.h"
+
+// ============================================================================
+// Helper functions
+// ============================================================================
+
+static bool approxEqual(double a, double b, double epsilon = 1e-9) {
+    return std::fabs(a - b) < epsilon;
+}
+
+static const StageStats* findStage(const BatchReport& report, const std::string& name) {
+    for (const auto& stage : report.stages) {
+        if (stage.name == name) return &stage;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void testStagePercentiles_nearestRank() {
+    BatchRecorder recorder("process", 1);
+    for (int i = 1; i <= 100; ++i) {
+        recorder.addStageSample("decode", static_cast<double>(i));
+    }
+    BatchReport report = recorder.finish();
+
+    const StageStats* decode = findStage(report, "decode");
+    assert(decode != nullptr);
+    assert(decode->count == 100);
+    assert(approxEqual(decode->p50Ms, 50.0));
+    assert(approxEqual(decode->p95Ms, 95.0));
+    assert(approxEqual(decode->maxMs, 100.0));
+    assert(approxEqual(decode->totalMs, 5050.0));
+}
+
+static void testSingleSample_allPercentilesEqual() {
+    BatchRecorder recorder("export", 1);
+    recorder.addStageSample("encode", 7.5);
+    BatchReport report = recorder.finish();
+
+    const StageStats* encode = findStage(report, "encode");
+    assert(encode != nullptr);
+    assert(approxEqual(encode->p50Ms, 7.5));
+    assert(approxEqual(encode->p95Ms, 7.5));
+    assert(approxEqual(encode->maxMs, 7.5));
+}
+
+static void testFiles_totalsAndSlowest() {
+    BatchRecorder recorder("load", 4);
+    recorder.addFile("a.wav", 1000, 5.0, true);
+    recorder.addFile("b.wav", 2000, 50.0, true);
+    recorder.addFile("c.wav", 3000, 20.0, false);
+    recorder.addFile("d.wav", 4000, 1.0, true);
+    BatchReport report = recorder.finish(2);
+
+    assert(report.files == 4);
+    assert(report.failedFiles == 1);
+    assert(report.bytes == 10000);
+    assert(report.workerThreads == 4);
+    assert(report.slowestFiles.size() == 2);
+    assert(report.slowestFiles[0].path == "b.wav");
+    assert(report.slowestFiles[1].path == "c.wav");
+    assert(!report.slowestFiles[1].succeeded);
+    assert(report.wallMs >= 0.0);
+    assert(report.parallelism > 0.0);
+}
+
+static void testConcurrentWorkers_allSamplesRecorded() {
+    BatchRecorder recorder("process", 4);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&recorder, t] {
+            for (int i = 0; i < 250; ++i) {
+                StageTimer timer(&recorder, "dsp");
+                recorder.addFile("clip" + std::to_string(t) + "_" + std::to_string(i), 10, 0.1, true);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    BatchReport report = recorder.finish();
+    assert(report.files == 1000);
+    const StageStats* dsp = findStage(report, "dsp");
+    assert(dsp != nullptr);
+    assert(dsp->count == 1000);
+}
+
+static void testNullRecorder_stageTimerIsNoOp() {
+    StageTimer timer(nullptr, "ignored");
+    assert(timer.elapsedMs() >= 0.0);
+}
+
+static void testJson_containsFieldsAndEscapes() {
+    BatchRecorder recorder("export", 2);
+    recorder.addStageSample("encode", 3.0);
+    recorder.addFile("dir\\clip \"1\".wav", 42, 3.0, true);
+    BatchReport report = recorder.finish();
+
+    std::string json = report.toJson();
+    assert(json.front() == '{' && json.back() == '}');
+    assert(json.find("\"operation\": \"export\"") != std::string::npos);
+    assert(json.find("\"p95Ms\"") != std::string::npos);
+    assert(json.find("\"peakResidentBytes\"") != std::string::npos);
+    assert(json.find("dir\\\\clip \\\"1\\\".wav") != std::string::npos);
+
+    // Control characters in a file name still give valid JSON
+    BatchRecorder control("load", 1);
+    control.addFile("bell\a.wav", 1, 1.0, true);
+    const std::string controlJson = control.finish().toJson();
+    assert(controlJson.find('\a') == std::string::npos);
+    assert(controlJson.find("bell\\u0007.wav") != std::string::npos);
+
+    const auto path = std::filesystem::temp_directory_path() / "woosh_batch_report_test.json";
+    bool ok = writeBatchReportsJson(path.string(), {report, report});
+    assert(ok);
+
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+    std::filesystem::remove(path);
+
+    std::string written = ss.str();
+    assert(written.find("\"batches\"") != std::string::npos);
+    size_t first = written.find("\"operation\"");
+    assert(first != std::string::npos);
+    assert(written.find("\"operation\"", first + 1) != std::string::npos);
+}
+
+static void testText_mentionsStagesAndSlowest() {
+    BatchRecorder recorder("process", 1);
+    recorder.addStageSample("compress", 2.0);
+    recorder.addFile("slow.wav", 1, 2.0, true);
+    std::string text = recorder.finish().toText();
+
+    assert(text.find("process") != std::string::npos);
+    assert(text.find("compress") != std::string::npos);
+    assert(text.find("slow.wav") != std::string::npos);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    testStagePercentiles_nearestRank();
+    testSingleSample_allPercentilesEqual();
+    testFiles_totalsAndSlowest();
+    testConcurrentWorkers_allSamplesRecorded();
+    testNullRecorder_stageTimerIsNoOp();
+    testJson_containsFieldsAndEscapes();
+    testText_mentionsStagesAndSlowest();
+    return 0;
+}
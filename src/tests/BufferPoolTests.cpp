@@ -0,0 +1,113 @@
+/**
+ * @file BufferPoolTests.cpp
+ * @brief Unit tests for the per-thread scratch buffer pool.
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include "utils/BufferPool.h"
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void testAcquire_isAlignedAndSized() {
+    BufferPool pool;
+    auto lease = pool.acquire<float>(1000);
+    assert(lease.size() == 1000);
+    assert(reinterpret_cast<std::uintptr_t>(lease.data()) % BufferPool::kAlignment == 0);
+
+    // Memory is writable end to end
+    for (size_t i = 0; i < lease.size(); ++i) lease[i] = static_cast<float>(i);
+    assert(lease[999] == 999.0f);
+}
+
+static void testRelease_reusesBlock() {
+    BufferPool pool;
+    void* first = nullptr;
+    {
+        auto lease = pool.acquire<float>(48000);
+        first = lease.data();
+    }
+    assert(pool.stats().cachedBytes > 0);
+
+    // Same or slightly smaller size reuses the cached block without allocating
+    auto again = pool.acquire<float>(47000);
+    assert(again.data() == first);
+    assert(pool.stats().acquires == 2);
+    assert(pool.stats().heapAllocations == 1);
+    assert(pool.stats().cachedBytes == 0);
+}
+
+static void testMuchLargerBlock_isNotUsedForSmallRequest() {
+    BufferPool pool;
+    {
+        auto big = pool.acquire<float>(1 << 20);
+    }
+    auto small = pool.acquire<float>(1024);
+    assert(pool.stats().heapAllocations == 2);
+}
+
+static void testMove_transfersOwnership() {
+    BufferPool pool;
+    auto a = pool.acquire<unsigned char>(100);
+    void* ptr = a.data();
+    auto b = std::move(a);
+    assert(a.data() == nullptr && a.size() == 0);
+    assert(b.data() == ptr && b.size() == 100);
+    b.reset();
+    assert(b.data() == nullptr);
+    assert(pool.stats().cachedBytes > 0);
+}
+
+static void testDisabled_allocatesEveryTime() {
+    BufferPool pool;
+    BufferPool::setEnabled(false);
+    {
+        auto lease = pool.acquire<float>(4096);
+    }
+    assert(pool.stats().cachedBytes == 0);
+    {
+        auto lease = pool.acquire<float>(4096);
+    }
+    assert(pool.stats().heapAllocations == 2);
+    BufferPool::setEnabled(true);
+}
+
+static void testRetentionCap_isRespected() {
+    BufferPool pool;
+    for (size_t i = 0; i < BufferPool::kMaxCachedBuffers + 8; ++i) {
+        auto lease = pool.acquire<float>(1024 * (i + 1) * 8);
+        auto other = pool.acquire<float>(1024 * (i + 1) * 8);
+    }
+    assert(pool.stats().cachedBytes <= BufferPool::kMaxCachedBytes);
+
+    pool.clear();
+    assert(pool.stats().cachedBytes == 0);
+}
+
+static void testLocal_isPerThread() {
+    BufferPool* mainPool = &BufferPool::local();
+    BufferPool* workerPool = nullptr;
+    std::thread worker([&workerPool] { workerPool = &BufferPool::local(); });
+    worker.join();
+    assert(mainPool == &BufferPool::local());
+    assert(workerPool != mainPool);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    testAcquire_isAlignedAndSized();
+    testRelease_reusesBlock();
+    testMuchLargerBlock_isNotUsedForSmallRequest();
+    testMove_transfersOwnership();
+    testDisabled_allocatesEveryTime();
+    testRetentionCap_isRespected();
+    testLocal_isPerThread();
+    return 0;
+}
@@ -3,11 +3,14 @@
  * @brief Unit tests for DSP utility functions.
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 #include <limits>
 #include "utils/DSP.h"
+#include "utils/SpeakerLayout.h"
 
 // ============================================================================
 // Helper functions
@@ -254,6 +257,138 @@ static void testCompressor_monoSignal() {
     assert(afterPeak < 0.0f);
 }
 
+// ============================================================================
+// limiter tests
+// ============================================================================
+
+static void testLimiter_belowCeilingUnchanged() {
+    auto samples = makeSine(440.0f, 48000, 4800, 2, 0.5f); // -6 dBFS peak
+    auto original = samples;
+    DSP::limiter(samples, {-1.0f, 5.0f, 50.0f}, 48000, 2);
+    assert(samples == original);
+}
+
+static void testLimiter_neverExceedsCeiling() {
+    // A quiet sine with sudden full-scale bursts: the look-ahead has to
+    // bring the gain down before each burst arrives
+    auto samples = makeSine(440.0f, 48000, 48000, 2, 0.3f);
+    for (size_t i = 0; i < samples.size(); i += 9000) samples[i] = (i / 9000) % 2 ? -1.0f : 1.0f;
+
+    DSP::limiter(samples, {-3.0f, 5.0f, 50.0f}, 48000, 2);
+
+    const float ceiling = std::pow(10.0f, -3.0f / 20.0f);
+    for (float s : samples) assert(std::abs(s) <= ceiling * 1.0001f);
+}
+
+static void testLimiter_rampsInsteadOfStepping() {
+    // Gain falls over the look-ahead, not in one step at the peak
+    std::vector<float> samples(1000, 0.5f);
+    samples[600] = 1.0f;
+    DSP::limiter(samples, {-6.0f, 2.0f, 10.0f}, 48000, 1);  // ~96 frames of look-ahead
+
+    assert(samples[400] == 0.5f);            // Before the look-ahead window
+    assert(samples[550] < 0.5f);             // Already ramping down
+    assert(samples[550] > samples[590]);
+    assert(std::abs(samples[600]) <= 0.5012f);
+    for (size_t i = 1; i < samples.size(); ++i) {
+        assert(std::abs(samples[i] - samples[i - 1]) < 0.05f || i == 600 || i == 601);
+    }
+}
+
+static void testLimiter_blocksMatchWholeBuffer() {
+    auto whole = makeSine(100.0f, 48000, 20000, 2, 1.5f);
+    auto blocked = whole;
+    const DSP::LimiterSettings settings{-1.0f, 10.0f, 80.0f};
+    DSP::limiter(whole, settings, 48000, 2);
+
+    // Odd block sizes, applied as soon as gains are ready
+    DSP::Limiter lim(settings, 48000);
+    size_t limited = 0;
+    for (size_t first = 0; first < 20000; first += 333) {
+        lim.analyze(blocked.data() + first * 2, std::min<size_t>(333, 20000 - first), 2);
+        const size_t ready = lim.readyFrames();
+        lim.apply(blocked.data() + limited * 2, ready, 2);
+        limited += ready;
+    }
+    lim.finish();
+    lim.apply(blocked.data() + limited * 2, lim.readyFrames(), 2);
+
+    assert(blocked == whole);
+}
+
+static void testLimiter_longLookaheadAndShortClip() {
+    // Look-ahead longer than the clip: everything drains in finish()
+    auto samples = makeSine(440.0f, 48000, 1000, 1, 2.0f);
+    DSP::limiter(samples, {0.0f, 100.0f, 100.0f}, 48000, 1);
+    for (float s : samples) assert(std::abs(s) <= 1.0001f);
+
+    std::vector<float> empty;
+    DSP::limiter(empty, {0.0f, 100.0f, 100.0f}, 48000, 1);
+    assert(empty.empty());
+}
+
+// ============================================================================
+// findSoundRange tests
+// ============================================================================
+
+/// Silence, then a tone over [toneStart, toneEnd), then silence.
+static std::vector<float> makePaddedTone(int frames, int toneStart, int toneEnd, int channels) {
+    auto data = makeSine(440.0f, 48000, frames, channels, 0.5f);
+    for (int i = 0; i < frames; ++i) {
+        if (i >= toneStart && i < toneEnd) continue;
+        for (int c = 0; c < channels; ++c) data[static_cast<size_t>(i * channels + c)] = 0.0f;
+    }
+    return data;
+}
+
+static void testFindSoundRange_findsToneEdges() {
+    // Tone starts at a zero crossing, so the first frame above threshold is just after it
+    auto samples = makePaddedTone(48000, 10000, 30000, 2);
+    auto range = DSP::findSoundRange(samples, 48000, 2, {-40.0f, 0.0f, 0.0f});
+
+    assert(range.startFrame >= 10000 && range.startFrame < 10005);
+    assert(range.endFrame <= 30000 && range.endFrame > 29990);
+}
+
+static void testFindSoundRange_appliesPreAndPostRoll() {
+    auto samples = makePaddedTone(48000, 10000, 30000, 1);
+    auto bare = DSP::findSoundRange(samples, 48000, 1, {-40.0f, 0.0f, 0.0f});
+    auto rolled = DSP::findSoundRange(samples, 48000, 1, {-40.0f, 10.0f, 50.0f});  // 480 / 2400 frames
+
+    assert(rolled.startFrame == bare.startFrame - 480);
+    assert(rolled.endFrame == bare.endFrame + 2400);
+
+    // Roll never reaches past the clip
+    auto wide = DSP::findSoundRange(samples, 48000, 1, {-40.0f, 1000.0f, 1000.0f});
+    assert(wide.startFrame == 0 && wide.endFrame == 48000);
+}
+
+static void testFindSoundRange_ignoresNoiseBelowThreshold() {
+    auto samples = makePaddedTone(24000, 5000, 15000, 1);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] += (i % 2 ? 1e-4f : -1e-4f);  // -80 dBFS hiss
+
+    auto range = DSP::findSoundRange(samples, 48000, 1, {-60.0f, 0.0f, 0.0f});
+    assert(range.startFrame >= 5000 && range.startFrame < 5005);
+    assert(range.endFrame <= 15000 && range.endFrame > 14990);
+}
+
+static void testFindSoundRange_allSilenceIsEmpty() {
+    auto samples = makeSilence(9600);
+    assert(DSP::findSoundRange(samples, 48000, 2, {-60.0f, 10.0f, 10.0f}).empty());
+
+    std::vector<float> empty;
+    assert(DSP::findSoundRange(empty, 48000, 2, {-60.0f, 10.0f, 10.0f}).empty());
+    assert(DSP::findSoundRange(samples, 0, 2, {-60.0f, 10.0f, 10.0f}).empty());
+}
+
+static void testFindSoundRange_singleClick() {
+    // One loud sample is enough to keep, even inside an otherwise silent block
+    auto samples = makeSilence(4800);
+    samples[3000] = 0.9f;
+    auto range = DSP::findSoundRange(samples, 48000, 1, {-50.0f, 0.0f, 0.0f});
+    assert(range.startFrame == 3000 && range.endFrame == 3001);
+}
+
 // ============================================================================
 // applyFadeIn tests
 // ============================================================================
@@ -401,6 +536,284 @@ static void testApplyFadeOut_fadeLongerThanBuffer() {
     assert(samples[9] < 0.2f);   // End approaching 0
 }
 
+static void testApplyFadeOut_stereoFramesShareGain() {
+    std::vector<float> samples(200, 1.0f);  // 100 stereo frames
+
+    DSP::applyFadeOut(samples, 50, DSP::FadeType::Linear, 2);
+
+    // Fade covers the last 50 frames (100 samples), both channels alike
+    assert(approxEqual(samples[98], 1.0f, 0.01f));
+    assert(approxEqual(samples[100], 1.0f, 0.01f));
+    assert(approxEqual(samples[150], 0.5f, 0.02f));
+    for (size_t f = 0; f < 100; ++f) {
+        assert(samples[f * 2] == samples[f * 2 + 1]);
+    }
+}
+
+// ============================================================================
+// applyFadeEnvelope tests
+// ============================================================================
+
+static void testApplyFadeEnvelope_blocksMatchWholeBuffer() {
+    const size_t frames = 1000;
+    auto whole = makeSine(440.0f, 44100, static_cast<int>(frames), 2);
+    auto blocked = whole;
+    const DSP::FadeEnvelope envelope{120, 300, DSP::FadeType::SCurve};
+
+    DSP::applyFadeEnvelope(whole.data(), frames, 2, 0, frames, envelope);
+
+    // Uneven block size so blocks straddle both fade boundaries
+    const size_t blockFrames = 77;
+    for (size_t first = 0; first < frames; first += blockFrames) {
+        const size_t n = std::min(blockFrames, frames - first);
+        DSP::applyFadeEnvelope(blocked.data() + first * 2, n, 2, first, frames, envelope);
+    }
+    assert(blocked == whole);
+}
+
+static void testApplyFadeEnvelope_matchesFadeInAndOut() {
+    auto expected = makeConstant(600, 1.0f);  // 200 frames of 3 channels
+    auto actual = expected;
+    DSP::applyFadeIn(expected, 40, DSP::FadeType::Exponential, 3);
+    DSP::applyFadeOut(expected, 60, DSP::FadeType::Exponential, 3);
+
+    DSP::applyFadeEnvelope(actual.data(), 200, 3, 0, 200, {40, 60, DSP::FadeType::Exponential});
+
+    assert(actual == expected);
+}
+
+static void testFadeEnvelope_touches() {
+    const DSP::FadeEnvelope envelope{100, 50, DSP::FadeType::Linear};
+
+    assert(envelope.touches(0, 10, 1000));
+    assert(envelope.touches(99, 10, 1000));
+    assert(!envelope.touches(100, 850, 1000));  // Between the fades
+    assert(envelope.touches(900, 100, 1000));
+    assert(!DSP::FadeEnvelope{}.touches(0, 1000, 1000));
+    assert(!DSP::FadeEnvelope{}.isActive());
+}
+
+// ============================================================================
+// Channel layout tests
+// ============================================================================
+
+/// Copy a mono signal into every channel of an interleaved buffer.
+static std::vector<float> spreadToChannels(const std::vector<float>& mono, int channels) {
+    std::vector<float> out(mono.size() * static_cast<size_t>(channels));
+    for (size_t f = 0; f < mono.size(); ++f) {
+        for (int c = 0; c < channels; ++c) out[f * static_cast<size_t>(channels) + static_cast<size_t>(c)] = mono[f];
+    }
+    return out;
+}
+
+static void testCompressor_layoutsAgree() {
+    // Mono, stereo and generic (3-channel) kernels see the same frame peaks
+    auto mono = makeSine(440.0f, 48000, 4800, 1, 0.9f);
+    auto stereo = spreadToChannels(mono, 2);
+    auto three = spreadToChannels(mono, 3);
+
+    DSP::compressor(mono, -12.0f, 4.0f, 5.0f, 50.0f, 0.0f, 48000, 1);
+    DSP::compressor(stereo, -12.0f, 4.0f, 5.0f, 50.0f, 0.0f, 48000, 2);
+    DSP::compressor(three, -12.0f, 4.0f, 5.0f, 50.0f, 0.0f, 48000, 3);
+
+    assert(stereo == spreadToChannels(mono, 2));
+    assert(three == spreadToChannels(mono, 3));
+}
+
+static void testLimiter_layoutsAgree() {
+    auto mono = makeSine(440.0f, 48000, 4800, 1, 1.4f);
+    auto stereo = spreadToChannels(mono, 2);
+    auto three = spreadToChannels(mono, 3);
+
+    DSP::limiter(mono, {-1.0f, 5.0f, 50.0f}, 48000, 1);
+    DSP::limiter(stereo, {-1.0f, 5.0f, 50.0f}, 48000, 2);
+    DSP::limiter(three, {-1.0f, 5.0f, 50.0f}, 48000, 3);
+
+    assert(stereo == spreadToChannels(mono, 2));
+    assert(three == spreadToChannels(mono, 3));
+}
+
+static void testConvertToInt16_scalesAndClamps() {
+    std::vector<float> samples = {0.0f, 1.0f, -1.0f, 0.5f, 2.0f, -3.0f};
+    std::vector<int16_t> out(samples.size());
+
+    DSP::convertToInt16(samples.data(), out.data(), 3, 2);
+
+    assert(out[0] == 0);
+    assert(out[1] == 32767);
+    assert(out[2] == -32767);
+    assert(out[3] == 16383);
+    assert(out[4] == 32767);   // Clamped
+    assert(out[5] == -32767);  // Clamped
+}
+
+static void testConvertToInt16_matchesFadedFloat() {
+    for (int channels : {1, 2, 6}) {
+        auto faded = spreadToChannels(makeConstant(500, 0.8f), channels);
+        const auto source = faded;
+        DSP::applyFadeEnvelope(faded.data(), 500, channels, 0, 500, {120, 200, DSP::FadeType::SCurve});
+
+        std::vector<int16_t> out(source.size());
+        DSP::convertToInt16(source.data(), out.data(), 500, channels, {120, 200, DSP::FadeType::SCurve});
+
+        for (size_t i = 0; i < out.size(); ++i) {
+            assert(out[i] == static_cast<int16_t>(faded[i] * 32767.0f));
+        }
+    }
+}
+
+static void testConvertToInt16_overlappingFades() {
+    // Fades longer than the clip overlap; both gains apply, as on export
+    std::vector<float> samples(20, 1.0f);
+    auto faded = samples;
+    DSP::applyFadeEnvelope(faded.data(), 20, 1, 0, 20, {15, 15, DSP::FadeType::Linear});
+
+    std::vector<int16_t> out(samples.size());
+    DSP::convertToInt16(samples.data(), out.data(), 20, 1, {15, 15, DSP::FadeType::Linear});
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        assert(out[i] == static_cast<int16_t>(faded[i] * 32767.0f));
+    }
+}
+
+// ============================================================================
+// Multichannel tests
+// ============================================================================
+
+static void testCompressor_surroundLfeDoesNotDuckFronts() {
+    // 5.1 with quiet fronts and a loud LFE: only the LFE group is compressed
+    constexpr int kFrames = 4800;
+    const auto quiet = makeSine(440.0f, 48000, kFrames, 1, 0.1f);
+    const auto loud = makeSine(60.0f, 48000, kFrames, 1, 0.9f);
+    std::vector<float> surround(static_cast<size_t>(kFrames) * 6, 0.0f);
+    for (size_t f = 0; f < kFrames; ++f) {
+        surround[f * 6 + 0] = surround[f * 6 + 1] = quiet[f];
+        surround[f * 6 + 3] = loud[f];
+    }
+    auto grouped = surround;
+    auto linked = surround;
+
+    DSP::Compressor({-12.0f, 4.0f, 5.0f, 50.0f, 0.0f}, 48000).process(grouped.data(), kFrames, 6);
+    DSP::Compressor({-12.0f, 4.0f, 5.0f, 50.0f, 0.0f, DSP::ChannelLink::All}, 48000)
+        .process(linked.data(), kFrames, 6);
+
+    float frontDiff = 0.0f;
+    float linkedFrontDiff = 0.0f;
+    float lfePeak = 0.0f;
+    for (size_t f = 0; f < kFrames; ++f) {
+        frontDiff = std::max(frontDiff, std::abs(grouped[f * 6] - surround[f * 6]));
+        linkedFrontDiff = std::max(linkedFrontDiff, std::abs(linked[f * 6] - surround[f * 6]));
+        lfePeak = std::max(lfePeak, std::abs(grouped[f * 6 + 3]));
+        assert(grouped[f * 6] == grouped[f * 6 + 1]);
+    }
+    assert(frontDiff == 0.0f);
+    assert(linkedFrontDiff > 0.01f);
+    assert(lfePeak < 0.85f);
+}
+
+static void testCompressor_groupsOfEqualChannelsMatchLinked() {
+    // Every group sees the same peaks, so every group follows the same gain
+    auto mono = makeSine(440.0f, 48000, 4800, 1, 0.9f);
+    DSP::compressor(mono, -12.0f, 4.0f, 5.0f, 50.0f, 0.0f, 48000, 1);
+    for (int channels : {5, 6, 8}) {
+        auto samples = spreadToChannels(makeSine(440.0f, 48000, 4800, 1, 0.9f), channels);
+        DSP::compressor(samples, -12.0f, 4.0f, 5.0f, 50.0f, 0.0f, 48000, channels);
+        assert(samples == spreadToChannels(mono, channels));
+    }
+}
+
+static void testSpeakerLayout_linkGroups() {
+    assert(SpeakerLayout::linkGroupCount(1) == 1);
+    assert(SpeakerLayout::linkGroupCount(2) == 1);
+    assert(SpeakerLayout::linkGroupCount(4) == 1);    // Quad or first-order ambisonics
+    assert(SpeakerLayout::linkGroupCount(16) == 1);
+    assert(SpeakerLayout::linkGroupCount(6) == 4);
+    assert(SpeakerLayout::linkGroup(0, 6) == SpeakerLayout::linkGroup(1, 6));
+    assert(SpeakerLayout::linkGroup(2, 6) != SpeakerLayout::linkGroup(3, 6));
+    assert(SpeakerLayout::linkGroup(4, 8) != SpeakerLayout::linkGroup(6, 8));
+    assert(SpeakerLayout::label(3, 6) == "LFE");
+    assert(SpeakerLayout::label(6, 8) == "Ls");
+    assert(SpeakerLayout::label(9, 16) == "10");
+}
+
+static void testMixMatrix_surroundToStereo() {
+    const auto m = SpeakerLayout::mixMatrix(6, 2);
+    assert(m.size() == 12);
+    // L R C LFE Ls Rs into left: L, -3 dB C and Ls, no LFE, scaled to sum to 1
+    const float scale = 1.0f / (1.0f + 2.0f * 0.70710678f);
+    assert(approxEqual(m[0], scale, 1e-5f));
+    assert(m[1] == 0.0f);
+    assert(approxEqual(m[2], 0.70710678f * scale, 1e-5f));
+    assert(m[3] == 0.0f);
+    assert(approxEqual(m[4], 0.70710678f * scale, 1e-5f));
+    assert(m[5] == 0.0f);
+    // Right mirrors left
+    assert(m[6 + 1] == m[0] && m[6 + 2] == m[2] && m[6 + 5] == m[4] && m[6 + 0] == 0.0f);
+}
+
+static void testMixMatrix_monoAndIdentity() {
+    assert((SpeakerLayout::mixMatrix(1, 2) == std::vector<float>{1.0f, 1.0f}));
+    assert((SpeakerLayout::mixMatrix(2, 1) == std::vector<float>{0.5f, 0.5f}));
+    assert((SpeakerLayout::mixMatrix(2, 2) == std::vector<float>{1.0f, 0.0f, 0.0f, 1.0f}));
+    // Mono into 5.1 plays from the front pair only
+    const auto m = SpeakerLayout::mixMatrix(1, 6);
+    assert(m[0] == 1.0f && m[1] == 1.0f && m[2] == 0.0f && m[3] == 0.0f);
+}
+
+static void testMixChannels_appliesMatrix() {
+    // One frame per row of a constant per channel; generic and specialized kernels agree
+    for (int channels : {3, 6, 8, 10}) {
+        std::vector<float> samples(100 * static_cast<size_t>(channels));
+        for (size_t i = 0; i < samples.size(); ++i) samples[i] = 0.1f * static_cast<float>(i % channels + 1);
+        const auto matrix = SpeakerLayout::mixMatrix(channels, 2);
+        std::vector<float> left(100), right(100);
+        float* out[] = {left.data(), right.data()};
+
+        DSP::mixChannels(samples.data(), 100, channels, matrix.data(), 2, out);
+
+        float expectedLeft = 0.0f;
+        float expectedRight = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            expectedLeft += matrix[static_cast<size_t>(c)] * 0.1f * static_cast<float>(c + 1);
+            expectedRight += matrix[static_cast<size_t>(channels + c)] * 0.1f * static_cast<float>(c + 1);
+        }
+        for (size_t f = 0; f < 100; ++f) {
+            assert(approxEqual(left[f], expectedLeft, 1e-5f));
+            assert(approxEqual(right[f], expectedRight, 1e-5f));
+            assert(std::abs(left[f]) <= 1.0f && std::abs(right[f]) <= 1.0f);
+        }
+    }
+}
+
+static void testChannelLevelMeter_perChannelAndOverall() {
+    constexpr size_t kFrames = 30000;     // Above the parallel threshold
+    std::vector<float> samples(kFrames * 6, 0.0f);
+    for (size_t f = 0; f < kFrames; ++f) {
+        samples[f * 6 + 0] = 0.5f;
+        samples[f * 6 + 3] = (f % 2 == 0) ? 0.25f : -0.25f;
+    }
+
+    const auto meter = DSP::measureChannelLevels(samples, 6);
+    const auto channels = meter.channelLevels();
+    assert(channels.size() == 6);
+    assert(approxEqual(channels[0].peakDb, -6.02f, 0.01f));
+    assert(approxEqual(channels[0].rmsDb, -6.02f, 0.01f));
+    assert(approxEqual(channels[3].peakDb, -12.04f, 0.01f));
+    assert(channels[1].peakDb < -150.0f);
+
+    // The overall levels are those of the whole buffer
+    const auto whole = DSP::measureLevels(samples);
+    assert(approxEqual(meter.levels().peakDb, whole.peakDb, 1e-4f));
+    assert(approxEqual(meter.levels().rmsDb, whole.rmsDb, 1e-4f));
+
+    // Block by block gives the same as one pass
+    DSP::ChannelLevelMeter blocks(6);
+    for (size_t first = 0; first < kFrames; first += 4096) {
+        blocks.add(samples.data() + first * 6, std::min<size_t>(4096, kFrames - first));
+    }
+    assert(approxEqual(blocks.channelLevels()[3].rmsDb, channels[3].rmsDb, 1e-4f));
+}
+
 // ============================================================================
 // Main test runner
 // ============================================================================
@@ -441,6 +854,20 @@ int main() {
     testCompressor_invalidChannels();
     testCompressor_monoSignal();
     
+    // limiter tests
+    testLimiter_belowCeilingUnchanged();
+    testLimiter_neverExceedsCeiling();
+    testLimiter_rampsInsteadOfStepping();
+    testLimiter_blocksMatchWholeBuffer();
+    testLimiter_longLookaheadAndShortClip();
+    
+    // findSoundRange tests
+    testFindSoundRange_findsToneEdges();
+    testFindSoundRange_appliesPreAndPostRoll();
+    testFindSoundRange_ignoresNoiseBelowThreshold();
+    testFindSoundRange_allSilenceIsEmpty();
+    testFindSoundRange_singleClick();
+    
     // applyFadeIn tests
     testApplyFadeIn_linearFade();
     testApplyFadeIn_exponentialFade();
@@ -456,6 +883,28 @@ int main() {
     testApplyFadeOut_emptyBuffer();
     testApplyFadeOut_zeroLength();
     testApplyFadeOut_fadeLongerThanBuffer();
+    testApplyFadeOut_stereoFramesShareGain();
+    
+    // applyFadeEnvelope tests
+    testApplyFadeEnvelope_blocksMatchWholeBuffer();
+    testApplyFadeEnvelope_matchesFadeInAndOut();
+    testFadeEnvelope_touches();
+    
+    // Channel layout tests
+    testCompressor_layoutsAgree();
+    testLimiter_layoutsAgree();
+    testConvertToInt16_scalesAndClamps();
+    testConvertToInt16_matchesFadedFloat();
+    testConvertToInt16_overlappingFades();
+
+    // Multichannel tests
+    testCompressor_surroundLfeDoesNotDuckFronts();
+    testCompressor_groupsOfEqualChannelsMatchLinked();
+    testSpeakerLayout_linkGroups();
+    testMixMatrix_surroundToStereo();
+    testMixMatrix_monoAndIdentity();
+    testMixChannels_appliesMatrix();
+    testChannelLevelMeter_perChannelAndOverall();
     
     return 0;
 }
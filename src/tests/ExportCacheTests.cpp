@@ -0,0 +1,300 @@
+/**
+ * @file ExportCacheTests.cpp
+ * @brief Unit tests for export keys and the export manifest.
+ */
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "core/ExportCache.h"
+#include "tests/TestFiles.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static ClipState makeState() {
+    ClipState state;
+    state.relativePath = "boom.wav";
+    state.isNormalized = true;
+    state.normalizeTargetDb = -1.0;
+    state.isCompressed = true;
+    state.compressorSettings = {-12.0f, 4.0f, 10.0f, 100.0f, 0.0f};
+    state.fadeOutFrames = 441;
+    return state;
+}
+
+static uint64_t keyOf(const ClipState* state, ExportFormat format = ExportFormat::MP3,
+                      Mp3Encoder::BitrateMode bitrate = Mp3Encoder::BitrateMode::CBR_192,
+                      const Mp3Metadata& metadata = {}) {
+    return ExportCache::exportKey(0x1234, state, format, bitrate, metadata);
+}
+
+// ============================================================================
+// Key tests
+// ============================================================================
+
+static void testExportKey_isStable() {
+    const ClipState state = makeState();
+    assert(keyOf(&state) == keyOf(&state));
+    assert(keyOf(nullptr) == keyOf(nullptr));
+    assert(keyOf(&state) != keyOf(nullptr));
+}
+
+static void testExportKey_changesWithInputs() {
+    const ClipState state = makeState();
+    const uint64_t base = keyOf(&state);
+
+    assert(ExportCache::exportKey(0x1235, &state, ExportFormat::MP3, Mp3Encoder::BitrateMode::CBR_192, {}) != base);
+
+    ClipState other = state;
+    other.compressorSettings.ratio = 5.0f;
+    assert(keyOf(&other) != base);
+
+    other = state;
+    other.fadeOutFrames = 442;
+    assert(keyOf(&other) != base);
+
+    other = state;
+    other.isLimited = true;
+    assert(keyOf(&other) != base);
+
+    assert(keyOf(&state, ExportFormat::WAV) != base);
+    assert(keyOf(&state, ExportFormat::MP3, Mp3Encoder::BitrateMode::CBR_128) != base);
+
+    Mp3Metadata metadata;
+    metadata.album = "Game";
+    assert(keyOf(&state, ExportFormat::MP3, Mp3Encoder::BitrateMode::CBR_192, metadata) != base);
+}
+
+static void testExportKey_ignoresUnusedSettings() {
+    ClipState state = makeState();
+    const uint64_t base = keyOf(&state);
+
+    // Parameters of disabled steps and non-output fields do not matter
+    ClipState other = state;
+    other.limiterSettings.ceilingDb = -3.0f;
+    other.trimStartSec = 0.5;
+    other.isExported = true;
+    other.exportedFilename = "boom.mp3";
+    assert(keyOf(&other) == base);
+
+    // WAV files carry no bitrate or tags
+    Mp3Metadata metadata;
+    metadata.artist = "Studio";
+    assert(keyOf(&state, ExportFormat::WAV, Mp3Encoder::BitrateMode::CBR_128, metadata)
+           == keyOf(&state, ExportFormat::WAV));
+}
+
+static void testOutputFileName_matchesWrittenFile() {
+    assert(ExportCache::outputFileName("/raw/sfx/boom.wav", ExportFormat::MP3) == "boom.mp3");
+    assert(ExportCache::outputFileName("/raw/sfx/boom.mp3", ExportFormat::WAV) == "boom.wav");
+    assert(ExportCache::outputFileName("/raw/sfx/boom.wav", ExportFormat::OGG) == "boom.wav");
+}
+
+// ============================================================================
+// Manifest tests
+// ============================================================================
+
+static void testHashFile_followsContent() {
+    const fs::path dir = makeTempDir("woosh_export_cache_hash");
+    writeFile(dir / "a.wav", "abc");
+    writeFile(dir / "b.wav", "abc");
+    writeFile(dir / "c.wav", "abd");
+
+    auto a = ExportCache::hashFile((dir / "a.wav").string());
+    assert(a.has_value());
+    assert(a == ExportCache::hashFile((dir / "b.wav").string()));
+    assert(a != ExportCache::hashFile((dir / "c.wav").string()));
+    assert(!ExportCache::hashFile((dir / "missing.wav").string()).has_value());
+    fs::remove_all(dir);
+}
+
+static void testManifest_upToDateAfterRecord() {
+    const fs::path dir = makeTempDir("woosh_export_cache_manifest");
+    const std::string folder = dir.string();
+    writeFile(dir / "source.wav", "source samples");
+    writeFile(dir / "boom.mp3", "encoded");
+
+    ExportManifest manifest;
+    auto stamp = manifest.sourceStamp((dir / "source.wav").string());
+    assert(stamp.has_value());
+    assert(!manifest.isUpToDate(folder, "boom.mp3", 42));
+
+    manifest.record(folder, "boom.mp3", 42, (dir / "source.wav").string(), *stamp);
+    assert(manifest.isUpToDate(folder, "boom.mp3", 42));
+    assert(!manifest.isUpToDate(folder, "boom.mp3", 43));
+
+    // A replaced or deleted output is no longer up to date
+    writeFile(dir / "boom.mp3", "encoded differently");
+    assert(!manifest.isUpToDate(folder, "boom.mp3", 42));
+    fs::remove(dir / "boom.mp3");
+    assert(!manifest.isUpToDate(folder, "boom.mp3", 42));
+
+    // Recording an output that was not written forgets it
+    manifest.record(folder, "boom.mp3", 42, (dir / "source.wav").string(), *stamp);
+    assert(!manifest.contains("boom.mp3"));
+    fs::remove_all(dir);
+}
+
+static void testManifest_saveLoadRoundTrip() {
+    const fs::path dir = makeTempDir("woosh_export_cache_roundtrip");
+    const std::string folder = dir.string();
+    const std::string source = (dir / "source file.wav").string();
+    writeFile(source, "source");
+    writeFile(dir / "a.wav", "output a");
+
+    ExportManifest manifest;
+    auto stamp = manifest.sourceStamp(source);
+    assert(stamp.has_value());
+    manifest.record(folder, "a.wav", 0xfedcba9876543210ull, source, *stamp);
+    assert(manifest.save(folder));
+    assert(fs::exists(dir / ExportManifest::kFileName));
+
+    ExportManifest loaded = ExportManifest::load(folder);
+    assert(loaded.size() == 1);
+    const auto* entry = loaded.find("a.wav");
+    assert(entry);
+    assert(entry->key == 0xfedcba9876543210ull);
+    assert(entry->outputSize == 8);
+    assert(entry->sourcePath == source);
+    assert(entry->source.contentHash == stamp->contentHash);
+    assert(entry->source.fileSize == stamp->fileSize);
+    assert(entry->source.modifiedTime == stamp->modifiedTime);
+    assert(loaded.isUpToDate(folder, "a.wav", 0xfedcba9876543210ull));
+    fs::remove_all(dir);
+}
+
+static void testManifest_loadToleratesDamage() {
+    const fs::path dir = makeTempDir("woosh_export_cache_damaged");
+    assert(ExportManifest::load(dir.string()).size() == 0);
+
+    writeFile(dir / ExportManifest::kFileName, "something else\n");
+    assert(ExportManifest::load(dir.string()).size() == 0);
+
+    writeFile(dir / ExportManifest::kFileName,
+              "woosh-export-manifest 1\n"
+              "2a\t7\t1\t3\t5\tgood.wav\t/raw/good.wav\n"
+              "not a valid line\n"
+              "zz\t7\t1\t3\t5\tbad.wav\t/raw/bad.wav\n");
+    ExportManifest manifest = ExportManifest::load(dir.string());
+    assert(manifest.size() == 1);
+    assert(manifest.contains("good.wav"));
+    fs::remove_all(dir);
+}
+
+static void testSourceStamp_reusesRecordedHash() {
+    const fs::path dir = makeTempDir("woosh_export_cache_stamp");
+    const std::string source = (dir / "source.wav").string();
+    writeFile(source, "original");
+    writeFile(dir / "out.wav", "output");
+
+    ExportManifest manifest;
+    SourceStamp recorded = *manifest.sourceStamp(source);
+    const uint64_t realHash = recorded.contentHash;
+    recorded.contentHash = 7;   // Stands in for a hash only the manifest knows
+    manifest.record(dir.string(), "out.wav", 1, source, recorded);
+
+    // Unchanged size and time: the file is not read again
+    assert(manifest.sourceStamp(source)->contentHash == 7);
+
+    // Changed content: hashed again
+    writeFile(source, "modified!");
+    const auto fresh = manifest.sourceStamp(source);
+    assert(fresh.has_value());
+    assert(fresh->contentHash != 7 && fresh->contentHash != realHash);
+    assert(!manifest.sourceStamp((dir / "missing.wav").string()).has_value());
+    fs::remove_all(dir);
+}
+
+static void testManifest_mergeTakesOwnedOutputs() {
+    const fs::path dir = makeTempDir("woosh_export_cache_merge");
+    const std::string folder = dir.string();
+    writeFile(dir / "source.wav", "source");
+    for (const char* name : {"a.wav", "b.wav", "c.wav"}) writeFile(dir / name, name);
+
+    ExportManifest base;
+    const SourceStamp stamp = *base.sourceStamp((dir / "source.wav").string());
+    base.record(folder, "a.wav", 1, "/raw/a.wav", stamp);
+    base.record(folder, "b.wav", 1, "/raw/b.wav", stamp);
+    base.record(folder, "c.wav", 1, "/raw/c.wav", stamp);
+
+    // A shard owning a and b re-exported a and failed b
+    ExportManifest shard = base;
+    shard.record(folder, "a.wav", 2, "/raw/a.wav", stamp);
+    shard.remove("b.wav");
+    shard.record(folder, "c.wav", 9, "/raw/c.wav", stamp);   // Not owned: ignored
+
+    base.merge(shard, {"a.wav", "b.wav"});
+    assert(base.find("a.wav") && base.find("a.wav")->key == 2);
+    assert(!base.contains("b.wav"));
+    assert(base.find("c.wav") && base.find("c.wav")->key == 1);
+    fs::remove_all(dir);
+}
+
+static void testUndo_nextExportIsWritten() {
+    const fs::path dir = makeTempDir("woosh_export_cache_undo");
+    const std::string folder = dir.string();
+    const std::string source = (dir / "boom.wav").string();
+    writeFile(source, "source samples");
+
+    // Process and export: the output is recorded under the processed key
+    ClipState state = makeState();
+    state.isTrimmed = true;
+    state.trimStartSec = 0.25;
+    state.trimEndSec = 1.5;
+    uint64_t processedKey = 0;
+    {
+        ExportManifest manifest = ExportManifest::load(folder);
+        const auto stamp = manifest.sourceStamp(source);
+        processedKey = ExportCache::exportKey(stamp->contentHash, &state, ExportFormat::MP3,
+                                              Mp3Encoder::BitrateMode::CBR_192, {});
+        writeFile(dir / "boom.mp3", "processed");
+        manifest.record(folder, "boom.mp3", processedKey, source, *stamp);
+        assert(manifest.save(folder));
+        assert(ExportManifest::load(folder).isUpToDate(folder, "boom.mp3", processedKey));
+    }
+
+    // Undo forgets the processing and the output
+    state.clearProcessing();
+    assert(!state.hasProcessing() && !state.info);
+    assert(state.fadeOutFrames == 441);
+    assert(ExportCache::forgetOutput(folder, source, ExportFormat::MP3));
+
+    // Export again: neither the restored key nor the old one is up to date
+    const ExportManifest manifest = ExportManifest::load(folder);
+    const uint64_t key = ExportCache::exportKey(manifest.sourceStamp(source)->contentHash, &state, ExportFormat::MP3,
+                                                Mp3Encoder::BitrateMode::CBR_192, {});
+    assert(key != processedKey);
+    assert(!manifest.isUpToDate(folder, "boom.mp3", key));
+    assert(!manifest.isUpToDate(folder, "boom.mp3", processedKey));
+
+    // Nothing to forget is not an error
+    assert(ExportCache::forgetOutput(folder, source, ExportFormat::MP3));
+    fs::remove_all(dir);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    // Keys
+    testExportKey_isStable();
+    testExportKey_changesWithInputs();
+    testExportKey_ignoresUnusedSettings();
+    testOutputFileName_matchesWrittenFile();
+
+    // Manifest
+    testHashFile_followsContent();
+    testManifest_upToDateAfterRecord();
+    testManifest_saveLoadRoundTrip();
+    testManifest_loadToleratesDamage();
+    testSourceStamp_reusesRecordedHash();
+    testManifest_mergeTakesOwnedOutputs();
+    testUndo_nextExportIsWritten();
+    return 0;
+}
@@ -0,0 +1,325 @@
+/**
+ * @file FingerprintTests.cpp
+ * @brief Unit tests for audio fingerprints and the duplicate index.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "audio/Formats/RiffWav.h"
+#include "core/FingerprintIndex.h"
+#include "tests/TestFiles.h"
+#include "utils/Fingerprint.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+constexpr int kRate = 44100;
+
+/// A sequence of decaying notes at pseudo-random pitches, different for every seed.
+static std::vector<float> makeSound(unsigned seed, double seconds, int channels = 1) {
+    std::mt19937 rng(seed);
+    const size_t frames = static_cast<size_t>(seconds * kRate);
+    const size_t noteFrames = kRate / 8;
+    std::vector<float> samples(frames * static_cast<size_t>(channels));
+    double freq = 0.0;
+    for (size_t i = 0; i < frames; ++i) {
+        const size_t inNote = i % noteFrames;
+        if (inNote == 0) freq = 200.0 + static_cast<double>(rng() % 2800);
+        const double t = static_cast<double>(inNote) / kRate;
+        const double x = 0.5 * std::exp(-t * 12.0) * std::sin(2.0 * 3.14159265358979 * freq * t);
+        for (int ch = 0; ch < channels; ++ch) {
+            samples[i * static_cast<size_t>(channels) + static_cast<size_t>(ch)] = static_cast<float>(x);
+        }
+    }
+    return samples;
+}
+
+/// Broadband noise, high-passed: covers most of the hash space over a few minutes.
+static std::vector<float> makeAmbience(unsigned seed, double seconds) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> samples(static_cast<size_t>(seconds * kRate));
+    float lowPassed = 0.0f;
+    float rumble = 0.0f;
+    for (float& s : samples) {
+        lowPassed += 0.3f * (noise(rng) - lowPassed);
+        s = 0.2f * (lowPassed - rumble);
+        rumble += 0.01f * (lowPassed - rumble);
+    }
+    return samples;
+}
+
+// ============================================================================
+// Fingerprint tests
+// ============================================================================
+
+static void testFingerprint_isDeterministicAndSorted() {
+    auto sound = makeSound(1, 2.0);
+    Fingerprint a = fingerprintSamples(sound, kRate, 1);
+    Fingerprint b = fingerprintSamples(sound, kRate, 1);
+    assert(a.landmarks.size() > 50);
+    assert(a.landmarks == b.landmarks);
+    assert(a.contentHash == b.contentHash);
+    assert(std::abs(a.durationSeconds - 2.0) < 1e-3);
+    for (size_t i = 1; i < a.landmarks.size(); ++i) assert(a.landmarks[i - 1] < a.landmarks[i]);
+    for (const Landmark& landmark : a.landmarks) assert(landmark.hash < (1u << kFingerprintHashBits));
+}
+
+static void testFingerprint_blockSizeDoesNotMatter() {
+    auto sound = makeSound(2, 1.5, 2);
+    Fingerprint whole = fingerprintSamples(sound, kRate, 2);
+
+    Fingerprinter streaming(kRate, 2);
+    const size_t frames = sound.size() / 2;
+    for (size_t start = 0; start < frames; start += 37) {
+        streaming.add(sound.data() + start * 2, std::min<size_t>(37, frames - start));
+    }
+    Fingerprint blocks = streaming.finish();
+    assert(blocks.landmarks == whole.landmarks);
+    assert(blocks.contentHash == whole.contentHash);
+}
+
+static void testFingerprint_gainChangeKeepsHashes() {
+    auto sound = makeSound(3, 2.0);
+    auto quieter = sound;
+    for (float& s : quieter) s *= 0.5f;
+
+    Fingerprint a = fingerprintSamples(sound, kRate, 1);
+    Fingerprint b = fingerprintSamples(quieter, kRate, 1);
+    assert(a.contentHash != b.contentHash);
+    assert(fingerprintSimilarity(a, b) > 0.9);
+}
+
+static void testFingerprint_channelAndTrimVariantsMatch() {
+    auto mono = makeSound(4, 2.0, 1);
+    auto stereo = makeSound(4, 2.0, 2);
+    std::vector<float> trimmed(mono.begin() + 1000, mono.end());
+
+    Fingerprint a = fingerprintSamples(mono, kRate, 1);
+    assert(fingerprintSimilarity(a, fingerprintSamples(stereo, kRate, 2)) > 0.9);
+    assert(fingerprintSimilarity(a, fingerprintSamples(trimmed, kRate, 1)) > 0.5);
+}
+
+static void testFingerprint_unrelatedSoundsDiffer() {
+    Fingerprint a = fingerprintSamples(makeSound(5, 2.0), kRate, 1);
+    Fingerprint b = fingerprintSamples(makeSound(6, 2.0), kRate, 1);
+    assert(fingerprintSimilarity(a, b) < 0.2);
+}
+
+static void testFingerprint_silenceHasNoLandmarks() {
+    std::vector<float> silence(kRate, 0.0f);
+    Fingerprint fp = fingerprintSamples(silence, kRate, 1);
+    assert(fp.landmarks.empty());
+    assert(fingerprintSimilarity(fp, fp) == 0.0);
+}
+
+static void testFingerprint_longAmbienceDoesNotContainShortSounds() {
+    // Three minutes of noise share many hashes with any short sound, but
+    // never at one consistent offset
+    Fingerprint ambience = fingerprintSamples(makeAmbience(7, 180.0), kRate, 1);
+    for (unsigned seed = 20; seed < 28; ++seed) {
+        Fingerprint clip = fingerprintSamples(makeSound(seed, 1.0), kRate, 1);
+        assert(fingerprintSimilarity(ambience, clip) < 0.2);
+    }
+
+    // A sound that really is part of a longer one still matches
+    auto longer = makeSound(30, 4.0);
+    std::vector<float> excerpt(longer.begin() + kRate, longer.begin() + 2 * kRate + 123);
+    assert(fingerprintSimilarity(fingerprintSamples(longer, kRate, 1), fingerprintSamples(excerpt, kRate, 1)) > 0.5);
+}
+
+// ============================================================================
+// FingerprintIndex tests
+// ============================================================================
+
+static FingerprintIndex makeLibrary() {
+    auto a = makeSound(10, 2.0);
+    auto aQuiet = a;
+    for (float& s : aQuiet) s *= 0.7f;
+
+    FingerprintIndex index;
+    index.add("lib/a.wav", 100, 1, fingerprintSamples(a, kRate, 1));
+    index.add("lib/a_quiet.wav", 100, 1, fingerprintSamples(aQuiet, kRate, 1));
+    index.add("lib/b.wav", 100, 1, fingerprintSamples(makeSound(11, 1.0), kRate, 1));
+    index.add("lib/copies/b.wav", 100, 1, fingerprintSamples(makeSound(11, 1.0), kRate, 1));
+    index.add("lib/c.wav", 100, 1, fingerprintSamples(makeSound(12, 1.5), kRate, 1));
+    return index;
+}
+
+static void testIndex_findsExactAndNearClusters() {
+    FingerprintIndex index = makeLibrary();
+    auto clusters = index.findDuplicates();
+    assert(clusters.size() == 2);
+
+    const DuplicateCluster* near = nullptr;
+    const DuplicateCluster* exact = nullptr;
+    for (const auto& cluster : clusters) {
+        assert(cluster.paths.size() == 2);
+        (cluster.exact ? exact : near) = &cluster;
+    }
+    assert(near && exact);
+    assert(near->paths[0] == "lib/a.wav" && near->paths[1] == "lib/a_quiet.wav");
+    assert(near->similarity > 0.5);
+    assert(exact->paths[0] == "lib/b.wav" && exact->paths[1] == "lib/copies/b.wav");
+    assert(exact->similarity == 1.0);
+
+    // A strict threshold keeps only the exact copies
+    auto strict = index.findDuplicates(1.01);
+    assert(strict.size() == 1 && strict[0].exact);
+}
+
+static void testIndex_longAmbienceStaysOutOfClusters() {
+    FingerprintIndex index;
+    index.add("amb/forest.wav", 100, 1, fingerprintSamples(makeAmbience(8, 180.0), kRate, 1));
+    for (unsigned seed = 40; seed < 44; ++seed) {
+        const std::string path = "sfx/hit" + std::to_string(seed) + ".wav";
+        index.add(path, 100, 1, fingerprintSamples(makeSound(seed, 1.0), kRate, 1));
+    }
+    assert(index.findDuplicates().empty());
+}
+
+static void testIndex_isCurrentAndRemove() {
+    FingerprintIndex index = makeLibrary();
+    assert(index.isCurrent("lib/a.wav", 100, 1));
+    assert(!index.isCurrent("lib/a.wav", 101, 1));
+    assert(!index.isCurrent("lib/a.wav", 100, 2));
+    assert(!index.isCurrent("lib/missing.wav", 100, 1));
+
+    assert(index.remove("lib/a_quiet.wav"));
+    assert(!index.remove("lib/a_quiet.wav"));
+    assert(index.size() == 4);
+    assert(index.findDuplicates().size() == 1);
+}
+
+static void testIndex_saveLoadRoundTrip() {
+    FingerprintIndex index = makeLibrary();
+    const std::string path = tempPath("woosh_fingerprint_test.fpindex");
+    assert(index.save(path));
+
+    auto loaded = FingerprintIndex::load(path);
+    assert(loaded.has_value());
+    assert(loaded->size() == index.size());
+    for (const char* name : {"lib/a.wav", "lib/b.wav", "lib/c.wav"}) {
+        const auto* original = index.find(name);
+        const auto* restored = loaded->find(name);
+        assert(original && restored);
+        assert(restored->fileSize == original->fileSize);
+        assert(restored->modifiedTime == original->modifiedTime);
+        assert(restored->fingerprint.contentHash == original->fingerprint.contentHash);
+        assert(restored->fingerprint.landmarks == original->fingerprint.landmarks);
+        assert(restored->fingerprint.durationSeconds == original->fingerprint.durationSeconds);
+    }
+    assert(loaded->findDuplicates().size() == 2);
+    std::filesystem::remove(path);
+}
+
+static void testIndex_loadRejectsOtherFiles() {
+    assert(!FingerprintIndex::load(tempPath("woosh_fingerprint_missing.fpindex")).has_value());
+
+    const std::string path = tempPath("woosh_fingerprint_garbage.fpindex");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "not an index";
+    }
+    assert(!FingerprintIndex::load(path).has_value());
+
+    // A truncated index is rejected rather than loaded partially
+    FingerprintIndex index = makeLibrary();
+    assert(index.save(path));
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    assert(!FingerprintIndex::load(path).has_value());
+    std::filesystem::remove(path);
+}
+
+static void testIndex_loadRejectsHugeCounts() {
+    const std::string path = tempPath("woosh_fingerprint_counts.fpindex");
+    auto writeIndex = [&](uint32_t fileCount, uint32_t pathLength, uint32_t landmarkCount) {
+        std::ofstream out(path, std::ios::binary);
+        auto put = [&](auto value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        out.write("WFPI", 4);
+        put(uint32_t{2});
+        put(fileCount);
+        put(pathLength);
+        out.write("a.wav", 5);
+        put(uint64_t{100});
+        put(int64_t{1});
+        put(uint64_t{0});
+        put(1.0);
+        put(landmarkCount);
+        put(uint32_t{0});
+    };
+
+    // Each count is checked against the bytes left before it sizes anything
+    writeIndex(0xFFFFFFFFu, 5, 0);
+    assert(!FingerprintIndex::load(path).has_value());
+    writeIndex(1, 0xFFFFFFF0u, 0);
+    assert(!FingerprintIndex::load(path).has_value());
+    writeIndex(1, 5, 0xFFFFFFFFu);
+    assert(!FingerprintIndex::load(path).has_value());
+
+    // The same record with honest counts loads
+    writeIndex(1, 5, 0);
+    auto loaded = FingerprintIndex::load(path);
+    assert(loaded.has_value() && loaded->find("a.wav"));
+    std::filesystem::remove(path);
+}
+
+static void testIndex_updateDropsMissingFiles() {
+    FingerprintIndex index = makeLibrary();
+    auto stats = index.update({"lib/does-not-exist.wav"}, 1);
+    assert(stats.removed == 5);
+    assert(stats.failed == 1);
+    assert(stats.fingerprinted == 0 && stats.unchanged == 0);
+    assert(index.size() == 0);
+}
+
+static void testIndex_updateStreamsFilesInBlocks() {
+    // Long enough to span many read blocks; float samples round-trip exactly
+    const auto samples = makeSound(50, 20.0, 2);
+    const std::string path = tempPath("woosh_fingerprint_stream.wav");
+    assert(RiffWav::write(path, samples.data(), samples.size() / 2, 2, kRate, {}, RiffWav::SampleFormat::Float32));
+
+    FingerprintIndex index;
+    auto stats = index.update({path}, 1);
+    assert(stats.fingerprinted == 1 && stats.failed == 0);
+
+    const auto* entry = index.find(path);
+    assert(entry);
+    const Fingerprint whole = fingerprintSamples(samples, kRate, 2);
+    assert(entry->fingerprint.contentHash == whole.contentHash);
+    assert(entry->fingerprint.landmarks == whole.landmarks);
+    assert(entry->fingerprint.durationSeconds == whole.durationSeconds);
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    // Fingerprint
+    testFingerprint_isDeterministicAndSorted();
+    testFingerprint_blockSizeDoesNotMatter();
+    testFingerprint_gainChangeKeepsHashes();
+    testFingerprint_channelAndTrimVariantsMatch();
+    testFingerprint_unrelatedSoundsDiffer();
+    testFingerprint_silenceHasNoLandmarks();
+    testFingerprint_longAmbienceDoesNotContainShortSounds();
+
+    // FingerprintIndex
+    testIndex_findsExactAndNearClusters();
+    testIndex_longAmbienceStaysOutOfClusters();
+    testIndex_isCurrentAndRemove();
+    testIndex_saveLoadRoundTrip();
+    testIndex_loadRejectsOtherFiles();
+    testIndex_loadRejectsHugeCounts();
+    testIndex_updateDropsMissingFiles();
+    testIndex_updateStreamsFilesInBlocks();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file FolderWatcherTests.cpp
+ * @brief Unit tests for FolderWatcher, with notifications and with polling.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "tests/TestFiles.h"
+#include "utils/FolderWatcher.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static FolderWatcher::Options fastOptions(bool polling) {
+    FolderWatcher::Options options;
+    options.debounceMs = 150;
+    options.maxDelayMs = 1000;
+    options.pollIntervalMs = 50;
+    options.forcePolling = polling;
+    return options;
+}
+
+static bool contains(const std::vector<std::string>& paths, const fs::path& path) {
+    return std::find(paths.begin(), paths.end(), path.string()) != paths.end();
+}
+
+// ============================================================================
+// Tests (each runs with notifications and with the polling fallback)
+// ============================================================================
+
+static void testWatcher_reportsNewAudioFiles(bool polling) {
+    const fs::path dir = makeTempDir("woosh_watch_new");
+    FolderWatcher watcher(dir.string(), fastOptions(polling));
+    assert(watcher.usesNotifications() != polling);
+
+    // Polling compares against the first scan, so give it one interval to see the file appear
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        writeFile(dir / "boom.wav", "take 1");
+        writeFile(dir / "notes.txt", "not audio");
+    });
+    auto changed = watcher.waitForChanges(5000);
+    writer.join();
+    assert(changed.size() == 1);
+    assert(contains(changed, dir / "boom.wav"));
+    fs::remove_all(dir);
+}
+
+static void testWatcher_debouncesBursts(bool polling) {
+    const fs::path dir = makeTempDir("woosh_watch_burst");
+    writeFile(dir / "a.wav", "old");
+    FolderWatcher watcher(dir.string(), fastOptions(polling));
+
+    std::thread writer([&] {
+        for (int i = 0; i < 4; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+            writeFile(dir / "a.wav", "take " + std::to_string(i));
+            writeFile(dir / "b.mp3", "take " + std::to_string(i));
+        }
+    });
+    auto changed = watcher.waitForChanges(5000);
+    writer.join();
+
+    // One burst, each file once
+    assert(changed.size() == 2);
+    assert(contains(changed, dir / "a.wav") && contains(changed, dir / "b.mp3"));
+
+    // Nothing further happened
+    assert(watcher.waitForChanges(300).empty());
+    fs::remove_all(dir);
+}
+
+static void testWatcher_followsNewSubfolders(bool polling) {
+    const fs::path dir = makeTempDir("woosh_watch_subfolder");
+    FolderWatcher watcher(dir.string(), fastOptions(polling));
+
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        fs::create_directories(dir / "ambience" / "night");
+        writeFile(dir / "ambience" / "night" / "crickets.wav", "chirp");
+    });
+    auto changed = watcher.waitForChanges(5000);
+    writer.join();
+    assert(contains(changed, dir / "ambience" / "night" / "crickets.wav"));
+    fs::remove_all(dir);
+}
+
+static void testWatcher_ignoresExcludedFolder(bool polling) {
+    const fs::path dir = makeTempDir("woosh_watch_excluded");
+    fs::create_directories(dir / "game");
+    FolderWatcher::Options options = fastOptions(polling);
+    options.excludedFolder = (dir / "game").string();
+    FolderWatcher watcher(dir.string(), options);
+
+    std::thread writer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        writeFile(dir / "game" / "boom.mp3", "exported");
+    });
+    assert(watcher.waitForChanges(500).empty());
+    writer.join();
+    fs::remove_all(dir);
+}
+
+static void testWatcher_stopWakesWaiter(bool polling) {
+    const fs::path dir = makeTempDir("woosh_watch_stop");
+    FolderWatcher watcher(dir.string(), fastOptions(polling));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread stopper([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        watcher.stop();
+    });
+    assert(watcher.waitForChanges().empty());
+    stopper.join();
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+    assert(watcher.stopped());
+    assert(watcher.waitForChanges().empty());
+    fs::remove_all(dir);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    for (bool polling : {false, true}) {
+#ifndef __linux__
+        if (!polling) continue;     // Notifications are Linux-only
+#endif
+        testWatcher_reportsNewAudioFiles(polling);
+        testWatcher_debouncesBursts(polling);
+        testWatcher_followsNewSubfolders(polling);
+        testWatcher_ignoresExcludedFolder(polling);
+        testWatcher_stopWakesWaiter(polling);
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file LoudnessMeterTests.cpp
+ * @brief Unit tests for the incremental loudness meter.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "utils/LoudnessMeter.h"
+
+// ============================================================================
+// Helper functions
+// ============================================================================
+
+static std::vector<float> makeSine(float freq, int sampleRate, int frames, int channels, float amplitude = 1.0f) {
+    std::vector<float> data(static_cast<size_t>(frames) * static_cast<size_t>(channels));
+    constexpr double kTwoPi = 2.0 * 3.14159265358979323846;
+    for (int i = 0; i < frames; ++i) {
+        float v = static_cast<float>(std::sin(kTwoPi * freq * i / sampleRate)) * amplitude;
+        for (int c = 0; c < channels; ++c) {
+            data[static_cast<size_t>(i) * static_cast<size_t>(channels) + static_cast<size_t>(c)] = v;
+        }
+    }
+    return data;
+}
+
+static bool approxEqual(float a, float b, float tolerance = 0.1f) {
+    return std::abs(a - b) < tolerance;
+}
+
+// ============================================================================
+// Reference levels
+// ============================================================================
+
+static void testMonoSine_readsMinusThreeLufs() {
+    // A 0 dBFS 1 kHz sine in one channel is -3.01 LUFS per BS.1770
+    LoudnessMeter meter(48000, 1);
+    auto sine = makeSine(1000.0f, 48000, 48000 * 4, 1);
+    meter.process(sine.data(), sine.size());
+
+    assert(approxEqual(meter.momentaryLufs(), -3.01f));
+    assert(approxEqual(meter.shortTermLufs(), -3.01f));
+    assert(approxEqual(meter.integratedLufs(), -3.01f));
+}
+
+static void testStereoSine_readsZeroLufs() {
+    LoudnessMeter meter(44100, 2);
+    auto sine = makeSine(1000.0f, 44100, 44100 * 4, 2);
+    meter.process(sine.data(), sine.size() / 2);
+
+    assert(approxEqual(meter.momentaryLufs(), 0.0f));
+    assert(approxEqual(meter.integratedLufs(), 0.0f));
+}
+
+static void testAttenuatedSine_tracksGain() {
+    LoudnessMeter meter(48000, 2);
+    auto sine = makeSine(1000.0f, 48000, 48000 * 4, 2, 0.1f);  // -20 dB
+    meter.process(sine.data(), sine.size() / 2);
+
+    assert(approxEqual(meter.momentaryLufs(), -20.0f));
+}
+
+// ============================================================================
+// Streaming behaviour
+// ============================================================================
+
+static void testSmallBlocks_matchSingleBlock() {
+    auto sine = makeSine(440.0f, 48000, 48000 * 3, 2, 0.5f);
+
+    LoudnessMeter whole(48000, 2);
+    whole.process(sine.data(), sine.size() / 2);
+
+    // Odd block size so sub-block boundaries land mid-block
+    LoudnessMeter chunked(48000, 2);
+    constexpr size_t kBlockFrames = 1237;
+    for (size_t frame = 0; frame < sine.size() / 2; frame += kBlockFrames) {
+        size_t n = std::min(kBlockFrames, sine.size() / 2 - frame);
+        chunked.process(sine.data() + frame * 2, n);
+    }
+
+    assert(approxEqual(whole.momentaryLufs(), chunked.momentaryLufs(), 0.001f));
+    assert(approxEqual(whole.shortTermLufs(), chunked.shortTermLufs(), 0.001f));
+    assert(approxEqual(whole.integratedLufs(), chunked.integratedLufs(), 0.001f));
+}
+
+static void testWindows_unavailableUntilFilled() {
+    LoudnessMeter meter(48000, 1);
+    auto sine = makeSine(1000.0f, 48000, 48000, 1);  // 1 second
+
+    meter.process(sine.data(), 48000 / 5);  // 200 ms
+    assert(std::isinf(meter.momentaryLufs()));
+
+    meter.process(sine.data(), sine.size());
+    assert(std::isfinite(meter.momentaryLufs()));
+    assert(std::isinf(meter.shortTermLufs()));
+}
+
+static void testSilence_isGatedOut() {
+    LoudnessMeter meter(48000, 2);
+    std::vector<float> silence(48000 * 2 * 2, 0.0f);
+    meter.process(silence.data(), silence.size() / 2);
+
+    assert(std::isinf(meter.integratedLufs()));
+}
+
+static void testIntegrated_relativeGateIgnoresQuietPassage() {
+    // 3 s at -20 dB followed by 3 s at -50 dB: the quiet part is more than
+    // 10 LU below the ungated mean and must not drag the result down
+    LoudnessMeter meter(48000, 1);
+    auto loud = makeSine(1000.0f, 48000, 48000 * 3, 1, 0.1f);
+    auto quiet = makeSine(1000.0f, 48000, 48000 * 3, 1, 0.00316f);
+    meter.process(loud.data(), loud.size());
+    meter.process(quiet.data(), quiet.size());
+
+    assert(approxEqual(meter.integratedLufs(), -23.01f, 0.3f));
+}
+
+static void testReset_clearsMeasurement() {
+    LoudnessMeter meter(48000, 1);
+    auto sine = makeSine(1000.0f, 48000, 48000, 1);
+    meter.process(sine.data(), sine.size());
+    assert(std::isfinite(meter.integratedLufs()));
+
+    meter.reset();
+    assert(std::isinf(meter.momentaryLufs()));
+    assert(std::isinf(meter.integratedLufs()));
+}
+
+static void testSurroundLayout_excludesLfe() {
+    // Signal only on the LFE channel of a 5.1 stream contributes nothing
+    constexpr int kChannels = 6;
+    LoudnessMeter meter(48000, kChannels);
+    auto mono = makeSine(1000.0f, 48000, 48000, 1);
+    std::vector<float> data(mono.size() * kChannels, 0.0f);
+    for (size_t i = 0; i < mono.size(); ++i) {
+        data[i * kChannels + 3] = mono[i];
+    }
+    meter.process(data.data(), mono.size());
+
+    assert(std::isinf(meter.momentaryLufs()));
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    testMonoSine_readsMinusThreeLufs();
+    testStereoSine_readsZeroLufs();
+    testAttenuatedSine_tracksGain();
+
+    testSmallBlocks_matchSingleBlock();
+    testWindows_unavailableUntilFilled();
+    testSilence_isGatedOut();
+    testIntegrated_relativeGateIgnoresQuietPassage();
+    testReset_clearsMeasurement();
+    testSurroundLayout_excludesLfe();
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file MemoryGovernorTests.cpp
+ * @brief Unit tests for the clip memory budget.
+ */
+
+#include <cassert>
+#include <vector>
+#include "core/MemoryGovernor.h"
+
+// ============================================================================
+// Accounting
+// ============================================================================
+
+static void testGovernor_tracksBytes() {
+    MemoryGovernor governor(1000);
+    governor.track(1, 300);
+    governor.track(2, 200);
+    assert(governor.clipBytes() == 500);
+    assert(governor.residentClips() == 2);
+
+    // Tracking again replaces the size
+    governor.track(1, 100);
+    assert(governor.clipBytes() == 300);
+
+    governor.setCacheBytes(50);
+    assert(governor.usedBytes() == 350);
+
+    governor.forget(2);
+    assert(governor.clipBytes() == 100);
+    assert(!governor.isTracked(2));
+    governor.forget(2);
+    assert(governor.clipBytes() == 100);
+
+    governor.clear();
+    assert(governor.clipBytes() == 0 && governor.residentClips() == 0);
+    assert(governor.usedBytes() == 50);
+}
+
+static void testGovernor_unlimitedNeverEvicts() {
+    MemoryGovernor governor;
+    for (size_t i = 0; i < 10; ++i) governor.track(i, 1ull << 40);
+    assert(!governor.overBudget());
+    assert(governor.selectVictims([](size_t) { return true; }).empty());
+}
+
+// ============================================================================
+// Eviction order
+// ============================================================================
+
+static void testGovernor_evictsLeastRecentlyUsedFirst() {
+    MemoryGovernor governor(250);
+    governor.track(0, 100);
+    governor.track(1, 100);
+    governor.track(2, 100);
+    governor.touch(0);      // 1 is now the least recently used
+    governor.track(3, 100);
+
+    assert(governor.overBudget());
+    const auto victims = governor.selectVictims([](size_t) { return true; });
+    assert((victims == std::vector<size_t>{1, 2}));
+
+    // Victims stay tracked until forgotten
+    assert(governor.isTracked(1));
+    for (size_t id : victims) governor.forget(id);
+    assert(!governor.overBudget());
+    assert(governor.usedBytes() == 200);
+}
+
+static void testGovernor_skipsPinnedClips() {
+    MemoryGovernor governor(150);
+    governor.track(0, 100);
+    governor.track(1, 100);
+    governor.track(2, 100);
+
+    const auto victims = governor.selectVictims([](size_t id) { return id != 0; });
+    assert((victims == std::vector<size_t>{1, 2}));
+}
+
+static void testGovernor_cacheCountsAgainstBudget() {
+    MemoryGovernor governor(300);
+    governor.track(0, 100);
+    governor.track(1, 100);
+    assert(!governor.overBudget());
+
+    governor.setCacheBytes(150);
+    const auto victims = governor.selectVictims([](size_t) { return true; });
+    assert((victims == std::vector<size_t>{0}));
+
+    // The cache alone over budget: everything evictable goes, and it is still not enough
+    governor.setCacheBytes(1000);
+    assert(governor.selectVictims([](size_t) { return true; }).size() == 2);
+}
+
+static void testGovernor_defaultBudgetIsBelowPhysicalMemory() {
+    const uint64_t budget = MemoryGovernor::defaultBudgetBytes();
+    // 0 means unknown; otherwise half of some plausible amount of RAM
+    assert(budget == 0 || budget >= 64ull * 1024 * 1024);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    // Accounting
+    testGovernor_tracksBytes();
+    testGovernor_unlimitedNeverEvicts();
+
+    // Eviction order
+    testGovernor_evictsLeastRecentlyUsedFirst();
+    testGovernor_skipsPinnedClips();
+    testGovernor_cacheCountsAgainstBudget();
+    testGovernor_defaultBudgetIsBelowPhysicalMemory();
+    return 0;
+}
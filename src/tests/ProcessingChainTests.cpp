@@ -0,0 +1,273 @@
+/**
+ * @file ProcessingChainTests.cpp
+ * @brief Unit tests for the fused ProcessingChain.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "audio/ProcessingChain.h"
+#include "utils/DSP.h"
+
+// ============================================================================
+// Helper functions
+// ============================================================================
+
+static std::vector<float> makeSweep(int sampleRate, int frames, int channels) {
+    // Rising amplitude so the compressor has something to react to
+    std::vector<float> data(static_cast<size_t>(frames) * static_cast<size_t>(channels));
+    constexpr float kTwoPi = 2.0f * 3.14159265358979f;
+    for (int i = 0; i < frames; ++i) {
+        const float amplitude = 0.05f + 0.6f * static_cast<float>(i) / static_cast<float>(frames);
+        for (int c = 0; c < channels; ++c) {
+            const float phase = kTwoPi * (220.0f + 110.0f * static_cast<float>(c)) * static_cast<float>(i) / static_cast<float>(sampleRate);
+            data[static_cast<size_t>(i) * static_cast<size_t>(channels) + static_cast<size_t>(c)] = amplitude * std::sin(phase);
+        }
+    }
+    return data;
+}
+
+static bool approxEqual(float a, float b, float tolerance) {
+    return std::abs(a - b) < tolerance;
+}
+
+static bool samplesMatch(const std::vector<float>& a, const std::vector<float>& b, float tolerance = 1e-5f) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!approxEqual(a[i], b[i], tolerance)) return false;
+    }
+    return true;
+}
+
+static const DSP::CompressorSettings kCompressor{-12.0f, 4.0f, 10.0f, 100.0f, 2.0f};
+static const DSP::LimiterSettings kLimiter{-1.0f, 5.0f, 50.0f};
+
+// ============================================================================
+// Equivalence with the separate DSP passes
+// ============================================================================
+
+static void testRun_normalizeThenCompressMatchesSeparatePasses() {
+    auto expected = makeSweep(48000, 20000, 2);
+    auto fused = expected;
+    DSP::normalizeToPeak(expected, -1.0f);
+    DSP::compressor(expected, kCompressor.thresholdDb, kCompressor.ratio, kCompressor.attackMs,
+                    kCompressor.releaseMs, kCompressor.makeupDb, 48000, 2);
+
+    auto result = ProcessingChain().normalizeToPeak(-1.0f).compress(kCompressor).run(fused, 48000, 2);
+
+    assert(samplesMatch(fused, expected));
+    assert(approxEqual(result.levels.peakDb, DSP::computePeakDbFS(expected), 1e-3f));
+    assert(approxEqual(result.levels.rmsDb, DSP::computeRMSDb(expected), 1e-3f));
+}
+
+static void testRun_compressThenNormalizeMatchesSeparatePasses() {
+    auto expected = makeSweep(44100, 15000, 1);
+    auto fused = expected;
+    DSP::compressor(expected, kCompressor.thresholdDb, kCompressor.ratio, kCompressor.attackMs,
+                    kCompressor.releaseMs, kCompressor.makeupDb, 44100, 1);
+    DSP::normalizeToRMS(expected, -20.0f);
+
+    auto result = ProcessingChain().compress(kCompressor).normalizeToRms(-20.0f).run(fused, 44100, 1);
+
+    assert(samplesMatch(fused, expected));
+    assert(approxEqual(result.levels.rmsDb, -20.0f, 1e-3f));
+}
+
+static void testRun_normalizeCompressLimitMatchesSeparatePasses() {
+    auto expected = makeSweep(48000, 20000, 2);
+    auto fused = expected;
+    DSP::normalizeToPeak(expected, 0.0f);
+    DSP::compressor(expected, kCompressor.thresholdDb, kCompressor.ratio, kCompressor.attackMs,
+                    kCompressor.releaseMs, kCompressor.makeupDb, 48000, 2);
+    DSP::limiter(expected, kLimiter, 48000, 2);
+
+    auto result = ProcessingChain().normalizeToPeak(0.0f).compress(kCompressor).limit(kLimiter)
+                      .run(fused, 48000, 2);
+
+    assert(result.fusedPasses == 1);
+    assert(samplesMatch(fused, expected));
+    assert(result.levels.peakDb <= -1.0f + 1e-3f);
+    assert(approxEqual(result.levels.rmsDb, DSP::computeRMSDb(expected), 1e-3f));
+}
+
+static void testRun_measuresEachChannel() {
+    // makeSweep gives every channel its own frequency, so 5.1 exercises the
+    // grouped compressor and the per-channel meter together
+    auto samples = makeSweep(48000, 10000, 6);
+    auto expected = samples;
+    DSP::normalizeToPeak(expected, -1.0f);
+    DSP::compressor(expected, kCompressor.thresholdDb, kCompressor.ratio, kCompressor.attackMs,
+                    kCompressor.releaseMs, kCompressor.makeupDb, 48000, 6);
+
+    auto result = ProcessingChain().normalizeToPeak(-1.0f).compress(kCompressor).run(samples, 48000, 6);
+
+    assert(samplesMatch(samples, expected));
+    const auto measured = DSP::measureChannelLevels(expected, 6).channelLevels();
+    assert(result.channelLevels.size() == 6);
+    float loudest = -1000.0f;
+    for (size_t c = 0; c < 6; ++c) {
+        assert(approxEqual(result.channelLevels[c].peakDb, measured[c].peakDb, 1e-3f));
+        assert(approxEqual(result.channelLevels[c].rmsDb, measured[c].rmsDb, 1e-3f));
+        loudest = std::max(loudest, result.channelLevels[c].peakDb);
+    }
+    assert(loudest == result.levels.peakDb);
+}
+
+// ============================================================================
+// Pass counting
+// ============================================================================
+
+static void testRun_knownLevelsNeedSinglePass() {
+    auto samples = makeSweep(48000, 10000, 2);
+    const auto levels = DSP::measureLevels(samples);
+
+    auto result = ProcessingChain().normalizeToPeak(-1.0f).compress(kCompressor).run(samples, 48000, 2, levels);
+
+    assert(result.analysisPasses == 0);
+    assert(result.fusedPasses == 1);
+}
+
+static void testRun_unknownLevelsAddOneAnalysisPass() {
+    auto samples = makeSweep(48000, 10000, 2);
+
+    auto result = ProcessingChain().normalizeToPeak(-1.0f).compress(kCompressor).run(samples, 48000, 2);
+
+    assert(result.analysisPasses == 1);
+    assert(result.fusedPasses == 1);
+}
+
+static void testRun_normalizeAfterCompressorSplitsPass() {
+    auto samples = makeSweep(48000, 10000, 2);
+    const auto levels = DSP::measureLevels(samples);
+
+    auto result = ProcessingChain().compress(kCompressor).normalizeToPeak(-3.0f).run(samples, 48000, 2, levels);
+
+    assert(result.analysisPasses == 0);
+    assert(result.fusedPasses == 2);
+    assert(approxEqual(result.levels.peakDb, -3.0f, 1e-3f));
+}
+
+static void testRun_stepAfterLimiterStartsNewPass() {
+    auto samples = makeSweep(48000, 10000, 2);
+
+    auto result = ProcessingChain().limit({-6.0f, 5.0f, 50.0f}).normalizeToPeak(-1.0f).run(samples, 48000, 2);
+
+    assert(result.fusedPasses == 2);
+    assert(approxEqual(result.levels.peakDb, -1.0f, 1e-3f));
+}
+
+static void testRun_consecutiveNormalizesFoldIntoOneGain() {
+    auto expected = makeSweep(48000, 5000, 2);
+    auto fused = expected;
+    DSP::normalizeToPeak(expected, -6.0f);
+    DSP::normalizeToRMS(expected, -24.0f);
+
+    auto result = ProcessingChain().normalizeToPeak(-6.0f).normalizeToRms(-24.0f).run(fused, 48000, 2);
+
+    assert(result.fusedPasses == 1);
+    assert(samplesMatch(fused, expected));
+}
+
+// ============================================================================
+// Edge cases
+// ============================================================================
+
+static void testRun_emptyBuffer() {
+    std::vector<float> empty;
+    auto result = ProcessingChain().normalizeToPeak(-1.0f).run(empty, 48000, 2);
+    assert(result.fusedPasses == 0);
+    assert(std::isinf(result.levels.peakDb));
+}
+
+static void testRun_emptyChainLeavesSamples() {
+    auto samples = makeSweep(48000, 1000, 2);
+    const auto original = samples;
+    ProcessingChain().run(samples, 48000, 2);
+    assert(samples == original);
+}
+
+// ============================================================================
+// Streaming
+// ============================================================================
+
+static void testStream_matchesRunHoweverFed() {
+    const auto chain = ProcessingChain().compress(kCompressor).normalizeToPeak(-3.0f).limit(kLimiter);
+    auto expected = makeSweep(48000, 30000, 2);
+    const auto input = expected;
+    const auto reference = chain.run(expected, 48000, 2);
+
+    // Filled in uneven pieces, as decoded ranges arrive
+    assert(ProcessingChain::Stream::canStream(chain));
+    std::vector<float> streamed(input.size(), 0.0f);
+    ProcessingChain::Stream stream(chain, streamed, 48000, 2);
+    size_t filled = 0;
+    for (size_t piece : {1u, 777u, 2048u, 5000u, 13u}) {
+        std::copy(input.begin() + filled * 2, input.begin() + (filled + piece) * 2, streamed.begin() + filled * 2);
+        stream.feed(piece);
+        filled += piece;
+    }
+    std::copy(input.begin() + filled * 2, input.end(), streamed.begin() + filled * 2);
+    stream.feed(30000 - filled);
+    const auto result = stream.finish();
+
+    assert(streamed == expected);
+    assert(result.fusedPasses == reference.fusedPasses && result.analysisPasses == reference.analysisPasses);
+    assert(approxEqual(result.levels.peakDb, reference.levels.peakDb, 1e-4f));
+}
+
+static void testStream_leadingNormalizeWaitsForFinish() {
+    const auto chain = ProcessingChain().normalizeToPeak(-1.0f).compress(kCompressor);
+    assert(!ProcessingChain::Stream::canStream(chain));
+    assert(ProcessingChain::Stream::canStream(chain, DSP::Levels{-6.0f, -12.0f}));
+
+    auto expected = makeSweep(48000, 10000, 2);
+    auto streamed = expected;
+    chain.run(expected, 48000, 2);
+    ProcessingChain::Stream stream(chain, streamed, 48000, 2);
+    stream.feed(10000);
+    const auto result = stream.finish();
+    assert(samplesMatch(streamed, expected));
+    assert(result.analysisPasses == 1);
+}
+
+static void testStream_unfedFramesAreLeftOut() {
+    const auto chain = ProcessingChain().compress(kCompressor);
+    auto samples = makeSweep(48000, 5000, 2);
+    const auto original = samples;
+    ProcessingChain::Stream stream(chain, samples, 48000, 2);
+    stream.feed(3000);
+    stream.finish();
+    assert(std::equal(samples.begin() + 6000, samples.end(), original.begin() + 6000));
+    assert(!std::equal(samples.begin(), samples.begin() + 6000, original.begin()));
+}
+
+// ============================================================================
+// Main test runner
+// ============================================================================
+
+int main() {
+    // Equivalence tests
+    testRun_normalizeThenCompressMatchesSeparatePasses();
+    testRun_compressThenNormalizeMatchesSeparatePasses();
+    testRun_normalizeCompressLimitMatchesSeparatePasses();
+    testRun_measuresEachChannel();
+
+    // Pass counting tests
+    testRun_knownLevelsNeedSinglePass();
+    testRun_unknownLevelsAddOneAnalysisPass();
+    testRun_normalizeAfterCompressorSplitsPass();
+    testRun_stepAfterLimiterStartsNewPass();
+    testRun_consecutiveNormalizesFoldIntoOneGain();
+
+    // Edge cases
+    testRun_emptyBuffer();
+    testRun_emptyChainLeavesSamples();
+
+    // Streaming tests
+    testStream_matchesRunHoweverFed();
+    testStream_leadingNormalizeWaitsForFinish();
+    testStream_unfedFramesAreLeftOut();
+
+    return 0;
+}
@@ -36,6 +36,7 @@ static void testClipState_defaultConstruction() {
     assert(state.relativePath.empty());
     assert(!state.isNormalized);
     assert(!state.isCompressed);
+    assert(!state.isLimited);
     assert(!state.isTrimmed);
     assert(!state.isExported);
     assert(state.normalizeTargetDb == 0.0);
@@ -96,6 +97,7 @@ static std::string buildStatusBadge(const ClipState& state) {
     if (state.isTrimmed) status += "T";
     if (state.isNormalized) status += "N";
     if (state.isCompressed) status += "C";
+    if (state.isLimited) status += "L";
     if (state.isExported) status += "E";
     return status;
 }
@@ -106,6 +108,7 @@ static int countOperations(const ClipState& state) {
     if (state.isTrimmed) count++;
     if (state.isNormalized) count++;
     if (state.isCompressed) count++;
+    if (state.isLimited) count++;
     if (state.isExported) count++;
     return count;
 }
@@ -240,6 +243,12 @@ static void testProcessingSettings_defaultConstruction() {
     assert(approxEqual(settings.compAttackMs, 10.0f, 0.1f));
     assert(approxEqual(settings.compReleaseMs, 100.0f, 0.1f));
     assert(approxEqual(settings.compMakeupDb, 0.0f, 0.1f));
+    assert(approxEqual(settings.limiterCeilingDb, -1.0f, 0.1f));
+    assert(approxEqual(settings.limiterLookaheadMs, 5.0f, 0.1f));
+    assert(approxEqual(settings.limiterReleaseMs, 50.0f, 0.1f));
+    assert(approxEqual(settings.autoTrimThresholdDb, -50.0f, 0.1f));
+    assert(approxEqual(settings.autoTrimPreRollMs, 10.0f, 0.1f));
+    assert(approxEqual(settings.autoTrimPostRollMs, 100.0f, 0.1f));
 }
 
 // ============================================================================
@@ -511,6 +520,20 @@ static void testProject_clearClipStates() {
     assert(project.isDirty());
 }
 
+static void testProject_findClipState_afterRemove() {
+    Project project;
+    for (const char* name : {"a.wav", "b.wav", "c.wav"}) {
+        ClipState state;
+        state.relativePath = name;
+        project.addClipState(state);
+    }
+
+    assert(project.removeClipState("a.wav"));
+    assert(project.findClipState("a.wav") == nullptr);
+    assert(project.findClipState("c.wav") != nullptr);
+    assert(project.findClipState("c.wav")->relativePath == "c.wav");
+}
+
 // ============================================================================
 // Dirty state tests
 // ============================================================================
@@ -574,6 +597,30 @@ static void testProject_saveAndLoad_basicProperties() {
     cleanupTempFile(path);
 }
 
+static void testProject_saveAndLoad_controlCharactersInNames() {
+    Project original;
+    original.setName("Tab\there \x01 and \"quotes\"");
+    original.setRawFolder("C:\\raw\x1f");
+    
+    std::string path = getTempProjectPath();
+    bool saved = original.save(path);
+    assert(saved);
+    
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+    assert(ss.str().find('\x01') == std::string::npos);
+    assert(ss.str().find("\\u0001") != std::string::npos);
+    
+    auto loaded = Project::load(path);
+    assert(loaded.has_value());
+    assert(loaded->name() == original.name());
+    assert(loaded->rawFolder() == original.rawFolder());
+    
+    cleanupTempFile(path);
+}
+
 static void testProject_saveAndLoad_exportSettings() {
     Project original;
     original.setName("Export Test");
@@ -614,6 +661,10 @@ static void testProject_saveAndLoad_processingSettings() {
     procSettings.compAttackMs = 5.0f;
     procSettings.compReleaseMs = 150.0f;
     procSettings.compMakeupDb = 4.0f;
+    procSettings.limiterCeilingDb = -0.5f;
+    procSettings.limiterLookaheadMs = 20.0f;
+    procSettings.autoTrimThresholdDb = -45.0f;
+    procSettings.autoTrimPostRollMs = 250.0f;
     original.setProcessingSettings(procSettings);
     
     std::string path = getTempProjectPath();
@@ -624,6 +675,10 @@ static void testProject_saveAndLoad_processingSettings() {
     assert(approxEqual(loaded->processingSettings().normalizeTargetDb, -3.0));
     assert(approxEqual(loaded->processingSettings().compThreshold, -18.0f, 0.1f));
     assert(approxEqual(loaded->processingSettings().compRatio, 6.0f, 0.1f));
+    assert(approxEqual(loaded->processingSettings().limiterCeilingDb, -0.5f, 0.01f));
+    assert(approxEqual(loaded->processingSettings().limiterLookaheadMs, 20.0f, 0.1f));
+    assert(approxEqual(loaded->processingSettings().autoTrimThresholdDb, -45.0f, 0.1f));
+    assert(approxEqual(loaded->processingSettings().autoTrimPostRollMs, 250.0f, 0.1f));
     
     cleanupTempFile(path);
 }
@@ -641,6 +696,9 @@ static void testProject_saveAndLoad_clipStates() {
     clip1.isCompressed = true;
     clip1.compressorSettings.threshold = -12.0f;
     clip1.compressorSettings.ratio = 4.0f;
+    clip1.isLimited = true;
+    clip1.limiterSettings.ceilingDb = -2.0f;
+    clip1.limiterSettings.lookaheadMs = 8.0f;
     clip1.isExported = true;
     clip1.exportedFilename = "boom.mp3";
     
@@ -664,6 +722,9 @@ static void testProject_saveAndLoad_clipStates() {
     assert(loadedClip1 != nullptr);
     assert(loadedClip1->isNormalized);
     assert(loadedClip1->isCompressed);
+    assert(loadedClip1->isLimited);
+    assert(approxEqual(loadedClip1->limiterSettings.ceilingDb, -2.0f, 0.01f));
+    assert(approxEqual(loadedClip1->limiterSettings.lookaheadMs, 8.0f, 0.1f));
     assert(loadedClip1->isExported);
     assert(loadedClip1->exportedFilename == "boom.mp3");
     
@@ -676,6 +737,46 @@ static void testProject_saveAndLoad_clipStates() {
     cleanupTempFile(path);
 }
 
+static void testProject_saveAndLoad_clipInfo() {
+    Project original;
+    original.setRawFolder("/raw");
+
+    ClipState cached;
+    cached.relativePath = "long.wav";
+    cached.isNormalized = true;
+    ClipInfo info;
+    info.sourceSize = 5'000'000'123ull;
+    info.sourceModified = 133'456'789'012'345'678ll;     // Needs more digits than a double holds
+    info.frames = 48000ull * 3600;
+    info.sampleRate = 48000;
+    info.channels = 6;
+    info.peakDb = -1.0f;
+    info.rmsDb = -18.25f;
+    cached.info = info;
+    original.addClipState(cached);
+
+    ClipState unknown;
+    unknown.relativePath = "new.wav";
+    original.addClipState(unknown);
+
+    std::string path = getTempProjectPath();
+    assert(original.save(path));
+    auto loaded = Project::load(path);
+    assert(loaded.has_value());
+
+    const ClipState* state = loaded->findClipState("long.wav");
+    assert(state && state->info && state->hasProcessing());
+    assert(state->info->matchesSource(info.sourceSize, info.sourceModified));
+    assert(!state->info->matchesSource(info.sourceSize, info.sourceModified + 1));
+    assert(state->info->frames == info.frames);
+    assert(state->info->sampleRate == 48000 && state->info->channels == 6);
+    assert(approxEqual(state->info->peakDb, -1.0f) && approxEqual(state->info->rmsDb, -18.25f));
+
+    assert(!loaded->findClipState("new.wav")->info);
+
+    cleanupTempFile(path);
+}
+
 static void testProject_load_nonexistentFile() {
     auto result = Project::load("/nonexistent/path/project.wooshp");
     assert(!result.has_value());
@@ -820,6 +921,7 @@ int main() {
     testProject_findClipState();
     testProject_removeClipState();
     testProject_clearClipStates();
+    testProject_findClipState_afterRemove();
     
     // Dirty state tests
     testProject_dirtyState_initiallyClean();
@@ -829,9 +931,11 @@ int main() {
     
     // Serialization tests
     testProject_saveAndLoad_basicProperties();
+    testProject_saveAndLoad_controlCharactersInNames();
     testProject_saveAndLoad_exportSettings();
     testProject_saveAndLoad_processingSettings();
     testProject_saveAndLoad_clipStates();
+    testProject_saveAndLoad_clipInfo();
     testProject_load_nonexistentFile();
     testProject_load_invalidJson();
     testProject_load_missingRequiredFields();
@@ -0,0 +1,206 @@
+/**
+ * @file ShardQueueTests.cpp
+ * @brief Unit tests for the file-based shard queue.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "core/ShardQueue.h"
+#include "tests/TestFiles.h"
+
+namespace fs = std::filesystem;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static std::vector<std::string> makeFiles(size_t count) {
+    std::vector<std::string> files;
+    for (size_t i = 0; i < count; ++i) files.push_back("sfx/clip" + std::to_string(i) + ".wav");
+    return files;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void testQueue_createSplitsIntoShards() {
+    const fs::path dir = makeTempDir("woosh_shards_create");
+    ShardQueue queue(dir.string());
+    assert(!queue.shardCount().has_value());
+
+    assert(queue.create(makeFiles(10), 4));
+    assert(queue.shardCount() == 3u);
+    assert(queue.files(0).size() == 4);
+    assert(queue.files(2).size() == 2);
+    assert(queue.files(2)[1] == "sfx/clip9.wav");
+
+    const auto status = queue.status();
+    assert(status.total == 3 && status.unclaimed == 3 && status.claimed == 0 && status.done == 0);
+    fs::remove_all(dir);
+}
+
+static void testQueue_claimsEachShardOnce() {
+    const fs::path dir = makeTempDir("woosh_shards_claim");
+    ShardQueue queue(dir.string());
+    assert(queue.create(makeFiles(7), 2));
+
+    auto first = queue.claim("a");
+    auto second = queue.claim("b");
+    assert(first && second && first->shard != second->shard);
+    assert(queue.status().claimed == 2);
+
+    ShardResult result{2, 1, 1, 0, "a"};
+    assert(queue.complete(first->shard, result));
+    const auto done = queue.result(first->shard);
+    assert(done && done->files == 2 && done->exported == 1 && done->upToDate == 1 && done->worker == "a");
+    assert(!queue.result(second->shard).has_value());
+
+    assert(queue.claim("c") && queue.claim("d"));
+    assert(!queue.claim("e").has_value());
+    const auto status = queue.status();
+    assert(status.done == 1 && status.claimed == 3 && status.unclaimed == 0);
+    fs::remove_all(dir);
+}
+
+static void testQueue_concurrentWorkersShareShards() {
+    const fs::path dir = makeTempDir("woosh_shards_concurrent");
+    {
+        ShardQueue queue(dir.string());
+        assert(queue.create(makeFiles(200), 1));
+    }
+
+    // Separate queue objects, as separate processes would have
+    std::atomic<size_t> claims{0};
+    std::vector<std::thread> workers;
+    for (int w = 0; w < 8; ++w) {
+        workers.emplace_back([&, w] {
+            ShardQueue queue(dir.string());
+            const std::string name = "worker" + std::to_string(w);
+            while (auto claim = queue.claim(name)) {
+                claims.fetch_add(1);
+                assert(queue.complete(claim->shard, {claim->files.size(), 1, 0, 0, name}));
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    ShardQueue queue(dir.string());
+    assert(claims.load() == 200);
+    assert(queue.status().done == 200);
+    fs::remove_all(dir);
+}
+
+static void testQueue_takesOverStaleClaims() {
+    const fs::path dir = makeTempDir("woosh_shards_stale");
+    ShardQueue queue(dir.string());
+    assert(queue.create(makeFiles(1), 4));
+
+    auto crashed = queue.claim("crashed");
+    assert(crashed);
+    assert(!queue.claim("other").has_value());
+
+    // Age the claim past the timeout
+    fs::last_write_time(queue.shardFile(crashed->shard, ".claim"),
+                        fs::file_time_type::clock::now() - std::chrono::minutes(20));
+    assert(queue.status().unclaimed == 1);
+
+    // A heartbeat keeps a claim alive
+    queue.heartbeat(crashed->shard);
+    assert(!queue.claim("other", std::chrono::seconds(60)).has_value());
+
+    fs::last_write_time(queue.shardFile(crashed->shard, ".claim"),
+                        fs::file_time_type::clock::now() - std::chrono::minutes(20));
+    auto takeover = queue.claim("other", std::chrono::seconds(60));
+    assert(takeover && takeover->shard == crashed->shard);
+    assert(takeover->files.size() == 1);
+
+    // The worker that lost its claim cannot record the shard
+    assert(!queue.isClaimedBy(crashed->shard, "crashed"));
+    assert(!queue.complete(crashed->shard, {1, 1, 0, 0, "crashed"}));
+    assert(!queue.result(crashed->shard).has_value());
+    assert(queue.complete(takeover->shard, {1, 1, 0, 0, "other"}));
+    assert(queue.result(takeover->shard)->worker == "other");
+    fs::remove_all(dir);
+}
+
+static void testQueue_heartbeatKeepsLongShardClaimed() {
+    const fs::path dir = makeTempDir("woosh_shards_heartbeat");
+    ShardQueue queue(dir.string());
+    assert(queue.create(makeFiles(1), 4));
+    const auto staleAfter = std::chrono::seconds(1);
+
+    auto busy = queue.claim("busy", staleAfter);
+    assert(busy);
+    {
+        // The shard runs for longer than the stale timeout
+        const ShardQueue::Heartbeat heartbeat(queue, busy->shard, std::chrono::milliseconds(100));
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(2500);
+        while (std::chrono::steady_clock::now() < end) {
+            assert(!queue.claim("other", staleAfter).has_value());
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+    assert(queue.complete(busy->shard, {1, 1, 0, 0, "busy"}));
+    assert(queue.status(staleAfter).done == 1);
+    fs::remove_all(dir);
+}
+
+static void testQueue_releasesClaimsOfCrashedWorker() {
+    const fs::path dir = makeTempDir("woosh_shards_release");
+    ShardQueue queue(dir.string());
+    assert(queue.create(makeFiles(6), 2));
+
+    auto finished = queue.claim("host:100");
+    auto crashed = queue.claim("host:100");
+    auto other = queue.claim("host:200");
+    assert(finished && crashed && other);
+    assert(queue.complete(finished->shard, {2, 2, 0, 0, "host:100"}));
+
+    assert(queue.releaseClaims("host:100") == 1);
+    assert(queue.releaseClaims("host:100") == 0);
+    auto retry = queue.claim("host:300");
+    assert(retry && retry->shard == crashed->shard);
+    assert(queue.result(finished->shard).has_value());
+    fs::remove_all(dir);
+}
+
+static void testQueue_createReplacesEarlierQueue() {
+    const fs::path dir = makeTempDir("woosh_shards_recreate");
+    ShardQueue queue(dir.string());
+    assert(queue.create(makeFiles(8), 2));
+    auto claim = queue.claim("a");
+    assert(claim && queue.complete(claim->shard, {2, 2, 0, 0, "a"}));
+    {
+        std::ofstream keep(dir / "notes.txt");
+        keep << "not ours";
+    }
+
+    assert(queue.create(makeFiles(3), 2));
+    assert(queue.shardCount() == 2u);
+    assert(queue.status().done == 0);
+    assert(fs::exists(dir / "notes.txt"));
+    fs::remove_all(dir);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    testQueue_createSplitsIntoShards();
+    testQueue_claimsEachShardOnce();
+    testQueue_concurrentWorkersShareShards();
+    testQueue_takesOverStaleClaims();
+    testQueue_heartbeatKeepsLongShardClaimed();
+    testQueue_releasesClaimsOfCrashedWorker();
+    testQueue_createReplacesEarlierQueue();
+    return 0;
+}
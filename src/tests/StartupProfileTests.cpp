@@ -0,0 +1,68 @@
+/**
+ * @file StartupProfileTests.cpp
+ * @brief Unit tests for the startup phase timings.
+ */
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "utils/StartupProfile.h"
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+static void testDisabled_recordsNothing() {
+    StartupProfile::reset();
+    {
+        WOOSH_STARTUP_PHASE("ignored");
+    }
+    StartupProfile::mark("ignored mark");
+    assert(!StartupProfile::isEnabled());
+    assert(StartupProfile::report().find("ignored") == std::string::npos);
+}
+
+static void testPhases_listedInStartOrder() {
+    StartupProfile::begin();
+    {
+        WOOSH_STARTUP_PHASE("window");
+        {
+            WOOSH_STARTUP_PHASE("menus");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+    StartupProfile::mark("interactive");
+
+    const std::string report = StartupProfile::report();
+    const auto window = report.find("window");
+    const auto menus = report.find("menus");
+    const auto interactive = report.find("interactive");
+    // Phases are recorded as they end, but the outer one started first
+    assert(window != std::string::npos && menus != std::string::npos && interactive != std::string::npos);
+    assert(window < menus && menus < interactive);
+    assert(StartupProfile::elapsedMs() >= 2.0);
+    StartupProfile::reset();
+}
+
+static void testBeforeMain_knownOnSupportedPlatforms() {
+    StartupProfile::begin();
+#if defined(_WIN32) || defined(__linux__)
+    assert(StartupProfile::beforeMainMs() >= 0.0);
+    assert(StartupProfile::report().find("before main") != std::string::npos);
+#endif
+    StartupProfile::reset();
+    assert(StartupProfile::beforeMainMs() < 0.0);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    // Recording
+    testDisabled_recordsNothing();
+    testPhases_listedInStartOrder();
+    testBeforeMain_knownOnSupportedPlatforms();
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file TraceTests.cpp
+ * @brief Unit tests for scoped trace spans and Chrome JSON output.
+ */
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "utils/Trace.h"
+
+// ============================================================================
+// Helper functions
+// ============================================================================
+
+static std::string writeAndRead() {
+    const auto path = std::filesystem::temp_directory_path() / "woosh_trace_test.json";
+    bool ok = Trace::writeChromeJson(path.string());
+    assert(ok);
+
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+    std::filesystem::remove(path);
+    return ss.str();
+}
+
+static size_t countOccurrences(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+static void testDisabled_recordsNothing() {
+    Trace::clear();
+    Trace::setEnabled(false);
+    {
+        WOOSH_TRACE_SCOPE("disabledSpan");
+    }
+    std::string json = writeAndRead();
+    assert(json.find("disabledSpan") == std::string::npos);
+}
+
+static void testEnabled_recordsCompleteEvents() {
+    Trace::clear();
+    Trace::setEnabled(true);
+    {
+        WOOSH_TRACE_SCOPE("outer");
+        WOOSH_TRACE_SCOPE_DETAIL("inner", std::string("clip \"a\".wav"));
+    }
+    Trace::setEnabled(false);
+
+    std::string json = writeAndRead();
+    assert(json.find("\"traceEvents\"") != std::string::npos);
+    assert(json.find("\"name\":\"outer\"") != std::string::npos);
+    assert(json.find("\"name\":\"inner\"") != std::string::npos);
+    assert(json.find("\"ph\":\"X\"") != std::string::npos);
+    // Detail strings are escaped
+    assert(json.find("clip \\\"a\\\".wav") != std::string::npos);
+}
+
+static void testThreads_getSeparateLanes() {
+    Trace::clear();
+    Trace::setEnabled(true);
+    Trace::setThreadName("TestMain");
+    {
+        WOOSH_TRACE_SCOPE("mainSpan");
+    }
+    std::thread worker([] {
+        Trace::setThreadName("TestWorker");
+        for (int i = 0; i < 3; ++i) {
+            WOOSH_TRACE_SCOPE("workerSpan");
+        }
+    });
+    worker.join();
+    Trace::setEnabled(false);
+
+    // Spans of an exited thread are still written
+    std::string json = writeAndRead();
+    assert(json.find("TestMain") != std::string::npos);
+    assert(json.find("TestWorker") != std::string::npos);
+    assert(countOccurrences(json, "\"name\":\"workerSpan\"") == 3);
+    assert(countOccurrences(json, "\"name\":\"mainSpan\"") == 1);
+}
+
+static void testClear_discardsEvents() {
+    Trace::setEnabled(true);
+    {
+        WOOSH_TRACE_SCOPE("clearedSpan");
+    }
+    Trace::setEnabled(false);
+    Trace::clear();
+
+    std::string json = writeAndRead();
+    assert(json.find("clearedSpan") == std::string::npos);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main() {
+    testDisabled_recordsNothing();
+    testEnabled_recordsCompleteEvents();
+    testThreads_getSeparateLanes();
+    testClear_discardsEvents();
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <vector>
 #include "ui/WaveformViewHelpers.h"
 
 static void testComputeTrimAndFadeRanges_noTrim_fullExtent() {
@@ -28,10 +29,113 @@ static void testComputeTrimAndFadeRanges_emptyClip() {
     assert(r.visibleEndFrame == 0);
 }
 
+static void testComputeWaveformColumns_stereoMinMax() {
+    // 4 frames of stereo, one frame per column
+    std::vector<float> samples = {0.5f, -0.25f, -1.0f, 0.75f, 0.2f, 0.1f, -0.3f, -0.6f};
+    auto cols = computeWaveformColumns(samples.data(), samples.size(), 2, 0, 2.0, 2);
+    assert(cols.size() == 2);
+    assert(cols[0].size() == 2);
+    assert(cols[0][0].minVal == -1.0f && cols[0][0].maxVal == 0.5f);
+    assert(cols[1][0].minVal == -0.25f && cols[1][0].maxVal == 0.75f);
+    assert(cols[0][1].minVal == -0.3f && cols[0][1].maxVal == 0.2f);
+    assert(cols[1][1].minVal == -0.6f && cols[1][1].maxVal == 0.1f);
+}
+
+static void testComputeWaveformColumns_parallelMatchesScroll() {
+    // Wide enough to take the parallel path; column x covers frame x + offset
+    std::vector<float> samples(1000);
+    for (size_t i = 0; i < samples.size(); ++i) samples[i] = static_cast<float>(i) / 1000.0f;
+    auto cols = computeWaveformColumns(samples.data(), samples.size(), 1, 100, 1.0, 400);
+    assert(cols.size() == 1);
+    assert(cols[0].size() == 400);
+    assert(cols[0][0].maxVal == 0.1f);
+    assert(cols[0][399].maxVal == 0.499f);
+}
+
+static void testComputeWaveformColumns_emptyInput() {
+    auto cols = computeWaveformColumns(nullptr, 0, 2, 0, 1.0, 100);
+    assert(cols.empty());
+}
+
+static void testComputeWaveformColumns_layoutsAgree() {
+    // The same mono signal copied into 1, 2 and 3 channels must give the same
+    // columns from the mono, stereo and generic kernels
+    std::vector<float> mono(2000);
+    for (size_t i = 0; i < mono.size(); ++i) mono[i] = static_cast<float>((i * 37) % 101) / 50.0f - 1.0f;
+    auto expected = computeWaveformColumns(mono.data(), mono.size(), 1, 0, 7.5, 250);
+
+    for (int channels : {2, 3}) {
+        std::vector<float> interleaved(mono.size() * static_cast<size_t>(channels));
+        for (size_t f = 0; f < mono.size(); ++f) {
+            for (int c = 0; c < channels; ++c) interleaved[f * static_cast<size_t>(channels) + static_cast<size_t>(c)] = mono[f];
+        }
+        auto cols = computeWaveformColumns(interleaved.data(), interleaved.size(), channels, 0, 7.5, 250);
+        assert(cols.size() == static_cast<size_t>(channels));
+        for (const auto& channelColumns : cols) {
+            for (size_t x = 0; x < channelColumns.size(); ++x) {
+                assert(channelColumns[x].minVal == expected[0][x].minVal);
+                assert(channelColumns[x].maxVal == expected[0][x].maxVal);
+            }
+        }
+    }
+}
+
+static void testComputeWaveformColumns_surroundLayouts() {
+    // Each channel its own scaled copy, across the specialized (6, 8) and generic (5, 7, 20) kernels
+    std::vector<float> mono(2000);
+    for (size_t i = 0; i < mono.size(); ++i) mono[i] = static_cast<float>((i * 37) % 101) / 50.0f - 1.0f;
+    auto expected = computeWaveformColumns(mono.data(), mono.size(), 1, 0, 7.5, 250);
+
+    for (int channels : {5, 6, 7, 8, 20}) {
+        std::vector<float> interleaved(mono.size() * static_cast<size_t>(channels));
+        for (size_t f = 0; f < mono.size(); ++f) {
+            for (int c = 0; c < channels; ++c) {
+                interleaved[f * static_cast<size_t>(channels) + static_cast<size_t>(c)] = mono[f] * 0.5f;
+            }
+        }
+        auto cols = computeWaveformColumns(interleaved.data(), interleaved.size(), channels, 0, 7.5, 250);
+        assert(cols.size() == static_cast<size_t>(channels));
+        for (const auto& channelColumns : cols) {
+            for (size_t x = 0; x < channelColumns.size(); ++x) {
+                assert(channelColumns[x].minVal == expected[0][x].minVal * 0.5f);
+                assert(channelColumns[x].maxVal == expected[0][x].maxVal * 0.5f);
+            }
+        }
+    }
+}
+
+static void testComputeWaveformLanes() {
+    auto mono = computeWaveformLanes(1, 0, 100, 2);
+    assert(mono.size() == 1 && mono[0].top == 0 && mono[0].height == 100 && !mono[0].flipY);
+
+    // Stereo: the right channel mirrored below the left
+    auto stereo = computeWaveformLanes(2, 10, 102, 2);
+    assert(stereo.size() == 2);
+    assert(stereo[0].top == 10 && stereo[0].height == 50 && !stereo[0].flipY);
+    assert(stereo[1].top == 62 && stereo[1].height == 50 && stereo[1].flipY);
+
+    // 5.1: six stacked lanes, none mirrored, inside the area
+    auto surround = computeWaveformLanes(6, 0, 130, 2);
+    assert(surround.size() == 6);
+    for (size_t c = 0; c < surround.size(); ++c) {
+        assert(!surround[c].flipY);
+        assert(surround[c].height == 20);
+        if (c > 0) assert(surround[c].top == surround[c - 1].top + 22);
+    }
+    assert(surround.back().top + surround.back().height <= 130);
+    assert(computeWaveformLanes(0, 0, 100, 2).empty());
+}
+
 int main() {
     testComputeTrimAndFadeRanges_noTrim_fullExtent();
     testComputeTrimAndFadeRanges_trimmed_clipView();
     testComputeTrimAndFadeRanges_fades_clamped();
     testComputeTrimAndFadeRanges_emptyClip();
+    testComputeWaveformColumns_stereoMinMax();
+    testComputeWaveformColumns_parallelMatchesScroll();
+    testComputeWaveformColumns_emptyInput();
+    testComputeWaveformColumns_layoutsAgree();
+    testComputeWaveformColumns_surroundLayouts();
+    testComputeWaveformLanes();
     return 0;
 }
@@ -5,6 +5,7 @@
 
 #include "ClipTableModel.h"
 #include "core/ProjectManager.h"
+#include "utils/SpeakerLayout.h"
 #include <QFileInfo>
 #include <QSettings>
 #include <QBrush>
@@ -45,9 +46,12 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
 
     const auto& clip = clips_[static_cast<size_t>(index.row())];
     
-    // Get clip state from project
+    // Get clip state from project. Only the status column and the row colour
+    // need it, and sorting asks for every row, so it is looked up on demand
+    // and without touching the file system.
+    const bool needsState = index.column() == ColStatus || role == Qt::BackgroundRole;
     const ClipState* clipState = nullptr;
-    if (projectManager_.hasProject()) {
+    if (needsState && projectManager_.hasProject()) {
         // Build relative path from clip path
         const std::string& clipPath = clip.filePath();
         const std::string& rawFolder = projectManager_.project().rawFolder();
@@ -56,7 +60,7 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
         if (!rawFolder.empty()) {
             std::filesystem::path clipFsPath(clipPath);
             std::filesystem::path rawFsPath(rawFolder);
-            auto relPath = std::filesystem::relative(clipFsPath, rawFsPath);
+            auto relPath = clipFsPath.lexically_normal().lexically_relative(rawFsPath.lexically_normal());
             relativePath = relPath.string();
         } else {
             relativePath = std::filesystem::path(clipPath).filename().string();
@@ -85,6 +89,7 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
                 if (clipState->isTrimmed) status += "T";
                 if (clipState->isNormalized) status += "N";
                 if (clipState->isCompressed) status += "C";
+                if (clipState->isLimited) status += "L";
                 if (clipState->isExported) status += "E";
                 return status;
             }
@@ -115,6 +120,7 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
                 if (clipState->isTrimmed) count++;
                 if (clipState->isNormalized) count++;
                 if (clipState->isCompressed) count++;
+                if (clipState->isLimited) count++;
                 if (clipState->isExported) count++;
                 return count;
             }
@@ -163,6 +169,14 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
                           .arg(cs.makeupDb, 0, 'f', 1);
         }
         
+        if (clipState->isLimited) {
+            const auto& ls = clipState->limiterSettings;
+            operations << tr("Limited: %1 dBFS, %2/%3ms")
+                          .arg(ls.ceilingDb, 0, 'f', 1)
+                          .arg(ls.lookaheadMs, 0, 'f', 0)
+                          .arg(ls.releaseMs, 0, 'f', 0);
+        }
+        
         if (clipState->isExported) {
             operations << tr("Exported: %1")
                           .arg(QString::fromStdString(clipState->exportedFilename));
@@ -175,11 +189,26 @@ QVariant ClipTableModel::data(const QModelIndex& index, int role) const {
         return operations.join("\n");
     }
     
+    // Tooltip for the level columns: each channel's level
+    if (role == Qt::ToolTipRole && (index.column() == ColPeakDb || index.column() == ColRmsDb)) {
+        const auto& levels = clip.channelLevels();
+        if (!clip.hasMetrics() || levels.size() < 2) return {};
+
+        QStringList lines;
+        for (size_t c = 0; c < levels.size(); ++c) {
+            const float db = index.column() == ColPeakDb ? levels[c].peakDb : levels[c].rmsDb;
+            lines << tr("%1: %2 dB")
+                     .arg(QString::fromStdString(SpeakerLayout::label(static_cast<int>(c), clip.channels())))
+                     .arg(static_cast<double>(db), 0, 'f', 2);
+        }
+        return lines.join("\n");
+    }
+
     // Background color for modified rows
     if (role == Qt::BackgroundRole) {
         if (clipState) {
             bool hasModifications = clipState->isTrimmed || clipState->isNormalized || 
-                                   clipState->isCompressed;
+                                   clipState->isCompressed || clipState->isLimited;
             bool isExported = clipState->isExported;
             
             if (isExported) {
@@ -244,6 +273,7 @@ QVariant ClipTableModel::headerData(int section, Qt::Orientation orientation, in
                           "  T = Trimmed\n"
                           "  N = Normalized\n"
                           "  C = Compressed\n"
+                          "  L = Limited\n"
                           "  E = Exported\n\n"
                           "Hover over a status to see detailed parameters.");
             default:
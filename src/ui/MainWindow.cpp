@@ -9,8 +9,10 @@
 #include <QCloseEvent>
 #include <QDialog>
 #include <QDir>
+#include <QDialogButtonBox>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFontDatabase>
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QItemSelection>
@@ -21,18 +23,26 @@
 #include <QMessageBox>
 #include <QPixmap>
 #include <QProgressBar>
+#include <QPlainTextEdit>
 #include <QPushButton>
 #include <QSettings>
 #include <QSortFilterProxyModel>
 #include <QSplitter>
 #include <QStatusBar>
 #include <QTableView>
+#include <QThreadPool>
 #include <QVBoxLayout>
 
 #include <QtConcurrent>
 
+#include <atomic>
+#include <filesystem>
+#include <limits>
+
 #include "audio/AudioPlayer.h"
 #include "audio/Formats/Mp3Encoder.h"
+#include "core/ClipPipeline.h"
+#include "core/ExportCache.h"
 #include "ui/ClipTableModel.h"
 #include "ui/OutputPanel.h"
 #include "ui/ProcessingPanel.h"
@@ -43,6 +53,10 @@
 #include "ui/NewProjectDialog.h"
 #include "ui/ProjectSettingsDialog.h"
 #include "utils/FileScanner.h"
+#include "utils/FileStamp.h"
+#include "utils/FrameRanges.h"
+#include "utils/StartupProfile.h"
+#include "utils/Trace.h"
 
 // Application settings keys
 namespace {
@@ -55,6 +69,14 @@ constexpr const char* kKeyRecentFiles = "RecentFiles";
 constexpr const char* kKeyRecentFolders = "RecentFolders";
 constexpr const char* kKeyDefaultAuthor = "DefaultAuthorName";
 constexpr const char* kKeyShowTooltips = "ShowColumnTooltips";
+constexpr const char* kKeyCompactSamples = "CompactSampleStorage";
+constexpr const char* kKeyMemoryBudget = "MemoryBudgetMB";
+
+constexpr uint64_t kMegabyte = 1024 * 1024;
+
+QString formatMegabytes(uint64_t bytes) {
+    return QString::number(static_cast<double>(bytes) / static_cast<double>(kMegabyte), 'f', 0);
+}
 }  // namespace
 
 // ============================================================================
@@ -65,9 +87,18 @@ MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , settings_(std::make_unique<QSettings>(kSettingsOrg, kSettingsApp))
 {
-    loadSettings();
-    setupUi();
-    setupMenus();
+    {
+        WOOSH_STARTUP_PHASE("MainWindow: settings");
+        loadSettings();
+    }
+    {
+        WOOSH_STARTUP_PHASE("MainWindow: panels");
+        setupUi();
+    }
+    {
+        WOOSH_STARTUP_PHASE("MainWindow: menus");
+        setupMenus();
+    }
     
     // Connect ProjectManager signals
     connect(&projectManager_, &ProjectManager::projectChanged, 
@@ -97,6 +128,11 @@ void MainWindow::loadSettings() {
     recentFolders_ = settings_->value(kKeyRecentFolders).toStringList();
     defaultAuthorName_ = settings_->value(kKeyDefaultAuthor).toString();
     showColumnTooltips_ = settings_->value(kKeyShowTooltips, true).toBool();
+    compactSamples_ = settings_->value(kKeyCompactSamples, false).toBool();
+    engine_.setCompactStorage(compactSamples_);
+    const auto defaultBudgetMb = static_cast<qulonglong>(MemoryGovernor::defaultBudgetBytes() / kMegabyte);
+    memoryBudgetMb_ = settings_->value(kKeyMemoryBudget, defaultBudgetMb).toULongLong();
+    memoryGovernor_.setBudget(memoryBudgetMb_ * kMegabyte);
 }
 
 void MainWindow::saveSettings() {
@@ -105,6 +141,8 @@ void MainWindow::saveSettings() {
     settings_->setValue(kKeyRecentFolders, recentFolders_);
     settings_->setValue(kKeyDefaultAuthor, defaultAuthorName_);
     settings_->setValue(kKeyShowTooltips, showColumnTooltips_);
+    settings_->setValue(kKeyCompactSamples, compactSamples_);
+    settings_->setValue(kKeyMemoryBudget, static_cast<qulonglong>(memoryBudgetMb_));
     if (outputPanel_) {
         settings_->setValue(kKeyOutputDir, outputPanel_->outputFolder());
     }
@@ -184,10 +222,14 @@ void MainWindow::setupUi() {
 
     rightLayout->addWidget(processingRow);
 
+    connect(processingPanel_, &ProcessingPanel::autoTrimSelectedRequested, this, &MainWindow::onAutoTrimSelected);
+    connect(processingPanel_, &ProcessingPanel::autoTrimAllRequested, this, &MainWindow::onAutoTrimAll);
     connect(processingPanel_, &ProcessingPanel::normalizeSelectedRequested, this, &MainWindow::onNormalizeSelected);
     connect(processingPanel_, &ProcessingPanel::normalizeAllRequested, this, &MainWindow::onNormalizeAll);
     connect(processingPanel_, &ProcessingPanel::compressSelectedRequested, this, &MainWindow::onCompressSelected);
     connect(processingPanel_, &ProcessingPanel::compressAllRequested, this, &MainWindow::onCompressAll);
+    connect(processingPanel_, &ProcessingPanel::limitSelectedRequested, this, &MainWindow::onLimitSelected);
+    connect(processingPanel_, &ProcessingPanel::limitAllRequested, this, &MainWindow::onLimitAll);
 
     outputPanel_ = new OutputPanel(rightPane);
     rightLayout->addWidget(outputPanel_);
@@ -220,6 +262,10 @@ void MainWindow::setupUi() {
 
     statusLabel_ = new QLabel(this);
     statusBar()->addPermanentWidget(statusLabel_);
+    memoryLabel_ = new QLabel(this);
+    memoryLabel_->setToolTip(tr("Memory held by loaded clips and caches, and the budget (Settings > Memory)"));
+    statusBar()->addPermanentWidget(memoryLabel_);
+    updateMemoryStatus();
 
     audioPlayer_ = new AudioPlayer(this);
     connect(audioPlayer_, &AudioPlayer::positionChanged, this, &MainWindow::onPlaybackPositionChanged);
@@ -231,6 +277,8 @@ void MainWindow::setupUi() {
     if (vuMeter_) {
         connect(audioPlayer_, &AudioPlayer::levelsChanged,
                 vuMeter_, &VuMeterWidget::setLevels);
+        connect(audioPlayer_, &AudioPlayer::loudnessChanged,
+                vuMeter_, &VuMeterWidget::setLoudness);
     }
 
     QByteArray geom = settings_->value(kKeyWindowGeom).toByteArray();
@@ -258,9 +306,9 @@ void MainWindow::setupMenus() {
 
     fileMenu->addSeparator();
 
-    // Recent Projects submenu
+    // Recent Projects submenu (the recent menus are filled when first opened)
     recentProjectsMenu_ = fileMenu->addMenu(tr("Recent &Projects"));
-    updateRecentProjectsMenu();
+    connect(recentProjectsMenu_, &QMenu::aboutToShow, this, &MainWindow::updateRecentProjectsMenu);
 
     fileMenu->addSeparator();
 
@@ -275,11 +323,11 @@ void MainWindow::setupMenus() {
 
     // Recent Files submenu (moved to legacy)
     recentFilesMenu_ = legacyMenu->addMenu(tr("Recent &Files"));
-    updateRecentFilesMenu();
+    connect(recentFilesMenu_, &QMenu::aboutToShow, this, &MainWindow::updateRecentFilesMenu);
 
     // Recent Folders submenu (moved to legacy)
     recentFoldersMenu_ = legacyMenu->addMenu(tr("Recent F&olders"));
-    updateRecentFoldersMenu();
+    connect(recentFoldersMenu_, &QMenu::aboutToShow, this, &MainWindow::updateRecentFoldersMenu);
 
     fileMenu->addSeparator();
 
@@ -298,6 +346,12 @@ void MainWindow::setupMenus() {
     undoAction_->setShortcut(QKeySequence::Undo);
     undoAction_->setEnabled(false);
 
+    // --- View menu ---
+    auto* viewMenu = menuBar()->addMenu(tr("&View"));
+
+    batchReportAction_ = viewMenu->addAction(tr("Last Batch &Report..."), this, &MainWindow::onShowBatchReport);
+    batchReportAction_->setEnabled(false);
+
     // --- Help menu ---
     auto* helpMenu = menuBar()->addMenu(tr("&Help"));
     helpMenu->addAction(tr("&About"), this, [this]() {
@@ -506,7 +560,10 @@ void MainWindow::newProject() {
 
     // Clear existing clips and load from RAW folder
     clips_.clear();
+    pendingRows_.clear();
+    memoryGovernor_.clear();
     clipModel_->refresh();
+    updateMemoryStatus();
     
     loadProjectClips();
     updateWindowTitle();
@@ -534,7 +591,10 @@ void MainWindow::openProject() {
     }
 
     clips_.clear();
+    pendingRows_.clear();
+    memoryGovernor_.clear();
     clipModel_->refresh();
+    updateMemoryStatus();
     
     loadProjectClips();
     updateWindowTitle();
@@ -554,6 +614,7 @@ void MainWindow::saveProject() {
         return;
     }
 
+    updateCachedClipInfo();
     if (projectManager_.saveProject()) {
         statusBar()->showMessage(tr("Project saved"));
     } else {
@@ -586,6 +647,7 @@ void MainWindow::saveProjectAs() {
     QFileInfo fi(path);
     lastOpenDirectory_ = fi.absolutePath();
 
+    updateCachedClipInfo();
     if (projectManager_.saveProjectAs(path)) {
         updateWindowTitle();
         statusBar()->showMessage(tr("Project saved as: %1").arg(fi.fileName()));
@@ -618,7 +680,10 @@ void MainWindow::openRecentProject() {
     }
 
     clips_.clear();
+    pendingRows_.clear();
+    memoryGovernor_.clear();
     clipModel_->refresh();
+    updateMemoryStatus();
     
     loadProjectClips();
     updateWindowTitle();
@@ -729,13 +794,38 @@ void MainWindow::loadProjectClips() {
         return;
     }
 
+    // Clips whose cached info is up to date are listed straight away and
+    // decoded later: in the background while they fit the memory budget,
+    // otherwise when used. The rest appear once they are decoded.
+    const uint64_t budget = memoryGovernor_.budget();
+    uint64_t warmBytes = memoryGovernor_.usedBytes();
+    const size_t listedBefore = clips_.size();
     QStringList list;
     list.reserve(static_cast<int>(found.size()));
     for (const auto& p : found) {
-        list << QString::fromStdString(p);
+        const ClipState* state = project.findClipState(std::filesystem::path(p).filename().string());
+        const auto stamp = state && state->info ? fileStamp(p) : std::nullopt;
+        if (!stamp || !state->info->matchesSource(stamp->size, stamp->modifiedTime)) {
+            list << QString::fromStdString(p);
+            continue;
+        }
+        const ClipInfo& info = *state->info;
+        clips_.push_back(AudioClip::fromMetadata(p, info.sampleRate, info.channels, info.frames,
+                                                 info.peakDb, info.rmsDb, state->hasProcessing()));
+
+        const uint64_t estimate = info.frames * static_cast<uint64_t>(info.channels) * sizeof(float);
+        if (budget == 0 || warmBytes + estimate <= budget) {
+            warmBytes += estimate;
+            pendingRows_[p] = clips_.size() - 1;
+            list << QString::fromStdString(p);
+        }
+    }
+    if (clips_.size() > listedBefore) {
+        clipModel_->refresh();
+        updateMemoryStatus();
     }
 
-    loadFileList(list);
+    if (!list.isEmpty()) loadFileList(list);
 
     // Update output panel with game folder
     if (outputPanel_ && !project.gameFolder().empty()) {
@@ -743,32 +833,6 @@ void MainWindow::loadProjectClips() {
     }
 }
 
-void MainWindow::applyClipState(AudioClip& clip, const ClipState& state) {
-    // Save original first (if not already saved)
-    if (!clip.hasOriginal()) {
-        clip.saveOriginal();
-    }
-    
-    // Apply trim if stored
-    if (state.isTrimmed) {
-        engine_.trim(clip, static_cast<float>(state.trimStartSec), static_cast<float>(state.trimEndSec));
-    }
-    
-    // Apply normalization if stored
-    if (state.isNormalized) {
-        engine_.normalizeToPeak(clip, static_cast<float>(state.normalizeTargetDb));
-    }
-    
-    // Apply compression if stored
-    if (state.isCompressed) {
-        const auto& cs = state.compressorSettings;
-        engine_.compress(clip, cs.threshold, cs.ratio, cs.attackMs, cs.releaseMs, cs.makeupDb);
-    }
-    
-    // Note: Fades are non-destructive and applied during playback/export,
-    // so we don't need to apply them to the clip samples here
-}
-
 void MainWindow::closeEvent(QCloseEvent* event) {
     if (!maybeSaveProject()) {
         event->ignore();
@@ -795,6 +859,8 @@ void MainWindow::openSettings() {
     SettingsDialog dialog(this);
     dialog.setShowColumnTooltips(showColumnTooltips_);
     dialog.setDefaultAuthorName(defaultAuthorName_);
+    dialog.setCompactSamples(compactSamples_);
+    dialog.setMemoryBudgetMb(static_cast<int>(memoryBudgetMb_));
 
     connect(&dialog, &SettingsDialog::clearHistoryRequested, this, &MainWindow::onClearHistory);
 
@@ -802,7 +868,165 @@ void MainWindow::openSettings() {
         showColumnTooltips_ = dialog.showColumnTooltips();
         defaultAuthorName_ = dialog.defaultAuthorName();
         clipModel_->setShowTooltips(showColumnTooltips_);
+        applyCompactSamples(dialog.compactSamples());
+        memoryBudgetMb_ = static_cast<uint64_t>(dialog.memoryBudgetMb());
+        memoryGovernor_.setBudget(memoryBudgetMb_ * kMegabyte);
+        enforceMemoryBudget();
+    }
+}
+
+void MainWindow::applyCompactSamples(bool compact) {
+    if (compact == compactSamples_) return;
+
+    // Running batches share engine_ and hold references into clips_
+    const auto running = [](const auto* watcher) { return watcher && watcher->isRunning(); };
+    if (running(loadWatcher_) || running(processWatcher_) || running(exportWatcher_) || running(reloadWatcher_)) {
+        statusBar()->showMessage(tr("Memory setting not changed: wait for the running operation to finish"), 5000);
+        return;
+    }
+
+    compactSamples_ = compact;
+    engine_.setCompactStorage(compact);
+
+    for (size_t i = 0; i < clips_.size(); ++i) {
+        auto& clip = clips_[i];
+        if (compact) {
+            clip.storeCompact16(clip.isModified());
+        } else {
+            clip.storeFloat();
+        }
+        if (clip.isResident()) memoryGovernor_.track(i, clip.residentBytes());
     }
+    updateWaveformView();
+    enforceMemoryBudget();
+}
+
+void MainWindow::storeClipInfo(const AudioClip& clip, ClipInfo& info) {
+    info.frames = clip.frameCount();
+    info.sampleRate = clip.sampleRate();
+    info.channels = clip.channels();
+    info.peakDb = clip.peakDb();
+    info.rmsDb = clip.rmsDb();
+}
+
+void MainWindow::updateCachedClipInfo() {
+    // Processing and trims since the clips were loaded change their info;
+    // the source stamp stays that of the file that was decoded
+    auto& project = projectManager_.project();
+    for (const auto& clip : clips_) {
+        ClipState* state = project.findClipState(clip.displayName());
+        if (state && state->info && clip.hasMetrics()) storeClipInfo(clip, *state->info);
+    }
+}
+
+// ============================================================================
+// Memory budget
+// ============================================================================
+
+void MainWindow::reloadInBackground(size_t index) {
+    // One reload at a time; when it finishes, the selection is looked at again
+    if (reloadWatcher_ && reloadWatcher_->isRunning()) return;
+    if (!reloadWatcher_) {
+        reloadWatcher_ = new QFutureWatcher<std::optional<AudioClip>>(this);
+        connect(reloadWatcher_, &QFutureWatcher<std::optional<AudioClip>>::finished,
+                this, &MainWindow::onReloadFinished);
+    }
+
+    // The worker gets copies: clips_ and the project may change meanwhile
+    const AudioClip& clip = clips_[index];
+    std::optional<ClipState> state;
+    if (projectManager_.hasProject()) {
+        if (const ClipState* stored = projectManager_.project().findClipState(clip.displayName())) state = *stored;
+    }
+    reloadRow_ = index;
+    reloadPath_ = clip.filePath();
+
+    const AudioEngine* engine = &engine_;
+    reloadWatcher_->setFuture(QtConcurrent::run([engine, clip, state = std::move(state)]() {
+        WOOSH_TRACE_SCOPE_DETAIL("MainWindow::reloadClip", clip.displayName());
+        return ClipPipeline::reloadClip(*engine, clip, state ? &*state : nullptr);
+    }));
+}
+
+void MainWindow::onReloadFinished() {
+    if (!reloadWatcher_) return;
+    std::optional<AudioClip> reloaded = reloadWatcher_->result();
+
+    // Only fill the row if it still holds the placeholder that was reloaded
+    const size_t row = reloadRow_;
+    const bool samePlaceholder = row < clips_.size() && clips_[row].filePath() == reloadPath_
+                                 && !clips_[row].isResident();
+    if (samePlaceholder && reloaded) {
+        clips_[row] = std::move(*reloaded);
+        memoryGovernor_.track(row, clips_[row].residentBytes());
+        const int sourceRow = static_cast<int>(row);
+        Q_EMIT clipModel_->dataChanged(clipModel_->index(sourceRow, 0),
+                                       clipModel_->index(sourceRow, ClipTableModel::ColCount - 1));
+        enforceMemoryBudget();
+    }
+
+    const int current = currentClipIndex();
+    if (current < 0 || current >= static_cast<int>(clips_.size())) return;
+    if (static_cast<size_t>(current) == row && samePlaceholder && !reloaded) {
+        statusLabel_->clear();
+        statusBar()->showMessage(tr("Could not reload %1").arg(QString::fromStdString(clips_[row].displayName())));
+        return;
+    }
+    // Show the reloaded clip, or start on another one selected meanwhile
+    if (static_cast<size_t>(current) == row || !clips_[static_cast<size_t>(current)].isResident()) {
+        onSelectionChanged();
+    }
+}
+
+bool MainWindow::canEvictClip(size_t index) const {
+    const AudioClip& clip = clips_[index];
+    if (!clip.isModified()) return true;
+    // Processed clips can only be reproduced from the processing stored in the project
+    return projectManager_.hasProject() && projectManager_.project().findClipState(clip.displayName()) != nullptr;
+}
+
+bool MainWindow::releaseClip(size_t index) {
+    AudioClip& clip = clips_[index];
+    // Processed clips go to a spill file rather than being reprocessed on reload
+    if (clip.isModified()) {
+        if (spillDirectory_.empty()) {
+            const QString dir = QDir::temp().filePath(QStringLiteral("woosh-spill"));
+            if (QDir().mkpath(dir)) spillDirectory_ = dir.toStdString();
+        }
+        if (!spillDirectory_.empty() && clip.spill(spillDirectory_)) return true;
+    }
+    if (!canEvictClip(index)) return false;
+    clip.evict();
+    return true;
+}
+
+void MainWindow::enforceMemoryBudget() {
+    memoryGovernor_.setCacheBytes(waveformView_->cacheBytes() + audioPlayer_->bufferBytes());
+
+    // Batches work on copies of the clips, so releasing them here is safe;
+    // the selected clip is shown and may be playing, so it stays
+    const int current = currentClipIndex();
+    const auto victims = memoryGovernor_.selectVictims([this, current](size_t index) {
+        return static_cast<int>(index) != current && (clips_[index].isModified() || canEvictClip(index));
+    });
+    for (size_t index : victims) {
+        // Spilled clips hold no heap memory, so they are not tracked either
+        if (releaseClip(index)) memoryGovernor_.forget(index);
+    }
+    updateMemoryStatus();
+}
+
+void MainWindow::updateMemoryStatus() {
+    const uint64_t used = memoryGovernor_.usedBytes();
+    const uint64_t budget = memoryGovernor_.budget();
+    QString text = budget == 0
+        ? tr("Memory: %1 MB").arg(formatMegabytes(used))
+        : tr("Memory: %1 / %2 MB").arg(formatMegabytes(used), formatMegabytes(budget));
+
+    uint64_t spilled = 0;
+    for (const auto& clip : clips_) spilled += clip.spilledBytes();
+    if (spilled > 0) text += tr(" (%1 MB on disk)").arg(formatMegabytes(spilled));
+    memoryLabel_->setText(text);
 }
 
 void MainWindow::onClearHistory() {
@@ -881,7 +1105,22 @@ void MainWindow::loadFileList(const QStringList& paths) {
     statusBar()->showMessage(tr("Loading %1 file(s) in parallel...").arg(paths.size()));
 
     // Capture engine pointer for the lambda (engine_ lifetime is tied to MainWindow)
-    AudioEngine* engine = &engine_;
+    const AudioEngine* engine = &engine_;
+
+    loadRecorder_ = std::make_shared<BatchRecorder>("load", QThreadPool::globalInstance()->maxThreadCount());
+    auto recorder = loadRecorder_;
+
+    // Stored processing is applied by the workers, from a copy of the project
+    std::shared_ptr<const Project> project;
+    if (projectManager_.hasProject()) project = std::make_shared<const Project>(projectManager_.project());
+
+    // Clips that no longer fit the memory budget keep their metrics and are
+    // evicted straight away; they are reloaded when used
+    const uint64_t budget = memoryGovernor_.budget();
+    const uint64_t used = memoryGovernor_.usedBytes();
+    auto budgetLeft = std::make_shared<std::atomic<int64_t>>(
+        budget == 0 ? std::numeric_limits<int64_t>::max()
+                    : static_cast<int64_t>(budget > used ? budget - used : 0));
 
     // Create watcher if needed
     if (!loadWatcher_) {
@@ -894,7 +1133,10 @@ void MainWindow::loadFileList(const QStringList& paths) {
     std::vector<QString> pathVec(paths.begin(), paths.end());
 
     // Load files in parallel using all available CPU cores
-    QFuture<std::vector<AudioClip>> future = QtConcurrent::run([engine, pathVec = std::move(pathVec)]() {
+    QFuture<std::vector<AudioClip>> future = QtConcurrent::run([engine, recorder, project, budgetLeft,
+                                                                pathVec = std::move(pathVec)]() {
+        WOOSH_TRACE_SCOPE("MainWindow::loadBatch");
+
         // Use QtConcurrent::mapped internally for true parallel loading
         QList<QString> pathList;
         pathList.reserve(static_cast<qsizetype>(pathVec.size()));
@@ -904,11 +1146,27 @@ void MainWindow::loadFileList(const QStringList& paths) {
 
         // Map: load each file in parallel
         QFuture<std::optional<AudioClip>> mappedFuture = QtConcurrent::mapped(pathList,
-            [engine](const QString& path) -> std::optional<AudioClip> {
-                auto clipOpt = engine->loadClip(path.toStdString());
+            [engine, recorder, project, budgetLeft](const QString& path) -> std::optional<AudioClip> {
+                const FrameRanges::WorkerScope busy;
+                StageTimer fileTimer(nullptr, "file");
+                std::optional<AudioClip> clipOpt;
+                {
+                    StageTimer timer(recorder.get(), "decode");
+                    clipOpt = engine->loadClip(path.toStdString());
+                }
                 if (clipOpt) {
                     clipOpt->saveOriginal();
+                    const ClipState* state = project ? project->findClipState(clipOpt->displayName()) : nullptr;
+                    if (state) ClipPipeline::applyClipState(*engine, *clipOpt, *state, recorder.get());
+
+                    const auto bytes = static_cast<int64_t>(clipOpt->residentBytes());
+                    if (budgetLeft->fetch_sub(bytes) < bytes) {
+                        budgetLeft->fetch_add(bytes);
+                        clipOpt->evict();
+                    }
                 }
+                recorder->addFile(path.toStdString(), static_cast<uint64_t>(QFileInfo(path).size()),
+                                  fileTimer.elapsedMs(), clipOpt.has_value());
                 return clipOpt;
             });
 
@@ -930,6 +1188,7 @@ void MainWindow::loadFileList(const QStringList& paths) {
 }
 
 void MainWindow::onLoadingFinished() {
+    WOOSH_TRACE_SCOPE("MainWindow::onLoadingFinished");
     progressBar_->setVisible(false);
 
     if (!loadWatcher_) return;
@@ -937,26 +1196,53 @@ void MainWindow::onLoadingFinished() {
     std::vector<AudioClip> loadedClips = loadWatcher_->result();
     int loaded = static_cast<int>(loadedClips.size());
 
+    const size_t rowsBefore = clips_.size();
     for (auto& clip : loadedClips) {
+        // Rows listed from cached info are filled in place, unless the clip
+        // was reloaded or processed meanwhile
+        if (auto pending = pendingRows_.find(clip.filePath()); pending != pendingRows_.end()) {
+            const size_t row = pending->second;
+            if (!clips_[row].isResident()) {
+                clips_[row] = std::move(clip);
+                if (clips_[row].isResident()) memoryGovernor_.track(row, clips_[row].residentBytes());
+                const int sourceRow = static_cast<int>(row);
+                Q_EMIT clipModel_->dataChanged(clipModel_->index(sourceRow, 0),
+                                               clipModel_->index(sourceRow, ClipTableModel::ColCount - 1));
+            }
+            continue;
+        }
+
         // Register clip with project if we have one
         if (projectManager_.hasProject()) {
             std::string relativePath = clip.displayName();
             ClipState* state = projectManager_.project().findClipState(relativePath);
             
+            // Stored processing was applied by the load workers
             if (!state) {
                 // Create new state for new clip
                 ClipState newState;
                 newState.relativePath = relativePath;
                 projectManager_.project().addClipState(newState);
-            } else {
-                // Apply stored processing from existing state
-                applyClipState(clip, *state);
+                state = projectManager_.project().findClipState(relativePath);
+            }
+            // Decoded because its info was missing or out of date
+            if (const auto stamp = fileStamp(clip.filePath())) {
+                state->info = ClipInfo{stamp->size, stamp->modifiedTime};
+                storeClipInfo(clip, *state->info);
             }
         }
         clips_.push_back(std::move(clip));
+        if (clips_.back().isResident()) memoryGovernor_.track(clips_.size() - 1, clips_.back().residentBytes());
     }
+    pendingRows_.clear();
 
-    clipModel_->refresh();
+    if (clips_.size() != rowsBefore) clipModel_->refresh();
+    enforceMemoryBudget();
+
+    if (loadRecorder_) {
+        storeBatchReport(loadRecorder_->finish());
+        loadRecorder_.reset();
+    }
 
     QString msg = tr("Loaded %1 clip(s)").arg(loaded);
     statusBar()->showMessage(msg);
@@ -984,6 +1270,18 @@ void MainWindow::onSelectionChanged() {
     int idx = indices.front();
     if (idx >= 0 && idx < static_cast<int>(clips_.size())) {
         AudioClip* clip = &clips_[static_cast<size_t>(idx)];
+        if (!clip->isResident()) {
+            // Evicted or listed from cached info: decoded off the GUI thread,
+            // and the row keeps showing the cached info until it is back
+            statusLabel_->setText(tr("%1 | Loading...").arg(QString::fromStdString(clip->displayName())));
+            waveformView_->setClip(nullptr);
+            audioPlayer_->setClip(nullptr);
+            transportPanel_->setTimeDisplay(0, 0);
+            undoAction_->setEnabled(false);
+            reloadInBackground(static_cast<size_t>(idx));
+            return;
+        }
+        memoryGovernor_.touch(static_cast<size_t>(idx));
 
         statusLabel_->setText(
             tr("%1 | %2s | %3 Hz | %4 ch | Peak: %5 dB | RMS: %6 dB")
@@ -1013,6 +1311,9 @@ void MainWindow::onSelectionChanged() {
             waveformView_->setFadeOutLengthFrames(0);
             audioPlayer_->setFadeEnvelope(0, 0);
         }
+
+        // The selected clip may have been reloaded; make room for it
+        enforceMemoryBudget();
     }
 }
 
@@ -1169,30 +1470,21 @@ void MainWindow::onApplyTrim() {
 
     if (startFrame <= 0 && endFrame <= 0) return;
 
-    int channels = clip->channels();
     int maxFrame = static_cast<int>(clip->frameCount());
     int effectiveEnd = (endFrame > 0) ? endFrame : maxFrame;
 
     if (startFrame >= effectiveEnd) return;
 
-    // Calculate trim times in seconds before applying
-    double sampleRate = static_cast<double>(clip->sampleRate());
-    double trimStartSec = static_cast<double>(startFrame) / sampleRate;
-    double trimEndSec = static_cast<double>(effectiveEnd) / sampleRate;
-
-    auto& samples = clip->samplesMutable();
-    size_t startSample = static_cast<size_t>(startFrame * channels);
-    size_t endSample = static_cast<size_t>(effectiveEnd * channels);
-
-    if (startSample >= samples.size()) return;
-    endSample = std::min(endSample, samples.size());
-
-    std::vector<float> trimmed(samples.begin() + startSample, samples.begin() + endSample);
-    clip->setSamples(std::move(trimmed));
-    clip->setModified(true);
+    // Narrow the clip's view; no samples are copied
+    if (!clip->trimFrames(static_cast<size_t>(std::max(0, startFrame)), static_cast<size_t>(effectiveEnd))) return;
 
     engine_.updateClipMetrics(*clip);
 
+    // Store the trim relative to the file on disk so re-trims reload correctly
+    double sampleRate = static_cast<double>(clip->sampleRate());
+    double trimStartSec = static_cast<double>(clip->trimOffsetFrames()) / sampleRate;
+    double trimEndSec = static_cast<double>(clip->trimOffsetFrames() + clip->frameCount()) / sampleRate;
+
     // Update project clip state if we have a project
     if (projectManager_.hasProject()) {
         std::string relativePath = clip->displayName();
@@ -1224,6 +1516,22 @@ void MainWindow::onUndoProcessing() {
     if (!clip || !clip->hasOriginal()) return;
 
     clip->restoreOriginal();
+    memoryGovernor_.track(static_cast<size_t>(currentClipIndex()), clip->residentBytes());
+
+    // Reloads and export keys follow the stored processing, so it has to go
+    // as well; the output's manifest entry is dropped so the next export
+    // rewrites the file that still holds the processed clip
+    if (projectManager_.hasProject()) {
+        auto& project = projectManager_.project();
+        project.updateClipState(clip->displayName(), [](ClipState& state) { state.clearProcessing(); });
+        project.markDirty();
+
+        const QString outputDir = outputPanel_->outputFolder();
+        if (!outputDir.isEmpty() && !outputPanel_->overwriteOriginals()
+            && !ExportCache::forgetOutput(outputDir.toStdString(), clip->filePath(), project.exportSettings().format)) {
+            qWarning("Could not update the export manifest in %s", qPrintable(outputDir));
+        }
+    }
 
     waveformView_->setClip(clip);
     audioPlayer_->setClip(clip);
@@ -1237,6 +1545,25 @@ void MainWindow::onUndoProcessing() {
 // Processing
 // ============================================================================
 
+void MainWindow::onAutoTrimSelected() {
+    auto indices = selectedIndices();
+    if (indices.empty()) {
+        QMessageBox::information(this, tr("No Selection"),
+            tr("Please select one or more clips to auto-trim."));
+        return;
+    }
+    applyProcessing(indices, false, false, false, true);
+}
+
+void MainWindow::onAutoTrimAll() {
+    if (clips_.empty()) {
+        QMessageBox::information(this, tr("No Clips"),
+            tr("Please load some audio files first."));
+        return;
+    }
+    applyProcessing(allIndices(), false, false, false, true);
+}
+
 void MainWindow::onNormalizeSelected() {
     auto indices = selectedIndices();
     if (indices.empty()) {
@@ -1275,6 +1602,25 @@ void MainWindow::onCompressAll() {
     applyProcessing(allIndices(), false, true);
 }
 
+void MainWindow::onLimitSelected() {
+    auto indices = selectedIndices();
+    if (indices.empty()) {
+        QMessageBox::information(this, tr("No Selection"),
+            tr("Please select one or more clips to limit."));
+        return;
+    }
+    applyProcessing(indices, false, false, true);
+}
+
+void MainWindow::onLimitAll() {
+    if (clips_.empty()) {
+        QMessageBox::information(this, tr("No Clips"),
+            tr("Please load some audio files first."));
+        return;
+    }
+    applyProcessing(allIndices(), false, false, true);
+}
+
 void MainWindow::onEditModeChanged(bool isFadeMode) {
     waveformView_->setEditMode(isFadeMode);
 }
@@ -1294,7 +1640,8 @@ void MainWindow::onFadeChanged(int fadeInFrames, int fadeOutFrames) {
     audioPlayer_->setFadeEnvelope(fadeInFrames, fadeOutFrames);
 }
 
-void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize, bool compress) {
+void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize, bool compress, bool limit,
+                                 bool autoTrim) {
     // Prevent starting new processing while one is in progress
     if (processWatcher_ && processWatcher_->isRunning()) {
         QMessageBox::warning(this, tr("Busy"), tr("A processing operation is already in progress."));
@@ -1314,6 +1661,12 @@ void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize
     float attack = processingPanel_->compAttackMs();
     float release = processingPanel_->compReleaseMs();
     float makeup = processingPanel_->compMakeupDb();
+    const DSP::LimiterSettings limiter{processingPanel_->limiterCeilingDb(),
+                                       processingPanel_->limiterLookaheadMs(),
+                                       processingPanel_->limiterReleaseMs()};
+    const DSP::SilenceSettings silence{processingPanel_->autoTrimThresholdDb(),
+                                       processingPanel_->autoTrimPreRollMs(),
+                                       processingPanel_->autoTrimPostRollMs()};
 
     // Store processing parameters for async completion handler
     processingAppliedNormalize_ = normalize;
@@ -1324,6 +1677,9 @@ void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize
     processingCompAttackMs_ = attack;
     processingCompReleaseMs_ = release;
     processingCompMakeupDb_ = makeup;
+    processingAppliedLimit_ = limit;
+    processingLimiter_ = limiter;
+    processingAppliedAutoTrim_ = autoTrim;
 
     // Collect clips to process (make copies for thread safety)
     std::vector<AudioClip> clipsToProcess;
@@ -1342,13 +1698,21 @@ void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize
     }
 
     // Capture engine pointer
-    AudioEngine* engine = &engine_;
+    const AudioEngine* engine = &engine_;
+
+    processRecorder_ = std::make_shared<BatchRecorder>("process", QThreadPool::globalInstance()->maxThreadCount());
+    auto recorder = processRecorder_;
+
+    // Evicted clips are reloaded by the workers, from a copy of the project
+    std::shared_ptr<const Project> project;
+    if (projectManager_.hasProject()) project = std::make_shared<const Project>(projectManager_.project());
 
     // Process clips in parallel
     QFuture<std::vector<AudioClip>> future = QtConcurrent::run(
-        [engine, clipsToProcess = std::move(clipsToProcess), normalize, compress,
-         normTarget, threshold, ratio, attack, release, makeup]() mutable {
-            
+        [engine, recorder, project, clipsToProcess = std::move(clipsToProcess), normalize, compress, limit, autoTrim,
+         normTarget, threshold, ratio, attack, release, makeup, limiter, silence]() mutable {
+            WOOSH_TRACE_SCOPE("MainWindow::processBatch");
+
             // Convert to QList for QtConcurrent::mapped
             QList<AudioClip> clipList;
             clipList.reserve(static_cast<qsizetype>(clipsToProcess.size()));
@@ -1358,15 +1722,38 @@ void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize
 
             // Map: process each clip in parallel
             QFuture<AudioClip> mappedFuture = QtConcurrent::mapped(clipList,
-                [engine, normalize, compress, normTarget, threshold, ratio, attack, release, makeup]
+                [engine, recorder, project, normalize, compress, limit, autoTrim, normTarget, threshold, ratio,
+                 attack, release, makeup, limiter, silence]
                 (AudioClip clip) -> AudioClip {
-                    if (normalize) {
-                        engine->normalizeToPeak(clip, normTarget);
+                    WOOSH_TRACE_SCOPE_DETAIL("MainWindow::processClip", clip.displayName());
+                    const FrameRanges::WorkerScope busy;
+                    StageTimer fileTimer(nullptr, "file");
+                    if (!clip.isResident()) {
+                        const ClipState* state = project ? project->findClipState(clip.displayName()) : nullptr;
+                        auto reloaded = ClipPipeline::reloadClip(*engine, clip, state, recorder.get());
+                        if (!reloaded) {
+                            recorder->addFile(clip.filePath(), 0, fileTimer.elapsedMs(), false);
+                            return clip;
+                        }
+                        clip = std::move(*reloaded);
                     }
-                    if (compress) {
-                        engine->compress(clip, threshold, ratio, attack, release, makeup);
+                    if (autoTrim) {
+                        StageTimer timer(recorder.get(), "trim");
+                        engine->autoTrim(clip, silence);
+                    }
+                    ProcessingChain chain;
+                    if (normalize) chain.normalizeToPeak(normTarget);
+                    if (compress) chain.compress({threshold, ratio, attack, release, makeup});
+                    if (limit) chain.limit(limiter);
+                    if (!chain.empty()) {
+                        StageTimer timer(recorder.get(), "process");
+                        engine->process(clip, chain);
+                    } else if (!clip.hasMetrics()) {
+                        engine->updateClipMetrics(clip);
                     }
                     clip.setModified(true);
+                    const size_t bytes = clip.frameCount() * static_cast<size_t>(clip.channels()) * sizeof(float);
+                    recorder->addFile(clip.filePath(), static_cast<uint64_t>(bytes), fileTimer.elapsedMs(), true);
                     return clip;
                 });
 
@@ -1386,6 +1773,7 @@ void MainWindow::applyProcessing(const std::vector<int>& indices, bool normalize
 }
 
 void MainWindow::onProcessingFinished() {
+    WOOSH_TRACE_SCOPE("MainWindow::onProcessingFinished");
     progressBar_->setVisible(false);
 
     if (!processWatcher_) return;
@@ -1396,7 +1784,15 @@ void MainWindow::onProcessingFinished() {
     for (size_t i = 0; i < processedClips.size() && i < processingIndices_.size(); ++i) {
         int idx = processingIndices_[i];
         if (idx >= 0 && idx < static_cast<int>(clips_.size())) {
+            // Auto-trim only records a trim for clips whose window actually moved
+            const AudioClip& before = clips_[static_cast<size_t>(idx)];
+            const bool trimmed = processingAppliedAutoTrim_ &&
+                (processedClips[i].trimOffsetFrames() != before.trimOffsetFrames() ||
+                 processedClips[i].frameCount() != before.frameCount());
             clips_[static_cast<size_t>(idx)] = std::move(processedClips[i]);
+            const AudioClip& stored = clips_[static_cast<size_t>(idx)];
+            pendingRows_.erase(stored.filePath());
+            if (stored.isResident()) memoryGovernor_.track(static_cast<size_t>(idx), stored.residentBytes());
             
             // Update project clip state if we have a project
             if (projectManager_.hasProject()) {
@@ -1409,10 +1805,24 @@ void MainWindow::onProcessingFinished() {
                 float attack = processingCompAttackMs_;
                 float release = processingCompReleaseMs_;
                 float makeup = processingCompMakeupDb_;
+                bool appliedLimit = processingAppliedLimit_;
+                DSP::LimiterSettings limiter = processingLimiter_;
+
+                // Stored relative to the file on disk, like a manual trim
+                const AudioClip& clip = clips_[static_cast<size_t>(idx)];
+                const double sampleRate = static_cast<double>(clip.sampleRate());
+                double trimStartSec = static_cast<double>(clip.trimOffsetFrames()) / sampleRate;
+                double trimEndSec = static_cast<double>(clip.trimOffsetFrames() + clip.frameCount()) / sampleRate;
                 
                 projectManager_.project().updateClipState(relativePath, 
                     [appliedNormalize, appliedCompress, normTarget, threshold, 
-                     ratio, attack, release, makeup](ClipState& state) {
+                     ratio, attack, release, makeup, appliedLimit, limiter,
+                     trimmed, trimStartSec, trimEndSec](ClipState& state) {
+                        if (trimmed) {
+                            state.isTrimmed = true;
+                            state.trimStartSec = trimStartSec;
+                            state.trimEndSec = trimEndSec;
+                        }
                         if (appliedNormalize) {
                             state.isNormalized = true;
                             state.normalizeTargetDb = static_cast<double>(normTarget);
@@ -1425,6 +1835,12 @@ void MainWindow::onProcessingFinished() {
                             state.compressorSettings.releaseMs = release;
                             state.compressorSettings.makeupDb = makeup;
                         }
+                        if (appliedLimit) {
+                            state.isLimited = true;
+                            state.limiterSettings.ceilingDb = limiter.ceilingDb;
+                            state.limiterSettings.lookaheadMs = limiter.lookaheadMs;
+                            state.limiterSettings.releaseMs = limiter.releaseMs;
+                        }
                     });
             }
         }
@@ -1440,11 +1856,18 @@ void MainWindow::onProcessingFinished() {
     int currentIdx = currentClipIndex();
     if (currentIdx >= 0 && std::find(processingIndices_.begin(), processingIndices_.end(), currentIdx) != processingIndices_.end()) {
         updateWaveformView();
+        if (processingAppliedAutoTrim_) audioPlayer_->setClip(currentClip());
         undoAction_->setEnabled(currentClip() && currentClip()->hasOriginal());
     }
 
+    if (processRecorder_) {
+        storeBatchReport(processRecorder_->finish());
+        processRecorder_.reset();
+    }
+
     statusBar()->showMessage(tr("Processed %1 clip(s)").arg(processedClips.size()));
     processingIndices_.clear();
+    enforceMemoryBudget();
 }
 
 // ============================================================================
@@ -1495,26 +1918,18 @@ void MainWindow::exportClips(const std::vector<int>& indices) {
     if (projectManager_.hasProject()) {
         const auto& exportSettings = projectManager_.project().exportSettings();
         exportFormat = exportSettings.format;
-        
-        switch (exportSettings.mp3Bitrate) {
-            case 128: bitrate = Mp3Encoder::BitrateMode::CBR_128; break;
-            case 160: bitrate = Mp3Encoder::BitrateMode::CBR_160; break;
-            case 192: bitrate = Mp3Encoder::BitrateMode::CBR_192; break;
-            default:  bitrate = Mp3Encoder::BitrateMode::CBR_160; break;
-        }
-        
-        metadata.artist = exportSettings.authorName;
-        metadata.album = exportSettings.gameName;
-        metadata.comment = "Made by Woosh";
+        bitrate = ClipPipeline::mp3Bitrate(exportSettings.mp3Bitrate);
+        metadata = ClipPipeline::mp3Metadata(exportSettings);
     }
 
     // Determine file extension based on export format
-    QString extension;
-    switch (exportFormat) {
-        case ExportFormat::MP3: extension = ".mp3"; break;
-        case ExportFormat::OGG: extension = ".ogg"; break;
-        case ExportFormat::WAV: 
-        default: extension = ".wav"; break;
+    const QString extension = QString::fromStdString(ClipPipeline::fileExtension(exportFormat));
+
+    // Project exports into a folder keep a manifest of content keys there,
+    // so outputs whose source, processing and settings are unchanged are skipped
+    std::shared_ptr<ExportManifest> manifest;
+    if (projectManager_.hasProject() && !overwriteOriginals) {
+        manifest = std::make_shared<ExportManifest>(ExportManifest::load(outputDir.toStdString()));
     }
 
     // Collect clips and destination info for background thread
@@ -1524,6 +1939,7 @@ void MainWindow::exportClips(const std::vector<int>& indices) {
         std::string outputPath;  // Full output path for existence check
         int fadeInFrames = 0;
         int fadeOutFrames = 0;
+        std::optional<ClipState> state;  // Stored processing, for the export key
     };
     std::vector<ExportItem> items;
     items.reserve(indices.size());
@@ -1548,24 +1964,28 @@ void MainWindow::exportClips(const std::vector<int>& indices) {
         QString outputFileName = inputInfo.completeBaseName() + extension;
         QString outputPath = QString::fromStdString(destFolder) + "/" + outputFileName;
         
-        // Check if file exists when not overwriting originals
-        if (!overwriteOriginals && QFile::exists(outputPath)) {
+        // Check if file exists when not overwriting originals; files written
+        // by an earlier export (listed in the manifest) are not conflicts
+        if (!overwriteOriginals && QFile::exists(outputPath)
+            && !(manifest && manifest->contains(ExportCache::outputFileName(clip.filePath(), exportFormat)))) {
             existingFiles << outputFileName;
         }
 
         // Get fade state from project if available
         int fadeInFrames = 0;
         int fadeOutFrames = 0;
+        std::optional<ClipState> clipState;
         if (projectManager_.hasProject()) {
             std::string relativePath = clip.displayName();
             ClipState* state = projectManager_.project().findClipState(relativePath);
             if (state) {
                 fadeInFrames = state->fadeInFrames;
                 fadeOutFrames = state->fadeOutFrames;
+                clipState = *state;
             }
         }
 
-        items.push_back({clip, destFolder, outputPath.toStdString(), fadeInFrames, fadeOutFrames});
+        items.push_back({clip, destFolder, outputPath.toStdString(), fadeInFrames, fadeOutFrames, std::move(clipState)});
     }
 
     // If files exist and overwrite is off, ask user
@@ -1597,17 +2017,30 @@ void MainWindow::exportClips(const std::vector<int>& indices) {
 
     // Create watcher if needed
     if (!exportWatcher_) {
-        exportWatcher_ = new QFutureWatcher<int>(this);
-        connect(exportWatcher_, &QFutureWatcher<int>::finished,
+        exportWatcher_ = new QFutureWatcher<ExportOutcome>(this);
+        connect(exportWatcher_, &QFutureWatcher<ExportOutcome>::finished,
                 this, &MainWindow::onExportFinished);
     }
 
     // Capture engine pointer for the lambda
-    AudioEngine* engine = &engine_;
+    const AudioEngine* engine = &engine_;
+
+    exportRecorder_ = std::make_shared<BatchRecorder>("export", QThreadPool::globalInstance()->maxThreadCount());
+    auto recorder = exportRecorder_;
+
+    // Per-item result; cache fields are only set when a manifest is in use
+    struct ItemResult {
+        bool ok = false;
+        bool upToDate = false;
+        std::optional<SourceStamp> source;
+        uint64_t key = 0;
+    };
 
     // Run exports in parallel using all available CPU cores
-    QFuture<int> future = QtConcurrent::run(
-        [engine, items = std::move(items), exportFormat, bitrate, metadata]() {
+    QFuture<ExportOutcome> future = QtConcurrent::run(
+        [engine, recorder, manifest, items = std::move(items), exportFormat, bitrate, metadata]() {
+        WOOSH_TRACE_SCOPE("MainWindow::exportBatch");
+
         // Convert to QList for QtConcurrent::mapped
         QList<ExportItem> itemList;
         itemList.reserve(static_cast<qsizetype>(items.size()));
@@ -1615,43 +2048,149 @@ void MainWindow::exportClips(const std::vector<int>& indices) {
             itemList.append(std::move(item));
         }
 
-        // Map: export each file in parallel
-        QFuture<bool> mappedFuture = QtConcurrent::mapped(itemList,
-            [engine, exportFormat, bitrate, metadata](const ExportItem& item) -> bool {
-                switch (exportFormat) {
-                    case ExportFormat::MP3:
-                        return engine->exportMp3(item.clip, item.destFolder, bitrate, metadata, 
-                                                 item.fadeInFrames, item.fadeOutFrames);
-                    case ExportFormat::OGG:
-                        // OGG export not yet implemented, fall back to WAV
-                        return engine->exportWav(item.clip, item.destFolder, 
-                                                 item.fadeInFrames, item.fadeOutFrames);
-                    case ExportFormat::WAV:
-                    default:
-                        return engine->exportWav(item.clip, item.destFolder, 
-                                                 item.fadeInFrames, item.fadeOutFrames);
+        // Map: export each file in parallel; the manifest is only read here
+        const ExportManifest* cache = manifest.get();
+        QFuture<ItemResult> mappedFuture = QtConcurrent::mapped(itemList,
+            [engine, recorder, cache, exportFormat, bitrate, metadata](const ExportItem& item) -> ItemResult {
+                const FrameRanges::WorkerScope busy;
+                ItemResult result;
+                if (cache) {
+                    result.source = cache->sourceStamp(item.clip.filePath());
+                    if (result.source) {
+                        result.key = ExportCache::exportKey(result.source->contentHash,
+                                                            item.state ? &*item.state : nullptr,
+                                                            exportFormat, bitrate, metadata);
+                        const auto outputName = ExportCache::outputFileName(item.clip.filePath(), exportFormat);
+                        if (cache->isUpToDate(item.destFolder, outputName, result.key)) {
+                            result.ok = true;
+                            result.upToDate = true;
+                            return result;
+                        }
+                    }
+                }
+
+                StageTimer fileTimer(nullptr, "file");
+                std::optional<AudioClip> reloaded;
+                if (!item.clip.isResident()) {
+                    reloaded = ClipPipeline::reloadClip(*engine, item.clip, item.state ? &*item.state : nullptr,
+                                                        recorder.get());
+                }
+                const AudioClip& clip = reloaded ? *reloaded : item.clip;
+                std::string error;
+                if (clip.isResident()) {
+                    StageTimer timer(recorder.get(), "encode");
+                    result.ok = ClipPipeline::exportClip(*engine, clip, item.destFolder, exportFormat,
+                                                         bitrate, metadata, item.fadeInFrames, item.fadeOutFrames,
+                                                         &error);
+                } else {
+                    error = "source could not be reloaded";
                 }
+                if (!result.ok) qWarning("Export of %s failed: %s", item.clip.displayName().c_str(), error.c_str());
+                const QFileInfo written(QString::fromStdString(item.outputPath));
+                recorder->addFile(item.outputPath, result.ok ? static_cast<uint64_t>(written.size()) : 0,
+                                  fileTimer.elapsedMs(), result.ok);
+                return result;
             });
 
         // Wait for all exports to complete
         mappedFuture.waitForFinished();
 
-        // Count successes
-        int exported = 0;
-        for (bool success : mappedFuture.results()) {
-            if (success) ++exported;
+        // Count successes and record the new outputs
+        ExportOutcome outcome;
+        const QList<ItemResult> results = mappedFuture.results();
+        for (qsizetype i = 0; i < results.size(); ++i) {
+            const ItemResult& result = results[i];
+            if (result.upToDate) {
+                ++outcome.upToDate;
+                continue;
+            }
+            if (result.ok) ++outcome.exported;
+            if (!manifest) continue;
+
+            const ExportItem& item = itemList[i];
+            const auto outputName = ExportCache::outputFileName(item.clip.filePath(), exportFormat);
+            if (result.ok && result.source) {
+                manifest->record(item.destFolder, outputName, result.key, item.clip.filePath(), *result.source);
+            } else {
+                manifest->remove(outputName);
+            }
         }
-        return exported;
+        if (manifest && !itemList.isEmpty() && !manifest->save(itemList.front().destFolder)) {
+            qWarning("Could not write the export manifest to %s", itemList.front().destFolder.c_str());
+        }
+        return outcome;
     });
 
     exportWatcher_->setFuture(future);
 }
 
 void MainWindow::onExportFinished() {
+    WOOSH_TRACE_SCOPE("MainWindow::onExportFinished");
     progressBar_->setVisible(false);
 
     if (!exportWatcher_) return;
 
-    int exported = exportWatcher_->result();
-    statusBar()->showMessage(tr("Exported %1 clip(s)").arg(exported));
+    const ExportOutcome outcome = exportWatcher_->result();
+
+    if (exportRecorder_) {
+        storeBatchReport(exportRecorder_->finish());
+        exportRecorder_.reset();
+    }
+
+    if (outcome.upToDate > 0) {
+        statusBar()->showMessage(tr("Exported %1 clip(s), %2 already up to date")
+                                     .arg(outcome.exported).arg(outcome.upToDate));
+    } else {
+        statusBar()->showMessage(tr("Exported %1 clip(s)").arg(outcome.exported));
+    }
+}
+
+// ============================================================================
+// Batch performance report
+// ============================================================================
+
+void MainWindow::storeBatchReport(BatchReport report) {
+    auto existing = std::find_if(batchReports_.begin(), batchReports_.end(),
+        [&report](const BatchReport& r) { return r.operation == report.operation; });
+    if (existing != batchReports_.end()) {
+        *existing = std::move(report);
+    } else {
+        batchReports_.push_back(std::move(report));
+    }
+    batchReportAction_->setEnabled(true);
+}
+
+void MainWindow::onShowBatchReport() {
+    if (batchReports_.empty()) return;
+
+    QString text;
+    for (const auto& report : batchReports_) {
+        text += QString::fromStdString(report.toText()) + "\n";
+    }
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Batch Report"));
+    dialog.resize(640, 520);
+
+    auto* layout = new QVBoxLayout(&dialog);
+
+    auto* textView = new QPlainTextEdit(text, &dialog);
+    textView->setReadOnly(true);
+    textView->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    layout->addWidget(textView);
+
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Close, &dialog);
+    auto* saveBtn = buttons->addButton(tr("Save JSON..."), QDialogButtonBox::ActionRole);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    connect(saveBtn, &QPushButton::clicked, &dialog, [this, &dialog]() {
+        QString path = QFileDialog::getSaveFileName(&dialog, tr("Save Batch Report"),
+            lastOpenDirectory_ + "/woosh-report.json", tr("JSON Files (*.json)"));
+        if (path.isEmpty()) return;
+        if (!writeBatchReportsJson(path.toStdString(), batchReports_)) {
+            QMessageBox::warning(&dialog, tr("Save Failed"), tr("Could not write %1").arg(path));
+        }
+    });
+    layout->addWidget(buttons);
+
+    dialog.exec();
 }
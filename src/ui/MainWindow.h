@@ -13,11 +13,16 @@
 #include <QStringList>
 #include <QFutureWatcher>
 #include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "audio/AudioClip.h"
 #include "audio/AudioEngine.h"
+#include "core/MemoryGovernor.h"
 #include "core/ProjectManager.h"
+#include "utils/BatchReport.h"
 
 class QTableView;
 class QSortFilterProxyModel;
@@ -35,6 +40,12 @@ class TransportPanel;
 class WaveformView;
 class VuMeterWidget;
 
+/** @brief Result of a background export batch. */
+struct ExportOutcome {
+    int exported{0};    ///< Clips encoded and written
+    int upToDate{0};    ///< Clips skipped because their output was unchanged
+};
+
 /**
  * @class MainWindow
  * @brief The main application window for Woosh.
@@ -66,6 +77,10 @@ private Q_SLOTS:
     void openRecentFile();
     void openRecentFolder();
 
+    // Processing actions - auto-trim
+    void onAutoTrimSelected();
+    void onAutoTrimAll();
+
     // Processing actions - normalize
     void onNormalizeSelected();
     void onNormalizeAll();
@@ -74,6 +89,10 @@ private Q_SLOTS:
     void onCompressSelected();
     void onCompressAll();
 
+    // Processing actions - limit
+    void onLimitSelected();
+    void onLimitAll();
+
     // Edit mode changed
     void onEditModeChanged(bool isFadeMode);
     void onFadeChanged(int fadeInFrames, int fadeOutFrames);
@@ -102,8 +121,12 @@ private Q_SLOTS:
     // Settings
     void onClearHistory();
 
+    // Performance report of the most recent batches
+    void onShowBatchReport();
+
     // Async loading/export completion
     void onLoadingFinished();
+    void onReloadFinished();
     void onExportFinished();
     void onProcessingFinished();
 
@@ -123,7 +146,6 @@ private:
     void updateRecentProjectsMenu();
     bool maybeSaveProject();
     void loadProjectClips();
-    void applyClipState(AudioClip& clip, const ClipState& state);
 
     // Recent files/folders management (legacy)
     void addRecentFile(const QString& path);
@@ -133,7 +155,8 @@ private:
     void clearRecentHistory();
 
     void loadFileList(const QStringList& paths);
-    void applyProcessing(const std::vector<int>& indices, bool normalize, bool compress);
+    void applyProcessing(const std::vector<int>& indices, bool normalize, bool compress, bool limit = false,
+                         bool autoTrim = false);
     void exportClips(const std::vector<int>& indices);
     [[nodiscard]] std::vector<int> selectedIndices() const;
     [[nodiscard]] std::vector<int> allIndices() const;
@@ -143,17 +166,36 @@ private:
     void updateTimeDisplay();
     void refreshModelPreservingSelection();
     void selectRows(const std::vector<int>& indices);
+    void storeBatchReport(BatchReport report);
+    void applyCompactSamples(bool compact);
+
+    // Clip info cached in the project, for listing clips before they are decoded
+    static void storeClipInfo(const AudioClip& clip, ClipInfo& info);
+    void updateCachedClipInfo();
+
+    // Memory budget: reload evicted clips on use, spill or evict the least recently used
+    void reloadInBackground(size_t index);
+    [[nodiscard]] bool canEvictClip(size_t index) const;
+    bool releaseClip(size_t index);
+    void enforceMemoryBudget();
+    void updateMemoryStatus();
 
     // --- Data ---
     AudioEngine engine_;
     std::vector<AudioClip> clips_;
+    MemoryGovernor memoryGovernor_;   // Resident bytes of clips_, by index
+    std::string spillDirectory_;      // Created on first spill
     ProjectManager projectManager_;
 
     // --- Async operations ---
     QFutureWatcher<std::vector<AudioClip>>* loadWatcher_ = nullptr;
-    QFutureWatcher<int>* exportWatcher_ = nullptr;
+    QFutureWatcher<ExportOutcome>* exportWatcher_ = nullptr;
     QFutureWatcher<std::vector<AudioClip>>* processWatcher_ = nullptr;
+    QFutureWatcher<std::optional<AudioClip>>* reloadWatcher_ = nullptr;
+    size_t reloadRow_{0};                 // Row of the clip being reloaded
+    std::string reloadPath_;              // Its source, to tell whether the row still holds it
     std::vector<int> processingIndices_;  // Tracks which indices were processed
+    std::unordered_map<std::string, size_t> pendingRows_;  // Listed from cached info, loading: path -> row
     
     // Processing state for async completion
     bool processingAppliedNormalize_{false};
@@ -164,6 +206,15 @@ private:
     float processingCompAttackMs_{10.0f};
     float processingCompReleaseMs_{100.0f};
     float processingCompMakeupDb_{0.0f};
+    bool processingAppliedLimit_{false};
+    DSP::LimiterSettings processingLimiter_{-1.0f, 5.0f, 50.0f};
+    bool processingAppliedAutoTrim_{false};
+
+    // Timing of the running batches, finished into reports on completion
+    std::shared_ptr<BatchRecorder> loadRecorder_;
+    std::shared_ptr<BatchRecorder> processRecorder_;
+    std::shared_ptr<BatchRecorder> exportRecorder_;
+    std::vector<BatchReport> batchReports_;  // Latest report per operation
 
     // --- Settings ---
     QString lastOpenDirectory_;
@@ -172,6 +223,8 @@ private:
     QStringList recentFolders_;
     std::unique_ptr<QSettings> settings_;
     bool showColumnTooltips_{true};
+    bool compactSamples_{false};   // Keep loaded clips as 16-bit samples
+    uint64_t memoryBudgetMb_{0};   // 0 = unlimited
 
     static constexpr int kMaxRecentItems = 10;
 
@@ -187,6 +240,7 @@ private:
     VuMeterWidget* vuMeter_ = nullptr;
 
     QLabel* statusLabel_ = nullptr;
+    QLabel* memoryLabel_ = nullptr;
     QProgressBar* progressBar_ = nullptr;
 
     // Audio playback
@@ -207,5 +261,6 @@ private:
     QAction* openFolderAction_ = nullptr;
     QAction* settingsAction_ = nullptr;
     QAction* undoAction_ = nullptr;
+    QAction* batchReportAction_ = nullptr;
     QAction* exitAction_ = nullptr;
 };
@@ -21,6 +21,44 @@ ProcessingPanel::ProcessingPanel(QWidget* parent)
 void ProcessingPanel::setupUi() {
     auto* mainLayout = new QVBoxLayout(this);
 
+    // --- Auto-trim section ---
+    auto* trimLabel = new QLabel(tr("<b>Auto-Trim</b>"), this);
+    mainLayout->addWidget(trimLabel);
+
+    auto* trimForm = new QFormLayout();
+    trimForm->setContentsMargins(10, 0, 0, 0);
+
+    silenceThresholdEdit_ = new QLineEdit("-50.0", this);
+    silenceThresholdEdit_->setToolTip(tr("Audio quieter than this (RMS, dBFS) counts as silence"));
+    silenceThresholdEdit_->setFixedWidth(60);
+    trimForm->addRow(tr("Threshold (dBFS):"), silenceThresholdEdit_);
+
+    preRollEdit_ = new QLineEdit("10.0", this);
+    preRollEdit_->setToolTip(tr("Silence to keep before the sound starts"));
+    preRollEdit_->setFixedWidth(60);
+    trimForm->addRow(tr("Pre-roll (ms):"), preRollEdit_);
+
+    postRollEdit_ = new QLineEdit("100.0", this);
+    postRollEdit_->setToolTip(tr("Silence to keep after the sound ends, so tails can decay"));
+    postRollEdit_->setFixedWidth(60);
+    trimForm->addRow(tr("Post-roll (ms):"), postRollEdit_);
+
+    mainLayout->addLayout(trimForm);
+
+    // Auto-trim buttons
+    auto* trimBtnLayout = new QHBoxLayout();
+    trimBtnLayout->setContentsMargins(10, 0, 0, 0);
+    autoTrimSelectedBtn_ = new QPushButton(tr("Auto-Trim Selected"), this);
+    autoTrimSelectedBtn_->setToolTip(tr("Trim leading and trailing silence from selected clips"));
+    trimBtnLayout->addWidget(autoTrimSelectedBtn_);
+    autoTrimAllBtn_ = new QPushButton(tr("Auto-Trim All"), this);
+    autoTrimAllBtn_->setToolTip(tr("Trim leading and trailing silence from all clips"));
+    trimBtnLayout->addWidget(autoTrimAllBtn_);
+    trimBtnLayout->addStretch();
+    mainLayout->addLayout(trimBtnLayout);
+
+    mainLayout->addSpacing(10);
+
     // --- Normalize section ---
     auto* normLabel = new QLabel(tr("<b>Normalize</b>"), this);
     mainLayout->addWidget(normLabel);
@@ -96,13 +134,73 @@ void ProcessingPanel::setupUi() {
     compBtnLayout->addStretch();
     mainLayout->addLayout(compBtnLayout);
 
+    mainLayout->addSpacing(10);
+
+    // --- Limiter section ---
+    auto* limLabel = new QLabel(tr("<b>Limiter</b>"), this);
+    mainLayout->addWidget(limLabel);
+
+    auto* limForm = new QFormLayout();
+    limForm->setContentsMargins(10, 0, 0, 0);
+
+    ceilingEdit_ = new QLineEdit("-1.0", this);
+    ceilingEdit_->setToolTip(tr("No sample will exceed this level (dBFS)"));
+    ceilingEdit_->setFixedWidth(60);
+    limForm->addRow(tr("Ceiling (dBFS):"), ceilingEdit_);
+
+    lookaheadEdit_ = new QLineEdit("5.0", this);
+    lookaheadEdit_->setToolTip(tr("How far ahead peaks are detected; the gain ramps down over this time"));
+    lookaheadEdit_->setFixedWidth(60);
+    limForm->addRow(tr("Look-ahead (ms):"), lookaheadEdit_);
+
+    limiterReleaseEdit_ = new QLineEdit("50.0", this);
+    limiterReleaseEdit_->setToolTip(tr("Release time in milliseconds"));
+    limiterReleaseEdit_->setFixedWidth(60);
+    limForm->addRow(tr("Release (ms):"), limiterReleaseEdit_);
+
+    mainLayout->addLayout(limForm);
+
+    // Limit buttons
+    auto* limBtnLayout = new QHBoxLayout();
+    limBtnLayout->setContentsMargins(10, 0, 0, 0);
+    limitSelectedBtn_ = new QPushButton(tr("Limit Selected"), this);
+    limitSelectedBtn_->setToolTip(tr("Apply the limiter to selected clips"));
+    limBtnLayout->addWidget(limitSelectedBtn_);
+    limitAllBtn_ = new QPushButton(tr("Limit All"), this);
+    limitAllBtn_->setToolTip(tr("Apply the limiter to all clips"));
+    limBtnLayout->addWidget(limitAllBtn_);
+    limBtnLayout->addStretch();
+    mainLayout->addLayout(limBtnLayout);
+
     mainLayout->addStretch();
 
     // --- Connections ---
+    connect(autoTrimSelectedBtn_, &QPushButton::clicked, this, &ProcessingPanel::autoTrimSelectedRequested);
+    connect(autoTrimAllBtn_, &QPushButton::clicked, this, &ProcessingPanel::autoTrimAllRequested);
     connect(normalizeSelectedBtn_, &QPushButton::clicked, this, &ProcessingPanel::normalizeSelectedRequested);
     connect(normalizeAllBtn_, &QPushButton::clicked, this, &ProcessingPanel::normalizeAllRequested);
     connect(compressSelectedBtn_, &QPushButton::clicked, this, &ProcessingPanel::compressSelectedRequested);
     connect(compressAllBtn_, &QPushButton::clicked, this, &ProcessingPanel::compressAllRequested);
+    connect(limitSelectedBtn_, &QPushButton::clicked, this, &ProcessingPanel::limitSelectedRequested);
+    connect(limitAllBtn_, &QPushButton::clicked, this, &ProcessingPanel::limitAllRequested);
+}
+
+float ProcessingPanel::autoTrimThresholdDb() const {
+    bool ok = false;
+    float val = silenceThresholdEdit_->text().toFloat(&ok);
+    return ok ? val : -50.0f;
+}
+
+float ProcessingPanel::autoTrimPreRollMs() const {
+    bool ok = false;
+    float val = preRollEdit_->text().toFloat(&ok);
+    return ok ? val : 10.0f;
+}
+
+float ProcessingPanel::autoTrimPostRollMs() const {
+    bool ok = false;
+    float val = postRollEdit_->text().toFloat(&ok);
+    return ok ? val : 100.0f;
 }
 
 double ProcessingPanel::normalizeTarget() const {
@@ -141,3 +239,21 @@ float ProcessingPanel::compMakeupDb() const {
     return ok ? val : 0.0f;
 }
 
+float ProcessingPanel::limiterCeilingDb() const {
+    bool ok = false;
+    float val = ceilingEdit_->text().toFloat(&ok);
+    return ok ? val : -1.0f;
+}
+
+float ProcessingPanel::limiterLookaheadMs() const {
+    bool ok = false;
+    float val = lookaheadEdit_->text().toFloat(&ok);
+    return ok ? val : 5.0f;
+}
+
+float ProcessingPanel::limiterReleaseMs() const {
+    bool ok = false;
+    float val = limiterReleaseEdit_->text().toFloat(&ok);
+    return ok ? val : 50.0f;
+}
+
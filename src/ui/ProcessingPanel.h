@@ -1,9 +1,10 @@
 /**
  * @file ProcessingPanel.h
- * @brief Panel widget containing normalize and compressor controls with apply buttons.
+ * @brief Panel widget containing auto-trim, normalize, compressor and limiter controls with apply buttons.
  *
- * This panel provides input fields for normalization target and compressor parameters,
- * plus separate buttons to apply normalization or compression independently.
+ * This panel provides input fields for the silence threshold and roll, normalization
+ * target, compressor and limiter parameters, plus separate buttons to apply each
+ * operation independently.
  */
 
 #pragma once
@@ -15,9 +16,9 @@ class QPushButton;
 
 /**
  * @class ProcessingPanel
- * @brief A grouped panel for audio processing controls (normalize, compress).
+ * @brief A grouped panel for audio processing controls (auto-trim, normalize, compress, limit).
  *
- * Emits signals when the user clicks normalize or compress buttons.
+ * Emits signals when the user clicks auto-trim, normalize, compress or limit buttons.
  * Operations can be applied to selected clips or all clips independently.
  */
 class ProcessingPanel final : public QGroupBox {
@@ -32,6 +33,15 @@ public:
 
     // --- Accessors for current parameter values ---
 
+    /** @brief Get the auto-trim silence threshold in dBFS. */
+    [[nodiscard]] float autoTrimThresholdDb() const;
+
+    /** @brief Get the silence kept before the sound, in milliseconds. */
+    [[nodiscard]] float autoTrimPreRollMs() const;
+
+    /** @brief Get the silence kept after the sound, in milliseconds. */
+    [[nodiscard]] float autoTrimPostRollMs() const;
+
     /** @brief Get the normalize target in dBFS. */
     [[nodiscard]] double normalizeTarget() const;
 
@@ -50,7 +60,26 @@ public:
     /** @brief Get the compressor makeup gain in dB. */
     [[nodiscard]] float compMakeupDb() const;
 
+    /** @brief Get the limiter ceiling in dBFS. */
+    [[nodiscard]] float limiterCeilingDb() const;
+
+    /** @brief Get the limiter look-ahead in milliseconds. */
+    [[nodiscard]] float limiterLookaheadMs() const;
+
+    /** @brief Get the limiter release time in milliseconds. */
+    [[nodiscard]] float limiterReleaseMs() const;
+
 Q_SIGNALS:
+    /**
+     * @brief Emitted when user clicks "Auto-Trim Selected".
+     */
+    void autoTrimSelectedRequested();
+
+    /**
+     * @brief Emitted when user clicks "Auto-Trim All".
+     */
+    void autoTrimAllRequested();
+
     /**
      * @brief Emitted when user clicks "Normalize Selected".
      */
@@ -71,9 +100,26 @@ Q_SIGNALS:
      */
     void compressAllRequested();
 
+    /**
+     * @brief Emitted when user clicks "Limit Selected".
+     */
+    void limitSelectedRequested();
+
+    /**
+     * @brief Emitted when user clicks "Limit All".
+     */
+    void limitAllRequested();
+
 private:
     void setupUi();
 
+    // Auto-trim controls
+    QLineEdit* silenceThresholdEdit_ = nullptr;
+    QLineEdit* preRollEdit_ = nullptr;
+    QLineEdit* postRollEdit_ = nullptr;
+    QPushButton* autoTrimSelectedBtn_ = nullptr;
+    QPushButton* autoTrimAllBtn_ = nullptr;
+
     // Normalize controls
     QLineEdit* normalizeTargetEdit_ = nullptr;
     QPushButton* normalizeSelectedBtn_ = nullptr;
@@ -87,5 +133,12 @@ private:
     QLineEdit* makeupEdit_ = nullptr;
     QPushButton* compressSelectedBtn_ = nullptr;
     QPushButton* compressAllBtn_ = nullptr;
+
+    // Limiter controls
+    QLineEdit* ceilingEdit_ = nullptr;
+    QLineEdit* lookaheadEdit_ = nullptr;
+    QLineEdit* limiterReleaseEdit_ = nullptr;
+    QPushButton* limitSelectedBtn_ = nullptr;
+    QPushButton* limitAllBtn_ = nullptr;
 };
 
@@ -13,6 +13,7 @@
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QVBoxLayout>
 
 SettingsDialog::SettingsDialog(QWidget* parent)
@@ -49,6 +50,29 @@ void SettingsDialog::setupUi() {
 
     mainLayout->addWidget(uiGroup);
 
+    // --- Memory section ---
+    auto* memoryGroup = new QGroupBox(tr("Memory"), this);
+    auto* memoryLayout = new QVBoxLayout(memoryGroup);
+
+    compactSamplesCheck_ = new QCheckBox(tr("Keep clips in memory as 16-bit samples"), this);
+    compactSamplesCheck_->setToolTip(tr("Halves the memory used by loaded clips. 16-bit sources are kept exactly; "
+                                        "processed audio is stored with a scale per block of samples"));
+    memoryLayout->addWidget(compactSamplesCheck_);
+
+    auto* budgetLayout = new QFormLayout();
+    memoryBudgetSpin_ = new QSpinBox(this);
+    memoryBudgetSpin_->setRange(0, 1024 * 1024);
+    memoryBudgetSpin_->setSingleStep(256);
+    memoryBudgetSpin_->setSuffix(tr(" MB"));
+    memoryBudgetSpin_->setSpecialValueText(tr("Unlimited"));
+    memoryBudgetSpin_->setToolTip(tr("Memory for loaded clips. Beyond it the least recently used clips are released "
+                                     "and reloaded from their files when needed; clips with unsaved processing "
+                                     "outside a project are kept"));
+    budgetLayout->addRow(tr("Budget:"), memoryBudgetSpin_);
+    memoryLayout->addLayout(budgetLayout);
+
+    mainLayout->addWidget(memoryGroup);
+
     // --- History section ---
     auto* historyGroup = new QGroupBox(tr("History"), this);
     auto* historyLayout = new QVBoxLayout(historyGroup);
@@ -91,6 +115,22 @@ void SettingsDialog::setDefaultAuthorName(const QString& name) {
     authorNameEdit_->setText(name);
 }
 
+bool SettingsDialog::compactSamples() const {
+    return compactSamplesCheck_->isChecked();
+}
+
+void SettingsDialog::setCompactSamples(bool compact) {
+    compactSamplesCheck_->setChecked(compact);
+}
+
+int SettingsDialog::memoryBudgetMb() const {
+    return memoryBudgetSpin_->value();
+}
+
+void SettingsDialog::setMemoryBudgetMb(int megabytes) {
+    memoryBudgetSpin_->setValue(megabytes);
+}
+
 void SettingsDialog::onClearHistoryClicked() {
     auto result = QMessageBox::question(
         this,
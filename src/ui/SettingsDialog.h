@@ -9,6 +9,7 @@
 
 class QCheckBox;
 class QLineEdit;
+class QSpinBox;
 class QPushButton;
 
 /**
@@ -18,6 +19,8 @@ class QPushButton;
  * Settings include:
  *  - Default author name for new projects
  *  - Show/hide column tooltips
+ *  - Keep loaded clips as 16-bit samples
+ *  - Memory budget for loaded clips
  *  - Clear recent folders/files history
  */
 class SettingsDialog final : public QDialog {
@@ -32,6 +35,13 @@ public:
     [[nodiscard]] QString defaultAuthorName() const;
     void setDefaultAuthorName(const QString& name);
 
+    [[nodiscard]] bool compactSamples() const;
+    void setCompactSamples(bool compact);
+
+    /** @brief Memory budget in MB; 0 is unlimited. */
+    [[nodiscard]] int memoryBudgetMb() const;
+    void setMemoryBudgetMb(int megabytes);
+
 Q_SIGNALS:
     /** @brief Emitted when user clicks Clear History. */
     void clearHistoryRequested();
@@ -42,6 +52,8 @@ private:
 
     QLineEdit* authorNameEdit_ = nullptr;
     QCheckBox* tooltipsCheck_ = nullptr;
+    QCheckBox* compactSamplesCheck_ = nullptr;
+    QSpinBox* memoryBudgetSpin_ = nullptr;
     QPushButton* clearHistoryBtn_ = nullptr;
 };
 
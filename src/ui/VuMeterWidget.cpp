@@ -1,8 +1,11 @@
 #include "VuMeterWidget.h"
 
+#include <QMouseEvent>
 #include <QPainter>
 #include <QTimer>
 #include <QtMath>
+#include <algorithm>
+#include <cmath>
 
 constexpr float VuMeterWidget::kAttackCoeff = 0.4f;
 constexpr float VuMeterWidget::kReleaseCoeff = 0.15f;
@@ -10,9 +13,11 @@ constexpr float VuMeterWidget::kPeakFalloffCoeff = 0.2f;
 
 VuMeterWidget::VuMeterWidget(QWidget* parent)
     : QFrame(parent)
+    , channels_(2)
 {
     setMinimumSize(70, 200);
     setFixedWidth(70);
+    setToolTip(tr("Click to switch between peak and loudness (LUFS)"));
 
     timer_ = new QTimer(this);
     timer_->setInterval(kUpdateIntervalMs);
@@ -21,22 +26,46 @@ VuMeterWidget::VuMeterWidget(QWidget* parent)
     elapsed_.start();
 }
 
-void VuMeterWidget::setLevels(float left, float right) {
-    left = std::clamp(left, 0.0f, 1.0f);
-    right = std::clamp(right, 0.0f, 1.0f);
+void VuMeterWidget::setMode(Mode mode) {
+    if (mode_ == mode) return;
+    mode_ = mode;
+    update();
+}
 
-    targetLeft_ = left;
-    targetRight_ = right;
+void VuMeterWidget::setLevels(const QVector<float>& levels) {
+    // Keep the current layout when the player reports no signal
+    if (!levels.isEmpty() && static_cast<size_t>(levels.size()) != channels_.size()) {
+        channels_.assign(static_cast<size_t>(levels.size()), ChannelLevel{});
+    }
 
     const qint64 now = elapsed_.elapsed();
-    if (left > peakLeft_) {
-        peakLeft_ = left;
-        lastPeakLeftMs_ = now;
+    for (size_t ch = 0; ch < channels_.size(); ++ch) {
+        const float level = ch < static_cast<size_t>(levels.size())
+            ? std::clamp(levels[static_cast<qsizetype>(ch)], 0.0f, 1.0f)
+            : 0.0f;
+
+        ChannelLevel& meter = channels_[ch];
+        meter.target = level;
+        if (level > meter.peak) {
+            meter.peak = level;
+            meter.lastPeakMs = now;
+        }
     }
-    if (right > peakRight_) {
-        peakRight_ = right;
-        lastPeakRightMs_ = now;
+}
+
+void VuMeterWidget::setLoudness(float momentaryLufs, float shortTermLufs, float integratedLufs) {
+    momentaryLufs_ = momentaryLufs;
+    shortTermLufs_ = shortTermLufs;
+    integratedLufs_ = integratedLufs;
+}
+
+void VuMeterWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        setMode(mode_ == Mode::Peak ? Mode::Loudness : Mode::Peak);
+        event->accept();
+        return;
     }
+    QFrame::mousePressEvent(event);
 }
 
 void VuMeterWidget::onUpdate() {
@@ -52,15 +81,12 @@ void VuMeterWidget::onUpdate() {
         }
     };
 
-    currentLeft_ = smooth(currentLeft_, targetLeft_, kAttackCoeff, kReleaseCoeff);
-    currentRight_ = smooth(currentRight_, targetRight_, kAttackCoeff, kReleaseCoeff);
-
-    if (now - lastPeakLeftMs_ > kPeakHoldMs) {
-        peakLeft_ = smooth(peakLeft_, currentLeft_, kPeakFalloffCoeff, kPeakFalloffCoeff);
-    }
+    for (ChannelLevel& meter : channels_) {
+        meter.current = smooth(meter.current, meter.target, kAttackCoeff, kReleaseCoeff);
 
-    if (now - lastPeakRightMs_ > kPeakHoldMs) {
-        peakRight_ = smooth(peakRight_, currentRight_, kPeakFalloffCoeff, kPeakFalloffCoeff);
+        if (now - meter.lastPeakMs > kPeakHoldMs) {
+            meter.peak = smooth(meter.peak, meter.current, kPeakFalloffCoeff, kPeakFalloffCoeff);
+        }
     }
 
     update();
@@ -85,15 +111,18 @@ void VuMeterWidget::paintEvent(QPaintEvent* event) {
     const QRectF r = rect();
     p.fillRect(r, QColor(30, 30, 30));
 
-    // Layout: [scale labels] [left bar] [right bar]
-    const int topMargin = 18;    // space for peak dB readout
-    const int bottomMargin = 4;
+    const bool loudnessMode = (mode_ == Mode::Loudness);
+
+    // Layout: [scale labels] [one bar per channel] or [momentary] [short-term]
+    const int barCount = loudnessMode ? 2 : std::max(1, static_cast<int>(channels_.size()));
+    const int topMargin = 18;    // space for peak dB / integrated LUFS readout
+    const int bottomMargin = loudnessMode ? 14 : 4;  // M/S captions
     const int leftMargin = 28;   // space for dB scale labels
     const int rightMargin = 4;
     const int barSpacing = 2;
 
     const int barAreaWidth = r.width() - leftMargin - rightMargin;
-    const int barWidth = (barAreaWidth - barSpacing) / 2;
+    const int barWidth = (barAreaWidth - barSpacing * (barCount - 1)) / barCount;
     const int barHeight = r.height() - topMargin - bottomMargin;
 
     if (barWidth <= 0 || barHeight <= 0) return;
@@ -110,6 +139,12 @@ void VuMeterWidget::paintEvent(QPaintEvent* event) {
         return (db - minDb) / (maxDb - minDb);
     };
 
+    // LUFS share the same scale (LU relative to full scale)
+    auto lufsToDbPos = [minDb, maxDb](float lufs) -> float {
+        if (!std::isfinite(lufs)) return 0.0f;
+        return (std::clamp(lufs, minDb, maxDb) - minDb) / (maxDb - minDb);
+    };
+
     // Draw dB scale labels and tick marks on the left
     p.setFont(QFont("Arial", 7));
     p.setPen(QColor(180, 180, 180));
@@ -129,14 +164,13 @@ void VuMeterWidget::paintEvent(QPaintEvent* event) {
     }
 
     // Draw bars with gradient coloring
-    auto drawBar = [&](float level, float peak, int xOffset) {
+    auto drawBar = [&](float dbPos, float peakDbPos, int xOffset) {
         QRectF barRect(leftMargin + xOffset, topMargin, barWidth, barHeight);
 
         // Background
         p.fillRect(barRect, QColor(20, 20, 20));
 
         // Level fill from bottom up using dB scale
-        const float dbPos = linearToDbPos(level);
         const float h = barHeight * dbPos;
 
         if (h > 0) {
@@ -153,7 +187,6 @@ void VuMeterWidget::paintEvent(QPaintEvent* event) {
         }
 
         // Peak indicator line
-        const float peakDbPos = linearToDbPos(peak);
         if (peakDbPos > 0.01f) {
             const qreal peakY = barRect.bottom() - barHeight * peakDbPos;
             p.setPen(QPen(Qt::white, 2));
@@ -161,17 +194,45 @@ void VuMeterWidget::paintEvent(QPaintEvent* event) {
         }
     };
 
-    drawBar(currentLeft_, peakLeft_, 0);
-    drawBar(currentRight_, peakRight_, barWidth + barSpacing);
+    p.setFont(QFont("Arial", 9, QFont::Bold));
 
-    // Draw peak dB readout at top
-    float peakDb = 20.0f * std::log10(std::max(peakLeft_, peakRight_) + 0.0001f);
-    peakDb = std::clamp(peakDb, minDb, maxDb);
+    if (loudnessMode) {
+        // Short-term doubles as the hold marker on the momentary bar
+        drawBar(lufsToDbPos(momentaryLufs_), lufsToDbPos(shortTermLufs_), 0);
+        drawBar(lufsToDbPos(shortTermLufs_), 0.0f, barWidth + barSpacing);
+
+        p.setFont(QFont("Arial", 7));
+        p.setPen(QColor(180, 180, 180));
+        const int captionY = topMargin + barHeight + 1;
+        p.drawText(QRect(leftMargin, captionY, barWidth, 12), Qt::AlignCenter, QStringLiteral("M"));
+        p.drawText(QRect(leftMargin + barWidth + barSpacing, captionY, barWidth, 12),
+                   Qt::AlignCenter, QStringLiteral("S"));
+
+        // Integrated loudness readout at top
+        p.setFont(QFont("Arial", 9, QFont::Bold));
+        p.setPen(QColor(200, 200, 200));
+        const QString integratedText = std::isfinite(integratedLufs_)
+            ? QString::number(std::max(integratedLufs_, -99.9f), 'f', 1)
+            : QStringLiteral("--");
+        p.drawText(QRect(0, 2, r.width(), 14), Qt::AlignHCenter | Qt::AlignTop,
+                   QStringLiteral("I ") + integratedText);
+    } else {
+        float maxPeak = 0.0f;
+        for (size_t ch = 0; ch < channels_.size(); ++ch) {
+            const ChannelLevel& meter = channels_[ch];
+            drawBar(linearToDbPos(meter.current), linearToDbPos(meter.peak),
+                    static_cast<int>(ch) * (barWidth + barSpacing));
+            maxPeak = std::max(maxPeak, meter.peak);
+        }
 
-    p.setFont(QFont("Arial", 9, QFont::Bold));
-    p.setPen(peakDb > -6.0f ? QColor(255, 80, 80) : QColor(200, 200, 200));
-    QString peakText = QString::number(peakDb, 'f', 1);
-    p.drawText(QRect(0, 2, r.width(), 14), Qt::AlignHCenter | Qt::AlignTop, peakText);
+        // Draw peak dB readout at top
+        float peakDb = 20.0f * std::log10(maxPeak + 0.0001f);
+        peakDb = std::clamp(peakDb, minDb, maxDb);
+
+        p.setPen(peakDb > -6.0f ? QColor(255, 80, 80) : QColor(200, 200, 200));
+        QString peakText = QString::number(peakDb, 'f', 1);
+        p.drawText(QRect(0, 2, r.width(), 14), Qt::AlignHCenter | Qt::AlignTop, peakText);
+    }
 
     // Draw 3D sunken border effect with high contrast
     const int w = static_cast<int>(r.width());
@@ -2,6 +2,9 @@
 
 #include <QElapsedTimer>
 #include <QFrame>
+#include <QVector>
+#include <limits>
+#include <vector>
 
 class QTimer;
 
@@ -9,33 +12,47 @@ class VuMeterWidget final : public QFrame {
     Q_OBJECT
 
 public:
+    /// What the bars display; clicking the meter toggles between the two.
+    enum class Mode {
+        Peak,       ///< Smoothed sample peak per channel
+        Loudness    ///< Momentary and short-term LUFS with integrated readout
+    };
+
     explicit VuMeterWidget(QWidget* parent = nullptr);
 
+    [[nodiscard]] Mode mode() const { return mode_; }
+    void setMode(Mode mode);
+
 public Q_SLOTS:
-    void setLevels(float left, float right);
+    void setLevels(const QVector<float>& levels);
+    void setLoudness(float momentaryLufs, float shortTermLufs, float integratedLufs);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
 
 private Q_SLOTS:
     void onUpdate();
 
 private:
-    float targetLeft_ = 0.0f;
-    float targetRight_ = 0.0f;
+    struct ChannelLevel {
+        float target = 0.0f;
+        float current = 0.0f;
+        float peak = 0.0f;
+        qint64 lastPeakMs = 0;
+    };
 
-    float currentLeft_ = 0.0f;
-    float currentRight_ = 0.0f;
+    Mode mode_ = Mode::Peak;
 
-    float peakLeft_ = 0.0f;
-    float peakRight_ = 0.0f;
+    std::vector<ChannelLevel> channels_;  ///< One per channel, stereo until told otherwise
+
+    float momentaryLufs_ = -std::numeric_limits<float>::infinity();
+    float shortTermLufs_ = -std::numeric_limits<float>::infinity();
+    float integratedLufs_ = -std::numeric_limits<float>::infinity();
 
     QTimer* timer_ = nullptr;
     QElapsedTimer elapsed_;
 
-    qint64 lastPeakLeftMs_ = 0;
-    qint64 lastPeakRightMs_ = 0;
-
     static constexpr int kUpdateIntervalMs = 30;
     static constexpr int kPeakHoldMs = 600;
     static const float kAttackCoeff;
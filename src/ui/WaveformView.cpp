@@ -1,10 +1,11 @@
 /**
  * @file WaveformView.cpp
- * @brief Implementation of WaveformView widget with stereo display.
+ * @brief Implementation of WaveformView widget with per-channel lanes.
  */
 
 #include "WaveformView.h"
 #include "audio/AudioClip.h"
+#include "utils/SpeakerLayout.h"
 
 #include <QPainter>
 #include <QPaintEvent>
@@ -15,8 +16,6 @@
 #include <QtMath>
 #include <algorithm>
 #include <cmath>
-#include <execution>
-#include <numeric>
 
 // ============================================================================
 // Construction
@@ -180,6 +179,12 @@ void WaveformView::clearPlayhead() {
     update();
 }
 
+size_t WaveformView::cacheBytes() const {
+    size_t bytes = 0;
+    for (const auto& columns : channelCache_) bytes += columns.capacity() * sizeof(WaveformColumn);
+    return bytes;
+}
+
 // ============================================================================
 // Paint event
 // ============================================================================
@@ -197,7 +202,7 @@ void WaveformView::paintEvent(QPaintEvent* event) {
 
     drawBackground(painter, waveformRect);
 
-    if (!clip_ || clip_->samples().empty()) {
+    if (!clip_ || clip_->frameCount() == 0) {
         painter.setPen(QColor(80, 80, 90));
         QFont f = painter.font();
         f.setPointSize(11);
@@ -232,13 +237,13 @@ void WaveformView::drawBackground(QPainter& painter, const QRect& rect) {
     painter.fillRect(rect, QColor(28, 30, 38));
 
     int channels = clip_ ? clip_->channels() : 1;
-    if (channels >= 2) {
-        // Stereo: draw channel separator
-        int halfHeight = rect.height() / 2;
+    const auto lanes = computeWaveformLanes(channels, rect.top(), rect.height(), kChannelGap);
 
-        // Channel separator line
-        painter.setPen(QColor(55, 60, 75));
-        painter.drawLine(rect.left(), rect.top() + halfHeight, rect.right(), rect.top() + halfHeight);
+    // Channel separator lines, in the gap above each lane but the first
+    painter.setPen(QColor(55, 60, 75));
+    for (size_t c = 1; c < lanes.size(); ++c) {
+        const int y = lanes[c].top - kChannelGap / 2;
+        painter.drawLine(rect.left(), y, rect.right(), y);
     }
 }
 
@@ -248,79 +253,18 @@ void WaveformView::drawBackground(QPainter& painter, const QRect& rect) {
 
 void WaveformView::computeWaveformCache() {
     channelCache_.clear();
-    if (!clip_ || clip_->samples().empty()) {
+    if (!clip_ || clip_->frameCount() == 0) {
         cacheValid_ = true;
         return;
     }
 
-    const auto& samples = clip_->samples();
-    int channels = clip_->channels();
-    size_t frameCount = clip_->frameCount();
-    int widgetWidth = width();
-
-    channelCache_.resize(channels);
-    for (int ch = 0; ch < channels; ++ch) {
-        channelCache_[ch].resize(widgetWidth);
-    }
-
-    // Threshold for parallel execution (overhead not worth it for small displays)
-    constexpr int kParallelThreshold = 200;
-
-    if (widgetWidth >= kParallelThreshold) {
-        // Parallel waveform computation - each column is independent
-        std::vector<int> columnIndices(widgetWidth);
-        std::iota(columnIndices.begin(), columnIndices.end(), 0);
-
-        std::for_each(std::execution::par_unseq, columnIndices.begin(), columnIndices.end(),
-            [this, &samples, channels, frameCount, widgetWidth](int x) {
-                int startFrame = scrollOffsetFrames_ + static_cast<int>(x * samplesPerPixel_);
-                int endFrame = scrollOffsetFrames_ + static_cast<int>((x + 1) * samplesPerPixel_);
-
-                startFrame = std::clamp(startFrame, 0, static_cast<int>(frameCount) - 1);
-                endFrame = std::clamp(endFrame, startFrame + 1, static_cast<int>(frameCount));
-
-                for (int ch = 0; ch < channels; ++ch) {
-                    float minVal = 0.0f;
-                    float maxVal = 0.0f;
-
-                    for (int f = startFrame; f < endFrame; ++f) {
-                        size_t idx = static_cast<size_t>(f * channels + ch);
-                        if (idx < samples.size()) {
-                            float val = samples[idx];
-                            minVal = std::min(minVal, val);
-                            maxVal = std::max(maxVal, val);
-                        }
-                    }
-
-                    channelCache_[ch][x] = {minVal, maxVal};
-                }
-            });
-    } else {
-        // Sequential for small widths (parallel overhead not worth it)
-        for (int x = 0; x < widgetWidth; ++x) {
-            int startFrame = scrollOffsetFrames_ + static_cast<int>(x * samplesPerPixel_);
-            int endFrame = scrollOffsetFrames_ + static_cast<int>((x + 1) * samplesPerPixel_);
-
-            startFrame = std::clamp(startFrame, 0, static_cast<int>(frameCount) - 1);
-            endFrame = std::clamp(endFrame, startFrame + 1, static_cast<int>(frameCount));
-
-            for (int ch = 0; ch < channels; ++ch) {
-                float minVal = 0.0f;
-                float maxVal = 0.0f;
-
-                for (int f = startFrame; f < endFrame; ++f) {
-                    size_t idx = static_cast<size_t>(f * channels + ch);
-                    if (idx < samples.size()) {
-                        float val = samples[idx];
-                        minVal = std::min(minVal, val);
-                        maxVal = std::max(maxVal, val);
-                    }
-                }
-
-                channelCache_[ch][x] = {minVal, maxVal};
-            }
-        }
-    }
+    // Only the visible frames, so a clip stored as 16 bits expands just those
+    const size_t firstFrame = std::min(static_cast<size_t>(std::max(0, scrollOffsetFrames_)), clip_->frameCount() - 1);
+    const auto visibleFrames = static_cast<size_t>(std::ceil(samplesPerPixel_ * width())) + 1;
+    const auto view = clip_->view(firstFrame, visibleFrames);
+    channelCache_ = computeWaveformColumns(view.data(), view.size(), clip_->channels(),
+                                           scrollOffsetFrames_ - static_cast<int>(firstFrame), samplesPerPixel_,
+                                           width());
 
     cacheValid_ = true;
 }
@@ -330,18 +274,27 @@ void WaveformView::drawWaveform(QPainter& painter, const QRect& rect) {
 
     int channels = static_cast<int>(channelCache_.size());
 
-    if (channels >= 2) {
-        // Stereo: top half = left, bottom half = right
-        int halfHeight = (rect.height() - kChannelGap) / 2;
-
-        QRect leftRect(rect.left(), rect.top(), rect.width(), halfHeight);
-        QRect rightRect(rect.left(), rect.top() + halfHeight + kChannelGap, rect.width(), halfHeight);
+    // Mono uses the full height, stereo mirrors the right channel below the
+    // left, surround stacks one lane per channel
+    const auto lanes = computeWaveformLanes(channels, rect.top(), rect.height(), kChannelGap);
+    for (int c = 0; c < channels; ++c) {
+        const WaveformLane& lane = lanes[static_cast<size_t>(c)];
+        drawWaveformChannel(painter, QRect(rect.left(), lane.top, rect.width(), lane.height), c, lane.flipY);
+    }
+    if (channels <= 2) return;
 
-        drawWaveformChannel(painter, leftRect, 0, false);
-        drawWaveformChannel(painter, rightRect, 1, true);
-    } else {
-        // Mono: use full height
-        drawWaveformChannel(painter, rect, 0, false);
+    // Name each surround lane, with its peak once the clip is measured
+    QFont smallFont = painter.font();
+    smallFont.setPointSize(8);
+    painter.setFont(smallFont);
+    painter.setPen(QColor(160, 165, 175));
+    const auto& levels = clip_ && clip_->hasMetrics() ? clip_->channelLevels() : std::vector<DSP::Levels>{};
+    for (int c = 0; c < channels; ++c) {
+        QString label = QString::fromStdString(SpeakerLayout::label(c, channels));
+        if (static_cast<size_t>(c) < levels.size()) {
+            label += QString("  %1 dB").arg(static_cast<double>(levels[static_cast<size_t>(c)].peakDb), 0, 'f', 1);
+        }
+        painter.drawText(rect.left() + 4, lanes[static_cast<size_t>(c)].top + painter.fontMetrics().ascent() + 1, label);
     }
 }
 
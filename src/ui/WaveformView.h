@@ -1,9 +1,10 @@
 /**
  * @file WaveformView.h
- * @brief Waveform visualization widget with zoom, scroll, trim, and stereo display.
+ * @brief Waveform visualization widget with zoom, scroll, trim, and multichannel display.
  *
  * Renders audio samples as a waveform with gradient fills, supports stereo
- * channel display, zooming centered on cursor, and visual trim markers.
+ * and surround channel display (one labelled lane per channel), zooming
+ * centered on cursor, and visual trim markers.
  */
 
 #pragma once
@@ -12,6 +13,8 @@
 #include <QString>
 #include <vector>
 
+#include "WaveformViewHelpers.h"
+
 class AudioClip;
 
 /**
@@ -70,6 +73,9 @@ public:
     int playheadFrame() const { return playheadFrame_; }
     void clearPlayhead();
 
+    // --- Memory ---
+    size_t cacheBytes() const;
+
 Q_SIGNALS:
     void seekRequested(int frame);
     void trimChanged(int startFrame, int endFrame);
@@ -111,10 +117,6 @@ private:
     int scrollOffsetFrames_ = 0;
 
     // Waveform cache per channel (min/max per pixel column)
-    struct WaveformColumn {
-        float minVal = 0.0f;
-        float maxVal = 0.0f;
-    };
     std::vector<std::vector<WaveformColumn>> channelCache_;  // [channel][x]
     bool cacheValid_ = false;
 
@@ -1,6 +1,10 @@
 #include "WaveformViewHelpers.h"
+#include "utils/ChannelDispatch.h"
 
 #include <algorithm>
+#include <array>
+#include <execution>
+#include <numeric>
 
 TrimAndFadeRanges computeTrimAndFadeRanges(
     std::size_t clipFrameCount,
@@ -50,3 +54,123 @@ TrimAndFadeRanges computeTrimAndFadeRanges(
 
     return result;
 }
+
+namespace {
+
+/// Channel counts up to this are swept frame by frame by the generic kernel
+constexpr std::size_t kMaxSweepChannels = 16;
+
+/// Min/max per channel over frames [startFrame, endFrame) into columns[channel][x].
+template <int Channels>
+void columnMinMax(const float* samples, int channels, int startFrame, int endFrame,
+                  std::vector<std::vector<WaveformColumn>>& columns, std::size_t x) {
+    const std::size_t ch = channelStride<Channels>(channels);
+    if constexpr (Channels > 0) {
+        // One sweep over the frames, all channels' extremes kept in registers
+        std::array<float, Channels> minVal{};
+        std::array<float, Channels> maxVal{};
+        for (int f = startFrame; f < endFrame; ++f) {
+            const float* frame = samples + static_cast<std::size_t>(f) * ch;
+            for (std::size_t c = 0; c < ch; ++c) {
+                minVal[c] = std::min(minVal[c], frame[c]);
+                maxVal[c] = std::max(maxVal[c], frame[c]);
+            }
+        }
+        for (std::size_t c = 0; c < ch; ++c) columns[c][x] = {minVal[c], maxVal[c]};
+    } else if (ch <= kMaxSweepChannels) {
+        // Surround layouts without a dedicated kernel still take one sweep
+        std::array<float, kMaxSweepChannels> minVal{};
+        std::array<float, kMaxSweepChannels> maxVal{};
+        for (int f = startFrame; f < endFrame; ++f) {
+            const float* frame = samples + static_cast<std::size_t>(f) * ch;
+            for (std::size_t c = 0; c < ch; ++c) {
+                minVal[c] = std::min(minVal[c], frame[c]);
+                maxVal[c] = std::max(maxVal[c], frame[c]);
+            }
+        }
+        for (std::size_t c = 0; c < ch; ++c) columns[c][x] = {minVal[c], maxVal[c]};
+    } else {
+        for (std::size_t c = 0; c < ch; ++c) {
+            float minVal = 0.0f;
+            float maxVal = 0.0f;
+            for (int f = startFrame; f < endFrame; ++f) {
+                float val = samples[static_cast<std::size_t>(f) * ch + c];
+                minVal = std::min(minVal, val);
+                maxVal = std::max(maxVal, val);
+            }
+            columns[c][x] = {minVal, maxVal};
+        }
+    }
+}
+
+} // namespace
+
+std::vector<std::vector<WaveformColumn>> computeWaveformColumns(
+    const float* samples,
+    std::size_t sampleCount,
+    int channels,
+    int scrollOffsetFrames,
+    double samplesPerPixel,
+    int width
+) {
+    std::vector<std::vector<WaveformColumn>> columns;
+    if (!samples || sampleCount == 0 || channels <= 0 || width <= 0) {
+        return columns;
+    }
+
+    const int frameCount = static_cast<int>(sampleCount / static_cast<std::size_t>(channels));
+    if (frameCount == 0) {
+        return columns;
+    }
+
+    columns.resize(static_cast<std::size_t>(channels));
+    for (auto& channelColumns : columns) {
+        channelColumns.resize(static_cast<std::size_t>(width));
+    }
+
+    dispatchChannels(channels, [&](auto layout) {
+        constexpr int kChannels = decltype(layout)::value;
+
+        auto computeColumn = [&](int x) {
+            int startFrame = scrollOffsetFrames + static_cast<int>(x * samplesPerPixel);
+            int endFrame = scrollOffsetFrames + static_cast<int>((x + 1) * samplesPerPixel);
+
+            startFrame = std::clamp(startFrame, 0, frameCount - 1);
+            endFrame = std::clamp(endFrame, startFrame + 1, frameCount);
+
+            columnMinMax<kChannels>(samples, channels, startFrame, endFrame, columns, static_cast<std::size_t>(x));
+        };
+
+        // Threshold for parallel execution (overhead not worth it for small displays)
+        constexpr int kParallelThreshold = 200;
+
+        if (width >= kParallelThreshold) {
+            std::vector<int> columnIndices(static_cast<std::size_t>(width));
+            std::iota(columnIndices.begin(), columnIndices.end(), 0);
+            std::for_each(std::execution::par_unseq, columnIndices.begin(), columnIndices.end(), computeColumn);
+        } else {
+            for (int x = 0; x < width; ++x) {
+                computeColumn(x);
+            }
+        }
+    });
+
+    return columns;
+}
+
+std::vector<WaveformLane> computeWaveformLanes(int channels, int top, int height, int gap) {
+    std::vector<WaveformLane> lanes;
+    if (channels <= 0) {
+        return lanes;
+    }
+    if (channels == 1) {
+        lanes.push_back({top, height, false});
+        return lanes;
+    }
+
+    const int laneHeight = std::max(1, (height - gap * (channels - 1)) / channels);
+    for (int c = 0; c < channels; ++c) {
+        lanes.push_back({top + c * (laneHeight + gap), laneHeight, channels == 2 && c == 1});
+    }
+    return lanes;
+}
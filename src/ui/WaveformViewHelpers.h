@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <tuple>
+#include <vector>
 
 struct TrimAndFadeRanges {
     std::size_t visibleStartFrame;
@@ -20,3 +21,30 @@ TrimAndFadeRanges computeTrimAndFadeRanges(
     std::size_t fadeInLengthFrames,
     std::size_t fadeOutLengthFrames
 );
+
+struct WaveformColumn {
+    float minVal = 0.0f;
+    float maxVal = 0.0f;
+};
+
+/// Min/max of each channel for every pixel column: result[channel][x].
+/// Columns are independent and computed in parallel for wide displays.
+std::vector<std::vector<WaveformColumn>> computeWaveformColumns(
+    const float* samples,
+    std::size_t sampleCount,
+    int channels,
+    int scrollOffsetFrames,
+    double samplesPerPixel,
+    int width
+);
+
+struct WaveformLane {
+    int top = 0;
+    int height = 0;
+    bool flipY = false;     ///< Drawn mirrored (stereo's right channel)
+};
+
+/// Vertical lane of each channel in an area @p height pixels tall from @p top.
+/// Mono fills the area and stereo mirrors its right channel in the bottom
+/// half; more channels are stacked in lanes of equal height, @p gap pixels apart.
+std::vector<WaveformLane> computeWaveformLanes(int channels, int top, int height, int gap);
@@ -0,0 +1,427 @@
+/**
+ * @file AsyncFileIO.cpp
+ * @brief io_uring and thread-pool backends of AsyncFileIO.
+ */
+
+#include "AsyncFileIO.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#include "utils/Trace.h"
+
+// io_uring is driven through its system calls directly, so there is no
+// liburing dependency; IORING_OP_READ/WRITE need the 5.6 kernel headers
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#ifdef IORING_FEAT_RW_CUR_POS
+#define WOOSH_HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifdef WOOSH_HAVE_IO_URING
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr unsigned kMaxPoolThreads = 8;
+
+} // namespace
+
+#ifdef WOOSH_HAVE_IO_URING
+
+/// The mapped submission and completion queues of one io_uring.
+struct AsyncFileIO::Ring {
+    int fd{-1};
+    void* sqRing{MAP_FAILED};
+    size_t sqRingBytes{0};
+    void* cqRing{MAP_FAILED};
+    size_t cqRingBytes{0};
+    io_uring_sqe* sqes{nullptr};
+    size_t sqesBytes{0};
+
+    unsigned* sqTail{nullptr};
+    unsigned sqMask{0};
+    unsigned* sqArray{nullptr};
+    unsigned sqEntries{0};
+    unsigned* cqHead{nullptr};
+    unsigned* cqTail{nullptr};
+    unsigned cqMask{0};
+    io_uring_cqe* cqes{nullptr};
+    unsigned unsubmitted{0};
+
+    ~Ring() {
+        if (sqes) munmap(sqes, sqesBytes);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingBytes);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingBytes);
+        if (fd >= 0) close(fd);
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0 || !(params.features & IORING_FEAT_RW_CUR_POS)) return false;
+
+        sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+
+        sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) return false;
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                  IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) return false;
+        sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        void* entriesMap = mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                                IORING_OFF_SQES);
+        if (entriesMap == MAP_FAILED) return false;
+        sqes = static_cast<io_uring_sqe*>(entriesMap);
+
+        auto* sq = static_cast<char*>(sqRing);
+        auto* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries = params.sq_entries;
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    /// Queue one read or write; the kernel sees it on the next enter().
+    void push(uint8_t opcode, int file, void* buffer, size_t length, size_t offset, uint64_t userData) {
+        const unsigned tail = *sqTail;      // Only this thread moves the tail
+        const unsigned index = tail & sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = opcode;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = static_cast<uint32_t>(length);
+        sqe.off = offset;
+        sqe.user_data = userData;
+        sqArray[index] = index;
+        std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+        ++unsubmitted;
+    }
+
+    /// Submit queued entries and optionally wait for @p minComplete completions.
+    bool enter(unsigned minComplete) {
+        while (unsubmitted > 0 || minComplete > 0) {
+            const long submitted = syscall(__NR_io_uring_enter, fd, unsubmitted, minComplete,
+                                           minComplete > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            unsubmitted -= static_cast<unsigned>(submitted);
+            minComplete = 0;
+        }
+        return true;
+    }
+
+    template <typename Handler>
+    void reap(Handler handler) {
+        unsigned head = std::atomic_ref<unsigned>(*cqHead).load(std::memory_order_relaxed);
+        const unsigned tail = std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            handler(cqe.user_data, cqe.res);
+        }
+        std::atomic_ref<unsigned>(*cqHead).store(head, std::memory_order_release);
+    }
+};
+
+#else
+
+struct AsyncFileIO::Ring {};
+
+#endif
+
+AsyncFileIO::AsyncFileIO()
+    : AsyncFileIO(Options{})
+{
+}
+
+AsyncFileIO::AsyncFileIO(Options options)
+    : options_(options)
+{
+    options_.queueDepth = std::max(1u, options_.queueDepth);
+    if (!options_.forceThreadPool && startRing()) {
+        backend_ = Backend::IoUring;
+    } else {
+        backend_ = Backend::ThreadPool;
+        startPool();
+    }
+}
+
+AsyncFileIO::~AsyncFileIO() {
+    while (pending_ > 0) {
+        (void)wait();
+    }
+    {
+        std::lock_guard lock(poolMutex_);
+        poolStopping_ = true;
+    }
+    poolWork_.notify_all();
+    for (auto& thread : pool_) {
+        thread.join();
+    }
+}
+
+const char* AsyncFileIO::backendName(Backend backend) noexcept {
+    return backend == Backend::IoUring ? "io_uring" : "thread pool";
+}
+
+void AsyncFileIO::read(uint64_t tag, const std::string& path) {
+    Request request;
+    request.tag = tag;
+    request.path = path;
+    ++pending_;
+    if (backend_ == Backend::IoUring) {
+        submitToRing(nextId_++, std::move(request));
+        return;
+    }
+    {
+        std::lock_guard lock(poolMutex_);
+        poolQueue_.push_back(std::move(request));
+    }
+    poolWork_.notify_one();
+}
+
+void AsyncFileIO::write(uint64_t tag, const std::string& path, std::vector<uint8_t> data) {
+    Request request;
+    request.tag = tag;
+    request.path = path;
+    request.isWrite = true;
+    request.data = std::move(data);
+    ++pending_;
+    if (backend_ == Backend::IoUring) {
+        submitToRing(nextId_++, std::move(request));
+        return;
+    }
+    {
+        std::lock_guard lock(poolMutex_);
+        poolQueue_.push_back(std::move(request));
+    }
+    poolWork_.notify_one();
+}
+
+std::vector<AsyncFileIO::Completion> AsyncFileIO::wait() {
+    std::vector<Completion> done;
+    if (pending_ == 0) return done;
+
+    if (backend_ == Backend::IoUring) {
+#ifdef WOOSH_HAVE_IO_URING
+        reapRing(done);
+        while (done.empty()) {
+            if (!ring_->enter(1)) {
+                // The ring is unusable; fail what is left rather than hang
+                for (auto& [id, request] : requests_) {
+                    if (request.fd >= 0) close(request.fd);
+                    done.push_back({request.tag, false, {}});
+                }
+                requests_.clear();
+                queued_.clear();
+                break;
+            }
+            reapRing(done);
+        }
+#endif
+    } else {
+        std::unique_lock lock(poolMutex_);
+        poolDone_.wait(lock, [this] { return !poolCompleted_.empty(); });
+        done.swap(poolCompleted_);
+    }
+    pending_ -= done.size();
+    return done;
+}
+
+// --- io_uring ---
+
+bool AsyncFileIO::startRing() {
+#ifdef WOOSH_HAVE_IO_URING
+    auto ring = std::make_unique<Ring>();
+    if (!ring->setup(options_.queueDepth)) return false;
+    // Never more chunks in flight than submission entries, so the
+    // completion queue (twice as large) cannot overflow
+    const size_t slots = std::min<size_t>(options_.queueDepth, ring->sqEntries);
+    slots_.resize(slots);
+    for (size_t s = slots; s > 0; --s) freeSlots_.push_back(s - 1);
+    ring_ = std::move(ring);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AsyncFileIO::submitToRing(uint64_t id, Request request) {
+#ifdef WOOSH_HAVE_IO_URING
+    WOOSH_TRACE_SCOPE_DETAIL("AsyncFileIO::submit", request.path);
+    size_t size = request.data.size();
+    if (request.isWrite) {
+        request.fd = open(request.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    } else {
+        request.fd = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info {};
+        if (request.fd >= 0 && fstat(request.fd, &info) == 0) {
+            size = static_cast<size_t>(info.st_size);
+            request.data.resize(size);
+        } else {
+            request.ok = false;
+        }
+    }
+    if (request.fd < 0) request.ok = false;
+
+    auto& stored = requests_.emplace(id, std::move(request)).first->second;
+    if (!stored.ok || size == 0) {
+        finishRequest(id, finished_);
+        return;
+    }
+    for (size_t offset = 0; offset < size; offset += kChunkBytes) {
+        queued_.push_back({id, offset, std::min(kChunkBytes, size - offset)});
+        ++stored.chunksLeft;
+    }
+    fillRing();
+    ring_->enter(0);
+#else
+    (void)id;
+    (void)request;
+#endif
+}
+
+void AsyncFileIO::fillRing() {
+#ifdef WOOSH_HAVE_IO_URING
+    while (!queued_.empty() && !freeSlots_.empty()) {
+        const Chunk chunk = queued_.front();
+        queued_.pop_front();
+        Request& request = requests_.at(chunk.request);
+        if (!request.ok) {
+            // An earlier chunk failed; the rest of the file is not worth transferring
+            if (--request.chunksLeft == 0) finishRequest(chunk.request, finished_);
+            continue;
+        }
+        const size_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        slots_[slot] = chunk;
+        ring_->push(request.isWrite ? IORING_OP_WRITE : IORING_OP_READ, request.fd,
+                    request.data.data() + chunk.offset, chunk.length, chunk.offset, slot);
+    }
+#endif
+}
+
+void AsyncFileIO::reapRing(std::vector<Completion>& done) {
+#ifdef WOOSH_HAVE_IO_URING
+    // Requests that finished without I/O (open failed, empty file) are parked here
+    for (auto& completion : finished_) done.push_back(std::move(completion));
+    finished_.clear();
+
+    ring_->reap([&](uint64_t slot, int32_t result) {
+        const Chunk chunk = slots_[slot];
+        freeSlots_.push_back(static_cast<size_t>(slot));
+        Request& request = requests_.at(chunk.request);
+
+        if (result == -EINTR || result == -EAGAIN) {
+            queued_.push_front(chunk);
+            return;
+        }
+        if (result <= 0) {
+            request.ok = false;     // Error, or the file shrank while reading
+        } else if (static_cast<size_t>(result) < chunk.length) {
+            // Short transfer: the remainder goes to the front of the queue
+            const auto moved = static_cast<size_t>(result);
+            queued_.push_front({chunk.request, chunk.offset + moved, chunk.length - moved});
+            return;
+        }
+        if (--request.chunksLeft == 0) finishRequest(chunk.request, done);
+    });
+    fillRing();
+    ring_->enter(0);
+#else
+    (void)done;
+#endif
+}
+
+void AsyncFileIO::finishRequest(uint64_t id, std::vector<Completion>& done) {
+#ifdef WOOSH_HAVE_IO_URING
+    auto it = requests_.find(id);
+    Request& request = it->second;
+    if (request.fd >= 0 && close(request.fd) != 0 && request.isWrite) request.ok = false;
+    Completion completion{request.tag, request.ok, {}};
+    if (!request.isWrite && request.ok) completion.data = std::move(request.data);
+    done.push_back(std::move(completion));
+    requests_.erase(it);
+#else
+    (void)id;
+    (void)done;
+#endif
+}
+
+// --- Thread pool ---
+
+void AsyncFileIO::startPool() {
+    const unsigned threads = std::min(options_.queueDepth, kMaxPoolThreads);
+    pool_.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool_.emplace_back([this, t] {
+            Trace::setThreadName("File I/O " + std::to_string(t + 1));
+            poolWorker();
+        });
+    }
+}
+
+void AsyncFileIO::poolWorker() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock lock(poolMutex_);
+            poolWork_.wait(lock, [this] { return poolStopping_ || !poolQueue_.empty(); });
+            if (poolQueue_.empty()) return;
+            request = std::move(poolQueue_.front());
+            poolQueue_.pop_front();
+        }
+        transfer(request);
+        Completion completion{request.tag, request.ok, {}};
+        if (!request.isWrite && request.ok) completion.data = std::move(request.data);
+        {
+            std::lock_guard lock(poolMutex_);
+            poolCompleted_.push_back(std::move(completion));
+        }
+        poolDone_.notify_one();
+    }
+}
+
+void AsyncFileIO::transfer(Request& request) {
+    WOOSH_TRACE_SCOPE_DETAIL("AsyncFileIO::transfer", request.path);
+    std::FILE* file = std::fopen(request.path.c_str(), request.isWrite ? "wb" : "rb");
+    if (!file) {
+        request.ok = false;
+        return;
+    }
+    if (request.isWrite) {
+        request.ok = std::fwrite(request.data.data(), 1, request.data.size(), file) == request.data.size();
+    } else {
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(request.path, ec);
+        request.data.resize(ec ? 0 : static_cast<size_t>(size));
+        request.ok = !ec && std::fread(request.data.data(), 1, request.data.size(), file) == request.data.size();
+    }
+    if (std::fclose(file) != 0) request.ok = false;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file AsyncFileIO.h
+ * @brief Whole-file reads and writes with many requests in flight.
+ *
+ * Batches on network storage spend most of their time waiting for I/O.
+ * On Linux the requests go to an io_uring, so one thread keeps dozens of
+ * reads and writes in flight without blocking on any of them. Where
+ * io_uring is unavailable (other platforms, kernels before 5.6, containers
+ * that block it) the same requests are served by a small pool of blocking
+ * I/O threads.
+ *
+ * Files are transferred in chunks of kChunkBytes, so a single large file
+ * also keeps several requests in flight.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AsyncFileIO
+ * @brief Submit reads and writes, then collect them as they complete.
+ *
+ * An AsyncFileIO belongs to the thread that submits and waits; it is not
+ * thread-safe. Destruction waits for requests still in flight.
+ */
+class AsyncFileIO final {
+public:
+    enum class Backend {
+        IoUring,
+        ThreadPool
+    };
+
+    static constexpr unsigned kDefaultQueueDepth = 32;
+    static constexpr size_t kChunkBytes = size_t{1} << 20;
+
+    struct Options {
+        unsigned queueDepth{kDefaultQueueDepth};    ///< Chunks (io_uring) or files (thread pool) in flight
+        bool forceThreadPool{false};                ///< Skip io_uring, e.g. for A/B runs
+    };
+
+    struct Completion {
+        uint64_t tag{0};
+        bool ok{false};
+        std::vector<uint8_t> data;      ///< Contents of a read; empty for writes
+    };
+
+    AsyncFileIO();
+    explicit AsyncFileIO(Options options);
+    ~AsyncFileIO();
+
+    AsyncFileIO(const AsyncFileIO&) = delete;
+    AsyncFileIO& operator=(const AsyncFileIO&) = delete;
+
+    [[nodiscard]] Backend backend() const noexcept { return backend_; }
+    [[nodiscard]] static const char* backendName(Backend backend) noexcept;
+
+    /** @brief Queue a read of the whole of @p path; completes with its contents. */
+    void read(uint64_t tag, const std::string& path);
+
+    /** @brief Queue writing @p data to @p path, replacing the file. */
+    void write(uint64_t tag, const std::string& path, std::vector<uint8_t> data);
+
+    /** @brief Requests submitted and not yet returned by wait(). */
+    [[nodiscard]] size_t pending() const noexcept { return pending_; }
+
+    /**
+     * @brief Block until at least one request completes and return all that have.
+     * @return Empty only when nothing is pending.
+     */
+    [[nodiscard]] std::vector<Completion> wait();
+
+private:
+    struct Request {
+        uint64_t tag{0};
+        std::string path;
+        bool isWrite{false};
+        std::vector<uint8_t> data;
+        bool ok{true};
+        int fd{-1};                 // io_uring only
+        size_t chunksLeft{0};       // io_uring only; queued or in the ring
+    };
+
+    // io_uring
+    struct Ring;
+    struct Chunk {
+        uint64_t request{0};
+        size_t offset{0};
+        size_t length{0};
+    };
+    bool startRing();
+    void submitToRing(uint64_t id, Request request);
+    void fillRing();
+    void reapRing(std::vector<Completion>& done);
+    void finishRequest(uint64_t id, std::vector<Completion>& done);
+
+    // Thread pool
+    void startPool();
+    void poolWorker();
+    static void transfer(Request& request);
+
+    Options options_;
+    Backend backend_{Backend::ThreadPool};
+    size_t pending_{0};
+    uint64_t nextId_{0};
+
+    std::unique_ptr<Ring> ring_;
+    std::map<uint64_t, Request> requests_;
+    std::deque<Chunk> queued_;      ///< Chunks waiting for a free ring slot
+    std::vector<Chunk> slots_;      ///< Chunks in the ring, by slot
+    std::vector<size_t> freeSlots_;
+    std::vector<Completion> finished_;  ///< Completed outside wait(), e.g. a file that failed to open
+
+    std::vector<std::thread> pool_;
+    std::mutex poolMutex_;
+    std::condition_variable poolWork_;
+    std::condition_variable poolDone_;
+    std::deque<Request> poolQueue_;
+    std::vector<Completion> poolCompleted_;
+    bool poolStopping_{false};
+};
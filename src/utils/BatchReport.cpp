@@ -0,0 +1,279 @@
+/**
+ * @file BatchReport.cpp
+ * @brief Implementation of batch timing collection and report formatting.
+ */
+
+#include "BatchReport.h"
+#include "JsonEscape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::string indent(int level) {
+    return std::string(static_cast<size_t>(level) * 2, ' ');
+}
+
+std::string formatNumber(double value, int decimals = 3) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    return buf;
+}
+
+/// Nearest-rank percentile of an ascending-sorted, non-empty sample set.
+double percentile(const std::vector<double>& sorted, double p) {
+    const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+} // namespace
+
+// ============================================================================
+// System statistics
+// ============================================================================
+
+double processCpuTimeMs() {
+#ifdef _WIN32
+    FILETIME creation, exitTime, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) {
+        return 0.0;
+    }
+    auto toMs = [](const FILETIME& ft) {
+        ULARGE_INTEGER value;
+        value.LowPart = ft.dwLowDateTime;
+        value.HighPart = ft.dwHighDateTime;
+        return static_cast<double>(value.QuadPart) / 10000.0;  // 100 ns units
+    };
+    return toMs(kernel) + toMs(user);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+    auto toMs = [](const timeval& tv) {
+        return static_cast<double>(tv.tv_sec) * 1000.0 + static_cast<double>(tv.tv_usec) / 1000.0;
+    };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+#endif
+}
+
+uint64_t processPeakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024u;  // kilobytes
+#endif
+#endif
+}
+
+// ============================================================================
+// BatchRecorder
+// ============================================================================
+
+BatchRecorder::BatchRecorder(std::string operation, int workerThreads)
+    : operation_(std::move(operation))
+    , workerThreads_(workerThreads)
+    , start_(std::chrono::steady_clock::now())
+    , cpuStartMs_(processCpuTimeMs())
+{
+}
+
+void BatchRecorder::addStageSample(const std::string& stage, double ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stageSamples_[stage].push_back(ms);
+}
+
+void BatchRecorder::addFile(const std::string& path, uint64_t bytes, double ms, bool succeeded) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_.push_back({path, bytes, ms, succeeded});
+}
+
+BatchReport BatchRecorder::finish(size_t slowestCount) const {
+    BatchReport report;
+    report.operation = operation_;
+    report.workerThreads = workerThreads_;
+    report.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    report.cpuMs = std::max(0.0, processCpuTimeMs() - cpuStartMs_);
+    report.peakResidentBytes = processPeakResidentBytes();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    double busyMs = 0.0;
+    for (const auto& file : files_) {
+        report.files++;
+        if (!file.succeeded) report.failedFiles++;
+        report.bytes += file.bytes;
+        busyMs += file.ms;
+    }
+    report.parallelism = report.wallMs > 0.0 ? busyMs / report.wallMs : 0.0;
+
+    for (const auto& [name, samples] : stageSamples_) {
+        if (samples.empty()) continue;
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        StageStats stats;
+        stats.name = name;
+        stats.count = sorted.size();
+        for (double ms : sorted) stats.totalMs += ms;
+        stats.p50Ms = percentile(sorted, 0.50);
+        stats.p95Ms = percentile(sorted, 0.95);
+        stats.maxMs = sorted.back();
+        report.stages.push_back(std::move(stats));
+    }
+
+    report.slowestFiles = files_;
+    const size_t keep = std::min(slowestCount, report.slowestFiles.size());
+    std::partial_sort(report.slowestFiles.begin(),
+                      report.slowestFiles.begin() + static_cast<std::ptrdiff_t>(keep),
+                      report.slowestFiles.end(),
+                      [](const FileTiming& a, const FileTiming& b) { return a.ms > b.ms; });
+    report.slowestFiles.resize(keep);
+
+    return report;
+}
+
+// ============================================================================
+// BatchReport
+// ============================================================================
+
+double BatchReport::filesPerSecond() const noexcept {
+    return wallMs > 0.0 ? static_cast<double>(files) * 1000.0 / wallMs : 0.0;
+}
+
+double BatchReport::megabytesPerSecond() const noexcept {
+    return wallMs > 0.0 ? static_cast<double>(bytes) / 1.0e6 * 1000.0 / wallMs : 0.0;
+}
+
+std::string BatchReport::toJson(int indentLevel) const {
+    const std::string i0 = indent(indentLevel);
+    const std::string i1 = indent(indentLevel + 1);
+    const std::string i2 = indent(indentLevel + 2);
+    const std::string i3 = indent(indentLevel + 3);
+
+    std::ostringstream ss;
+    ss << "{\n";
+    ss << i1 << "\"operation\": \"" << escapeJson(operation) << "\",\n";
+    ss << i1 << "\"files\": " << files << ",\n";
+    ss << i1 << "\"failedFiles\": " << failedFiles << ",\n";
+    ss << i1 << "\"bytes\": " << bytes << ",\n";
+    ss << i1 << "\"wallMs\": " << formatNumber(wallMs) << ",\n";
+    ss << i1 << "\"cpuMs\": " << formatNumber(cpuMs) << ",\n";
+    ss << i1 << "\"filesPerSec\": " << formatNumber(filesPerSecond()) << ",\n";
+    ss << i1 << "\"mbPerSec\": " << formatNumber(megabytesPerSecond()) << ",\n";
+    ss << i1 << "\"workerThreads\": " << workerThreads << ",\n";
+    ss << i1 << "\"parallelism\": " << formatNumber(parallelism) << ",\n";
+    ss << i1 << "\"peakResidentBytes\": " << peakResidentBytes << ",\n";
+
+    ss << i1 << "\"stages\": [";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const auto& s = stages[i];
+        ss << (i == 0 ? "\n" : ",\n");
+        ss << i2 << "{\n";
+        ss << i3 << "\"name\": \"" << escapeJson(s.name) << "\",\n";
+        ss << i3 << "\"count\": " << s.count << ",\n";
+        ss << i3 << "\"totalMs\": " << formatNumber(s.totalMs) << ",\n";
+        ss << i3 << "\"p50Ms\": " << formatNumber(s.p50Ms) << ",\n";
+        ss << i3 << "\"p95Ms\": " << formatNumber(s.p95Ms) << ",\n";
+        ss << i3 << "\"maxMs\": " << formatNumber(s.maxMs) << "\n";
+        ss << i2 << "}";
+    }
+    ss << (stages.empty() ? "],\n" : "\n" + i1 + "],\n");
+
+    ss << i1 << "\"slowestFiles\": [";
+    for (size_t i = 0; i < slowestFiles.size(); ++i) {
+        const auto& f = slowestFiles[i];
+        ss << (i == 0 ? "\n" : ",\n");
+        ss << i2 << "{\n";
+        ss << i3 << "\"path\": \"" << escapeJson(f.path) << "\",\n";
+        ss << i3 << "\"bytes\": " << f.bytes << ",\n";
+        ss << i3 << "\"ms\": " << formatNumber(f.ms) << ",\n";
+        ss << i3 << "\"succeeded\": " << (f.succeeded ? "true" : "false") << "\n";
+        ss << i2 << "}";
+    }
+    ss << (slowestFiles.empty() ? "]\n" : "\n" + i1 + "]\n");
+
+    ss << i0 << "}";
+    return ss.str();
+}
+
+std::string BatchReport::toText() const {
+    std::ostringstream ss;
+    ss << "Batch: " << operation << "\n";
+    ss << "  Files:        " << files;
+    if (failedFiles > 0) ss << " (" << failedFiles << " failed)";
+    ss << "\n";
+    ss << "  Data:         " << formatNumber(static_cast<double>(bytes) / 1.0e6, 2) << " MB\n";
+    ss << "  Wall time:    " << formatNumber(wallMs, 1) << " ms\n";
+    ss << "  CPU time:     " << formatNumber(cpuMs, 1) << " ms\n";
+    ss << "  Throughput:   " << formatNumber(filesPerSecond(), 1) << " files/s, "
+       << formatNumber(megabytesPerSecond(), 1) << " MB/s\n";
+    ss << "  Parallelism:  " << formatNumber(parallelism, 2) << "x on "
+       << workerThreads << " thread(s)\n";
+    if (peakResidentBytes > 0) {
+        ss << "  Peak memory:  " << formatNumber(static_cast<double>(peakResidentBytes) / (1024.0 * 1024.0), 1) << " MiB\n";
+    }
+
+    if (!stages.empty()) {
+        ss << "\n  Stage              count     p50 ms     p95 ms     max ms\n";
+        for (const auto& s : stages) {
+            char line[160];
+            std::snprintf(line, sizeof(line), "  %-16s %7zu %10.2f %10.2f %10.2f\n",
+                          s.name.c_str(), s.count, s.p50Ms, s.p95Ms, s.maxMs);
+            ss << line;
+        }
+    }
+
+    if (!slowestFiles.empty()) {
+        ss << "\n  Slowest files:\n";
+        for (const auto& f : slowestFiles) {
+            ss << "    " << formatNumber(f.ms, 1) << " ms  " << f.path
+               << (f.succeeded ? "" : "  (failed)") << "\n";
+        }
+    }
+
+    return ss.str();
+}
+
+bool writeBatchReportsJson(const std::string& path, const std::vector<BatchReport>& reports) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) return false;
+
+    file << "{\n";
+    file << indent(1) << "\"batches\": [";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        file << (i == 0 ? "\n" : ",\n") << indent(2) << reports[i].toJson(2);
+    }
+    file << (reports.empty() ? "]\n" : "\n" + indent(1) + "]\n");
+    file << "}\n";
+
+    return static_cast<bool>(file);
+}
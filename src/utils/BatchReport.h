@@ -0,0 +1,141 @@
+/**
+ * @file BatchReport.h
+ * @brief Per-batch performance summary for load, process and export runs.
+ *
+ * A BatchRecorder is shared by the workers of one batch. Each worker times
+ * its stages and files into it; finish() turns the samples into a
+ * BatchReport with throughput, stage latency percentiles, the slowest files,
+ * CPU time, peak resident memory and achieved parallelism.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Latency distribution of one stage (e.g. "decode", "encode").
+ */
+struct StageStats {
+    std::string name;
+    size_t count{0};
+    double totalMs{0.0};
+    double p50Ms{0.0};
+    double p95Ms{0.0};
+    double maxMs{0.0};
+};
+
+/**
+ * @brief Time spent on a single file across all of its stages.
+ */
+struct FileTiming {
+    std::string path;
+    uint64_t bytes{0};
+    double ms{0.0};
+    bool succeeded{true};
+};
+
+/**
+ * @brief Summary of a finished batch.
+ */
+struct BatchReport {
+    std::string operation;              ///< "load", "process", "export", ...
+    size_t files{0};
+    size_t failedFiles{0};
+    uint64_t bytes{0};
+    double wallMs{0.0};
+    double cpuMs{0.0};                  ///< Process CPU time (user + system) during the batch
+    int workerThreads{0};
+    double parallelism{0.0};            ///< Sum of per-file time / wall time
+    uint64_t peakResidentBytes{0};      ///< Process high-water mark, 0 if unavailable
+    std::vector<StageStats> stages;
+    std::vector<FileTiming> slowestFiles;
+
+    [[nodiscard]] double filesPerSecond() const noexcept;
+    [[nodiscard]] double megabytesPerSecond() const noexcept;
+
+    /** @brief Serialize as a JSON object (no trailing newline). */
+    [[nodiscard]] std::string toJson(int indentLevel = 0) const;
+
+    /** @brief Human-readable multi-line summary. */
+    [[nodiscard]] std::string toText() const;
+};
+
+/**
+ * @brief Write one or more reports as a JSON document.
+ * @return True on success.
+ */
+[[nodiscard]] bool writeBatchReportsJson(const std::string& path, const std::vector<BatchReport>& reports);
+
+/**
+ * @class BatchRecorder
+ * @brief Thread-safe collector of stage and file timings for one batch.
+ */
+class BatchRecorder final {
+public:
+    static constexpr size_t kDefaultSlowestFiles = 10;
+
+    /**
+     * @param operation Batch name used in the report.
+     * @param workerThreads Number of workers the batch runs on.
+     */
+    BatchRecorder(std::string operation, int workerThreads);
+
+    void addStageSample(const std::string& stage, double ms);
+    void addFile(const std::string& path, uint64_t bytes, double ms, bool succeeded);
+
+    /**
+     * @brief Build the report; wall and CPU time are measured up to this call.
+     * @param slowestCount How many of the slowest files to list.
+     */
+    [[nodiscard]] BatchReport finish(size_t slowestCount = kDefaultSlowestFiles) const;
+
+private:
+    std::string operation_;
+    int workerThreads_;
+    std::chrono::steady_clock::time_point start_;
+    double cpuStartMs_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::vector<double>> stageSamples_;
+    std::vector<FileTiming> files_;
+};
+
+/**
+ * @class StageTimer
+ * @brief Times a scope into a BatchRecorder stage. A null recorder is a no-op.
+ */
+class StageTimer final {
+public:
+    StageTimer(BatchRecorder* recorder, const char* stage)
+        : recorder_(recorder)
+        , stage_(stage)
+        , start_(std::chrono::steady_clock::now())
+    {}
+
+    ~StageTimer() {
+        if (recorder_) recorder_->addStageSample(stage_, elapsedMs());
+    }
+
+    [[nodiscard]] double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    BatchRecorder* recorder_;
+    const char* stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/** @brief CPU time (user + system) consumed by this process so far, in ms. */
+[[nodiscard]] double processCpuTimeMs();
+
+/** @brief Peak resident set size of this process in bytes, 0 if unavailable. */
+[[nodiscard]] uint64_t processPeakResidentBytes();
@@ -0,0 +1,106 @@
+/**
+ * @file BufferPool.cpp
+ * @brief Implementation of the per-thread scratch buffer pool.
+ */
+
+#include "BufferPool.h"
+
+#include <algorithm>
+
+namespace {
+
+/// Smallest block handed out; keeps tiny leases from fragmenting the cache.
+constexpr size_t kMinBlockBytes = 4096;
+
+/// A cached block is reused for a request if it is at most this many times
+/// larger, so one huge clip does not pin memory for every small lease.
+constexpr size_t kMaxOversize = 4;
+
+} // namespace
+
+std::atomic<bool> BufferPool::enabled_{true};
+
+BufferPool::BufferPool() {
+    // Reserved up front so release() never allocates
+    free_.reserve(kMaxCachedBuffers);
+}
+
+BufferPool::~BufferPool() {
+    clear();
+}
+
+BufferPool& BufferPool::local() {
+    thread_local BufferPool pool;
+    return pool;
+}
+
+void* BufferPool::acquireBytes(size_t bytes, size_t& capacityBytes) {
+    acquires_++;
+    const size_t wanted = std::max(bytes, kMinBlockBytes);
+
+    if (isEnabled()) {
+        // Best fit among cached blocks that are large enough
+        auto best = free_.end();
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if (it->bytes >= wanted && it->bytes / kMaxOversize <= wanted &&
+                (best == free_.end() || it->bytes < best->bytes)) {
+                best = it;
+            }
+        }
+        if (best != free_.end()) {
+            void* memory = best->memory;
+            capacityBytes = best->bytes;
+            cachedBytes_ -= best->bytes;
+            *best = free_.back();
+            free_.pop_back();
+            return memory;
+        }
+    }
+
+    // Round up to whole alignment units so the block is reusable for
+    // slightly larger requests of the next file
+    capacityBytes = (wanted + wanted / 8 + kAlignment - 1) / kAlignment * kAlignment;
+    heapAllocations_++;
+    return allocateAligned(capacityBytes);
+}
+
+void BufferPool::release(void* memory, size_t capacityBytes) noexcept {
+    if (!isEnabled() || capacityBytes > kMaxCachedBytes) {
+        freeAligned(memory);
+        return;
+    }
+
+    // Evict the smallest blocks first until the new one fits the budget
+    while (!free_.empty() &&
+           (free_.size() >= kMaxCachedBuffers || cachedBytes_ + capacityBytes > kMaxCachedBytes)) {
+        auto smallest = std::min_element(free_.begin(), free_.end(),
+            [](const Block& a, const Block& b) { return a.bytes < b.bytes; });
+        cachedBytes_ -= smallest->bytes;
+        freeAligned(smallest->memory);
+        *smallest = free_.back();
+        free_.pop_back();
+    }
+
+    free_.push_back({memory, capacityBytes});
+    cachedBytes_ += capacityBytes;
+}
+
+void BufferPool::clear() noexcept {
+    for (const Block& block : free_) {
+        freeAligned(block.memory);
+    }
+    free_.clear();
+    cachedBytes_ = 0;
+}
+
+BufferPool::Stats BufferPool::stats() const noexcept {
+    return {acquires_, heapAllocations_, cachedBytes_};
+}
+
+void* BufferPool::allocateAligned(size_t bytes) {
+    return ::operator new(bytes, std::align_val_t{kAlignment});
+}
+
+void BufferPool::freeAligned(void* memory) noexcept {
+    ::operator delete(memory, std::align_val_t{kAlignment});
+}
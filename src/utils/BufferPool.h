@@ -0,0 +1,150 @@
+/**
+ * @file BufferPool.h
+ * @brief Per-thread pool of reusable, cache-line aligned scratch buffers.
+ *
+ * Batch workers run the same decode/process/encode steps for every file, so
+ * their scratch buffers (export fade copies, encoder output, deinterleave
+ * lanes, decode chunks) have the same sizes from file to file. Instead of a
+ * fresh heap allocation per call, code leases a buffer from the calling
+ * thread's pool and hands it back when the lease goes out of scope:
+ *
+ * @code
+ *   auto scratch = BufferPool::local().acquire<float>(frames * channels);
+ *   std::copy(src, src + scratch.size(), scratch.data());
+ * @endcode
+ *
+ * Leases must be released on the thread that acquired them. Leased memory is
+ * uninitialized.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class BufferPool final {
+public:
+    static constexpr size_t kAlignment = 64;                        ///< Cache line / AVX-512 friendly
+    static constexpr size_t kMaxCachedBytes = size_t{256} << 20;    ///< Per-thread retention cap
+    static constexpr size_t kMaxCachedBuffers = 16;
+
+    /**
+     * @class Lease
+     * @brief Move-only handle to a pooled buffer of @p count elements.
+     */
+    template <typename T>
+    class Lease final {
+        static_assert(std::is_trivially_copyable_v<T>, "BufferPool only holds trivially copyable elements");
+
+    public:
+        Lease() = default;
+        Lease(BufferPool* pool, void* memory, size_t capacityBytes, size_t count) noexcept
+            : pool_(pool), memory_(memory), capacityBytes_(capacityBytes), count_(count) {}
+
+        ~Lease() { reset(); }
+
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr))
+            , memory_(std::exchange(other.memory_, nullptr))
+            , capacityBytes_(std::exchange(other.capacityBytes_, 0))
+            , count_(std::exchange(other.count_, 0)) {}
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool_ = std::exchange(other.pool_, nullptr);
+                memory_ = std::exchange(other.memory_, nullptr);
+                capacityBytes_ = std::exchange(other.capacityBytes_, 0);
+                count_ = std::exchange(other.count_, 0);
+            }
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        [[nodiscard]] T* data() noexcept { return static_cast<T*>(memory_); }
+        [[nodiscard]] const T* data() const noexcept { return static_cast<const T*>(memory_); }
+        [[nodiscard]] size_t size() const noexcept { return count_; }
+        [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+        [[nodiscard]] T* begin() noexcept { return data(); }
+        [[nodiscard]] T* end() noexcept { return data() + count_; }
+        [[nodiscard]] T& operator[](size_t i) noexcept { return data()[i]; }
+        [[nodiscard]] const T& operator[](size_t i) const noexcept { return data()[i]; }
+
+        /** @brief Return the buffer to its pool early. */
+        void reset() noexcept {
+            if (memory_) {
+                pool_->release(memory_, capacityBytes_);
+                memory_ = nullptr;
+                count_ = 0;
+            }
+        }
+
+    private:
+        BufferPool* pool_{nullptr};
+        void* memory_{nullptr};
+        size_t capacityBytes_{0};
+        size_t count_{0};
+    };
+
+    struct Stats {
+        size_t acquires{0};         ///< Leases handed out
+        size_t heapAllocations{0};  ///< Leases that needed a new heap block
+        size_t cachedBytes{0};      ///< Bytes currently held for reuse
+    };
+
+    BufferPool();
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /** @brief The calling thread's pool. */
+    [[nodiscard]] static BufferPool& local();
+
+    /**
+     * @brief Globally enable or disable reuse (for A/B benchmarks).
+     *
+     * When disabled every lease is a fresh aligned allocation that is freed
+     * on release; existing cached blocks are dropped on their next release.
+     */
+    static void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+    [[nodiscard]] static bool isEnabled() noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+    /** @brief Lease an uninitialized, kAlignment-aligned buffer of @p count elements. */
+    template <typename T>
+    [[nodiscard]] Lease<T> acquire(size_t count) {
+        size_t capacityBytes = 0;
+        void* memory = acquireBytes(count * sizeof(T), capacityBytes);
+        return Lease<T>(this, memory, capacityBytes, count);
+    }
+
+    /** @brief Free all cached blocks of this pool. */
+    void clear() noexcept;
+
+    [[nodiscard]] Stats stats() const noexcept;
+
+private:
+    struct Block {
+        void* memory;
+        size_t bytes;
+    };
+
+    void* acquireBytes(size_t bytes, size_t& capacityBytes);
+    void release(void* memory, size_t capacityBytes) noexcept;
+
+    static void* allocateAligned(size_t bytes);
+    static void freeAligned(void* memory) noexcept;
+
+    std::vector<Block> free_;
+    size_t cachedBytes_{0};
+    size_t acquires_{0};
+    size_t heapAllocations_{0};
+
+    static std::atomic<bool> enabled_;
+};
@@ -0,0 +1,47 @@
+/**
+ * @file ChannelDispatch.h
+ * @brief Select a channel-count specialized kernel once per call.
+ *
+ * Inner loops that step over interleaved channels with a runtime count
+ * can't be unrolled or vectorized well. Kernels instead take the channel
+ * count as a template parameter, and dispatchChannels() picks the mono,
+ * stereo, 5.1 or 7.1 instantiation at the call site, falling back to a
+ * generic instantiation (Channels == 0) that reads the count at runtime:
+ *
+ * @code
+ *   dispatchChannels(channels, [&](auto layout) {
+ *       kernel<decltype(layout)::value>(data, frames, channels);
+ *   });
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+/// Compile-time channel count, or 0 for "any count, given at runtime".
+template <int Channels>
+using ChannelLayout = std::integral_constant<int, Channels>;
+
+/// Channel count a kernel instantiated for @p Channels should use.
+template <int Channels>
+constexpr std::size_t channelStride(int runtimeChannels) noexcept {
+    if constexpr (Channels > 0) {
+        return static_cast<std::size_t>(Channels);
+    } else {
+        return static_cast<std::size_t>(runtimeChannels);
+    }
+}
+
+/// Invoke @p f with ChannelLayout<1>, <2>, <6>, <8> or ChannelLayout<0> (generic).
+template <typename F>
+decltype(auto) dispatchChannels(int channels, F&& f) {
+    switch (channels) {
+        case 1: return f(ChannelLayout<1>{});
+        case 2: return f(ChannelLayout<2>{});
+        case 6: return f(ChannelLayout<6>{});
+        case 8: return f(ChannelLayout<8>{});
+        default: return f(ChannelLayout<0>{});
+    }
+}
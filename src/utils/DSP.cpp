@@ -1,7 +1,10 @@
 #include "DSP.h"
+#include "ChannelDispatch.h"
+#include "SpeakerLayout.h"
 #include <algorithm>
 #include <cmath>
 #include <execution>
+#include <limits>
 #include <numeric>
 
 namespace {
@@ -13,7 +16,7 @@ inline float linearToDb(float lin) { return 20.0f * std::log10(std::max(lin, kEp
 constexpr size_t kParallelThreshold = 10000;
 }
 
-float DSP::computePeakDbFS(const std::vector<float>& samples) {
+float DSP::computePeakDbFS(std::span<const float> samples) {
     if (samples.empty()) return -std::numeric_limits<float>::infinity();
     
     float peak = 0.0f;
@@ -32,7 +35,7 @@ float DSP::computePeakDbFS(const std::vector<float>& samples) {
     return linearToDb(peak);
 }
 
-float DSP::computeRMSDb(const std::vector<float>& samples) {
+float DSP::computeRMSDb(std::span<const float> samples) {
     if (samples.empty()) return -std::numeric_limits<float>::infinity();
     
     double sumSq = 0.0;
@@ -52,7 +55,7 @@ float DSP::computeRMSDb(const std::vector<float>& samples) {
     return static_cast<float>(linearToDb(static_cast<float>(rms)));
 }
 
-void DSP::normalizeToPeak(std::vector<float>& samples, float targetDbFS) {
+void DSP::normalizeToPeak(std::span<float> samples, float targetDbFS) {
     const float currentPeakDb = computePeakDbFS(samples);
     float gainDb = targetDbFS - currentPeakDb;
     float gain = dbToLinear(gainDb);
@@ -66,7 +69,7 @@ void DSP::normalizeToPeak(std::vector<float>& samples, float targetDbFS) {
     }
 }
 
-void DSP::normalizeToRMS(std::vector<float>& samples, float targetDb) {
+void DSP::normalizeToRMS(std::span<float> samples, float targetDb) {
     const float currentRmsDb = computeRMSDb(samples);
     float gainDb = targetDb - currentRmsDb;
     float gain = dbToLinear(gainDb);
@@ -80,28 +83,416 @@ void DSP::normalizeToRMS(std::vector<float>& samples, float targetDb) {
     }
 }
 
-void DSP::compressor(std::vector<float>& samples, float thresholdDb, float ratio,
+void DSP::compressor(std::span<float> samples, float thresholdDb, float ratio,
                      float attackMs, float releaseMs, float makeupDb,
                      int sampleRate, int channels) {
     if (sampleRate <= 0 || channels <= 0) return;
-    float thresholdLin = dbToLinear(thresholdDb);
-    float makeupLin = dbToLinear(makeupDb);
-    float attackCoeff = std::exp(-1.0f / (0.001f * attackMs * sampleRate));
-    float releaseCoeff = std::exp(-1.0f / (0.001f * releaseMs * sampleRate));
-    float env = 0.0f;
-    for (size_t i = 0; i < samples.size(); i += channels) {
+    Compressor comp({thresholdDb, ratio, attackMs, releaseMs, makeupDb, ChannelLink::Groups}, sampleRate);
+    comp.process(samples.data(), samples.size() / static_cast<size_t>(channels), channels);
+}
+
+DSP::Compressor::Compressor(const CompressorSettings& settings, int sampleRate)
+    : thresholdDb_(settings.thresholdDb)
+    , thresholdLin_(dbToLinear(settings.thresholdDb))
+    , ratio_(settings.ratio)
+    , makeupLin_(dbToLinear(settings.makeupDb))
+    , attackCoeff_(std::exp(-1.0f / (0.001f * settings.attackMs * sampleRate)))
+    , releaseCoeff_(std::exp(-1.0f / (0.001f * settings.releaseMs * sampleRate)))
+    , link_(settings.link) {}
+
+void DSP::Compressor::process(float* samples, size_t frames, int channels) noexcept {
+    if (channels <= 0) return;
+    if (link_ == ChannelLink::Groups && channels != groupedChannels_) setupGroups(channels);
+    const bool grouped = link_ == ChannelLink::Groups && groupCount_ > 1;
+    dispatchChannels(channels, [&](auto layout) {
+        if (grouped) {
+            processGroupedFrames<decltype(layout)::value>(samples, frames, channels);
+        } else {
+            processFrames<decltype(layout)::value>(samples, frames, channels);
+        }
+    });
+}
+
+void DSP::Compressor::setupGroups(int channels) noexcept {
+    groupedChannels_ = channels;
+    groupCount_ = channels <= static_cast<int>(kMaxLinkGroups)
+        ? static_cast<size_t>(SpeakerLayout::linkGroupCount(channels)) : 1;
+    for (int c = 0; c < channels && c < static_cast<int>(kMaxLinkGroups); ++c) {
+        groupOf_[static_cast<size_t>(c)] = static_cast<uint8_t>(SpeakerLayout::linkGroup(c, channels));
+    }
+    groupEnv_.fill(env_);
+}
+
+float DSP::Compressor::gainFor(float env) const noexcept {
+    if (env <= thresholdLin_) return 1.0f;
+    float overDb = linearToDb(env) - thresholdDb_;
+    float reducedDb = overDb / ratio_;
+    float gainDb = -(overDb - reducedDb);
+    return dbToLinear(gainDb);
+}
+
+template <int Channels>
+void DSP::Compressor::processFrames(float* samples, size_t frames, int channels) noexcept {
+    const size_t ch = channelStride<Channels>(channels);
+    float env = env_;
+    for (size_t i = 0; i < frames * ch; i += ch) {
         float framePeak = 0.0f;
-        for (int c = 0; c < channels; ++c) framePeak = std::max(framePeak, std::abs(samples[i + c]));
-        env = framePeak > env ? attackCoeff * (env - framePeak) + framePeak : releaseCoeff * (env - framePeak) + framePeak;
-        float gain = 1.0f;
-        if (env > thresholdLin) {
-            float overDb = linearToDb(env) - thresholdDb;
-            float reducedDb = overDb / ratio;
-            float gainDb = -(overDb - reducedDb);
-            gain = dbToLinear(gainDb);
+        for (size_t c = 0; c < ch; ++c) framePeak = std::max(framePeak, std::abs(samples[i + c]));
+        env = framePeak > env ? attackCoeff_ * (env - framePeak) + framePeak : releaseCoeff_ * (env - framePeak) + framePeak;
+        const float gain = gainFor(env);
+        for (size_t c = 0; c < ch; ++c) samples[i + c] *= gain * makeupLin_;
+    }
+    env_ = env;
+}
+
+template <int Channels>
+void DSP::Compressor::processGroupedFrames(float* samples, size_t frames, int channels) noexcept {
+    const size_t ch = channelStride<Channels>(channels);
+    const size_t groups = groupCount_;
+    std::array<float, kMaxLinkGroups> env = groupEnv_;
+    for (size_t i = 0; i < frames * ch; i += ch) {
+        std::array<float, kMaxLinkGroups> peak{};
+        for (size_t c = 0; c < ch; ++c) {
+            peak[groupOf_[c]] = std::max(peak[groupOf_[c]], std::abs(samples[i + c]));
+        }
+        std::array<float, kMaxLinkGroups> gain;
+        for (size_t g = 0; g < groups; ++g) {
+            env[g] = peak[g] > env[g] ? attackCoeff_ * (env[g] - peak[g]) + peak[g]
+                                      : releaseCoeff_ * (env[g] - peak[g]) + peak[g];
+            gain[g] = gainFor(env[g]) * makeupLin_;
+        }
+        for (size_t c = 0; c < ch; ++c) samples[i + c] *= gain[groupOf_[c]];
+    }
+    groupEnv_ = env;
+}
+
+void DSP::limiter(std::span<float> samples, const LimiterSettings& settings, int sampleRate, int channels) {
+    if (sampleRate <= 0 || channels <= 0) return;
+    const auto ch = static_cast<size_t>(channels);
+    const size_t frames = samples.size() / ch;
+    Limiter lim(settings, sampleRate);
+
+    // Limit each block as soon as its gains are known, so the pending gains
+    // never exceed a block plus the look-ahead
+    constexpr size_t kBlockFrames = 4096;
+    size_t limited = 0;
+    for (size_t first = 0; first < frames; first += kBlockFrames) {
+        lim.analyze(samples.data() + first * ch, std::min(kBlockFrames, frames - first), channels);
+        const size_t ready = lim.readyFrames();
+        lim.apply(samples.data() + limited * ch, ready, channels);
+        limited += ready;
+    }
+    lim.finish();
+    lim.apply(samples.data() + limited * ch, lim.readyFrames(), channels);
+}
+
+DSP::Limiter::Limiter(const LimiterSettings& settings, int sampleRate)
+    : lookahead_(std::max<size_t>(1, static_cast<size_t>(std::lround(0.001f * settings.lookaheadMs * sampleRate))))
+    , ceilingLin_(dbToLinear(settings.ceilingDb))
+    , releaseCoeff_(settings.releaseMs > 0.0f ? std::exp(-1.0f / (0.001f * settings.releaseMs * sampleRate)) : 0.0f)
+    , required_(lookahead_, 1.0f)
+    , window_(lookahead_ + 1)
+    , smoothing_(lookahead_, 1.0f)
+    , smoothingSum_(static_cast<double>(lookahead_)) {}
+
+void DSP::Limiter::analyze(const float* samples, size_t frames, int channels) {
+    if (channels <= 0) return;
+    dispatchChannels(channels, [&](auto layout) {
+        analyzeFrames<decltype(layout)::value>(samples, frames, channels);
+    });
+}
+
+void DSP::Limiter::finish() {
+    // Frames past the end need no reduction, so the window just drains
+    while (emitted_ < analyzed_) emitGain();
+}
+
+void DSP::Limiter::apply(float* samples, size_t frames, int channels) noexcept {
+    if (channels <= 0) return;
+    frames = std::min(frames, ready_.size());
+    dispatchChannels(channels, [&](auto layout) {
+        applyFrames<decltype(layout)::value>(samples, frames, channels);
+    });
+    ready_.erase(ready_.begin(), ready_.begin() + static_cast<std::ptrdiff_t>(frames));
+}
+
+template <int Channels>
+void DSP::Limiter::analyzeFrames(const float* samples, size_t frames, int channels) {
+    const size_t ch = channelStride<Channels>(channels);
+    for (size_t i = 0; i < frames * ch; i += ch) {
+        float framePeak = 0.0f;
+        for (size_t c = 0; c < ch; ++c) framePeak = std::max(framePeak, std::abs(samples[i + c]));
+        pushRequired(framePeak > ceilingLin_ ? ceilingLin_ / framePeak : 1.0f);
+    }
+}
+
+template <int Channels>
+void DSP::Limiter::applyFrames(float* samples, size_t frames, int channels) noexcept {
+    const size_t ch = channelStride<Channels>(channels);
+    for (size_t f = 0; f < frames; ++f) {
+        const float gain = ready_[f];
+        for (size_t c = 0; c < ch; ++c) samples[f * ch + c] *= gain;
+    }
+}
+
+void DSP::Limiter::pushRequired(float gain) {
+    const size_t frame = analyzed_++;
+    required_[frame % lookahead_] = gain;
+
+    // Entries that can never be the minimum again leave from the back,
+    // so the front is always the smallest gain in the window
+    const size_t capacity = window_.size();
+    while (windowSize_ > 0 && window_[(windowHead_ + windowSize_ - 1) % capacity].gain >= gain) --windowSize_;
+    window_[(windowHead_ + windowSize_) % capacity] = {frame, gain};
+    ++windowSize_;
+
+    if (analyzed_ >= lookahead_) emitGain();
+}
+
+void DSP::Limiter::emitGain() {
+    const size_t frame = emitted_++;
+    const size_t capacity = window_.size();
+    while (windowSize_ > 0 && window_[windowHead_].frame < frame) {
+        windowHead_ = (windowHead_ + 1) % capacity;
+        --windowSize_;
+    }
+    // Lowest gain any frame in [frame, frame + lookahead) needs
+    const float hold = windowSize_ > 0 ? window_[windowHead_].gain : 1.0f;
+
+    // Drops are taken at once (the average below turns them into a ramp),
+    // recoveries follow the release time
+    released_ = hold < released_ ? hold : hold + releaseCoeff_ * (released_ - hold);
+
+    // Every value averaged here already covers this frame's peak, so the
+    // ramp reaches the required gain by the time the peak arrives
+    smoothingSum_ += static_cast<double>(released_) - smoothing_[smoothingPos_];
+    smoothing_[smoothingPos_] = released_;
+    smoothingPos_ = smoothingPos_ + 1 == lookahead_ ? 0 : smoothingPos_ + 1;
+    const auto average = static_cast<float>(smoothingSum_ / static_cast<double>(lookahead_));
+
+    // The clamp only absorbs rounding in the running sum
+    ready_.push_back(std::min(average, required_[frame % lookahead_]));
+}
+
+namespace {
+// Silence scan granularity: short enough to find an onset within a few
+// milliseconds, long enough that a block's sum of squares vectorizes well
+constexpr int kSilenceBlockMs = 5;
+} // namespace
+
+DSP::FrameRange DSP::findSoundRange(std::span<const float> samples, int sampleRate, int channels,
+                                    const SilenceSettings& settings) {
+    if (sampleRate <= 0 || channels <= 0) return {};
+    const auto ch = static_cast<size_t>(channels);
+    const size_t frames = samples.size() / ch;
+    const size_t blockFrames = std::max<size_t>(1, static_cast<size_t>(sampleRate * kSilenceBlockMs / 1000));
+    const float threshold = dbToLinear(settings.thresholdDb);
+
+    // RMS >= threshold, compared as sums of squares so no block needs a sqrt or log
+    auto blockIsLoud = [&](size_t first, size_t n) {
+        const float* block = samples.data() + first * ch;
+        const float sumSq = std::transform_reduce(std::execution::unseq, block, block + n * ch, 0.0f,
+                                                  std::plus<>(), [](float s) { return s * s; });
+        return sumSq >= threshold * threshold * static_cast<float>(n * ch);
+    };
+    auto frameIsLoud = [&](size_t frame) {
+        for (size_t c = 0; c < ch; ++c) {
+            if (std::abs(samples[frame * ch + c]) >= threshold) return true;
+        }
+        return false;
+    };
+
+    // A block whose RMS reaches the threshold has a sample that does too,
+    // so the refinement loops below stop inside the block
+    size_t start = frames;
+    for (size_t first = 0; first < frames; first += blockFrames) {
+        const size_t n = std::min(blockFrames, frames - first);
+        if (blockIsLoud(first, n)) {
+            start = first;
+            while (start + 1 < first + n && !frameIsLoud(start)) ++start;
+            break;
+        }
+    }
+    if (start == frames) return {};
+
+    size_t end = start + 1;
+    for (size_t last = frames; last > start;) {
+        const size_t first = last - std::min(blockFrames, last - start);
+        if (blockIsLoud(first, last - first)) {
+            end = last;
+            while (end > first + 1 && !frameIsLoud(end - 1)) --end;
+            break;
+        }
+        last = first;
+    }
+
+    const auto preRoll = static_cast<size_t>(std::max(0.0f, settings.preRollMs) * 0.001f * sampleRate);
+    const auto postRoll = static_cast<size_t>(std::max(0.0f, settings.postRollMs) * 0.001f * sampleRate);
+    return {start > preRoll ? start - preRoll : 0, std::min(frames, end + postRoll)};
+}
+
+void DSP::LevelMeter::add(const float* samples, size_t count) noexcept {
+    float peak = peak_;
+    double sumSq = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        peak = std::max(peak, std::abs(samples[i]));
+        sumSq += static_cast<double>(samples[i]) * samples[i];
+    }
+    peak_ = peak;
+    sumSquares_ += sumSq;
+    count_ += count;
+}
+
+DSP::Levels DSP::LevelMeter::levels() const noexcept {
+    if (count_ == 0) {
+        return {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
+    }
+    const double rms = std::sqrt(sumSquares_ / static_cast<double>(count_));
+    return {linearToDb(peak_), linearToDb(static_cast<float>(rms))};
+}
+
+DSP::Levels DSP::measureLevels(std::span<const float> samples) {
+    if (samples.size() < kParallelThreshold) {
+        LevelMeter meter;
+        meter.add(samples.data(), samples.size());
+        return meter.levels();
+    }
+
+    // Parallel reduction of peak and sum of squares together, one read of the buffer
+    struct Partial {
+        float peak;
+        double sumSq;
+    };
+    const Partial total = std::transform_reduce(
+        std::execution::par_unseq,
+        samples.begin(), samples.end(),
+        Partial{0.0f, 0.0},
+        [](Partial a, Partial b) { return Partial{std::max(a.peak, b.peak), a.sumSq + b.sumSq}; },
+        [](float s) { return Partial{std::abs(s), static_cast<double>(s) * s}; }
+    );
+    const double rms = std::sqrt(total.sumSq / static_cast<double>(samples.size()));
+    return {linearToDb(total.peak), linearToDb(static_cast<float>(rms))};
+}
+
+DSP::ChannelLevelMeter::ChannelLevelMeter(int channels)
+    : channels_(std::max(channels, 1))
+    , peak_(static_cast<size_t>(channels_), 0.0f)
+    , sumSquares_(static_cast<size_t>(channels_), 0.0) {}
+
+void DSP::ChannelLevelMeter::add(const float* samples, size_t frames) noexcept {
+    dispatchChannels(channels_, [&](auto layout) {
+        addFrames<decltype(layout)::value>(samples, frames);
+    });
+    frames_ += frames;
+}
+
+template <int Channels>
+void DSP::ChannelLevelMeter::addFrames(const float* samples, size_t frames) noexcept {
+    if constexpr (Channels > 0) {
+        // Accumulate in registers, one lane per channel
+        std::array<float, Channels> peak{};
+        std::array<double, Channels> sumSq{};
+        for (size_t i = 0; i < frames * Channels; i += Channels) {
+            for (size_t c = 0; c < Channels; ++c) {
+                peak[c] = std::max(peak[c], std::abs(samples[i + c]));
+                sumSq[c] += static_cast<double>(samples[i + c]) * samples[i + c];
+            }
+        }
+        for (size_t c = 0; c < Channels; ++c) {
+            peak_[c] = std::max(peak_[c], peak[c]);
+            sumSquares_[c] += sumSq[c];
         }
-        for (int c = 0; c < channels; ++c) samples[i + c] *= gain * makeupLin;
+    } else {
+        const auto ch = static_cast<size_t>(channels_);
+        for (size_t c = 0; c < ch; ++c) {
+            float peak = peak_[c];
+            double sumSq = 0.0;
+            for (size_t i = c; i < frames * ch; i += ch) {
+                peak = std::max(peak, std::abs(samples[i]));
+                sumSq += static_cast<double>(samples[i]) * samples[i];
+            }
+            peak_[c] = peak;
+            sumSquares_[c] += sumSq;
+        }
+    }
+}
+
+void DSP::ChannelLevelMeter::merge(const ChannelLevelMeter& other) noexcept {
+    const size_t n = std::min(peak_.size(), other.peak_.size());
+    for (size_t c = 0; c < n; ++c) {
+        peak_[c] = std::max(peak_[c], other.peak_[c]);
+        sumSquares_[c] += other.sumSquares_[c];
+    }
+    frames_ += other.frames_;
+}
+
+DSP::Levels DSP::ChannelLevelMeter::levels() const noexcept {
+    if (frames_ == 0) {
+        return {-std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity()};
     }
+    const float peak = *std::max_element(peak_.begin(), peak_.end());
+    const double sumSq = std::accumulate(sumSquares_.begin(), sumSquares_.end(), 0.0);
+    const double rms = std::sqrt(sumSq / static_cast<double>(frames_ * peak_.size()));
+    return {linearToDb(peak), linearToDb(static_cast<float>(rms))};
+}
+
+std::vector<DSP::Levels> DSP::ChannelLevelMeter::channelLevels() const {
+    std::vector<Levels> result(peak_.size(), Levels{-std::numeric_limits<float>::infinity(),
+                                                    -std::numeric_limits<float>::infinity()});
+    if (frames_ == 0) return result;
+    for (size_t c = 0; c < peak_.size(); ++c) {
+        const double rms = std::sqrt(sumSquares_[c] / static_cast<double>(frames_));
+        result[c] = {linearToDb(peak_[c]), linearToDb(static_cast<float>(rms))};
+    }
+    return result;
+}
+
+DSP::ChannelLevelMeter DSP::measureChannelLevels(std::span<const float> samples, int channels) {
+    ChannelLevelMeter total(channels);
+    const auto ch = static_cast<size_t>(std::max(channels, 1));
+    const size_t frames = samples.size() / ch;
+    if (samples.size() < kParallelThreshold) {
+        total.add(samples.data(), frames);
+        return total;
+    }
+
+    // One meter per chunk in parallel, merged in order
+    constexpr size_t kChunkFrames = 65536;
+    std::vector<ChannelLevelMeter> partial((frames + kChunkFrames - 1) / kChunkFrames, ChannelLevelMeter(channels));
+    std::vector<size_t> chunks(partial.size());
+    std::iota(chunks.begin(), chunks.end(), size_t{0});
+    std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](size_t i) {
+        const size_t first = i * kChunkFrames;
+        partial[i].add(samples.data() + first * ch, std::min(kChunkFrames, frames - first));
+    });
+    for (const ChannelLevelMeter& meter : partial) total.merge(meter);
+    return total;
+}
+
+namespace {
+template <int Channels>
+void mixFrames(const float* samples, size_t frames, int inChannels, const float* matrix, int outChannels,
+               float* const* out) noexcept {
+    const size_t ch = channelStride<Channels>(inChannels);
+    for (int o = 0; o < outChannels; ++o) {
+        const float* row = matrix + static_cast<size_t>(o) * ch;
+        float* dst = out[o];
+        for (size_t f = 0; f < frames; ++f) {
+            const float* frame = samples + f * ch;
+            float acc = 0.0f;
+            for (size_t c = 0; c < ch; ++c) acc += row[c] * frame[c];
+            dst[f] = acc;
+        }
+    }
+}
+} // namespace
+
+void DSP::mixChannels(const float* samples, size_t frames, int inChannels, const float* matrix, int outChannels,
+                      float* const* out) noexcept {
+    if (inChannels <= 0 || outChannels <= 0) return;
+    dispatchChannels(inChannels, [&](auto layout) {
+        mixFrames<decltype(layout)::value>(samples, frames, inChannels, matrix, outChannels, out);
+    });
 }
 
 namespace {
@@ -149,30 +540,95 @@ float computeFadeGain(size_t position, size_t fadeLength, DSP::FadeType fadeType
 }
 } // anonymous namespace
 
-void DSP::applyFadeIn(std::vector<float>& samples, size_t fadeLengthSamples, FadeType fadeType) {
-    if (samples.empty() || fadeLengthSamples == 0) return;
-    
-    // Clamp fade length to buffer size
-    size_t actualFadeLength = std::min(fadeLengthSamples, samples.size());
-    
-    for (size_t i = 0; i < actualFadeLength; ++i) {
-        float gain = computeFadeGain(i, actualFadeLength, fadeType, true);
-        samples[i] *= gain;
-    }
+bool DSP::FadeEnvelope::touches(size_t firstFrame, size_t frames, size_t totalFrames) const noexcept {
+    const size_t inEnd = std::min(fadeInFrames, totalFrames);
+    const size_t outStart = totalFrames - std::min(fadeOutFrames, totalFrames);
+    return frames > 0 && (firstFrame < inEnd || firstFrame + frames > outStart);
 }
 
-void DSP::applyFadeOut(std::vector<float>& samples, size_t fadeLengthSamples, FadeType fadeType) {
-    if (samples.empty() || fadeLengthSamples == 0) return;
-    
-    // Clamp fade length to buffer size
-    size_t actualFadeLength = std::min(fadeLengthSamples, samples.size());
-    size_t fadeStart = samples.size() - actualFadeLength;
-    
-    for (size_t i = 0; i < actualFadeLength; ++i) {
-        float gain = computeFadeGain(i, actualFadeLength, fadeType, false);
-        samples[fadeStart + i] *= gain;
+namespace {
+template <int Channels>
+void fadeFrames(float* block, size_t frames, int channels, size_t firstFrame,
+                size_t totalFrames, const DSP::FadeEnvelope& envelope) {
+    const size_t ch = channelStride<Channels>(channels);
+    const size_t blockEnd = std::min(firstFrame + frames, totalFrames);
+
+    // Clamp fade lengths to the stream, as a fade can't be longer than the audio
+    const size_t inLength = std::min(envelope.fadeInFrames, totalFrames);
+    for (size_t f = firstFrame; f < std::min(blockEnd, inLength); ++f) {
+        const float gain = computeFadeGain(f, inLength, envelope.type, true);
+        float* frame = block + (f - firstFrame) * ch;
+        for (size_t c = 0; c < ch; ++c) frame[c] *= gain;
+    }
+
+    const size_t outLength = std::min(envelope.fadeOutFrames, totalFrames);
+    const size_t outStart = totalFrames - outLength;
+    for (size_t f = std::max(firstFrame, outStart); f < blockEnd; ++f) {
+        const float gain = computeFadeGain(f - outStart, outLength, envelope.type, false);
+        float* frame = block + (f - firstFrame) * ch;
+        for (size_t c = 0; c < ch; ++c) frame[c] *= gain;
     }
 }
+} // namespace
+
+void DSP::applyFadeEnvelope(float* block, size_t frames, int channels, size_t firstFrame,
+                            size_t totalFrames, const FadeEnvelope& envelope) {
+    if (frames == 0 || channels <= 0) return;
+    dispatchChannels(channels, [&](auto layout) {
+        fadeFrames<decltype(layout)::value>(block, frames, channels, firstFrame, totalFrames, envelope);
+    });
+}
+
+void DSP::applyFadeIn(std::span<float> samples, size_t fadeLengthFrames, FadeType fadeType, int channels) {
+    if (channels <= 0) return;
+    const size_t frames = samples.size() / static_cast<size_t>(channels);
+    applyFadeEnvelope(samples.data(), frames, channels, 0, frames, {fadeLengthFrames, 0, fadeType});
+}
+
+void DSP::applyFadeOut(std::span<float> samples, size_t fadeLengthFrames, FadeType fadeType, int channels) {
+    if (channels <= 0) return;
+    const size_t frames = samples.size() / static_cast<size_t>(channels);
+    applyFadeEnvelope(samples.data(), frames, channels, 0, frames, {0, fadeLengthFrames, fadeType});
+}
+
+namespace {
+inline int16_t toInt16(float v) {
+    return static_cast<int16_t>(std::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+
+template <int Channels>
+void convertFrames(const float* samples, int16_t* out, size_t frames, int channels,
+                   const DSP::FadeEnvelope& fades) {
+    const size_t ch = channelStride<Channels>(channels);
+    const size_t inLength = std::min(fades.fadeInFrames, frames);
+    const size_t outLength = std::min(fades.fadeOutFrames, frames);
+    const size_t outStart = frames - outLength;
+
+    // Frames between the fades: one straight loop the compiler can vectorize
+    const size_t plainEnd = std::max(outStart, inLength);
+    for (size_t i = inLength * ch; i < plainEnd * ch; ++i) out[i] = toInt16(samples[i]);
+
+    // Fade frames; on short clips the fades can overlap and both gains apply
+    auto convertFrame = [&](size_t f) {
+        float gain = 1.0f;
+        if (f < inLength) gain *= computeFadeGain(f, inLength, fades.type, true);
+        if (f >= outStart) gain *= computeFadeGain(f - outStart, outLength, fades.type, false);
+        const float* src = samples + f * ch;
+        int16_t* dst = out + f * ch;
+        for (size_t c = 0; c < ch; ++c) dst[c] = toInt16(src[c] * gain);
+    };
+    for (size_t f = 0; f < inLength; ++f) convertFrame(f);
+    for (size_t f = plainEnd; f < frames; ++f) convertFrame(f);
+}
+} // namespace
+
+void DSP::convertToInt16(const float* samples, int16_t* out, size_t frames, int channels,
+                         const FadeEnvelope& fades) {
+    if (frames == 0 || channels <= 0) return;
+    dispatchChannels(channels, [&](auto layout) {
+        convertFrames<decltype(layout)::value>(samples, out, frames, channels, fades);
+    });
+}
 
 
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace DSP {
@@ -13,29 +17,307 @@ enum class FadeType {
     SCurve       ///< S-curve (slow-fast-slow, smooth transition)
 };
 
-[[nodiscard]] float computePeakDbFS(const std::vector<float>& samples);
-[[nodiscard]] float computeRMSDb(const std::vector<float>& samples);
-void normalizeToPeak(std::vector<float>& samples, float targetDbFS);
-void normalizeToRMS(std::vector<float>& samples, float targetDb);
-void compressor(std::vector<float>& samples, float thresholdDb, float ratio,
+[[nodiscard]] float computePeakDbFS(std::span<const float> samples);
+[[nodiscard]] float computeRMSDb(std::span<const float> samples);
+void normalizeToPeak(std::span<float> samples, float targetDbFS);
+void normalizeToRMS(std::span<float> samples, float targetDb);
+void compressor(std::span<float> samples, float thresholdDb, float ratio,
                 float attackMs, float releaseMs, float makeupDb,
                 int sampleRate, int channels);
 
+/** @brief Peak and RMS level of a signal, as computePeakDbFS() and computeRMSDb() report them. */
+struct Levels {
+    float peakDb{0.0f};
+    float rmsDb{0.0f};
+};
+
+/**
+ * @brief Running peak/RMS measurement, fed one block at a time.
+ *
+ * Lets a processing loop measure its output while writing it instead of
+ * reading the buffer again afterwards.
+ */
+class LevelMeter {
+public:
+    void add(const float* samples, size_t count) noexcept;
+    [[nodiscard]] Levels levels() const noexcept;
+
+private:
+    float peak_{0.0f};
+    double sumSquares_{0.0};
+    size_t count_{0};
+};
+
+/** @brief Peak and RMS in a single pass over the samples. */
+[[nodiscard]] Levels measureLevels(std::span<const float> samples);
+
+/**
+ * @brief LevelMeter for each channel of interleaved frames.
+ *
+ * levels() gives the levels of all channels together, as LevelMeter would
+ * measure them, from the same pass.
+ */
+class ChannelLevelMeter {
+public:
+    explicit ChannelLevelMeter(int channels);
+
+    void add(const float* samples, size_t frames) noexcept;
+
+    /** @brief Add what @p other measured (of the same channel count), e.g. over another part of a clip. */
+    void merge(const ChannelLevelMeter& other) noexcept;
+
+    [[nodiscard]] Levels levels() const noexcept;
+    [[nodiscard]] std::vector<Levels> channelLevels() const;
+
+private:
+    /// add() for a compile-time channel count (0 = runtime channels_).
+    template <int Channels>
+    void addFrames(const float* samples, size_t frames) noexcept;
+
+    int channels_;
+    std::vector<float> peak_;
+    std::vector<double> sumSquares_;
+    size_t frames_{0};
+};
+
+/** @brief Levels of each channel and of all together, in one pass (in parallel for large buffers). */
+[[nodiscard]] ChannelLevelMeter measureChannelLevels(std::span<const float> samples, int channels);
+
+/**
+ * @brief Mix interleaved frames through a gain matrix into one planar buffer per output channel.
+ *
+ * @param matrix @p outChannels rows of @p inChannels gains (see SpeakerLayout::mixMatrix)
+ * @param out @p outChannels buffers of @p frames samples each
+ */
+void mixChannels(const float* samples, size_t frames, int inChannels, const float* matrix, int outChannels,
+                 float* const* out) noexcept;
+
+/** @brief How a compressor shares its gain between channels. */
+enum class ChannelLink {
+    Groups,     ///< One gain per speaker group (SpeakerLayout::linkGroup); one for mono and stereo
+    All         ///< One gain for every channel
+};
+
+/** @brief Parameters of compressor(). */
+struct CompressorSettings {
+    float thresholdDb;
+    float ratio;
+    float attackMs;
+    float releaseMs;
+    float makeupDb;
+    ChannelLink link{ChannelLink::Groups};
+};
+
+/**
+ * @brief Stateful form of compressor(), fed one block of frames at a time.
+ *
+ * The envelope carries over between calls, so processing a buffer in blocks
+ * gives the same result as compressor() over the whole buffer.
+ *
+ * Surround layouts are compressed in linked groups by default: each group
+ * of speakers (front pair, centre, LFE, surround pairs) follows its own
+ * envelope, so the LFE does not pump the dialogue in the centre.
+ */
+class Compressor {
+public:
+    Compressor(const CompressorSettings& settings, int sampleRate);
+    void process(float* samples, size_t frames, int channels) noexcept;
+
+private:
+    static constexpr size_t kMaxLinkGroups = 8;
+
+    /// process() for a compile-time channel count (0 = runtime @p channels), all channels linked.
+    template <int Channels>
+    void processFrames(float* samples, size_t frames, int channels) noexcept;
+
+    /// process() with one envelope per link group.
+    template <int Channels>
+    void processGroupedFrames(float* samples, size_t frames, int channels) noexcept;
+
+    void setupGroups(int channels) noexcept;
+    [[nodiscard]] float gainFor(float env) const noexcept;
+
+    float thresholdDb_;
+    float thresholdLin_;
+    float ratio_;
+    float makeupLin_;
+    float attackCoeff_;
+    float releaseCoeff_;
+    float env_{0.0f};
+
+    ChannelLink link_;
+    int groupedChannels_{0};                        ///< Channel count the groups were set up for
+    size_t groupCount_{1};
+    std::array<uint8_t, kMaxLinkGroups> groupOf_{}; ///< Link group of each channel
+    std::array<float, kMaxLinkGroups> groupEnv_{};
+};
+
+/** @brief Parameters of limiter(). */
+struct LimiterSettings {
+    float ceilingDb;    ///< No output sample exceeds this level (dBFS)
+    float lookaheadMs;  ///< How far ahead peaks are seen; also the gain attack time
+    float releaseMs;    ///< Time constant of the gain recovering after a peak
+};
+
+/**
+ * @brief Brickwall look-ahead limiter over interleaved samples, in place.
+ *
+ * The gain reaches what a peak needs by the time the peak arrives, so the
+ * output never exceeds the ceiling, and it ramps down and back up without
+ * steps. Material below the ceiling passes through unchanged.
+ */
+void limiter(std::span<float> samples, const LimiterSettings& settings, int sampleRate, int channels);
+
+/**
+ * @brief Stateful form of limiter(), fed one block of frames at a time.
+ *
+ * The gain of a frame depends on the look-ahead frames after it, so input
+ * and output are decoupled: analyze() takes the next block of input,
+ * after which readyFrames() frames (a look-ahead behind) can be passed to
+ * apply(). finish() ends the stream and makes the remaining frames ready.
+ * The caller keeps the samples; the limiter only holds per-frame gains.
+ *
+ * The look-ahead maximum is a sliding-window minimum of the required gain
+ * kept in a monotonic deque, so every frame costs O(1) whatever the
+ * look-ahead length; a moving average over the same window smooths it into
+ * a linear ramp.
+ */
+class Limiter {
+public:
+    Limiter(const LimiterSettings& settings, int sampleRate);
+
+    /** @brief Look-ahead in frames; apply() trails analyze() by this much. */
+    [[nodiscard]] size_t lookaheadFrames() const noexcept { return lookahead_; }
+
+    void analyze(const float* samples, size_t frames, int channels);
+    void finish();
+
+    /** @brief Frames whose gain is known and can be passed to apply(). */
+    [[nodiscard]] size_t readyFrames() const noexcept { return ready_.size(); }
+
+    /** @brief Limit the next @p frames frames of the stream; at most readyFrames(). */
+    void apply(float* samples, size_t frames, int channels) noexcept;
+
+private:
+    /// analyze()/apply() for a compile-time channel count (0 = runtime @p channels).
+    template <int Channels>
+    void analyzeFrames(const float* samples, size_t frames, int channels);
+    template <int Channels>
+    void applyFrames(float* samples, size_t frames, int channels) noexcept;
+
+    void pushRequired(float gain);
+    void emitGain();
+
+    struct WindowEntry {
+        size_t frame;
+        float gain;
+    };
+
+    size_t lookahead_;
+    float ceilingLin_;
+    float releaseCoeff_;
+
+    std::vector<float> required_;       ///< Required gain of the last lookahead_ frames (ring)
+    std::vector<WindowEntry> window_;   ///< Monotonic deque of window minima (ring)
+    size_t windowHead_{0};
+    size_t windowSize_{0};
+    std::vector<float> smoothing_;      ///< Released hold gains being averaged (ring)
+    size_t smoothingPos_{0};
+    double smoothingSum_{0.0};
+    float released_{1.0f};
+    size_t analyzed_{0};
+    size_t emitted_{0};
+    std::vector<float> ready_;          ///< Gains of frames not yet applied
+};
+
+/** @brief Parameters of findSoundRange(). */
+struct SilenceSettings {
+    float thresholdDb;  ///< Blocks with an RMS below this level (dBFS) count as silence
+    float preRollMs;    ///< Silence kept before the first sound
+    float postRollMs;   ///< Silence kept after the last sound, so tails can decay
+};
+
+/** @brief Frames [startFrame, endFrame) of a clip. */
+struct FrameRange {
+    size_t startFrame{0};
+    size_t endFrame{0};
+
+    [[nodiscard]] bool empty() const noexcept { return endFrame <= startFrame; }
+};
+
+/**
+ * @brief Find the part of a clip between its leading and trailing silence.
+ *
+ * Scans inward from both ends in 5 ms blocks, comparing each block's RMS
+ * with the threshold, so only the silence and one block at each edge are
+ * read. Each edge then moves to the first (last) frame above the threshold
+ * inside its block and is widened by the pre-/post-roll.
+ * @return The range to keep; empty if the whole clip is silence.
+ */
+[[nodiscard]] FrameRange findSoundRange(std::span<const float> samples, int sampleRate, int channels,
+                                        const SilenceSettings& settings);
+
+/**
+ * @brief Fade-in/fade-out gain envelope, evaluated block by block.
+ *
+ * Lengths are in frames, so every channel of a frame gets the same gain.
+ * Writers apply it to each block as they stream it out, which avoids
+ * fading a full copy of the clip first.
+ */
+struct FadeEnvelope {
+    size_t fadeInFrames{0};
+    size_t fadeOutFrames{0};
+    FadeType type{FadeType::SCurve};
+
+    [[nodiscard]] bool isActive() const noexcept { return fadeInFrames > 0 || fadeOutFrames > 0; }
+
+    /** @brief True if any frame of [firstFrame, firstFrame + frames) lies inside a fade. */
+    [[nodiscard]] bool touches(size_t firstFrame, size_t frames, size_t totalFrames) const noexcept;
+};
+
+/**
+ * @brief Apply a fade envelope to one block of a longer interleaved stream.
+ * @param block Interleaved samples of the block, modified in-place
+ * @param frames Number of frames in the block
+ * @param channels Number of interleaved channels
+ * @param firstFrame Position of the block's first frame within the stream
+ * @param totalFrames Length of the whole stream in frames
+ * @param envelope Fade lengths and curve
+ */
+void applyFadeEnvelope(float* block, size_t frames, int channels, size_t firstFrame,
+                       size_t totalFrames, const FadeEnvelope& envelope);
+
 /**
  * @brief Apply a fade-in effect to the beginning of the sample buffer.
- * @param samples Audio samples to modify in-place
- * @param fadeLengthSamples Number of samples over which to apply the fade
+ * @param samples Interleaved audio samples to modify in-place
+ * @param fadeLengthFrames Number of frames over which to apply the fade
  * @param fadeType Type of fade curve to use
+ * @param channels Number of interleaved channels
  */
-void applyFadeIn(std::vector<float>& samples, size_t fadeLengthSamples, FadeType fadeType);
+void applyFadeIn(std::span<float> samples, size_t fadeLengthFrames, FadeType fadeType, int channels = 1);
 
 /**
  * @brief Apply a fade-out effect to the end of the sample buffer.
- * @param samples Audio samples to modify in-place
- * @param fadeLengthSamples Number of samples over which to apply the fade
+ * @param samples Interleaved audio samples to modify in-place
+ * @param fadeLengthFrames Number of frames over which to apply the fade
  * @param fadeType Type of fade curve to use
+ * @param channels Number of interleaved channels
+ */
+void applyFadeOut(std::span<float> samples, size_t fadeLengthFrames, FadeType fadeType, int channels = 1);
+
+/**
+ * @brief Convert interleaved float samples to 16-bit PCM, applying a fade envelope.
+ *
+ * Samples are clamped to [-1, 1] before conversion. Frames between the fades
+ * are converted without a gain multiply.
+ * @param samples Interleaved float samples
+ * @param out Destination for frames * channels samples
+ * @param frames Number of frames to convert
+ * @param channels Number of interleaved channels
+ * @param fades Fades over the converted range
  */
-void applyFadeOut(std::vector<float>& samples, size_t fadeLengthSamples, FadeType fadeType);
+void convertToInt16(const float* samples, int16_t* out, size_t frames, int channels,
+                    const FadeEnvelope& fades = {});
 
 }
 
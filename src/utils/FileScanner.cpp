@@ -7,13 +7,14 @@ std::vector<std::string> FileScanner::scan(const std::string& folder) const {
     if (!fs::exists(folder)) return results;
     for (auto& entry : fs::recursive_directory_iterator(folder)) {
         if (!entry.is_regular_file()) continue;
-        auto ext = entry.path().extension().string();
-        if (ext == ".wav" || ext == ".WAV" || ext == ".mp3" || ext == ".MP3") {
+        if (isAudioFile(entry.path().string())) {
             results.push_back(entry.path().string());
         }
     }
     return results;
 }
 
-
-
+bool FileScanner::isAudioFile(const std::string& path) {
+    auto ext = std::filesystem::path(path).extension().string();
+    return ext == ".wav" || ext == ".WAV" || ext == ".mp3" || ext == ".MP3";
+}
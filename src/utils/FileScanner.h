@@ -6,7 +6,7 @@
 class FileScanner final {
 public:
     [[nodiscard]] std::vector<std::string> scan(const std::string& folder) const;
-};
-
-
 
+    /// True for the file types scan() returns.
+    [[nodiscard]] static bool isAudioFile(const std::string& path);
+};
@@ -0,0 +1,32 @@
+/**
+ * @file FileStamp.h
+ * @brief Size and modification time of a file, for telling whether it changed.
+ *
+ * The fingerprint index, the export cache and the project's cached clip
+ * info all skip work for files whose stamp matches the one they stored.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <system_error>
+
+struct FileStamp {
+    uint64_t size{0};
+    int64_t modifiedTime{0};    ///< Filesystem clock ticks; only compared for equality
+
+    friend bool operator==(const FileStamp&, const FileStamp&) = default;
+};
+
+/** @brief Stamp of @p path, or nullopt if it cannot be read. */
+[[nodiscard]] inline std::optional<FileStamp> fileStamp(const std::string& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    if (ec) return std::nullopt;
+    const auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return std::nullopt;
+    return FileStamp{static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count())};
+}
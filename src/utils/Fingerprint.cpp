@@ -0,0 +1,301 @@
+/**
+ * @file Fingerprint.cpp
+ * @brief Implementation of the spectral-peak fingerprinter.
+ */
+
+#include "Fingerprint.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kAnalysisRate = 11025.0;
+constexpr size_t kFrameSize = 512;                  // ~46 ms at the analysis rate
+constexpr size_t kHop = 256;
+constexpr size_t kBins = kFrameSize / 2;            // Bins 1..255 are used; each fits in 8 bits
+constexpr size_t kPeaksPerFrame = 3;
+constexpr size_t kTargetFrames = 3;                 // Anchors pair with the next 3 frames
+constexpr uint32_t kDtBits = 2;
+static_assert(8 + 8 + kDtBits == kFingerprintHashBits);
+constexpr float kRelativeFloor = 1e-4f;             // -40 dB below the frame's loudest bin
+constexpr float kAbsoluteFloor = 1e-4f;             // About -80 dBFS for a sine
+constexpr size_t kBlockFrames = 4096;
+
+/// A hash repeated so often in both sounds (a steady tone or hum) votes for
+/// too many offsets to tell anything; it is left out of the alignment.
+constexpr size_t kMaxPairsPerHash = 4096;
+
+/// Twiddle factors and bit-reversal permutation of the kFrameSize-point FFT.
+struct FftTables {
+    std::array<float, kFrameSize / 2> cosTable;
+    std::array<float, kFrameSize / 2> sinTable;
+    std::array<uint16_t, kFrameSize> bitReverse;
+
+    FftTables() {
+        for (size_t k = 0; k < kFrameSize / 2; ++k) {
+            cosTable[k] = static_cast<float>(std::cos(2.0 * kPi * k / kFrameSize));
+            sinTable[k] = static_cast<float>(-std::sin(2.0 * kPi * k / kFrameSize));
+        }
+        size_t bits = 0;
+        while ((size_t{1} << bits) < kFrameSize) ++bits;
+        for (size_t i = 0; i < kFrameSize; ++i) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; ++b) {
+                if (i & (size_t{1} << b)) r |= size_t{1} << (bits - 1 - b);
+            }
+            bitReverse[i] = static_cast<uint16_t>(r);
+        }
+    }
+};
+
+const FftTables& fftTables() {
+    static const FftTables tables;
+    return tables;
+}
+
+/// In-place iterative radix-2 FFT of kFrameSize complex values.
+void fft(float* re, float* im) {
+    const FftTables& t = fftTables();
+    for (size_t i = 0; i < kFrameSize; ++i) {
+        const size_t j = t.bitReverse[i];
+        if (j > i) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for (size_t len = 2; len <= kFrameSize; len <<= 1) {
+        const size_t half = len / 2;
+        const size_t stride = kFrameSize / len;
+        for (size_t start = 0; start < kFrameSize; start += len) {
+            for (size_t k = 0; k < half; ++k) {
+                const float wr = t.cosTable[k * stride];
+                const float wi = t.sinTable[k * stride];
+                const size_t a = start + k;
+                const size_t b = a + half;
+                const float tr = re[b] * wr - im[b] * wi;
+                const float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+}
+
+Fingerprinter::Fingerprinter(int sampleRate, int channels)
+    : sampleRate_(std::max(1, sampleRate))
+    , channels_(std::max(1, channels))
+    , step_(std::max(1.0, sampleRate_ / kAnalysisRate))
+    , frame_(kFrameSize, 0.0f)
+    , window_(kFrameSize)
+    , re_(kFrameSize)
+    , im_(kFrameSize)
+    , recent_(kTargetFrames + 1)
+{
+    for (size_t i = 0; i < kFrameSize; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / (kFrameSize - 1)));
+    }
+    // The format is part of the identity: the same samples at another rate are a different sound
+    for (int shift = 0; shift < 32; shift += 8) {
+        contentHash_.addByte(static_cast<uint8_t>(sampleRate_ >> shift));
+    }
+    contentHash_.addByte(static_cast<uint8_t>(channels_));
+}
+
+void Fingerprinter::add(const float* samples, size_t frames) {
+    const size_t channels = static_cast<size_t>(channels_);
+    const float mixGain = 1.0f / static_cast<float>(channels);
+
+    for (size_t f = 0; f < frames; ++f) {
+        const float* frame = samples + f * channels;
+        float mono = 0.0f;
+        for (size_t ch = 0; ch < channels; ++ch) {
+            const float x = std::clamp(frame[ch], -1.0f, 1.0f);
+            const auto q = static_cast<uint16_t>(static_cast<int16_t>(std::lrint(x * 32767.0f)));
+            contentHash_.addByte(static_cast<uint8_t>(q));
+            contentHash_.addByte(static_cast<uint8_t>(q >> 8));
+            mono += frame[ch];
+        }
+        decimationSum_ += mono * mixGain;
+        ++decimationCount_;
+        phase_ += 1.0;
+        if (phase_ >= step_) {
+            phase_ -= step_;
+            pushAnalysisSample(static_cast<float>(decimationSum_ / decimationCount_));
+            decimationSum_ = 0.0;
+            decimationCount_ = 0;
+        }
+    }
+    framesAdded_ += frames;
+}
+
+void Fingerprinter::pushAnalysisSample(float sample) {
+    frame_[frameFill_++] = sample;
+    if (frameFill_ == kFrameSize) {
+        analyzeFrame();
+        std::copy(frame_.begin() + kHop, frame_.end(), frame_.begin());
+        frameFill_ = kFrameSize - kHop;
+    }
+}
+
+void Fingerprinter::analyzeFrame() {
+    for (size_t i = 0; i < kFrameSize; ++i) {
+        re_[i] = frame_[i] * window_[i];
+        im_[i] = 0.0f;
+    }
+    fft(re_.data(), im_.data());
+
+    // Power spectrum, reusing re_ for bins 0..kBins
+    float loudest = 0.0f;
+    for (size_t k = 0; k <= kBins; ++k) {
+        re_[k] = re_[k] * re_[k] + im_[k] * im_[k];
+        loudest = std::max(loudest, re_[k]);
+    }
+    const float floor = std::max(kAbsoluteFloor, loudest * kRelativeFloor);
+
+    // Strongest local maxima, kept sorted by power (strongest first)
+    std::array<uint16_t, kPeaksPerFrame> peaks{};
+    std::array<float, kPeaksPerFrame> peakPower{};
+    size_t peakCount = 0;
+    for (size_t k = 1; k < kBins; ++k) {
+        const float p = re_[k];
+        if (p <= floor || p <= re_[k - 1] || p < re_[k + 1]) continue;
+        if (peakCount == kPeaksPerFrame && p <= peakPower[peakCount - 1]) continue;
+        size_t pos = std::min(peakCount, kPeaksPerFrame - 1);
+        while (pos > 0 && peakPower[pos - 1] < p) {
+            peaks[pos] = peaks[pos - 1];
+            peakPower[pos] = peakPower[pos - 1];
+            --pos;
+        }
+        peaks[pos] = static_cast<uint16_t>(k);
+        peakPower[pos] = p;
+        peakCount = std::min(peakCount + 1, kPeaksPerFrame);
+    }
+
+    // Pair the strongest peak of this frame with the anchors of the frames before it
+    if (peakCount > 0) {
+        const uint32_t target = peaks[0];
+        for (size_t dt = 1; dt <= kTargetFrames && dt <= frameIndex_; ++dt) {
+            for (uint16_t anchor : recent_[(frameIndex_ - dt) % recent_.size()]) {
+                const uint32_t hash = (static_cast<uint32_t>(anchor) << (8 + kDtBits))
+                                      | (target << kDtBits)
+                                      | static_cast<uint32_t>(dt - 1);
+                landmarks_.push_back({hash, static_cast<uint32_t>(frameIndex_ - dt)});
+            }
+        }
+    }
+
+    auto& slot = recent_[frameIndex_ % recent_.size()];
+    slot.assign(peaks.begin(), peaks.begin() + static_cast<std::ptrdiff_t>(peakCount));
+    ++frameIndex_;
+}
+
+Fingerprint Fingerprinter::finish() {
+    if (decimationCount_ > 0) {
+        pushAnalysisSample(static_cast<float>(decimationSum_ / decimationCount_));
+        decimationSum_ = 0.0;
+        decimationCount_ = 0;
+    }
+    // Zero-pad the last partial frame so short sounds get at least one frame
+    const size_t analyzedFill = frameIndex_ == 0 ? 0 : kFrameSize - kHop;
+    if (frameFill_ > analyzedFill) {
+        std::fill(frame_.begin() + static_cast<std::ptrdiff_t>(frameFill_), frame_.end(), 0.0f);
+        analyzeFrame();
+    }
+
+    std::sort(landmarks_.begin(), landmarks_.end());
+    landmarks_.erase(std::unique(landmarks_.begin(), landmarks_.end()), landmarks_.end());
+
+    Fingerprint result;
+    result.contentHash = contentHash_.value();
+    result.landmarks = std::move(landmarks_);
+    result.durationSeconds = static_cast<double>(framesAdded_) / sampleRate_;
+    landmarks_.clear();
+    return result;
+}
+
+void FingerprintSink::begin(int sampleRate, int channels, size_t) {
+    fingerprinter_.emplace(sampleRate, channels);
+}
+
+void FingerprintSink::frames(const float* samples, size_t, size_t frames) {
+    if (fingerprinter_) fingerprinter_->add(samples, frames);
+}
+
+std::optional<Fingerprint> FingerprintSink::finish() {
+    if (!fingerprinter_) return std::nullopt;
+    return fingerprinter_->finish();
+}
+
+Fingerprint fingerprintSamples(std::span<const float> samples, int sampleRate, int channels) {
+    Fingerprinter fingerprinter(sampleRate, channels);
+    const size_t stride = static_cast<size_t>(std::max(1, channels));
+    const size_t frames = samples.size() / stride;
+    for (size_t start = 0; start < frames; start += kBlockFrames) {
+        const size_t count = std::min(kBlockFrames, frames - start);
+        fingerprinter.add(samples.data() + start * stride, count);
+    }
+    return fingerprinter.finish();
+}
+
+double fingerprintSimilarity(const Fingerprint& a, const Fingerprint& b) {
+    const bool aSmaller = a.landmarks.size() <= b.landmarks.size();
+    const auto& small = aSmaller ? a.landmarks : b.landmarks;
+    const auto& large = aSmaller ? b.landmarks : a.landmarks;
+    if (small.empty()) return 0.0;
+
+    // Every pair of landmarks with the same hash votes for the offset between
+    // them: (offset, landmark of the smaller fingerprint)
+    std::vector<std::pair<int64_t, uint32_t>> votes;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < small.size() && j < large.size()) {
+        if (small[i].hash < large[j].hash) {
+            ++i;
+        } else if (large[j].hash < small[i].hash) {
+            ++j;
+        } else {
+            const uint32_t hash = small[i].hash;
+            size_t iEnd = i;
+            size_t jEnd = j;
+            while (iEnd < small.size() && small[iEnd].hash == hash) ++iEnd;
+            while (jEnd < large.size() && large[jEnd].hash == hash) ++jEnd;
+            if ((iEnd - i) * (jEnd - j) <= kMaxPairsPerHash) {
+                for (size_t x = i; x < iEnd; ++x) {
+                    for (size_t y = j; y < jEnd; ++y) {
+                        votes.emplace_back(static_cast<int64_t>(large[y].frame) - static_cast<int64_t>(small[x].frame),
+                                           static_cast<uint32_t>(x));
+                    }
+                }
+            }
+            i = iEnd;
+            j = jEnd;
+        }
+    }
+    std::sort(votes.begin(), votes.end());
+
+    // A landmark votes at most once per offset; the best offset counts the
+    // landmarks that voted for it or the next one, each once
+    size_t best = 0;
+    size_t group = 0;
+    while (group < votes.size()) {
+        size_t groupEnd = group;
+        while (groupEnd < votes.size() && votes[groupEnd].first == votes[group].first) ++groupEnd;
+        size_t count = groupEnd - group;
+        if (groupEnd < votes.size() && votes[groupEnd].first == votes[group].first + 1) {
+            size_t x = group;
+            size_t y = groupEnd;
+            while (y < votes.size() && votes[y].first == votes[group].first + 1) {
+                while (x < groupEnd && votes[x].second < votes[y].second) ++x;
+                if (x == groupEnd || votes[x].second != votes[y].second) ++count;
+                ++y;
+            }
+        }
+        best = std::max(best, count);
+        group = groupEnd;
+    }
+    return static_cast<double>(best) / static_cast<double>(small.size());
+}
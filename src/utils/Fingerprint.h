@@ -0,0 +1,126 @@
+/**
+ * @file Fingerprint.h
+ * @brief Spectral-peak audio fingerprints for duplicate detection.
+ *
+ * A fingerprint is the set of landmarks of a sound: the strongest spectral
+ * peaks of each analysis frame are paired with the strongest peak of each
+ * of the next few frames, and each pair (anchor bin, target bin, frame
+ * distance) becomes one 18-bit hash, stored with the frame of its anchor.
+ * Peaks are picked relative to the loudest bin of their frame, so gain
+ * changes, re-encoding, resampling and small trims keep most of the
+ * landmarks.
+ *
+ * A hash alone is weak evidence: a long, noisy recording produces most of
+ * the hash space at some point. Two sounds only match where many of their
+ * shared hashes occur at one consistent time offset, which unrelated
+ * sounds do not do however long they are.
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "utils/FrameRanges.h"
+#include "utils/Hash.h"
+
+/// Landmark hashes are below 1 << kFingerprintHashBits.
+inline constexpr uint32_t kFingerprintHashBits = 18;
+
+/**
+ * @brief One landmark: a peak-pair hash and the analysis frame of its anchor peak.
+ */
+struct Landmark {
+    uint32_t hash{0};
+    uint32_t frame{0};
+
+    friend auto operator<=>(const Landmark&, const Landmark&) = default;
+};
+
+/**
+ * @brief Landmarks and identity of one sound.
+ */
+struct Fingerprint {
+    uint64_t contentHash{0};            ///< Hash of the 16-bit quantized samples; equal for exact copies
+    std::vector<Landmark> landmarks;    ///< Sorted by hash, then frame; distinct
+    double durationSeconds{0.0};
+};
+
+/**
+ * @class Fingerprinter
+ * @brief Streaming fingerprint computation, fed one block of frames at a time.
+ *
+ * The input is mixed to mono and decimated to a fixed analysis rate before
+ * the spectral analysis, so sources at different sample rates or channel
+ * counts produce comparable hashes. Only the current analysis frame and a
+ * short window of recent peaks are kept, whatever the length of the sound.
+ *
+ * Not thread-safe; use one Fingerprinter per stream.
+ */
+class Fingerprinter final {
+public:
+    Fingerprinter(int sampleRate, int channels);
+
+    /** @brief Feed @p frames frames of interleaved samples. */
+    void add(const float* samples, size_t frames);
+
+    /** @brief End the stream and return its fingerprint. */
+    [[nodiscard]] Fingerprint finish();
+
+private:
+    void pushAnalysisSample(float sample);
+    void analyzeFrame();
+
+    int sampleRate_;
+    int channels_;
+    size_t framesAdded_{0};
+    Fnv1a contentHash_;
+
+    // Decimation to the analysis rate (box filter over each output period)
+    double step_;
+    double phase_{0.0};
+    double decimationSum_{0.0};
+    int decimationCount_{0};
+
+    std::vector<float> frame_;          ///< Analysis samples of the current frame
+    size_t frameFill_{0};
+    std::vector<float> window_;         ///< Hann window
+    std::vector<float> re_;             ///< FFT scratch
+    std::vector<float> im_;
+
+    std::vector<std::vector<uint16_t>> recent_;   ///< Peak bins of the last frames, strongest first (ring)
+    size_t frameIndex_{0};
+    std::vector<Landmark> landmarks_;
+};
+
+/**
+ * @class FingerprintSink
+ * @brief Fingerprints a source while a decoder streams it, e.g. through AudioEngine::streamFrames().
+ */
+class FingerprintSink final : public FrameRanges::Sink {
+public:
+    void begin(int sampleRate, int channels, size_t frames) override;
+    void frames(const float* samples, size_t firstFrame, size_t frames) override;
+
+    /** @brief Fingerprint of the frames received; nullopt if no source began. */
+    [[nodiscard]] std::optional<Fingerprint> finish();
+
+private:
+    std::optional<Fingerprinter> fingerprinter_;
+};
+
+/** @brief Fingerprint of a whole interleaved buffer, fed through a Fingerprinter in blocks. */
+[[nodiscard]] Fingerprint fingerprintSamples(std::span<const float> samples, int sampleRate, int channels);
+
+/**
+ * @brief Fraction of the smaller fingerprint's landmarks that the other one has at one time offset.
+ *
+ * Shared hashes vote for the offset between their frames; the best offset
+ * (give or take a frame, for trims between frame boundaries) counts.
+ * @return 0 if either fingerprint has no landmarks.
+ */
+[[nodiscard]] double fingerprintSimilarity(const Fingerprint& a, const Fingerprint& b);
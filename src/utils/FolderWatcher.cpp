@@ -0,0 +1,306 @@
+/**
+ * @file FolderWatcher.cpp
+ * @brief Implementation of the inotify and polling folder watchers.
+ */
+
+#include "FolderWatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+#include "utils/FileScanner.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int elapsedMs(Clock::time_point since) {
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - since).count());
+}
+
+/// Milliseconds left of @p timeoutMs since @p start; -1 stays -1 (no timeout).
+int remainingMs(int timeoutMs, Clock::time_point start) {
+    if (timeoutMs < 0) return -1;
+    return std::max(0, timeoutMs - elapsedMs(start));
+}
+
+bool isWithin(const fs::path& path, const fs::path& folder) {
+    auto p = path.begin();
+    for (auto f = folder.begin(); f != folder.end(); ++f, ++p) {
+        if (f->empty()) continue;   // Trailing separator
+        if (p == path.end() || *p != *f) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FolderWatcher::FolderWatcher(std::string folder)
+    : FolderWatcher(std::move(folder), Options{})
+{
+}
+
+FolderWatcher::FolderWatcher(std::string folder, Options options)
+    : folder_(fs::path(std::move(folder)).lexically_normal().string())
+    , options_(std::move(options))
+{
+    if (!options_.excludedFolder.empty()) {
+        options_.excludedFolder = fs::path(options_.excludedFolder).lexically_normal().string();
+    }
+    if (options_.forcePolling || !startNotifications()) {
+        snapshot_ = takeSnapshot();
+    }
+}
+
+FolderWatcher::~FolderWatcher() {
+#ifdef __linux__
+    if (notifyFd_ >= 0) close(notifyFd_);
+    if (wakeFd_ >= 0) close(wakeFd_);
+#endif
+}
+
+std::vector<std::string> FolderWatcher::waitForChanges(int timeoutMs) {
+    if (stopped()) return {};
+    return usesNotifications() ? waitForNotifications(timeoutMs) : waitByPolling(timeoutMs);
+}
+
+void FolderWatcher::stop() noexcept {
+    stopped_.store(true, std::memory_order_relaxed);
+#ifdef __linux__
+    if (wakeFd_ >= 0) {
+        const uint64_t one = 1;
+        [[maybe_unused]] auto written = write(wakeFd_, &one, sizeof(one));
+    }
+#endif
+}
+
+bool FolderWatcher::isRelevant(const std::string& path) const {
+    if (!FileScanner::isAudioFile(path)) return false;
+    return options_.excludedFolder.empty()
+        || !isWithin(fs::path(path).lexically_normal(), fs::path(options_.excludedFolder));
+}
+
+// ============================================================================
+// inotify
+// ============================================================================
+
+#ifdef __linux__
+
+bool FolderWatcher::startNotifications() {
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notifyFd_ >= 0 && wakeFd_ >= 0) {
+        // Without a watch on the root nothing would ever be reported
+        if (watchTree(folder_, nullptr)) return true;
+    }
+
+    if (notifyFd_ >= 0) close(notifyFd_);
+    if (wakeFd_ >= 0) close(wakeFd_);
+    notifyFd_ = -1;
+    wakeFd_ = -1;
+    watches_.clear();
+    return false;
+}
+
+bool FolderWatcher::watchTree(const std::string& directory, std::set<std::string>* found) {
+    // Closed-after-write and moved-in cover saves, copies and atomic renames;
+    // created directories get watches of their own
+    constexpr uint32_t kMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+
+    const int wd = inotify_add_watch(notifyFd_, directory.c_str(), kMask);
+    if (wd < 0) return false;
+    watches_[wd] = directory;
+
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(directory, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        const std::string path = it->path().string();
+        if (it->is_directory(ec)) {
+            if (!options_.excludedFolder.empty() && isWithin(it->path(), fs::path(options_.excludedFolder))) {
+                it.disable_recursion_pending();
+                continue;
+            }
+            const int sub = inotify_add_watch(notifyFd_, path.c_str(), kMask);
+            if (sub >= 0) watches_[sub] = path;
+        } else if (found && isRelevant(path)) {
+            // Files written into a new directory before its watch existed
+            found->insert(path);
+        }
+    }
+    return true;
+}
+
+bool FolderWatcher::readEvents(std::set<std::string>& changed) {
+    alignas(inotify_event) char buffer[16384];
+    while (true) {
+        const ssize_t length = read(notifyFd_, buffer, sizeof(buffer));
+        if (length < 0) return errno == EAGAIN || errno == EINTR;
+        if (length == 0) return true;
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were lost; report everything so the caller rechecks it all
+                for (auto& path : FileScanner().scan(folder_)) {
+                    if (isRelevant(path)) changed.insert(std::move(path));
+                }
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                watches_.erase(event->wd);
+                continue;
+            }
+
+            auto dir = watches_.find(event->wd);
+            if (dir == watches_.end() || event->len == 0) continue;
+            const std::string path = (fs::path(dir->second) / event->name).string();
+
+            if (event->mask & IN_ISDIR) {
+                const bool excluded = !options_.excludedFolder.empty()
+                    && isWithin(fs::path(path), fs::path(options_.excludedFolder));
+                if (!excluded && (event->mask & (IN_CREATE | IN_MOVED_TO))) watchTree(path, &changed);
+            } else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) && isRelevant(path)) {
+                changed.insert(path);
+            }
+        }
+    }
+}
+
+std::vector<std::string> FolderWatcher::waitForNotifications(int timeoutMs) {
+    const auto start = Clock::now();
+    Clock::time_point firstChange;
+    std::set<std::string> changed;
+
+    while (!stopped()) {
+        int waitMs = remainingMs(timeoutMs, start);
+        if (!changed.empty()) {
+            // A burst that never pauses still ends after the maximum delay
+            const int left = options_.maxDelayMs - elapsedMs(firstChange);
+            if (left <= 0) return {changed.begin(), changed.end()};
+            waitMs = std::min(options_.debounceMs, left);
+        }
+
+        pollfd fds[2] = {{notifyFd_, POLLIN, 0}, {wakeFd_, POLLIN, 0}};
+        const int ready = poll(fds, 2, waitMs);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready == 0) {
+            // Quiet for the debounce interval, past the maximum delay, or timed out
+            return {changed.begin(), changed.end()};
+        }
+        if (fds[0].revents & POLLIN) {
+            const bool hadChanges = !changed.empty();
+            if (!readEvents(changed)) break;
+            if (!hadChanges && !changed.empty()) firstChange = Clock::now();
+        }
+    }
+    return {};
+}
+
+#else
+
+bool FolderWatcher::startNotifications() {
+    return false;
+}
+
+bool FolderWatcher::watchTree(const std::string&, std::set<std::string>*) {
+    return false;
+}
+
+bool FolderWatcher::readEvents(std::set<std::string>&) {
+    return false;
+}
+
+std::vector<std::string> FolderWatcher::waitForNotifications(int) {
+    return {};
+}
+
+#endif
+
+// ============================================================================
+// Polling fallback
+// ============================================================================
+
+FolderWatcher::Snapshot FolderWatcher::takeSnapshot() const {
+    Snapshot snapshot;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(folder_, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            if (!options_.excludedFolder.empty() && isWithin(it->path(), fs::path(options_.excludedFolder))) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        const std::string path = it->path().string();
+        if (!it->is_regular_file(ec) || !isRelevant(path)) continue;
+
+        std::error_code statError;
+        const auto size = it->file_size(statError);
+        const auto time = it->last_write_time(statError);
+        if (statError) continue;
+        snapshot[path] = {static_cast<uint64_t>(size), static_cast<int64_t>(time.time_since_epoch().count())};
+    }
+    return snapshot;
+}
+
+bool FolderWatcher::sleepUnlessStopped(int ms) const {
+    // Short slices keep stop() responsive without a wake-up primitive
+    constexpr int kSliceMs = 100;
+    for (int slept = 0; slept < ms && !stopped(); slept += kSliceMs) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(kSliceMs, ms - slept)));
+    }
+    return !stopped();
+}
+
+std::vector<std::string> FolderWatcher::waitByPolling(int timeoutMs) {
+    const auto start = Clock::now();
+    std::set<std::string> changed;
+
+    auto collect = [&]() {
+        Snapshot current = takeSnapshot();
+        bool any = false;
+        for (const auto& [path, state] : current) {
+            auto previous = snapshot_.find(path);
+            if (previous == snapshot_.end() || previous->second != state) {
+                changed.insert(path);
+                any = true;
+            }
+        }
+        snapshot_ = std::move(current);
+        return any;
+    };
+
+    while (changed.empty()) {
+        const int remaining = remainingMs(timeoutMs, start);
+        if (remaining == 0) return {};
+        const int waitMs = remaining < 0 ? options_.pollIntervalMs : std::min(options_.pollIntervalMs, remaining);
+        if (!sleepUnlessStopped(waitMs)) return {};
+        collect();
+    }
+
+    // Debounce: rescan until a scan finds nothing new, or the maximum delay passes
+    const auto firstChange = Clock::now();
+    while (elapsedMs(firstChange) < options_.maxDelayMs) {
+        if (!sleepUnlessStopped(std::min(options_.debounceMs, options_.maxDelayMs - elapsedMs(firstChange)))) return {};
+        if (!collect()) break;
+    }
+    return {changed.begin(), changed.end()};
+}
@@ -0,0 +1,89 @@
+/**
+ * @file FolderWatcher.h
+ * @brief Reports audio files that were added or rewritten under a folder.
+ *
+ * On Linux the watcher uses inotify: it sleeps in the kernel until a file is
+ * closed after writing or moved into the tree, so an idle watch costs no CPU.
+ * Elsewhere, or when inotify is unavailable (e.g. the watch limit is
+ * reached), it falls back to comparing file sizes and modification times
+ * every poll interval.
+ *
+ * Editors and copy tools write a file in several steps and often save many
+ * files at once, so changes are debounced: waitForChanges() returns once
+ * the tree has been quiet for the debounce interval, or at the latest after
+ * the maximum delay, with every changed file of the burst listed once.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class FolderWatcher final {
+public:
+    struct Options {
+        int debounceMs{500};            ///< Quiet time that ends a burst of changes
+        int maxDelayMs{5000};           ///< Longest a change waits while a burst goes on
+        int pollIntervalMs{2000};       ///< Scan interval of the polling fallback
+        std::string excludedFolder;     ///< Subtree to ignore, e.g. an export folder inside the watched one
+        bool forcePolling{false};       ///< Use the polling fallback even where inotify exists
+    };
+
+    explicit FolderWatcher(std::string folder);
+    FolderWatcher(std::string folder, Options options);
+    ~FolderWatcher();
+
+    FolderWatcher(const FolderWatcher&) = delete;
+    FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+    /** @brief True if changes arrive as kernel notifications rather than by polling. */
+    [[nodiscard]] bool usesNotifications() const noexcept { return notifyFd_ >= 0; }
+
+    /**
+     * @brief Block until audio files changed and the burst settled.
+     *
+     * Only changes after construction (or after the previous call) are
+     * reported.
+     * @param timeoutMs Give up after this long without a change; -1 waits forever.
+     * @return Sorted paths of the changed files; empty on timeout or after stop().
+     */
+    [[nodiscard]] std::vector<std::string> waitForChanges(int timeoutMs = -1);
+
+    /**
+     * @brief Make waitForChanges() return. Safe from other threads and signal handlers.
+     */
+    void stop() noexcept;
+
+    [[nodiscard]] bool stopped() const noexcept { return stopped_.load(std::memory_order_relaxed); }
+
+private:
+    using Snapshot = std::map<std::string, std::pair<uint64_t, int64_t>>;   ///< Path to size, mtime
+
+    bool isRelevant(const std::string& path) const;
+
+    // inotify
+    bool startNotifications();
+    bool watchTree(const std::string& directory, std::set<std::string>* found);
+    bool readEvents(std::set<std::string>& changed);
+    std::vector<std::string> waitForNotifications(int timeoutMs);
+
+    // Polling fallback
+    Snapshot takeSnapshot() const;
+    std::vector<std::string> waitByPolling(int timeoutMs);
+    bool sleepUnlessStopped(int ms) const;
+
+    std::string folder_;
+    Options options_;
+    std::atomic<bool> stopped_{false};
+
+    int notifyFd_{-1};
+    int wakeFd_{-1};                                ///< eventfd that stop() signals
+    std::map<int, std::string> watches_;            ///< inotify watch descriptor to directory
+
+    Snapshot snapshot_;
+};
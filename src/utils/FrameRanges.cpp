@@ -0,0 +1,229 @@
+/**
+ * @file FrameRanges.cpp
+ * @brief Implementation of the frame range splitting and the shared range helpers.
+ */
+
+#include "FrameRanges.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace FrameRanges {
+
+std::vector<Range> split(size_t frames, size_t frameBytes) {
+    if (frames == 0) return {};
+    if (frameBytes == 0 || !worthSplitting(frames * frameBytes)) return {{0, frames}};
+
+    const size_t rangeFrames = std::max<size_t>(1, kRangeBytes / frameBytes);
+    std::vector<Range> ranges;
+    ranges.reserve((frames + rangeFrames - 1) / rangeFrames);
+    for (size_t first = 0; first < frames; first += rangeFrames) {
+        ranges.push_back({first, std::min(rangeFrames, frames - first)});
+    }
+    return ranges;
+}
+
+namespace {
+
+unsigned coreCount() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+/// Threads currently decoding: marked workers, callers of run() and busy helpers.
+std::atomic<int> busyThreads{0};
+thread_local bool markedWorker = false;
+
+/** @brief Counts the current thread as busy for its lifetime. */
+class BusyThread {
+public:
+    BusyThread() { busyThreads.fetch_add(1, std::memory_order_relaxed); }
+    ~BusyThread() { busyThreads.fetch_sub(1, std::memory_order_relaxed); }
+    BusyThread(const BusyThread&) = delete;
+    BusyThread& operator=(const BusyThread&) = delete;
+};
+
+/**
+ * @brief Helper threads shared by every run() in the process.
+ *
+ * Created on the first split file with one thread less than there are cores,
+ * since every caller decodes its own ranges as well.
+ */
+class HelperPool {
+public:
+    static HelperPool& shared() {
+        static HelperPool pool;
+        return pool;
+    }
+
+    /// Queue @p task for at most @p copies helpers that are idle and not already spoken for.
+    void post(const std::function<void()>& task, size_t copies) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const size_t free = idle_ > tasks_.size() ? idle_ - tasks_.size() : 0;
+            copies = std::min(copies, free);
+            for (size_t c = 0; c < copies; ++c) tasks_.push_back(task);
+        }
+        for (size_t c = 0; c < copies; ++c) wake_.notify_one();
+    }
+
+private:
+    HelperPool() {
+        const unsigned helpers = coreCount() - 1;
+        threads_.reserve(helpers);
+        for (unsigned h = 0; h < helpers; ++h) {
+            threads_.emplace_back([this, h] { loop(h); });
+        }
+    }
+
+    ~HelperPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    void loop(unsigned helperIndex) {
+        bool named = false;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ++idle_;
+            wake_.wait(lock, [&] { return stopping_ || !tasks_.empty(); });
+            --idle_;
+            if (stopping_) return;
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            // Tracing may be switched on after the pool started
+            if (!named && Trace::isEnabled()) {
+                Trace::setThreadName("Range worker " + std::to_string(helperIndex + 1));
+                named = true;
+            }
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;   // Guarded by mutex_
+    size_t idle_{0};                            // Guarded by mutex_
+    bool stopping_{false};                      // Guarded by mutex_
+    std::vector<std::thread> threads_;
+};
+
+enum : char { kPending, kSucceeded, kFailed };
+
+/** @brief One run(), shared between its caller and the helpers that join it. */
+struct Job {
+    size_t count{0};
+    const std::function<bool(size_t)>* work{nullptr};
+    std::atomic<size_t> next{0};
+    std::atomic<bool> stop{false};
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<char> state;    // Guarded by mutex
+    int helpers{0};             // Helpers inside work(); guarded by mutex
+    bool closed{false};         // run() is returning, helpers may not join; guarded by mutex
+
+    /// Claim and run one index; false if none was left to claim.
+    bool workOne() {
+        if (stop.load(std::memory_order_relaxed)) return false;
+        const size_t i = next.fetch_add(1);
+        if (i >= count) return false;
+        const bool ok = (*work)(i);
+        if (!ok) stop.store(true, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            state[i] = ok ? kSucceeded : kFailed;
+        }
+        changed.notify_all();
+        return true;
+    }
+
+    /// Body of a helper; queued copies that start after run() returned do nothing.
+    void help() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (closed) return;
+            ++helpers;
+        }
+        {
+            BusyThread busy;
+            while (workOne()) {}
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --helpers;
+        }
+        changed.notify_all();
+    }
+};
+
+} // namespace
+
+WorkerScope::WorkerScope() : outer_(markedWorker) {
+    if (!outer_) busyThreads.fetch_add(1, std::memory_order_relaxed);
+    markedWorker = true;
+}
+
+WorkerScope::~WorkerScope() {
+    markedWorker = outer_;
+    if (!outer_) busyThreads.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t run(size_t count, const std::function<bool(size_t)>& work, const std::function<void(size_t)>& inOrder) {
+    if (count == 0) return 0;
+
+    auto job = std::make_shared<Job>();
+    job->count = count;
+    job->work = &work;
+    job->state.assign(count, kPending);
+
+    // Ask for helpers only while cores are idle; the caller counts once, whether marked or not
+    std::optional<BusyThread> caller;
+    if (!markedWorker) caller.emplace();
+    const int idleCores = static_cast<int>(coreCount()) - busyThreads.load(std::memory_order_relaxed);
+    if (count > 1 && idleCores > 0) {
+        HelperPool::shared().post([job] { job->help(); }, std::min<size_t>(count - 1, idleCores));
+    }
+
+    // Hand finished ranges on in order; while the next one is not ready, decode one ourselves
+    size_t delivered = 0;
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        while (delivered < count) {
+            if (job->state[delivered] == kPending) {
+                lock.unlock();
+                const bool worked = job->workOne();
+                lock.lock();
+                if (worked) continue;
+                // Unclaimed after a failure: nobody will run it
+                if (delivered >= std::min(job->next.load(), count)) break;
+                job->changed.wait(lock, [&] { return job->state[delivered] != kPending; });
+            }
+            if (job->state[delivered] != kSucceeded) break;
+            lock.unlock();
+            if (inOrder) inOrder(delivered);
+            lock.lock();
+            ++delivered;
+        }
+        // work() refers to the caller's data, so wait for helpers still inside it
+        job->closed = true;
+        job->changed.wait(lock, [&] { return job->helpers == 0; });
+    }
+    for (; delivered < count && job->state[delivered] == kSucceeded; ++delivered) {
+        if (inOrder) inOrder(delivered);
+    }
+    return delivered;
+}
+
+} // namespace FrameRanges
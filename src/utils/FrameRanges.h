@@ -0,0 +1,101 @@
+/**
+ * @file FrameRanges.h
+ * @brief Decode one long file as consecutive frame ranges on several threads.
+ *
+ * Batches run files in parallel, but a single long location recording would
+ * otherwise be read, converted and measured on one thread. The readers split
+ * such sources into ranges of a few MiB that are decoded concurrently, each
+ * into its own part of the output and with its own level meter; smaller
+ * sources are read in one go as before.
+ *
+ * Serial consumers such as the compressor can take the decoded ranges in
+ * order through a Sink while later ranges are still being decoded, so one
+ * huge file keeps every core busy instead of decoding and then processing.
+ * The helper threads are created once and shared, so files decoded by
+ * parallel batch workers do not multiply them.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace FrameRanges {
+
+/// Sources with at least this many bytes of sample data are split.
+inline constexpr size_t kMinSplitBytes = size_t{32} << 20;
+
+/// Bytes of sample data per range.
+inline constexpr size_t kRangeBytes = size_t{4} << 20;
+
+/** @brief Frames [first, first + frames) of a source. */
+struct Range {
+    size_t first{0};
+    size_t frames{0};
+};
+
+/** @brief Whether a source with @p sampleBytes of sample data is worth splitting. */
+[[nodiscard]] constexpr bool worthSplitting(size_t sampleBytes) noexcept { return sampleBytes >= kMinSplitBytes; }
+
+/**
+ * @brief Consecutive ranges covering [0, frames) of a source with @p frameBytes per frame.
+ *
+ * A single range if the source is not worthSplitting().
+ */
+[[nodiscard]] std::vector<Range> split(size_t frames, size_t frameBytes);
+
+/**
+ * @brief Run @p work(index) for indices [0, count) on the calling thread and shared helpers.
+ *
+ * The calling thread takes part, and helper threads shared by the whole
+ * process join in only while fewer threads than cores are busy, counting
+ * WorkerScope threads and other callers. Batch workers that already fill
+ * the cores therefore decode their ranges inline instead of each adding a
+ * thread per core.
+ *
+ * @p inOrder(index) is called on the calling thread, in index order, as soon
+ * as that index and all before it have finished; @p work of later indices
+ * keeps running meanwhile. Once an index fails, no new work is started and
+ * inOrder() stops before it.
+ * @return The number of leading indices that succeeded (count if all did).
+ */
+size_t run(size_t count, const std::function<bool(size_t)>& work,
+           const std::function<void(size_t)>& inOrder = {});
+
+/**
+ * @brief Counts the current thread as a busy worker while it lives.
+ *
+ * Worker pools that decode several files at once hold one on each worker,
+ * so run() leaves the cores they occupy to them. Scopes may nest.
+ */
+class WorkerScope {
+public:
+    WorkerScope();
+    ~WorkerScope();
+    WorkerScope(const WorkerScope&) = delete;
+    WorkerScope& operator=(const WorkerScope&) = delete;
+
+private:
+    bool outer_;
+};
+
+/**
+ * @brief Receives decoded frames in order while the rest of a source is decoding.
+ *
+ * Readers that split a source call begin() once and then frames() for each
+ * range, on the thread that called the reader. Sources read in one go reach
+ * no sink; whoever passed it feeds the finished clip instead.
+ */
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    /** @brief Format of the source; @p frames is what its header announces. */
+    virtual void begin(int sampleRate, int channels, size_t frames) = 0;
+
+    /** @brief Interleaved frames [firstFrame, firstFrame + frames) of the source. */
+    virtual void frames(const float* samples, size_t firstFrame, size_t frames) = 0;
+};
+
+} // namespace FrameRanges
@@ -0,0 +1,51 @@
+/**
+ * @file Hash.h
+ * @brief 64-bit FNV-1a hashing for keys that are stored on disk.
+ *
+ * std::hash may differ between standard libraries and runs; these keys are
+ * written into indexes and manifests and must stay the same.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @class Fnv1a
+ * @brief Incremental 64-bit FNV-1a hash.
+ *
+ * Arithmetic values are hashed by their in-memory bytes, which is the same
+ * on every little-endian platform Woosh builds for.
+ */
+class Fnv1a final {
+public:
+    void addByte(uint8_t byte) noexcept { value_ = (value_ ^ byte) * kPrime; }
+
+    void addBytes(const void* data, size_t size) noexcept {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) addByte(bytes[i]);
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void add(T value) noexcept {
+        addBytes(&value, sizeof(T));
+    }
+
+    /** @brief Length-prefixed, so consecutive strings cannot run into each other. */
+    void add(std::string_view text) noexcept {
+        add(static_cast<uint64_t>(text.size()));
+        addBytes(text.data(), text.size());
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept { return value_; }
+
+private:
+    static constexpr uint64_t kOffset = 14695981039346656037ull;
+    static constexpr uint64_t kPrime = 1099511628211ull;
+
+    uint64_t value_{kOffset};
+};
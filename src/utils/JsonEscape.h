@@ -0,0 +1,46 @@
+/**
+ * @file JsonEscape.h
+ * @brief Escaping of text written into JSON string literals.
+ *
+ * Projects, trace files, batch reports and benchmark results are all written
+ * by hand; they share this one escaper so any file name produces valid JSON.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Escape @p text for use between the quotes of a JSON string.
+ *
+ * Quotes and backslashes are backslash-escaped, common control characters
+ * get their short forms and the remaining ones below 0x20 become \\uXXXX.
+ * Bytes from 0x80 up pass through, so UTF-8 text stays as it is.
+ */
+[[nodiscard]] inline std::string escapeJson(std::string_view text) {
+    std::string result;
+    result.reserve(text.size() + 2);
+    for (char c : text) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\b': result += "\\b"; break;
+            case '\f': result += "\\f"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                    result += buf;
+                } else {
+                    result += c;
+                }
+                break;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file LoudnessMeter.cpp
+ * @brief Implementation of the incremental BS.1770 loudness meter.
+ */
+
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLoudnessOffset = -0.691;
+constexpr double kAbsoluteGateLufs = -70.0;
+constexpr double kRelativeGateLu = -10.0;
+constexpr double kHistogramMinLufs = -70.0;
+constexpr double kHistogramStepLu = 0.1;
+
+inline double energyToLufs(double energy) {
+    return kLoudnessOffset + 10.0 * std::log10(energy);
+}
+
+inline float energyToLufsOrSilence(double energy) {
+    if (energy <= 0.0) return -std::numeric_limits<float>::infinity();
+    return static_cast<float>(energyToLufs(energy));
+}
+}
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels) {
+    reset(sampleRate, channels);
+}
+
+void LoudnessMeter::reset(int sampleRate, int channels) {
+    sampleRate_ = std::max(0, sampleRate);
+    channels_ = std::max(0, channels);
+
+    // K-weighting coefficients derived for the actual sample rate (BS.1770-4
+    // gives them for 48 kHz only; this is the usual bilinear re-derivation)
+    if (sampleRate_ > 0) {
+        const double rate = static_cast<double>(sampleRate_);
+
+        // Stage 1: high shelf modelling the acoustic effect of the head
+        {
+            const double f0 = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(kPi * f0 / rate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf_.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf_.b1 = 2.0 * (k * k - vh) / a0;
+            shelf_.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf_.a2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        // Stage 2: RLB high-pass
+        {
+            const double f0 = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(kPi * f0 / rate);
+            const double a0 = 1.0 + k / q + k * k;
+            highPass_.b0 = 1.0;
+            highPass_.b1 = -2.0;
+            highPass_.b2 = 1.0;
+            highPass_.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass_.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    weights_.assign(static_cast<size_t>(channels_), 1.0);
+    if (channels_ >= 6) {
+        weights_[3] = 0.0;  // LFE
+        for (size_t c = 4; c < weights_.size(); ++c) weights_[c] = 1.41;
+    }
+
+    subBlockFrames_ = static_cast<size_t>(std::max(1, sampleRate_ / 10));
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    state_.assign(static_cast<size_t>(channels_), ChannelState{});
+    subBlockPos_ = 0;
+    subBlockSum_ = 0.0;
+    subBlocks_.fill(0.0);
+    subBlockHead_ = 0;
+    subBlocksCompleted_ = 0;
+    histogramCount_.fill(0);
+    histogramEnergy_.fill(0.0);
+}
+
+void LoudnessMeter::process(const float* interleaved, size_t frames) {
+    if (!interleaved || channels_ <= 0 || sampleRate_ <= 0) return;
+
+    const size_t channels = static_cast<size_t>(channels_);
+    const Biquad sh = shelf_;
+    const Biquad hp = highPass_;
+
+    size_t frame = 0;
+    while (frame < frames) {
+        const size_t run = std::min(frames - frame, subBlockFrames_ - subBlockPos_);
+        const float* block = interleaved + frame * channels;
+
+        // Channel-outer loop keeps the filter state in registers for the run
+        for (size_t c = 0; c < channels; ++c) {
+            const double weight = weights_[c];
+            ChannelState st = state_[c];
+            double sumSq = 0.0;
+            for (size_t i = 0; i < run; ++i) {
+                const double x = block[i * channels + c];
+                const double y1 = sh.b0 * x + st.s1;
+                st.s1 = sh.b1 * x - sh.a1 * y1 + st.s2;
+                st.s2 = sh.b2 * x - sh.a2 * y1;
+                const double y2 = hp.b0 * y1 + st.h1;
+                st.h1 = hp.b1 * y1 - hp.a1 * y2 + st.h2;
+                st.h2 = hp.b2 * y1 - hp.a2 * y2;
+                sumSq += y2 * y2;
+            }
+            state_[c] = st;
+            subBlockSum_ += weight * sumSq;
+        }
+
+        frame += run;
+        subBlockPos_ += run;
+        if (subBlockPos_ == subBlockFrames_) {
+            completeSubBlock();
+        }
+    }
+}
+
+void LoudnessMeter::completeSubBlock() {
+    subBlocks_[subBlockHead_] = subBlockSum_ / static_cast<double>(subBlockFrames_);
+    subBlockHead_ = (subBlockHead_ + 1) % kShortTermBlocks;
+    ++subBlocksCompleted_;
+    subBlockPos_ = 0;
+    subBlockSum_ = 0.0;
+
+    // Every 100 ms step closes a 400 ms gating block (75% overlap)
+    if (subBlocksCompleted_ < kMomentaryBlocks) return;
+
+    const double energy = windowEnergy(kMomentaryBlocks);
+    if (energy <= 0.0) return;
+    const double lufs = energyToLufs(energy);
+    if (lufs <= kAbsoluteGateLufs) return;
+
+    int bin = static_cast<int>((lufs - kHistogramMinLufs) / kHistogramStepLu);
+    bin = std::clamp(bin, 0, kHistogramBins - 1);
+    ++histogramCount_[static_cast<size_t>(bin)];
+    histogramEnergy_[static_cast<size_t>(bin)] += energy;
+}
+
+double LoudnessMeter::windowEnergy(size_t blocks) const noexcept {
+    double sum = 0.0;
+    for (size_t i = 1; i <= blocks; ++i) {
+        sum += subBlocks_[(subBlockHead_ + kShortTermBlocks - i) % kShortTermBlocks];
+    }
+    return sum / static_cast<double>(blocks);
+}
+
+float LoudnessMeter::momentaryLufs() const noexcept {
+    if (subBlocksCompleted_ < kMomentaryBlocks) return -std::numeric_limits<float>::infinity();
+    return energyToLufsOrSilence(windowEnergy(kMomentaryBlocks));
+}
+
+float LoudnessMeter::shortTermLufs() const noexcept {
+    if (subBlocksCompleted_ < kShortTermBlocks) return -std::numeric_limits<float>::infinity();
+    return energyToLufsOrSilence(windowEnergy(kShortTermBlocks));
+}
+
+float LoudnessMeter::integratedLufs() const noexcept {
+    // Absolute-gated mean
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (int i = 0; i < kHistogramBins; ++i) {
+        count += histogramCount_[static_cast<size_t>(i)];
+        energy += histogramEnergy_[static_cast<size_t>(i)];
+    }
+    if (count == 0) return -std::numeric_limits<float>::infinity();
+
+    // Relative gate, resolved at histogram-bin granularity (0.1 LU)
+    const double relativeGate = energyToLufs(energy / static_cast<double>(count)) + kRelativeGateLu;
+    int firstBin = static_cast<int>(std::ceil((relativeGate - kHistogramMinLufs) / kHistogramStepLu));
+    firstBin = std::clamp(firstBin, 0, kHistogramBins);
+
+    count = 0;
+    energy = 0.0;
+    for (int i = firstBin; i < kHistogramBins; ++i) {
+        count += histogramCount_[static_cast<size_t>(i)];
+        energy += histogramEnergy_[static_cast<size_t>(i)];
+    }
+    if (count == 0) return -std::numeric_limits<float>::infinity();
+    return energyToLufsOrSilence(energy / static_cast<double>(count));
+}
@@ -0,0 +1,102 @@
+/**
+ * @file LoudnessMeter.h
+ * @brief Incremental ITU-R BS.1770 / EBU R128 loudness measurement.
+ *
+ * Computes momentary (400 ms), short-term (3 s) and gated integrated loudness
+ * from consecutive blocks of interleaved samples. K-weighting filter state is
+ * carried between blocks, so the meter can be fed straight from a playback
+ * stream without an offline analysis pass.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class LoudnessMeter
+ * @brief Streaming LUFS meter for any number of channels.
+ *
+ * Channel weighting follows BS.1770 for the common WAV/SMPTE layouts: for six
+ * or more channels, channel 3 is treated as LFE (excluded) and channels 4+ as
+ * surrounds (+1.5 dB). Layouts with fewer channels weight every channel 1.0.
+ *
+ * Not thread-safe; feed it from a single thread.
+ */
+class LoudnessMeter final {
+public:
+    LoudnessMeter() = default;
+    LoudnessMeter(int sampleRate, int channels);
+
+    /**
+     * @brief Reconfigure the meter and clear all measurement state.
+     * @param sampleRate Sample rate of the incoming stream in Hz.
+     * @param channels Number of interleaved channels.
+     */
+    void reset(int sampleRate, int channels);
+
+    /** @brief Clear measurement state, keeping the current configuration. */
+    void reset();
+
+    /**
+     * @brief Feed a block of interleaved samples.
+     * @param interleaved Pointer to frames * channels() samples.
+     * @param frames Number of frames in the block.
+     */
+    void process(const float* interleaved, size_t frames);
+
+    /** @brief Momentary loudness (400 ms window) in LUFS, -inf until 400 ms have been fed. */
+    [[nodiscard]] float momentaryLufs() const noexcept;
+
+    /** @brief Short-term loudness (3 s window) in LUFS, -inf until 3 s have been fed. */
+    [[nodiscard]] float shortTermLufs() const noexcept;
+
+    /** @brief Gated integrated loudness since the last reset in LUFS, -inf if nothing passed the gate. */
+    [[nodiscard]] float integratedLufs() const noexcept;
+
+    [[nodiscard]] int sampleRate() const noexcept { return sampleRate_; }
+    [[nodiscard]] int channels() const noexcept { return channels_; }
+
+private:
+    struct Biquad {
+        double b0{1.0}, b1{0.0}, b2{0.0}, a1{0.0}, a2{0.0};
+    };
+
+    /// Transposed direct form II state for the two K-weighting stages.
+    struct ChannelState {
+        double s1{0.0}, s2{0.0};   ///< Pre-filter (high shelf)
+        double h1{0.0}, h2{0.0};   ///< RLB high-pass
+    };
+
+    static constexpr size_t kMomentaryBlocks = 4;    ///< 4 x 100 ms
+    static constexpr size_t kShortTermBlocks = 30;   ///< 30 x 100 ms
+    static constexpr int kHistogramBins = 800;       ///< 0.1 LU bins from -70 to +10 LUFS
+
+    void completeSubBlock();
+    [[nodiscard]] double windowEnergy(size_t blocks) const noexcept;
+
+    int sampleRate_{0};
+    int channels_{0};
+
+    Biquad shelf_;
+    Biquad highPass_;
+    std::vector<ChannelState> state_;
+    std::vector<double> weights_;
+
+    // 100 ms sub-block accumulation
+    size_t subBlockFrames_{0};
+    size_t subBlockPos_{0};
+    double subBlockSum_{0.0};
+
+    // Ring of the most recent sub-block mean-square energies
+    std::array<double, kShortTermBlocks> subBlocks_{};
+    size_t subBlockHead_{0};
+    size_t subBlocksCompleted_{0};
+
+    // Integrated loudness: energies of gating blocks above the absolute gate,
+    // bucketed by loudness so the relative gate is O(bins) rather than O(blocks)
+    std::array<uint64_t, kHistogramBins> histogramCount_{};
+    std::array<double, kHistogramBins> histogramEnergy_{};
+};
@@ -0,0 +1,159 @@
+/**
+ * @file SpeakerLayout.cpp
+ * @brief Implementation of the speaker layout tables and mix matrices.
+ */
+
+#include "SpeakerLayout.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace SpeakerLayout {
+
+namespace {
+
+enum class Speaker { FrontLeft, FrontRight, Centre, Lfe, Left, Right, BackCentre };
+
+struct SpeakerInfo {
+    Speaker speaker;
+    const char* label;
+    int group;          ///< Compressor link group
+};
+
+using S = Speaker;
+
+// Layouts for 3..8 channels, in WAVE channel order
+constexpr std::array<SpeakerInfo, 3> kLayout3{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0}, {S::Centre, "C", 1}}};
+constexpr std::array<SpeakerInfo, 4> kLayout4{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0},
+                                               {S::Left, "Ls", 0}, {S::Right, "Rs", 0}}};
+constexpr std::array<SpeakerInfo, 5> kLayout5{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0}, {S::Centre, "C", 1},
+                                               {S::Left, "Ls", 2}, {S::Right, "Rs", 2}}};
+constexpr std::array<SpeakerInfo, 6> kLayout6{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0}, {S::Centre, "C", 1},
+                                               {S::Lfe, "LFE", 2}, {S::Left, "Ls", 3}, {S::Right, "Rs", 3}}};
+constexpr std::array<SpeakerInfo, 7> kLayout7{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0}, {S::Centre, "C", 1},
+                                               {S::Lfe, "LFE", 2}, {S::BackCentre, "Cs", 3},
+                                               {S::Left, "Ls", 4}, {S::Right, "Rs", 4}}};
+constexpr std::array<SpeakerInfo, 8> kLayout8{{{S::FrontLeft, "L", 0}, {S::FrontRight, "R", 0}, {S::Centre, "C", 1},
+                                               {S::Lfe, "LFE", 2}, {S::Left, "Lb", 3}, {S::Right, "Rb", 3},
+                                               {S::Left, "Ls", 4}, {S::Right, "Rs", 4}}};
+
+/// The speaker of @p channel, or nullptr if @p channels has no layout.
+const SpeakerInfo* speakerInfo(int channel, int channels) noexcept {
+    if (channel < 0 || channel >= channels) return nullptr;
+    const auto c = static_cast<size_t>(channel);
+    switch (channels) {
+        case 3: return &kLayout3[c];
+        case 4: return &kLayout4[c];
+        case 5: return &kLayout5[c];
+        case 6: return &kLayout6[c];
+        case 7: return &kLayout7[c];
+        case 8: return &kLayout8[c];
+        default: return nullptr;
+    }
+}
+
+/// Scale @p row so its gains sum to at most 1.
+void limitRow(float* row, int count) {
+    float sum = 0.0f;
+    for (int i = 0; i < count; ++i) sum += std::abs(row[i]);
+    if (sum <= 1.0f) return;
+    for (int i = 0; i < count; ++i) row[i] /= sum;
+}
+
+/// Unscaled gains of every input channel into the left and right output.
+void stereoGains(int inChannels, std::vector<float>& left, std::vector<float>& right) {
+    constexpr float kMinus3Db = 0.70710678f;
+    left.assign(static_cast<size_t>(inChannels), 0.0f);
+    right.assign(static_cast<size_t>(inChannels), 0.0f);
+    if (inChannels == 1) {
+        left[0] = right[0] = 1.0f;
+        return;
+    }
+    for (int c = 0; c < inChannels; ++c) {
+        const auto i = static_cast<size_t>(c);
+        const SpeakerInfo* info = inChannels == 2 ? nullptr : speakerInfo(c, inChannels);
+        if (!info) {
+            // Stereo, or no layout: alternate between left and right
+            (c % 2 == 0 ? left : right)[i] = 1.0f;
+            continue;
+        }
+        switch (info->speaker) {
+            case S::FrontLeft:  left[i] = 1.0f; break;
+            case S::FrontRight: right[i] = 1.0f; break;
+            case S::Centre:     left[i] = right[i] = kMinus3Db; break;
+            case S::Lfe:        break;
+            case S::Left:       left[i] = kMinus3Db; break;
+            case S::Right:      right[i] = kMinus3Db; break;
+            case S::BackCentre: left[i] = right[i] = 0.5f; break;
+        }
+    }
+}
+
+} // namespace
+
+std::string label(int channel, int channels) {
+    if (channels == 2 && (channel == 0 || channel == 1)) return channel == 0 ? "L" : "R";
+    if (const SpeakerInfo* info = speakerInfo(channel, channels)) return info->label;
+    return std::to_string(channel + 1);
+}
+
+int linkGroupCount(int channels) noexcept {
+    // Four channels may be ambisonics; keep them linked (see the file comment)
+    if (channels <= 4 && channels != 3) return 1;
+    int groups = 1;
+    for (int c = 0; c < channels; ++c) {
+        if (const SpeakerInfo* info = speakerInfo(c, channels)) groups = std::max(groups, info->group + 1);
+    }
+    return groups;
+}
+
+int linkGroup(int channel, int channels) noexcept {
+    if (linkGroupCount(channels) == 1) return 0;
+    const SpeakerInfo* info = speakerInfo(channel, channels);
+    return info ? info->group : 0;
+}
+
+std::vector<float> mixMatrix(int inChannels, int outChannels) {
+    if (inChannels <= 0 || outChannels <= 0) return {};
+    const auto in = static_cast<size_t>(inChannels);
+    std::vector<float> gains(in * static_cast<size_t>(outChannels), 0.0f);
+    float* row0 = gains.data();
+    float* row1 = outChannels > 1 ? gains.data() + in : nullptr;
+
+    if (inChannels == outChannels) {
+        for (size_t c = 0; c < in; ++c) gains[c * in + c] = 1.0f;
+        return gains;
+    }
+
+    std::vector<float> left;
+    std::vector<float> right;
+    stereoGains(inChannels, left, right);
+    limitRow(left.data(), inChannels);
+    limitRow(right.data(), inChannels);
+
+    if (outChannels == 1) {
+        for (size_t c = 0; c < in; ++c) row0[c] = 0.5f * (left[c] + right[c]);
+        return gains;
+    }
+    if (outChannels == 2 || inChannels == 1) {
+        std::copy(left.begin(), left.end(), row0);
+        std::copy(right.begin(), right.end(), row1);
+        return gains;
+    }
+
+    // Between two multichannel layouts: the shared channels pass through and
+    // the rest of a larger input is folded into the front pair
+    const size_t shared = std::min(in, static_cast<size_t>(outChannels));
+    for (size_t c = 0; c < shared; ++c) gains[c * in + c] = 1.0f;
+    stereoGains(inChannels, left, right);
+    for (size_t c = shared; c < in; ++c) {
+        row0[c] = left[c];
+        row1[c] = right[c];
+    }
+    limitRow(row0, inChannels);
+    limitRow(row1, inChannels);
+    return gains;
+}
+
+} // namespace SpeakerLayout
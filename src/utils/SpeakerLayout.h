@@ -0,0 +1,54 @@
+/**
+ * @file SpeakerLayout.h
+ * @brief Speaker layouts of multichannel clips: names, compressor link groups, mix matrices.
+ *
+ * Clips don't carry a channel mask, so the layout follows from the channel
+ * count, with channels in WAVE order (FL FR FC LFE BL BR SL SR):
+ *
+ *   - 3: L R C            - 6: 5.1 (L R C LFE Ls Rs)
+ *   - 4: quad (L R Ls Rs) - 7: 6.1 (L R C LFE Cs Ls Rs)
+ *   - 5: L R C Ls Rs      - 8: 7.1 (L R C LFE Lb Rb Ls Rs)
+ *
+ * Other counts (e.g. higher-order ambisonics) have no speaker layout; their
+ * channels are numbered, compressed fully linked and folded to stereo
+ * alternately. Four channels may also be first-order ambisonics, so they
+ * are compressed fully linked as well, which keeps the sound field intact.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace SpeakerLayout {
+
+/// Largest channel count with a speaker layout.
+constexpr int kMaxLayoutChannels = 8;
+
+/** @brief Short name of @p channel (e.g. "L", "LFE", "Rs"), or its number for unknown layouts. */
+[[nodiscard]] std::string label(int channel, int channels);
+
+/**
+ * @brief Number of compressor link groups for @p channels channels.
+ *
+ * Channels of a group share one gain, so a stereo pair's image stays put,
+ * but a loud centre or LFE does not duck the other speakers. Mono, stereo
+ * and counts without a speaker layout have a single group.
+ */
+[[nodiscard]] int linkGroupCount(int channels) noexcept;
+
+/** @brief Link group of @p channel, in [0, linkGroupCount(channels)). */
+[[nodiscard]] int linkGroup(int channel, int channels) noexcept;
+
+/**
+ * @brief Gains that mix @p inChannels channels into @p outChannels.
+ *
+ * Row-major, @p outChannels rows of @p inChannels gains. Stereo and mono
+ * downmixes use the ITU-R BS.775 coefficients (centre and surrounds at
+ * -3 dB, LFE left out), scaled so that no output can exceed full scale.
+ * Mono is copied to the front pair; channels both layouts have pass
+ * through, and the rest of a larger layout is folded into the front pair.
+ */
+[[nodiscard]] std::vector<float> mixMatrix(int inChannels, int outChannels);
+
+} // namespace SpeakerLayout
@@ -0,0 +1,168 @@
+/**
+ * @file StartupProfile.cpp
+ * @brief Implementation of the startup phase timings.
+ */
+
+#include "StartupProfile.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#endif
+
+namespace StartupProfile {
+
+namespace {
+
+struct Entry {
+    const char* name;
+    double startMs;
+    double durationMs;      ///< Negative for a milestone
+};
+
+std::atomic<bool> gEnabled{false};
+std::mutex gMutex;
+std::vector<Entry> gEntries;
+std::chrono::steady_clock::time_point gBegin;
+double gBeforeMainMs = -1.0;
+
+/// Milliseconds the process has existed, or a negative value if the OS cannot tell.
+double processAgeMs() {
+#ifdef _WIN32
+    FILETIME creation{}, exitTime{}, kernel{}, user{}, now{};
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exitTime, &kernel, &user)) return -1.0;
+    GetSystemTimePreciseAsFileTime(&now);
+    auto ticks = [](const FILETIME& ft) {
+        return (static_cast<unsigned long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+    return static_cast<double>(ticks(now) - ticks(creation)) / 1.0e4;   // 100 ns units
+#elif defined(__linux__)
+    // Field 22 of /proc/self/stat: start time in clock ticks after boot.
+    // The command name (field 2) may contain spaces, so parse after its ')'.
+    std::ifstream in("/proc/self/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto close = stat.rfind(')');
+    if (close == std::string::npos) return -1.0;
+    std::istringstream fields(stat.substr(close + 2));
+    std::string field;
+    for (int i = 3; i < 22 && fields >> field; ++i) {}
+    unsigned long long startTicks = 0;
+    if (!(fields >> startTicks)) return -1.0;
+
+    timespec boot{};
+    const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (ticksPerSecond <= 0 || clock_gettime(CLOCK_BOOTTIME, &boot) != 0) return -1.0;
+    const double nowMs = static_cast<double>(boot.tv_sec) * 1000.0 + static_cast<double>(boot.tv_nsec) / 1.0e6;
+    return nowMs - static_cast<double>(startTicks) * 1000.0 / static_cast<double>(ticksPerSecond);
+#else
+    return -1.0;
+#endif
+}
+
+} // namespace
+
+void begin() {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gBeforeMainMs = processAgeMs();
+    gBegin = std::chrono::steady_clock::now();
+    gEntries.clear();
+    gEnabled.store(true, std::memory_order_release);
+}
+
+bool isEnabled() noexcept {
+    return gEnabled.load(std::memory_order_acquire);
+}
+
+double elapsedMs() noexcept {
+    if (!isEnabled()) return 0.0;
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - gBegin).count();
+}
+
+double beforeMainMs() noexcept {
+    return isEnabled() ? gBeforeMainMs : -1.0;
+}
+
+void mark(const char* name) {
+    if (!isEnabled()) return;
+    const double now = elapsedMs();
+    std::lock_guard<std::mutex> lock(gMutex);
+    gEntries.push_back({name, now, -1.0});
+}
+
+void recordPhase(const char* name, double startMs) {
+    if (!isEnabled()) return;
+    const double now = elapsedMs();
+    std::lock_guard<std::mutex> lock(gMutex);
+    gEntries.push_back({name, startMs, now - startMs});
+}
+
+std::string report() {
+    std::vector<Entry> entries;
+    double beforeMain = -1.0;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        entries = gEntries;
+        beforeMain = gBeforeMainMs;
+    }
+    // Phases are recorded when they end; list them as they started, outer first
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.startMs != b.startMs) return a.startMs < b.startMs;
+        return a.durationMs > b.durationMs;
+    });
+
+    std::string text = "Startup (ms from main)\n";
+    char line[160];
+    if (beforeMain >= 0.0) {
+        std::snprintf(line, sizeof(line), "  %9s %9.1f  %s\n", "", beforeMain, "before main (libraries, static init)");
+        text += line;
+    }
+    std::snprintf(line, sizeof(line), "  %9s %9s  %s\n", "start", "took", "phase");
+    text += line;
+    for (const Entry& entry : entries) {
+        if (entry.durationMs < 0.0) {
+            std::snprintf(line, sizeof(line), "  %9.1f %9s  %s\n", entry.startMs, "-", entry.name);
+        } else {
+            std::snprintf(line, sizeof(line), "  %9.1f %9.1f  %s\n", entry.startMs, entry.durationMs, entry.name);
+        }
+        text += line;
+    }
+    return text;
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(gMutex);
+    gEnabled.store(false, std::memory_order_release);
+    gEntries.clear();
+    gBeforeMainMs = -1.0;
+}
+
+Phase::Phase(const char* name) noexcept
+    : name_(name)
+    , active_(isEnabled())
+    , tracing_(Trace::isEnabled())
+{
+    if (active_) startMs_ = elapsedMs();
+    if (tracing_) traceStartUs_ = Trace::nowUs();
+}
+
+Phase::~Phase() {
+    if (active_) recordPhase(name_, startMs_);
+    if (tracing_) Trace::recordComplete(name_, traceStartUs_, Trace::nowUs() - traceStartUs_);
+}
+
+} // namespace StartupProfile
@@ -0,0 +1,80 @@
+/**
+ * @file StartupProfile.h
+ * @brief Timings of the startup phases, reported by `--startup-trace`.
+ *
+ * main() calls begin() first thing; phases are then timed from there until
+ * the window is interactive, when report() lists them. The time the process
+ * spent before main() (loading Qt and the codec libraries, static
+ * initialization) is included where the OS tells when the process started.
+ *
+ * Phases are also recorded as trace spans when `--trace` is on, so the
+ * subsystems that initialize lazily on first use (the MP3 decoder, the
+ * audio output) show up there after startup.
+ *
+ * Usage:
+ * @code
+ *   {
+ *       WOOSH_STARTUP_PHASE("theme");
+ *       applyDarkTheme(app);
+ *   }
+ * @endcode
+ */
+
+#pragma once
+
+#include <string>
+
+namespace StartupProfile {
+
+/** @brief Start the clock and enable recording; call first thing in main(). */
+void begin();
+
+/** @brief Whether begin() was called and phases are recorded. */
+[[nodiscard]] bool isEnabled() noexcept;
+
+/** @brief Milliseconds since begin(). */
+[[nodiscard]] double elapsedMs() noexcept;
+
+/** @brief Milliseconds from process creation to begin(); negative if unknown. */
+[[nodiscard]] double beforeMainMs() noexcept;
+
+/** @brief Record a milestone (a phase of zero length) at the current time. */
+void mark(const char* name);
+
+/** @brief Record a phase that started at @p startMs (from elapsedMs()) and ends now. */
+void recordPhase(const char* name, double startMs);
+
+/** @brief The recorded phases as a text table, in the order they started. */
+[[nodiscard]] std::string report();
+
+/** @brief Discard the recorded phases and disable recording. */
+void reset();
+
+/**
+ * @class Phase
+ * @brief RAII phase: records from construction to destruction when enabled.
+ */
+class Phase final {
+public:
+    explicit Phase(const char* name) noexcept;
+    ~Phase();
+
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+private:
+    const char* name_;
+    double startMs_{0.0};
+    double traceStartUs_{0.0};
+    bool active_;
+    bool tracing_;
+};
+
+} // namespace StartupProfile
+
+#define WOOSH_STARTUP_CONCAT_INNER(a, b) a##b
+#define WOOSH_STARTUP_CONCAT(a, b) WOOSH_STARTUP_CONCAT_INNER(a, b)
+
+/// Time the enclosing scope as a startup phase named @p name (a string literal).
+#define WOOSH_STARTUP_PHASE(name) \
+    ::StartupProfile::Phase WOOSH_STARTUP_CONCAT(wooshStartupPhase_, __LINE__)(name)
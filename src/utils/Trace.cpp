@@ -0,0 +1,148 @@
+/**
+ * @file Trace.cpp
+ * @brief Implementation of per-thread trace buffers and Chrome JSON output.
+ */
+
+#include "Trace.h"
+#include "JsonEscape.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+namespace detail {
+std::atomic<bool> gEnabled{false};
+}
+
+namespace {
+
+struct Event {
+    const char* name;
+    double startUs;
+    double durationUs;
+    std::string detail;
+};
+
+/// Events of one thread. The owning thread appends; the writer reads under
+/// the same (practically uncontended) lock.
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::string threadName;
+    int tid{0};
+};
+
+/// All thread buffers ever created. Buffers are shared so spans from threads
+/// that have exited (e.g. a shrunk thread pool) still make it into the file.
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextTid{1};
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        created->tid = reg.nextTid++;
+        created->threadName = "Thread " + std::to_string(created->tid);
+        created->events.reserve(1024);
+        reg.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+const std::chrono::steady_clock::time_point& epoch() {
+    static const auto start = std::chrono::steady_clock::now();
+    return start;
+}
+
+} // namespace
+
+void setEnabled(bool enabled) noexcept {
+    (void)epoch();
+    detail::gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+double nowUs() noexcept {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch()).count();
+}
+
+void recordComplete(const char* name, double startUs, double durationUs, std::string detail) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({name, startUs, durationUs, std::move(detail)});
+}
+
+void clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+bool writeChromeJson(const std::string& path) {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) return false;
+
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() -> const char* {
+        if (first) {
+            first = false;
+            return "";
+        }
+        return ",\n";
+    };
+
+    char number[64];
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+
+        // Lane label
+        file << separator()
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+             << ",\"args\":{\"name\":\"" << escapeJson(buffer->threadName) << "\"}}";
+
+        for (const Event& event : buffer->events) {
+            file << separator() << "{\"name\":\"" << escapeJson(event.name) << "\",\"cat\":\"woosh\",\"ph\":\"X\"";
+            std::snprintf(number, sizeof(number), "%.3f", event.startUs);
+            file << ",\"ts\":" << number;
+            std::snprintf(number, sizeof(number), "%.3f", event.durationUs);
+            file << ",\"dur\":" << number;
+            file << ",\"pid\":1,\"tid\":" << buffer->tid;
+            if (!event.detail.empty()) {
+                file << ",\"args\":{\"detail\":\"" << escapeJson(event.detail) << "\"}";
+            }
+            file << "}";
+        }
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+} // namespace Trace
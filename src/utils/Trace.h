@@ -0,0 +1,114 @@
+/**
+ * @file Trace.h
+ * @brief Lightweight scoped trace spans written as Chrome trace-event JSON.
+ *
+ * Spans are recorded into per-thread buffers and only merged when the trace
+ * is written, so worker threads never contend with each other. When tracing
+ * is disabled a span costs one relaxed atomic load.
+ *
+ * Usage:
+ * @code
+ *   void AudioEngine::compress(AudioClip& clip, ...) {
+ *       WOOSH_TRACE_SCOPE("AudioEngine::compress");
+ *       ...
+ *   }
+ * @endcode
+ *
+ * The resulting file opens in chrome://tracing or https://ui.perfetto.dev
+ * with one lane per thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace Trace {
+
+namespace detail {
+extern std::atomic<bool> gEnabled;
+}
+
+/** @brief Whether spans are currently being recorded. */
+[[nodiscard]] inline bool isEnabled() noexcept {
+    return detail::gEnabled.load(std::memory_order_relaxed);
+}
+
+/** @brief Start or stop recording. Already-recorded spans are kept. */
+void setEnabled(bool enabled) noexcept;
+
+/** @brief Label the calling thread's lane in the trace viewer. */
+void setThreadName(const std::string& name);
+
+/** @brief Microseconds since the trace clock epoch (first use in the process). */
+[[nodiscard]] double nowUs() noexcept;
+
+/**
+ * @brief Record a completed span on the calling thread.
+ * @param name Span name; must outlive the trace (use string literals).
+ * @param startUs Start time from nowUs().
+ * @param durationUs Duration in microseconds.
+ * @param detail Optional argument shown with the span (e.g. file name).
+ */
+void recordComplete(const char* name, double startUs, double durationUs, std::string detail = {});
+
+/** @brief Discard all recorded spans. */
+void clear();
+
+/**
+ * @brief Write all recorded spans as Chrome trace-event JSON.
+ * @param path Output file path.
+ * @return True on success.
+ */
+[[nodiscard]] bool writeChromeJson(const std::string& path);
+
+/**
+ * @class Scope
+ * @brief RAII span: records from construction to destruction when tracing is on.
+ */
+class Scope final {
+public:
+    explicit Scope(const char* name) noexcept
+        : name_(name)
+        , active_(isEnabled())
+    {
+        if (active_) startUs_ = nowUs();
+    }
+
+    Scope(const char* name, std::string detail)
+        : name_(name)
+        , detail_(std::move(detail))
+        , active_(isEnabled())
+    {
+        if (active_) startUs_ = nowUs();
+    }
+
+    ~Scope() {
+        if (active_) recordComplete(name_, startUs_, nowUs() - startUs_, std::move(detail_));
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    std::string detail_;
+    double startUs_{0.0};
+    bool active_;
+};
+
+} // namespace Trace
+
+#define WOOSH_TRACE_CONCAT_INNER(a, b) a##b
+#define WOOSH_TRACE_CONCAT(a, b) WOOSH_TRACE_CONCAT_INNER(a, b)
+
+/// Trace the enclosing scope under @p name (a string literal).
+#define WOOSH_TRACE_SCOPE(name) \
+    ::Trace::Scope WOOSH_TRACE_CONCAT(wooshTraceScope_, __LINE__)(name)
+
+/// Trace the enclosing scope with a detail string, evaluated only when tracing is on.
+#define WOOSH_TRACE_SCOPE_DETAIL(name, detail) \
+    ::Trace::Scope WOOSH_TRACE_CONCAT(wooshTraceScope_, __LINE__)( \
+        name, ::Trace::isEnabled() ? std::string(detail) : std::string())